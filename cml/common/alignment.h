@@ -0,0 +1,96 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Alignment of vector, matrix and quaternion storage.  Alignments are in
+ * bytes, and are always powers of two.
+ */
+
+#pragma once
+
+#ifndef	cml_common_alignment_h
+#define	cml_common_alignment_h
+
+#include <cstddef>
+#include <type_traits>
+
+namespace cml {
+
+/** The largest alignment given to fixed-size storage by default.  Before
+ * C++17, operator new only honors alignments up to that of
+ * std::max_align_t, so larger defaults would make heap-allocated objects
+ * (e.g. in a std::vector) misaligned.
+ */
+#if defined(__cpp_aligned_new)
+const int max_default_alignment = 32;
+#else
+const int max_default_alignment = int(alignof(std::max_align_t));
+#endif
+
+/** Specializable class giving the default alignment of fixed-size storage
+ * for @c Size elements of type @c Element.  Arithmetic arrays filling
+ * whole 16- or 32-byte SIMD registers (e.g. float4, double4 and 4x4
+ * matrices) are aligned to the register size, up to
+ * max_default_alignment, and other arrays have the alignment of @c
+ * Element.  Since the alignment divides the size of the array, the size of
+ * the storage is unchanged.
+ */
+template<class Element, int Size> struct default_storage_alignment
+{
+  private:
+
+  static const int bytes = int(sizeof(Element))*Size;
+  static const int simd
+    = !std::is_arithmetic<Element>::value ? 0
+    : (bytes % 32 == 0) ? 32 : (bytes % 16 == 0) ? 16 : 0;
+  static const int capped
+    = (simd < max_default_alignment) ? simd : max_default_alignment;
+  static const int natural = int(alignof(Element));
+
+
+  public:
+
+  static const int value = (capped > natural) ? capped : natural;
+};
+
+/** Resolve the alignment of fixed-size storage for @c Size elements of
+ * type @c Element, given the alignment parameter @c Align of its storage
+ * selector: 0 selects default_storage_alignment, and other values must be
+ * powers of two at least as large as the alignment of @c Element.
+ */
+template<class Element, int Size, int Align> struct storage_alignment
+{
+  static_assert(Align >= 0 && (Align & (Align - 1)) == 0,
+    "alignment must be a power of two");
+  static_assert(Align == 0 || Align >= int(alignof(Element)),
+    "alignment is smaller than that of the element type");
+
+  static const int value = (Align == 0)
+    ? default_storage_alignment<Element, Size>::value : Align;
+};
+
+/** Defines @c value as the alignment guaranteed for the elements of @c T.
+ * This is @c T::alignment if @c T defines it (vectors, matrices and
+ * quaternions with compiled or allocated storage, and aligned_allocator),
+ * or the alignment of @c T::value_type otherwise.  Kernels can test it at
+ * compile time to select aligned SIMD loads and stores.
+ */
+template<class T, class Enable = void> struct storage_alignment_of
+{
+  static const int value = int(alignof(typename T::value_type));
+};
+
+/** storage_alignment_of for types defining @c alignment. */
+template<class T> struct storage_alignment_of<T,
+  typename std::enable_if<(T::alignment > 0)>::type>
+{
+  static const int value = T::alignment;
+};
+
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,232 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Support for allocator-aware containers.  Containers store an instance
+ * of their allocator, propagate it on copy and move as directed by
+ * std::allocator_traits, and pass it on to temporaries built from them.
+ */
+
+#pragma once
+
+#ifndef	cml_common_allocator_h
+#define	cml_common_allocator_h
+
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace cml {
+
+/** Rebind @c Allocator to allocate elements of type @c T.  Unlike
+ * rebind_t<>, this also works for allocators without a rebind member
+ * template (e.g. std::pmr::polymorphic_allocator).
+ */
+template<class Allocator, class T> using rebind_alloc_t
+  = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+namespace detail {
+
+/** Defines @c value as true if @c Sub has a get_allocator() method
+ * returning an allocator convertible to @c Allocator, or false otherwise.
+ * Expression nodes have no allocator.
+ */
+template<class Allocator, class Sub> struct has_allocator_for
+{
+  private:
+
+  template<class X> static auto test(int) -> std::is_constructible<
+    Allocator, decltype(std::declval<const X&>().get_allocator())>;
+  template<class X> static auto test(...) -> std::false_type;
+
+  public:
+
+  typedef decltype(test<Sub>(0))			type;
+  static const bool value = type::value;
+};
+
+/* inherit_allocator() when no operand has an allocator. */
+template<class Allocator> inline Allocator
+inherit_allocator()
+{
+  return Allocator();
+}
+
+/* Forward declaration for inherit_allocator_from(). */
+template<class Allocator, class Sub, class... Subs> inline Allocator
+inherit_allocator(const Sub& sub, const Subs&... subs);
+
+/* Skip an operand without an allocator. */
+template<class Allocator, class Sub, class... Subs> inline Allocator
+inherit_allocator_from(std::false_type, const Sub&, const Subs&... subs)
+{
+  return inherit_allocator<Allocator>(subs...);
+}
+
+/* Copy the allocator of an operand. */
+template<class Allocator, class Sub, class... Subs> inline Allocator
+inherit_allocator_from(std::true_type, const Sub& sub, const Subs&...)
+{
+  return std::allocator_traits<Allocator>
+    ::select_on_container_copy_construction(Allocator(sub.get_allocator()));
+}
+
+/** Return the allocator for a temporary computed from @c sub and @c
+ * subs: a copy of the allocator of the first operand having one
+ * convertible to @c Allocator, as if by copy construction, or a
+ * default-constructed allocator if there is none.
+ */
+template<class Allocator, class Sub, class... Subs> inline Allocator
+inherit_allocator(const Sub& sub, const Subs&... subs)
+{
+  return inherit_allocator_from<Allocator>(
+    typename has_allocator_for<Allocator, Sub>::type(), sub, subs...);
+}
+
+
+/** Defines @c value as true if @c T is an allocator-aware container, or
+ * false otherwise.
+ */
+template<class T> struct is_allocator_aware
+{
+  private:
+
+  template<class X> static auto test(int)
+    -> decltype(std::declval<typename X::allocator_type>(), std::true_type());
+  template<class X> static auto test(...) -> std::false_type;
+
+  public:
+
+  typedef decltype(test<T>(0))				type;
+  static const bool value = type::value;
+};
+
+/* make_temporary() for containers without an allocator. */
+template<class T, class... Subs> inline T
+make_temporary(std::false_type, const Subs&...)
+{
+  return T();
+}
+
+/* make_temporary() for allocator-aware containers. */
+template<class T, class... Subs> inline T
+make_temporary(std::true_type, const Subs&... subs)
+{
+  return T(inherit_allocator<typename T::allocator_type>(subs...));
+}
+
+/** Return an empty temporary of type @c T to hold a result computed from
+ * @c subs.  If @c T is allocator-aware, it uses the allocator returned by
+ * inherit_allocator().
+ */
+template<class T, class... Subs> inline T
+make_temporary(const Subs&... subs)
+{
+  return make_temporary<T>(
+    typename is_allocator_aware<T>::type(), subs...);
+}
+
+
+/* Allocators that do not propagate are left unchanged. */
+template<class Allocator> inline void
+assign_allocator(Allocator&, const Allocator&, std::false_type) {}
+
+/* Copy a propagating allocator. */
+template<class Allocator> inline void
+assign_allocator(Allocator& to, const Allocator& from, std::true_type)
+{
+  to = from;
+}
+
+/* Move a propagating allocator. */
+template<class Allocator> inline void
+assign_allocator(Allocator& to, Allocator&& from, std::true_type)
+{
+  to = std::move(from);
+}
+
+/** Assign @c from to @c to, if @c Allocator propagates on container copy
+ * assignment.
+ */
+template<class Allocator> inline void
+copy_assign_allocator(Allocator& to, const Allocator& from)
+{
+  assign_allocator(to, from, typename std::allocator_traits<Allocator>
+    ::propagate_on_container_copy_assignment());
+}
+
+/** Move @c from to @c to, if @c Allocator propagates on container move
+ * assignment.
+ */
+template<class Allocator> inline void
+move_assign_allocator(Allocator& to, Allocator& from)
+{
+  assign_allocator(to, std::move(from), typename std::allocator_traits<
+    Allocator>::propagate_on_container_move_assignment());
+}
+
+
+/** Base class holding the allocator of a container.  Stateless allocators
+ * (empty and default-constructible) are not stored, and add nothing to the
+ * size of the container.
+ *
+ * @note The allocator is never a base class of the container, so that
+ * operators defined for the allocator cannot match the container.
+ */
+template<class Allocator, bool Stateless = std::is_empty<Allocator>::value
+  && std::is_default_constructible<Allocator>::value> class allocator_base
+{
+  protected:
+
+    allocator_base() {}
+    explicit allocator_base(const Allocator&) {}
+
+    /** Return the allocator. */
+    Allocator stored_allocator() const { return Allocator(); }
+
+    /** No-op for stateless allocators. */
+    void copy_assign_allocator(const allocator_base&) {}
+
+    /** No-op for stateless allocators. */
+    void move_assign_allocator(allocator_base&) {}
+};
+
+/** Base class storing a stateful allocator. */
+template<class Allocator> class allocator_base<Allocator, false>
+{
+  protected:
+
+    allocator_base() : m_allocator() {}
+    explicit allocator_base(const Allocator& a) : m_allocator(a) {}
+
+    /** Return the allocator. */
+    const Allocator& stored_allocator() const { return m_allocator; }
+
+    /** Copy the allocator of @c other, if it propagates on container copy
+     * assignment.
+     */
+    void copy_assign_allocator(const allocator_base& other) {
+      detail::copy_assign_allocator(m_allocator, other.m_allocator);
+    }
+
+    /** Move the allocator of @c other, if it propagates on container move
+     * assignment.
+     */
+    void move_assign_allocator(allocator_base& other) {
+      detail::move_assign_allocator(m_allocator, other.m_allocator);
+    }
+
+
+  private:
+
+    Allocator				m_allocator;
+};
+
+} // namespace detail
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,40 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Detect the SIMD instruction sets enabled by the compiler.  Define
+ * CML_NO_SIMD before including any CML header to force the portable
+ * scalar code paths.
+ */
+
+#pragma once
+
+#ifndef	cml_common_simd_h
+#define	cml_common_simd_h
+
+#if !defined(CML_NO_SIMD)
+
+/* SSE2 (always available on x86-64): */
+# if defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  define CML_SIMD_SSE2
+# endif
+
+/* AVX: */
+# if defined(__AVX__)
+#  define CML_SIMD_AVX
+# endif
+
+#endif
+
+#if defined(CML_SIMD_AVX)
+# include <immintrin.h>
+#elif defined(CML_SIMD_SSE2)
+# include <emmintrin.h>
+#endif
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
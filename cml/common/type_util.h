@@ -89,6 +89,25 @@ template<class T> struct actual_operand_type_of {
 template<class T> using actual_operand_type_of_t
   = typename actual_operand_type_of<T>::type;
 
+/** Defines @c value as true if @c T is a vector or matrix type with
+ * elements stored in a single array accessible through data(), or false
+ * otherwise.  Expression nodes do not expose data(), so are never
+ * contiguous.
+ */
+template<class T> struct has_contiguous_data
+{
+  private:
+
+  template<class X> static auto test(int)
+    -> decltype(std::declval<const X&>().data(), std::true_type());
+  template<class X> static auto test(...) -> std::false_type;
+
+  public:
+
+  static const bool value
+    = decltype(test<cml::unqualified_type_t<T>>(0))::value;
+};
+
 } // namespace cml
 
 #endif
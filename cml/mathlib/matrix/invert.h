@@ -40,6 +40,19 @@ template<class Sub> void matrix_invert_RT_only(writable_matrix<Sub>& m);
  */
 template<class Sub> void matrix_invert_RT(writable_matrix<Sub>& m);
 
+/** Invert the square matrix @c m in place, choosing the cheapest method
+ * that gives the correct result.  3x3 and 4x4 matrices whose last row or
+ * last column is (0,...,0,1) are inverted as affine transformations; if
+ * their linear part is also orthonormal, it is inverted by transposing
+ * it.  Other matrices are inverted by the general inverse().
+ *
+ * @note The result is unspecified if @c m is singular.
+ *
+ * @throws non_square_matrix_error at run-time if @c m is dynamically-sized
+ * and not square.  Fixed-size matrices are checked at compile-time.
+ */
+template<class Sub> void inverse_auto(writable_matrix<Sub>& m);
+
 } // namespace cml
 
 #define __CML_MATHLIB_MATRIX_INVERT_TPP
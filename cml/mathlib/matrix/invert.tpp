@@ -4,6 +4,9 @@
 /** @file
  */
 
+#include <cmath>
+#include <limits>
+#include <cml/common/mpl/int_c.h>
 #include <cml/vector/dot.h>
 #include <cml/mathlib/matrix/basis.h>
 #include <cml/mathlib/matrix/translation.h>
@@ -73,6 +76,159 @@ matrix_invert_RT(writable_matrix<Sub>& m)
   }
 }
 
+namespace detail {
+
+/** Invert the upper-left 2x2 block of @c m in place. */
+template<class Sub> inline void
+inverse_linear(writable_matrix<Sub>& m, int_c<2>)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  value_type m00 = m(0,0), m01 = m(0,1);
+  value_type m10 = m(1,0), m11 = m(1,1);
+  value_type iD = value_type(1)/(m00*m11 - m01*m10);
+  m(0,0) =   m11*iD; m(0,1) = - m01*iD;
+  m(1,0) = - m10*iD; m(1,1) =   m00*iD;
+}
+
+/** Invert the upper-left 3x3 block of @c m in place. */
+template<class Sub> inline void
+inverse_linear(writable_matrix<Sub>& m, int_c<3>)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  value_type m00 = m(0,0), m01 = m(0,1), m02 = m(0,2);
+  value_type m10 = m(1,0), m11 = m(1,1), m12 = m(1,2);
+  value_type m20 = m(2,0), m21 = m(2,1), m22 = m(2,2);
+
+  /* Cofactors: */
+  value_type c00 = m11*m22 - m12*m21;
+  value_type c01 = m02*m21 - m01*m22;
+  value_type c02 = m01*m12 - m02*m11;
+  value_type c10 = m12*m20 - m10*m22;
+  value_type c11 = m00*m22 - m02*m20;
+  value_type c12 = m02*m10 - m00*m12;
+  value_type c20 = m10*m21 - m11*m20;
+  value_type c21 = m01*m20 - m00*m21;
+  value_type c22 = m00*m11 - m01*m10;
+
+  value_type iD = value_type(1)/(m00*c00 + m01*c10 + m02*c20);
+  m(0,0) = c00*iD; m(0,1) = c01*iD; m(0,2) = c02*iD;
+  m(1,0) = c10*iD; m(1,1) = c11*iD; m(1,2) = c12*iD;
+  m(2,0) = c20*iD; m(2,1) = c21*iD; m(2,2) = c22*iD;
+}
+
+/** Return true if |L^T L - I| is within a few epsilons of 0 for the
+ * upper-left 2x2 block L of @c m.
+ */
+template<class Sub> inline bool
+is_orthonormal(const writable_matrix<Sub>& m, int_c<2>)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  const value_type tolerance
+    = value_type(16)*std::numeric_limits<value_type>::epsilon();
+  value_type m00 = m(0,0), m01 = m(0,1);
+  value_type m10 = m(1,0), m11 = m(1,1);
+  return (std::abs(m00*m00 + m10*m10 - value_type(1)) <= tolerance)
+    & (std::abs(m01*m01 + m11*m11 - value_type(1)) <= tolerance)
+    & (std::abs(m00*m01 + m10*m11) <= tolerance);
+}
+
+/** Return true if |L^T L - I| is within a few epsilons of 0 for the
+ * upper-left 3x3 block L of @c m.  The tests are combined without
+ * branches, since none of them is cheaper to skip than to compute.
+ */
+template<class Sub> inline bool
+is_orthonormal(const writable_matrix<Sub>& m, int_c<3>)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  const value_type tolerance
+    = value_type(16)*std::numeric_limits<value_type>::epsilon();
+  value_type m00 = m(0,0), m01 = m(0,1), m02 = m(0,2);
+  value_type m10 = m(1,0), m11 = m(1,1), m12 = m(1,2);
+  value_type m20 = m(2,0), m21 = m(2,1), m22 = m(2,2);
+  return (std::abs(m00*m00 + m10*m10 + m20*m20 - value_type(1)) <= tolerance)
+    & (std::abs(m01*m01 + m11*m11 + m21*m21 - value_type(1)) <= tolerance)
+    & (std::abs(m02*m02 + m12*m12 + m22*m22 - value_type(1)) <= tolerance)
+    & (std::abs(m00*m01 + m10*m11 + m20*m21) <= tolerance)
+    & (std::abs(m00*m02 + m10*m12 + m20*m22) <= tolerance)
+    & (std::abs(m01*m02 + m11*m12 + m21*m22) <= tolerance);
+}
+
+/** Invert the affine transformation @c m having its @c M x @c M linear
+ * part L in its upper-left corner, and its translation t in its last
+ * column if @c col_translation is true, or in its last row otherwise.  The
+ * last row or column must be (0,...,0,1).
+ */
+template<class Sub, int M> void
+inverse_affine(writable_matrix<Sub>& m, int_c<M>, bool col_translation)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  /* Invert L in place, by transposing it if it is orthonormal: */
+  if(detail::is_orthonormal(m, int_c<M>())) {
+    for(int i = 0; i < M; ++ i)
+      for(int j = i + 1; j < M; ++ j) {
+	value_type e = m(i,j); m(i,j) = m(j,i); m(j,i) = e;
+      }
+  } else {
+    detail::inverse_linear(m, int_c<M>());
+  }
+
+  /* The inverse is (Li, -Li t; 0 1), or (Li, 0; -t Li, 1) if t is in the
+   * last row:
+   */
+  value_type t[M];
+  if(col_translation) {
+    for(int i = 0; i < M; ++ i) t[i] = m(i,M);
+    for(int i = 0; i < M; ++ i) {
+      value_type e = m(i,0)*t[0];
+      for(int k = 1; k < M; ++ k) e += m(i,k)*t[k];
+      m(i,M) = - e;
+    }
+  } else {
+    for(int i = 0; i < M; ++ i) t[i] = m(M,i);
+    for(int i = 0; i < M; ++ i) {
+      value_type e = t[0]*m(0,i);
+      for(int k = 1; k < M; ++ k) e += t[k]*m(k,i);
+      m(M,i) = - e;
+    }
+  }
+}
+
+} // namespace detail
+
+template<class Sub> void
+inverse_auto(writable_matrix<Sub>& m)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  cml::check_square(m);
+
+  /* Look for an affine transformation, with its translation either in the
+   * last column or in the last row:
+   */
+  int N = m.rows();
+  if((N == 3 || N == 4) && m(N-1,N-1) == value_type(1)) {
+    int M = N - 1;
+    bool col_translation = true, row_translation = true;
+    for(int i = 0; i < M; ++ i) {
+      col_translation = col_translation && m(M,i) == value_type(0);
+      row_translation = row_translation && m(i,M) == value_type(0);
+    }
+    if(col_translation || row_translation) {
+      if(M == 2) detail::inverse_affine(m, int_c<2>(), col_translation);
+      else detail::inverse_affine(m, int_c<3>(), col_translation);
+      return;
+    }
+  }
+
+  /* Otherwise, use the general inverse: */
+  m.inverse();
+}
+
 } // namespace cml
 
 // -------------------------------------------------------------------------
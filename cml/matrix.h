@@ -15,6 +15,7 @@
 #include <cml/matrix/ops.h>
 #include <cml/matrix/vector_product.h>
 #include <cml/matrix/matrix_product.h>
+#include <cml/matrix/multiply.h>
 #include <cml/matrix/functions.h>
 #include <cml/matrix/inverse.h>
 #include <cml/matrix/types.h>
@@ -0,0 +1,59 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_batch_lu_h
+#define	cml_matrix_batch_lu_h
+
+#include <cml/vector/writable_vector.h>
+#include <cml/matrix/writable_matrix.h>
+
+namespace cml {
+
+/** Specializable class holding the number of systems solved together by
+ * batch_lu_solve().  @c lanes systems are interleaved element by element,
+ * so that each step of the elimination is applied to all of them by a
+ * single vectorizable loop.
+ */
+template<class Element> struct batch_lu_blocking
+{
+  static const int lanes = 8;
+};
+
+/** Solve the @c count independent systems @c A[s] @c x[s] = @c b[s]
+ * using LU decomposition with partial pivoting.  @c Matrix must be a
+ * fixed-size square matrix type, and @c Vector a fixed-size vector type
+ * of the same size and element type.
+ *
+ * The systems are processed batch_lu_blocking<>::lanes at a time, in an
+ * interleaved (AoSoA) workspace on the stack: pivots are chosen for each
+ * system as by lu_pivot(), and the elimination is applied to the
+ * right-hand sides as it proceeds.  Sizes are known at compile time, so
+ * no temporaries are allocated and no run-time size checks are performed.
+ *
+ * A system is singular if the magnitude of one of its pivots is smaller
+ * than the element type's epsilon.  Its solution @c x[s] is not written,
+ * and @c singular[s] is set to true if @c singular is not null.
+ *
+ * @note @c x may be the same array as @c b.
+ *
+ * @returns the number of singular systems.
+ */
+template<class Matrix, class Vector> int batch_lu_solve(
+  const Matrix* A, const Vector* b, Vector* x, int count,
+  bool* singular = nullptr);
+
+} // namespace cml
+
+#define __CML_MATRIX_BATCH_LU_TPP
+#include <cml/matrix/batch_lu.tpp>
+#undef __CML_MATRIX_BATCH_LU_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,193 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_BATCH_LU_TPP
+#error "matrix/batch_lu.tpp not included correctly"
+#endif
+
+#include <algorithm>
+#include <cml/common/simd.h>
+#include <cml/common/traits.h>
+
+namespace cml {
+namespace detail {
+
+/** Operations on the @c W interleaved lanes of batch_lu_solve(). */
+template<int W, class T> struct batch_lanes
+{
+  /** Compute @c z[w] -= @c x[w] * @c y[w] for each lane. */
+  static void nmsub(T* z, const T* x, const T* y) {
+    for(int w = 0; w < W; ++ w) z[w] -= x[w] * y[w];
+  }
+};
+
+#if defined(CML_SIMD_SSE2)
+/** batch_lanes for float, using SSE. */
+template<int W> struct batch_lanes<W, float>
+{
+  static void nmsub(float* z, const float* x, const float* y) {
+    int w = 0;
+    for(; w + 4 <= W; w += 4) {
+      __m128 p = _mm_mul_ps(_mm_loadu_ps(x + w), _mm_loadu_ps(y + w));
+      _mm_storeu_ps(z + w, _mm_sub_ps(_mm_loadu_ps(z + w), p));
+    }
+    for(; w < W; ++ w) z[w] -= x[w] * y[w];
+  }
+};
+
+/** batch_lanes for double, using AVX if available, or SSE2. */
+template<int W> struct batch_lanes<W, double>
+{
+  static void nmsub(double* z, const double* x, const double* y) {
+    int w = 0;
+#if defined(CML_SIMD_AVX)
+    for(; w + 4 <= W; w += 4) {
+      __m256d p = _mm256_mul_pd(_mm256_loadu_pd(x + w), _mm256_loadu_pd(y + w));
+      _mm256_storeu_pd(z + w, _mm256_sub_pd(_mm256_loadu_pd(z + w), p));
+    }
+#endif
+    for(; w + 2 <= W; w += 2) {
+      __m128d p = _mm_mul_pd(_mm_loadu_pd(x + w), _mm_loadu_pd(y + w));
+      _mm_storeu_pd(z + w, _mm_sub_pd(_mm_loadu_pd(z + w), p));
+    }
+    for(; w < W; ++ w) z[w] -= x[w] * y[w];
+  }
+};
+#endif
+
+/** Solve the @c W interleaved @c N x @c N systems in @c a and @c y in
+ * place, leaving the solutions in @c y.  Element @c (i,j) of system @c w
+ * is @c a[i][j][w], and element @c i of its right-hand side is @c
+ * y[i][w].  @c bad[w] is set to true if system @c w is singular.
+ */
+template<int N, int W, class T> inline void
+batch_lu_solve(T (&a)[N][N][W], T (&y)[N][W], bool (&bad)[W])
+{
+  typedef traits_of_t<T>				value_traits;
+  typedef batch_lanes<W,T>				lanes;
+
+  for(int w = 0; w < W; ++ w) bad[w] = false;
+
+  for(int k = 0; k < N; ++ k) {
+
+    /* Find the next pivot row of each system: */
+    T max[W];
+    int row[W];
+    for(int w = 0; w < W; ++ w) {
+      max[w] = value_traits::fabs(a[k][k][w]);
+      row[w] = k;
+    }
+    for(int i = k+1; i < N; ++ i)
+      for(int w = 0; w < W; ++ w) {
+	T mag = value_traits::fabs(a[i][k][w]);
+	row[w] = (mag > max[w]) ? i : row[w];
+	max[w] = (mag > max[w]) ? mag : max[w];
+      }
+
+    /* Check for singular systems: */
+    for(int w = 0; w < W; ++ w)
+      bad[w] = bad[w] || (max[w] < value_traits::epsilon());
+
+    /* Swap the remaining part of the pivot rows; swapping row k with
+     * itself avoids a branch on data-dependent pivots:
+     */
+    for(int w = 0; w < W; ++ w) {
+      int r = row[w];
+      for(int j = k; j < N; ++ j) std::swap(a[k][j][w], a[r][j][w]);
+      std::swap(y[k][w], y[r][w]);
+    }
+
+    /* Eliminate below the pivot, and update the right-hand sides.  The
+     * pivots of singular systems may be 0, so they are replaced by 1 to
+     * keep the other lanes free of floating point exceptions:
+     */
+    T inv[W];
+    for(int w = 0; w < W; ++ w)
+      inv[w] = T(1) / (bad[w] ? T(1) : a[k][k][w]);
+    for(int i = k+1; i < N; ++ i) {
+      T l[W];
+      for(int w = 0; w < W; ++ w) l[w] = a[i][k][w] * inv[w];
+      for(int j = k+1; j < N; ++ j) lanes::nmsub(a[i][j], l, a[k][j]);
+      lanes::nmsub(y[i], l, y[k]);
+    }
+  }
+
+  /* Back substitution: */
+  for(int i = N-1; i >= 0; -- i) {
+    for(int j = i+1; j < N; ++ j) lanes::nmsub(y[i], a[i][j], y[j]);
+    for(int w = 0; w < W; ++ w)
+      y[i][w] /= (bad[w] ? T(1) : a[i][i][w]);
+  }
+}
+
+} // namespace detail
+
+
+template<class Matrix, class Vector> inline int
+batch_lu_solve(const Matrix* A, const Vector* b, Vector* x, int count,
+  bool* singular)
+{
+  typedef matrix_traits<Matrix>				matrix_traits_type;
+  typedef vector_traits<Vector>				vector_traits_type;
+  typedef typename matrix_traits_type::value_type	value_type;
+
+  static_assert(is_fixed_size<Matrix>::value && is_fixed_size<Vector>::value,
+    "batch_lu_solve requires fixed-size matrices and vectors");
+  static_assert(
+    matrix_traits_type::array_rows == matrix_traits_type::array_cols,
+    "batch_lu_solve requires square matrices");
+  static_assert(
+    vector_traits_type::array_size == matrix_traits_type::array_rows,
+    "incompatible matrix and vector sizes");
+  static_assert(std::is_same<value_type,
+    typename vector_traits_type::value_type>::value,
+    "incompatible matrix and vector element types");
+
+  static const int N = matrix_traits_type::array_rows;
+  static const int W = batch_lu_blocking<value_type>::lanes;
+
+  int failed = 0;
+  for(int s0 = 0; s0 < count; s0 += W) {
+    int lanes = std::min(W, count - s0);
+
+    /* Interleave the systems, padding the last batch with the identity: */
+    value_type a[N][N][W], y[N][W];
+    bool bad[W];
+    for(int w = 0; w < W; ++ w) {
+      if(w < lanes) {
+	const Matrix& M = A[s0 + w];
+	const Vector& v = b[s0 + w];
+	for(int i = 0; i < N; ++ i) {
+	  for(int j = 0; j < N; ++ j) a[i][j][w] = M(i,j);
+	  y[i][w] = v[i];
+	}
+      } else {
+	for(int i = 0; i < N; ++ i) {
+	  for(int j = 0; j < N; ++ j)
+	    a[i][j][w] = (i == j) ? value_type(1) : value_type(0);
+	  y[i][w] = value_type(0);
+	}
+      }
+    }
+
+    detail::batch_lu_solve(a, y, bad);
+
+    /* Store the solutions of the non-singular systems: */
+    for(int w = 0; w < lanes; ++ w) {
+      if(singular) singular[s0 + w] = bad[w];
+      if(bad[w]) { ++ failed; continue; }
+      Vector& v = x[s0 + w];
+      for(int i = 0; i < N; ++ i) v[i] = y[i][w];
+    }
+  }
+
+  return failed;
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,174 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_cholesky_h
+#define	cml_matrix_cholesky_h
+
+#include <cml/common/type_util.h>
+#include <cml/vector/temporary.h>
+#include <cml/matrix/temporary.h>
+
+namespace cml {
+
+/** Results from Cholesky decomposition of a symmetric positive-definite
+ * matrix.
+ */
+template<class Matrix> struct cholesky_result
+{
+  /** The lower-triangular factor L, with zeros above the diagonal. */
+  Matrix			llt;
+
+  /** True if the input matrix is positive definite.  If false, the
+   * contents of @c llt are unspecified.
+   */
+  bool				positive_definite;
+
+  explicit cholesky_result(const Matrix& M)
+    : llt(M), positive_definite(false) {}
+};
+
+/** Results from LDL^T decomposition of a symmetric positive-definite
+ * matrix.
+ */
+template<class Matrix> struct ldlt_result
+{
+  /** The unit lower-triangular factor L below the diagonal, and D on the
+   * diagonal, with zeros above the diagonal.
+   */
+  Matrix			ldlt;
+
+  /** True if the input matrix is positive definite.  If false, the
+   * contents of @c ldlt are unspecified.
+   */
+  bool				positive_definite;
+
+  explicit ldlt_result(const Matrix& M)
+    : ldlt(M), positive_definite(false) {}
+};
+
+
+/** Compute the Cholesky decomposition M = L L^T of the symmetric matrix
+ * @c M.  Only the lower triangle of @c M is read.  The result is returned
+ * in a cholesky_result.
+ *
+ * Fixed-size matrices with up to cholesky_blocking<>::unrolled rows are
+ * factored with every loop bound known at compile time, and matrices with
+ * contiguous dynamic storage by a blocked algorithm using the packed
+ * matrix product for the trailing updates.
+ *
+ * @note @c result.positive_definite is false if a pivot is not positive;
+ * this does not throw.
+ */
+template<class Sub> auto
+cholesky(const readable_matrix<Sub>& M)
+-> cholesky_result< temporary_of_t<Sub> >;
+
+/** In-place computation of the Cholesky decomposition of @c result.llt. */
+template<class Matrix> void
+cholesky(cholesky_result<Matrix>& result);
+
+/** Compute the decomposition M = L D L^T of the symmetric matrix @c M,
+ * where L is unit lower triangular and D is diagonal.  This avoids the
+ * square roots of cholesky(), but is otherwise computed the same way.
+ * The result is returned in an ldlt_result.
+ *
+ * @note @c result.positive_definite is false if an element of D is not
+ * positive; this does not throw.
+ */
+template<class Sub> auto
+ldlt(const readable_matrix<Sub>& M)
+-> ldlt_result< temporary_of_t<Sub> >;
+
+/** In-place computation of the LDL^T decomposition of @c result.ldlt. */
+template<class Matrix> void
+ldlt(ldlt_result<Matrix>& result);
+
+
+/** Solve @c L L^T x = @c b for @c x, and return @c x as a temporary
+ * vector.  @c b must have the same number of elements as @c chol.llt has
+ * rows.
+ *
+ * @throws std::invalid_argument if @c chol.positive_definite is false.
+ */
+template<class Matrix, class BSub> auto
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  const readable_vector<BSub>& b) -> temporary_of_t<BSub>;
+
+/** Solve @c L L^T x = @c b for @c x.  @c x can be the same vector as @c
+ * b.
+ *
+ * @throws std::invalid_argument if @c chol.positive_definite is false.
+ */
+template<class Matrix, class XSub, class BSub> void
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b);
+
+/** Solve @c L L^T X = @c B for the matrix @c X, and return @c X as a
+ * temporary matrix.  Each column of @c B is a right-hand side.
+ *
+ * @throws std::invalid_argument if @c chol.positive_definite is false.
+ */
+template<class Matrix, class BSub> auto
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  const readable_matrix<BSub>& B) -> temporary_of_t<BSub>;
+
+/** Solve @c L L^T X = @c B for the matrix @c X.  @c X is resized to the
+ * size of @c B if possible, and can be the same matrix as @c B.
+ *
+ * @throws std::invalid_argument if @c chol.positive_definite is false.
+ */
+template<class Matrix, class XSub, class BSub> void
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B);
+
+/** Solve @c L D L^T x = @c b for @c x, and return @c x as a temporary
+ * vector.
+ *
+ * @throws std::invalid_argument if @c fact.positive_definite is false.
+ */
+template<class Matrix, class BSub> auto
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  const readable_vector<BSub>& b) -> temporary_of_t<BSub>;
+
+/** Solve @c L D L^T x = @c b for @c x.  @c x can be the same vector as @c
+ * b.
+ *
+ * @throws std::invalid_argument if @c fact.positive_definite is false.
+ */
+template<class Matrix, class XSub, class BSub> void
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b);
+
+/** Solve @c L D L^T X = @c B for the matrix @c X, and return @c X as a
+ * temporary matrix.
+ *
+ * @throws std::invalid_argument if @c fact.positive_definite is false.
+ */
+template<class Matrix, class BSub> auto
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  const readable_matrix<BSub>& B) -> temporary_of_t<BSub>;
+
+/** Solve @c L D L^T X = @c B for the matrix @c X.  @c X is resized to the
+ * size of @c B if possible, and can be the same matrix as @c B.
+ *
+ * @throws std::invalid_argument if @c fact.positive_definite is false.
+ */
+template<class Matrix, class XSub, class BSub> void
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B);
+
+} // namespace cml
+
+#define __CML_MATRIX_CHOLESKY_TPP
+#include <cml/matrix/cholesky.tpp>
+#undef __CML_MATRIX_CHOLESKY_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,153 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_CHOLESKY_TPP
+#error "matrix/cholesky.tpp not included correctly"
+#endif
+
+#include <cml/common/allocator.h>
+#include <cml/vector/writable_vector.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/size_checking.h>
+#include <cml/matrix/detail/check_or_resize.h>
+#include <cml/matrix/detail/cholesky.h>
+
+namespace cml {
+
+template<class Sub> inline auto
+cholesky(const readable_matrix<Sub>& M)
+-> cholesky_result< temporary_of_t<Sub> >
+{
+  cml::check_square(M);
+  cholesky_result<temporary_of_t<Sub>> result(M);
+  result.positive_definite = detail::cholesky_inplace(result.llt);
+  return result;
+}
+
+template<class Matrix> inline void
+cholesky(cholesky_result<Matrix>& result)
+{
+  cml::check_square(result.llt);
+  result.positive_definite = detail::cholesky_inplace(result.llt);
+}
+
+template<class Sub> inline auto
+ldlt(const readable_matrix<Sub>& M)
+-> ldlt_result< temporary_of_t<Sub> >
+{
+  cml::check_square(M);
+  ldlt_result<temporary_of_t<Sub>> result(M);
+  result.positive_definite = detail::ldlt_inplace(result.ldlt);
+  return result;
+}
+
+template<class Matrix> inline void
+ldlt(ldlt_result<Matrix>& result)
+{
+  cml::check_square(result.ldlt);
+  result.positive_definite = detail::ldlt_inplace(result.ldlt);
+}
+
+
+template<class Matrix, class BSub> inline auto
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  const readable_vector<BSub>& b) -> temporary_of_t<BSub>
+{
+  auto x = detail::make_temporary<temporary_of_t<BSub>>(b.actual());
+  detail::check_or_resize(x, b);
+  cholesky_solve(chol, x, b);
+  return x;
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b)
+{
+  cml::check_same_inner_size(chol.llt, x);
+  cml::check_same_inner_size(chol.llt, b);
+  cml_require(chol.positive_definite,
+    std::invalid_argument, "matrix is not positive definite");
+
+  for(int i = 0; i < x.size(); ++ i) x.put(i, b.get(i));
+  detail::cholesky_substitute(chol.llt, x, false);
+}
+
+template<class Matrix, class BSub> inline auto
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  const readable_matrix<BSub>& B) -> temporary_of_t<BSub>
+{
+  auto X = detail::make_temporary<temporary_of_t<BSub>>(B.actual());
+  detail::check_or_resize(X, B);
+  cholesky_solve(chol, X, B);
+  return X;
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+cholesky_solve(const cholesky_result<Matrix>& chol,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B)
+{
+  cml::check_same_inner_size(chol.llt, B);
+  cml_require(chol.positive_definite,
+    std::invalid_argument, "matrix is not positive definite");
+
+  detail::check_or_resize(X, B);
+  for(int i = 0; i < X.rows(); ++ i)
+    for(int j = 0; j < X.cols(); ++ j) X.put(i,j, B.get(i,j));
+  detail::cholesky_substitute(chol.llt, X, false);
+}
+
+
+template<class Matrix, class BSub> inline auto
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  const readable_vector<BSub>& b) -> temporary_of_t<BSub>
+{
+  auto x = detail::make_temporary<temporary_of_t<BSub>>(b.actual());
+  detail::check_or_resize(x, b);
+  ldlt_solve(fact, x, b);
+  return x;
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b)
+{
+  cml::check_same_inner_size(fact.ldlt, x);
+  cml::check_same_inner_size(fact.ldlt, b);
+  cml_require(fact.positive_definite,
+    std::invalid_argument, "matrix is not positive definite");
+
+  for(int i = 0; i < x.size(); ++ i) x.put(i, b.get(i));
+  detail::cholesky_substitute(fact.ldlt, x, true);
+}
+
+template<class Matrix, class BSub> inline auto
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  const readable_matrix<BSub>& B) -> temporary_of_t<BSub>
+{
+  auto X = detail::make_temporary<temporary_of_t<BSub>>(B.actual());
+  detail::check_or_resize(X, B);
+  ldlt_solve(fact, X, B);
+  return X;
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+ldlt_solve(const ldlt_result<Matrix>& fact,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B)
+{
+  cml::check_same_inner_size(fact.ldlt, B);
+  cml_require(fact.positive_definite,
+    std::invalid_argument, "matrix is not positive definite");
+
+  detail::check_or_resize(X, B);
+  for(int i = 0; i < X.rows(); ++ i)
+    for(int j = 0; j < X.cols(); ++ j) X.put(i,j, B.get(i,j));
+  detail::cholesky_substitute(fact.ldlt, X, true);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -88,6 +88,16 @@ class matrix_col_node<Sub,-1>
 #endif
 
 
+  public:
+
+    /** Return true if the subexpression reads the object at @c dest out
+     * of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_vector Interface */
@@ -8,6 +8,8 @@
 #error "matrix/col_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* matrix_col_node 'structors: */
@@ -35,6 +37,16 @@ matrix_col_node<Sub,-1>::matrix_col_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub> bool
+matrix_col_node<Sub,-1>::aliases(const detail::alias_target& dest) const
+{
+  return detail::aliases(this->m_sub, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
@@ -0,0 +1,107 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_cholesky_h
+#define	cml_matrix_detail_cholesky_h
+
+#include <cml/vector/fwd.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+
+/** Specializable class holding the blocking parameters for the Cholesky
+ * and LDL^T decompositions: @c nb is the number of columns factored per
+ * panel, and fixed-size matrices with at most @c unrolled rows are
+ * factored in a local array with compile-time loop bounds.
+ */
+template<class Element> struct cholesky_blocking
+{
+  static const int nb = 64;
+  static const int unrolled = 12;
+};
+
+namespace detail {
+
+/** In-place Cholesky decomposition @c M = L L^T of the symmetric matrix
+ * @c M.  Only the lower triangle of @c M is read, and it is overwritten
+ * by @c L; the strict upper triangle is set to 0.  Fixed-size matrices
+ * are factored with compile-time loop bounds if they are small enough,
+ * and matrices with contiguous storage by cholesky_blocked().
+ *
+ * @returns true if every pivot was positive, i.e. @c M is positive
+ * definite.  Otherwise, the contents of @c M are unspecified.
+ *
+ * @note It is up to the caller to ensure @c M is a square matrix.
+ */
+template<class Sub> inline bool
+cholesky_inplace(writable_matrix<Sub>& M);
+
+/** In-place decomposition @c M = L D L^T of the symmetric matrix @c M,
+ * where @c L is unit lower triangular and @c D is diagonal.  Only the
+ * lower triangle of @c M is read.  It is overwritten by @c L below the
+ * diagonal and @c D on the diagonal, and the strict upper triangle is set
+ * to 0.
+ *
+ * @returns true if every element of @c D is positive, i.e. @c M is
+ * positive definite.  Otherwise, the contents of @c M are unspecified.
+ *
+ * @note It is up to the caller to ensure @c M is a square matrix.
+ */
+template<class Sub> inline bool
+ldlt_inplace(writable_matrix<Sub>& M);
+
+/** Blocked right-looking Cholesky decomposition of the lower triangle of
+ * the @c N x @c N matrix @c A, given as a pointer to its first element and
+ * its row and column strides.  Each panel of cholesky_blocking<T>::nb
+ * columns is factored by columns, then the lower triangle of the trailing
+ * submatrix is updated by gemm(), one block column at a time.  The upper
+ * triangle is not modified.
+ *
+ * @returns true if @c A is positive definite.
+ */
+template<class T> inline bool
+cholesky_blocked(int N, T* A, int a_rs, int a_cs);
+
+/** Blocked LDL^T decomposition of the lower triangle of the @c N x @c N
+ * matrix @c A, like cholesky_blocked().  The trailing update uses a copy
+ * of the panel scaled by @c D.
+ *
+ * @returns true if @c A is positive definite.
+ */
+template<class T> inline bool
+ldlt_blocked(int N, T* A, int a_rs, int a_cs);
+
+/** Overwrite @c x with the solution of @c F y = @c x, where @c F holds a
+ * Cholesky factor @c L (if @c unit is false) or an LDL^T factorization
+ * (if @c unit is true) in its lower triangle.
+ *
+ * @note It is up to the caller to ensure @c F is square, and has as many
+ * rows as @c x.
+ */
+template<class FSub, class XSub> inline void
+cholesky_substitute(const readable_matrix<FSub>& F,
+  writable_vector<XSub>& x, bool unit);
+
+/** Overwrite each column of @c X with the solution of @c F Y = @c X,
+ * where @c F is as for cholesky_substitute() above.
+ */
+template<class FSub, class XSub> inline void
+cholesky_substitute(const readable_matrix<FSub>& F,
+  writable_matrix<XSub>& X, bool unit);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_CHOLESKY_TPP
+#include <cml/matrix/detail/cholesky.tpp>
+#undef __CML_MATRIX_DETAIL_CHOLESKY_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
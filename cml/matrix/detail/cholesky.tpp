@@ -0,0 +1,348 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_CHOLESKY_TPP
+#error "matrix/detail/cholesky.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <cml/common/traits.h>
+#include <cml/common/size_tags.h>
+#include <cml/common/array_size_of.h>
+#include <cml/common/mpl/int_c.h>
+#include <cml/matrix/detail/gemm.h>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Set the strict upper triangle of @c M to 0. */
+template<class Sub, class Size> inline void
+cholesky_zero_upper(writable_matrix<Sub>& M, Size N)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  for(int i = 0; i < N; ++ i)
+    for(int j = i+1; j < N; ++ j) M(i,j) = value_type(0);
+}
+
+/** Factor the @c N x @c N matrix @c M = L L^T by columns.  @c N is either
+ * an int, or an int_c<> for fixed-size matrices so that every loop bound
+ * is a compile-time constant.
+ */
+template<class Sub, class Size> inline bool
+cholesky_columns(writable_matrix<Sub>& M, Size N)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef traits_of_t<value_type>			value_traits;
+
+  for(int k = 0; k < N; ++ k) {
+    value_type d = M(k,k);
+    for(int p = 0; p < k; ++ p) d -= M(k,p)*M(k,p);
+    if(!(d > value_type(0))) return false;
+
+    d = value_traits::sqrt(d);
+    M(k,k) = d;
+    value_type inv = value_type(1)/d;
+    for(int i = k+1; i < N; ++ i) {
+      value_type s = M(i,k);
+      for(int p = 0; p < k; ++ p) s -= M(i,p)*M(k,p);
+      M(i,k) = s*inv;
+    }
+  }
+
+  cholesky_zero_upper(M, N);
+  return true;
+}
+
+/** Factor the @c N x @c N matrix @c M = L D L^T by columns, like
+ * cholesky_columns().  @c w must have room for @c N elements.
+ */
+template<class Sub, class Size> inline bool
+ldlt_columns(writable_matrix<Sub>& M, Size N, value_type_trait_of_t<Sub>* w)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  for(int k = 0; k < N; ++ k) {
+
+    /* Row k of L scaled by D: */
+    for(int p = 0; p < k; ++ p) w[p] = M(k,p)*M(p,p);
+
+    value_type d = M(k,k);
+    for(int p = 0; p < k; ++ p) d -= w[p]*M(k,p);
+    if(!(d > value_type(0))) return false;
+
+    M(k,k) = d;
+    value_type inv = value_type(1)/d;
+    for(int i = k+1; i < N; ++ i) {
+      value_type s = M(i,k);
+      for(int p = 0; p < k; ++ p) s -= M(i,p)*w[p];
+      M(i,k) = s*inv;
+    }
+  }
+
+  cholesky_zero_upper(M, N);
+  return true;
+}
+
+/** Tag selecting the fixed-size factorizations with @c N rows. */
+template<int N> struct cholesky_unrolled_tag {};
+
+/** Tag selecting the blocked factorizations. */
+struct cholesky_blocked_tag {};
+
+/** Tag selecting the element-wise factorizations. */
+struct cholesky_generic_tag {};
+
+/** Defines @c type as the tag used to factor matrices of type @c Sub. */
+template<class Sub, class Enable = void> struct cholesky_tag_of
+{
+  typedef typename std::conditional<is_gemm_operand<Sub>::value,
+	  cholesky_blocked_tag, cholesky_generic_tag>::type	type;
+};
+
+/** cholesky_tag_of for small fixed-size matrices. */
+template<class Sub> struct cholesky_tag_of<Sub,
+  typename std::enable_if<
+    is_fixed_size<matrix_traits<Sub>>::value
+    && array_rows_of_c<matrix_traits<Sub>>::value
+      <= cholesky_blocking<value_type_trait_of_t<Sub>>::unrolled>::type>
+{
+  typedef cholesky_unrolled_tag<
+    array_rows_of_c<matrix_traits<Sub>>::value>		type;
+};
+
+} // namespace
+
+/** cholesky_inplace() for small fixed-size matrices. */
+template<class Sub, int N> inline bool
+cholesky_inplace(writable_matrix<Sub>& M, cholesky_unrolled_tag<N>)
+{
+  return cholesky_columns(M, int_c<N>());
+}
+
+/** cholesky_inplace() for matrices with contiguous storage. */
+template<class Sub> inline bool
+cholesky_inplace(writable_matrix<Sub>& M, cholesky_blocked_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+
+  auto& A = M.actual();
+  if(!detail::cholesky_blocked(A.rows(), A.data(),
+      row_stride(A, layout()), col_stride(A, layout()))) return false;
+  cholesky_zero_upper(M, M.rows());
+  return true;
+}
+
+/** cholesky_inplace() for arbitrary writable matrices. */
+template<class Sub> inline bool
+cholesky_inplace(writable_matrix<Sub>& M, cholesky_generic_tag)
+{
+  return cholesky_columns(M, M.rows());
+}
+
+template<class Sub> inline bool
+cholesky_inplace(writable_matrix<Sub>& M)
+{
+  typedef typename cholesky_tag_of<Sub>::type		tag;
+  return detail::cholesky_inplace(M, tag());
+}
+
+/** ldlt_inplace() for small fixed-size matrices. */
+template<class Sub, int N> inline bool
+ldlt_inplace(writable_matrix<Sub>& M, cholesky_unrolled_tag<N>)
+{
+  value_type_trait_of_t<Sub> w[N];
+  return ldlt_columns(M, int_c<N>(), w);
+}
+
+/** ldlt_inplace() for matrices with contiguous storage. */
+template<class Sub> inline bool
+ldlt_inplace(writable_matrix<Sub>& M, cholesky_blocked_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+
+  auto& A = M.actual();
+  if(!detail::ldlt_blocked(A.rows(), A.data(),
+      row_stride(A, layout()), col_stride(A, layout()))) return false;
+  cholesky_zero_upper(M, M.rows());
+  return true;
+}
+
+/** ldlt_inplace() for arbitrary writable matrices. */
+template<class Sub> inline bool
+ldlt_inplace(writable_matrix<Sub>& M, cholesky_generic_tag)
+{
+  std::vector<value_type_trait_of_t<Sub>> w(M.rows());
+  return ldlt_columns(M, M.rows(), w.data());
+}
+
+template<class Sub> inline bool
+ldlt_inplace(writable_matrix<Sub>& M)
+{
+  typedef typename cholesky_tag_of<Sub>::type		tag;
+  return detail::ldlt_inplace(M, tag());
+}
+
+template<class T> inline bool
+cholesky_blocked(int N, T* A, int a_rs, int a_cs)
+{
+  typedef traits_of_t<T>				value_traits;
+  static const int NB = cholesky_blocking<T>::nb;
+
+  for(int j0 = 0; j0 < N; j0 += NB) {
+    int nb = std::min(NB, N - j0), j1 = j0 + nb;
+
+    /* Factor the N-j0 x nb panel by columns; the columns left of the
+     * panel have already been subtracted by the trailing updates:
+     */
+    for(int k = j0; k < j1; ++ k) {
+      const T* lk = A + k*a_rs;
+      T d = lk[k*a_cs];
+      for(int p = j0; p < k; ++ p) d -= lk[p*a_cs]*lk[p*a_cs];
+      if(!(d > T(0))) return false;
+
+      d = value_traits::sqrt(d);
+      A[k*a_rs + k*a_cs] = d;
+      T inv = T(1)/d;
+      for(int i = k+1; i < N; ++ i) {
+	T* li = A + i*a_rs;
+	T s = li[k*a_cs];
+	for(int p = j0; p < k; ++ p) s -= li[p*a_cs]*lk[p*a_cs];
+	li[k*a_cs] = s*inv;
+      }
+    }
+
+    /* Update the lower triangle of the trailing submatrix, A22 -= L21
+     * L21^T, by block columns.  The diagonal blocks are updated in full,
+     * which touches only elements of the upper triangle that are not
+     * read:
+     */
+    const T* L21 = A + j0*a_cs;
+    for(int jb = j1; jb < N; jb += NB) {
+      int mb = std::min(NB, N - jb);
+      detail::gemm(N - jb, mb, nb, T(-1),
+	L21 + jb*a_rs, a_rs, a_cs, L21 + jb*a_rs, a_cs, a_rs,
+	T(1), A + jb*a_rs + jb*a_cs, a_rs, a_cs);
+    }
+  }
+  return true;
+}
+
+template<class T> inline bool
+ldlt_blocked(int N, T* A, int a_rs, int a_cs)
+{
+  static const int NB = cholesky_blocking<T>::nb;
+
+  /* The current panel of L scaled by D, stored by rows: */
+  std::vector<T> w(std::size_t(N)*std::min(NB, N));
+
+  for(int j0 = 0; j0 < N; j0 += NB) {
+    int nb = std::min(NB, N - j0), j1 = j0 + nb;
+
+    /* Factor the N-j0 x nb panel by columns: */
+    for(int k = j0; k < j1; ++ k) {
+      const T* lk = A + k*a_rs;
+      const T* wk = w.data() + (k - j0)*nb;
+      T d = lk[k*a_cs];
+      for(int p = j0; p < k; ++ p) d -= wk[p - j0]*lk[p*a_cs];
+      if(!(d > T(0))) return false;
+
+      A[k*a_rs + k*a_cs] = d;
+      T inv = T(1)/d;
+      for(int i = k+1; i < N; ++ i) {
+	T* li = A + i*a_rs;
+	T s = li[k*a_cs];
+	for(int p = j0; p < k; ++ p) s -= li[p*a_cs]*wk[p - j0];
+	w[(i - j0)*nb + (k - j0)] = s;
+	li[k*a_cs] = s*inv;
+      }
+    }
+
+    /* Update the lower triangle of the trailing submatrix, A22 -= L21 D1
+     * L21^T, by block columns:
+     */
+    const T* L21 = A + j0*a_cs;
+    const T* W21 = w.data() + (j1 - j0)*nb;
+    for(int jb = j1; jb < N; jb += NB) {
+      int mb = std::min(NB, N - jb);
+      detail::gemm(N - jb, mb, nb, T(-1),
+	L21 + jb*a_rs, a_rs, a_cs, W21 + (jb - j1)*nb, 1, nb,
+	T(1), A + jb*a_rs + jb*a_cs, a_rs, a_cs);
+    }
+  }
+  return true;
+}
+
+template<class FSub, class XSub> inline void
+cholesky_substitute(const readable_matrix<FSub>& F,
+  writable_vector<XSub>& x, bool unit)
+{
+  int N = x.size();
+
+  /* Forward substitution with L: */
+  for(int i = 0; i < N; ++ i) {
+    auto s = x.get(i);
+    for(int k = 0; k < i; ++ k) s -= F(i,k)*x.get(k);
+    x.put(i, unit ? s : s/F(i,i));
+  }
+
+  /* Scale by D^-1 for LDL^T: */
+  if(unit) for(int i = 0; i < N; ++ i) x.put(i, x.get(i)/F(i,i));
+
+  /* Backward substitution with L^T: */
+  for(int i = N-1; i >= 0; -- i) {
+    auto s = x.get(i);
+    for(int k = i+1; k < N; ++ k) s -= F(k,i)*x.get(k);
+    x.put(i, unit ? s : s/F(i,i));
+  }
+}
+
+template<class FSub, class XSub> inline void
+cholesky_substitute(const readable_matrix<FSub>& F,
+  writable_matrix<XSub>& X, bool unit)
+{
+  int N = X.rows(), M = X.cols();
+
+  /* Forward substitution with L: */
+  for(int i = 0; i < N; ++ i) {
+    for(int k = 0; k < i; ++ k) {
+      auto l = F(i,k);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j) - l*X.get(k,j));
+    }
+    if(!unit) {
+      auto d = F(i,i);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j)/d);
+    }
+  }
+
+  /* Scale by D^-1 for LDL^T: */
+  if(unit) {
+    for(int i = 0; i < N; ++ i) {
+      auto d = F(i,i);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j)/d);
+    }
+  }
+
+  /* Backward substitution with L^T: */
+  for(int i = N-1; i >= 0; -- i) {
+    for(int k = i+1; k < N; ++ k) {
+      auto l = F(k,i);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j) - l*X.get(k,j));
+    }
+    if(!unit) {
+      auto d = F(i,i);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j)/d);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
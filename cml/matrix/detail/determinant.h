@@ -32,8 +32,9 @@ determinant(const readable_matrix<Sub>& M, int_c<4>)
 -> value_type_trait_of_t<Sub>;
 
 /** Determinant implementation for statically-sized square matrices with
- * dimension greater than 4, using a pivoting algorithm to compute the
- * result.
+ * dimension greater than 4.  Dimensions 5 through 8 use the Schur
+ * complement of the leading block when its estimated error is small
+ * enough, and a pivoting algorithm is used otherwise.
  *
  * @note It is up to the caller to ensure @c M is a square matrix.
  */
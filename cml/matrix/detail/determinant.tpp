@@ -11,6 +11,7 @@
 #include <vector>
 #include <cml/matrix/temporary.h>
 #include <cml/matrix/detail/lu.h>
+#include <cml/matrix/detail/schur.h>
 
 namespace cml {
 namespace detail {
@@ -87,13 +88,11 @@ determinant(const readable_matrix<Sub>& M, int_c<4>)
 }
 
 /** Determinant implementation for statically-sized square matrices with
- * dimension greater than 4, using a pivoting algorithm to compute the
+ * dimension greater than 8, using a pivoting algorithm to compute the
  * result.
- *
- * @note It is up to the caller to ensure @c M is a square matrix.
  */
 template<class Sub, int N> inline auto
-determinant(const readable_matrix<Sub>& M, int_c<N>)
+determinant(const readable_matrix<Sub>& M, int_c<N>, std::false_type)
 -> value_type_trait_of_t<Sub>
 {
   temporary_of_t<Sub> A(M);
@@ -104,6 +103,32 @@ determinant(const readable_matrix<Sub>& M, int_c<N>)
   return sign * diagonal_product(A);
 }
 
+/** Determinant implementation for statically-sized square matrices with
+ * dimension 5 through 8, using the Schur complement of the leading (N+1)/2
+ * x (N+1)/2 block if its estimated error is small enough, or the pivoting
+ * algorithm otherwise.
+ */
+template<class Sub, int N> inline auto
+determinant(const readable_matrix<Sub>& M, int_c<N>, std::true_type)
+-> value_type_trait_of_t<Sub>
+{
+  value_type_trait_of_t<Sub> D;
+  if(schur_determinant(M, int_c<(N+1)/2>(), int_c<N/2>(), D)) return D;
+  return determinant(M, int_c<N>(), std::false_type());
+}
+
+/** Determinant implementation for statically-sized square matrices with
+ * dimension greater than 4.
+ *
+ * @note It is up to the caller to ensure @c M is a square matrix.
+ */
+template<class Sub, int N> inline auto
+determinant(const readable_matrix<Sub>& M, int_c<N>)
+-> value_type_trait_of_t<Sub>
+{
+  return determinant(M, int_c<N>(), std::integral_constant<bool, (N <= 8)>());
+}
+
 /** Determinant implementation for dynamically-sized matrices.  This
  * dispatches to a small matrix implementation when the dimension of @c M
  * is no more than 4.  Otherwise, the general pivoting implementation is
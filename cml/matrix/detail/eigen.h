@@ -0,0 +1,64 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_eigen_h
+#define	cml_matrix_detail_eigen_h
+
+namespace cml {
+namespace detail {
+
+/** Compute the eigenvalues @c w and eigenvectors @c V of the symmetric
+ * 3x3 array @c A by cyclic Jacobi rotations.  Column @c j of @c V is the
+ * unit eigenvector for @c w[j], and the eigenvalues are sorted in
+ * increasing order.  The loop bounds are constants, and the only branches
+ * skip negligible rotations and stop once a sweep rotates nothing, so
+ * this is suited to large batches of small problems.  @c A is
+ * overwritten.
+ */
+template<class T> inline void
+eigen_jacobi_3x3(T (&A)[3][3], T (&w)[3], T (&V)[3][3]);
+
+/** Compute the eigenvalues @c w of the symmetric 3x3 array @c A, sorted
+ * in increasing order, by the Jacobi rotations of eigen_jacobi_3x3()
+ * without accumulating the eigenvectors.  The results are identical to
+ * those of eigen_jacobi_3x3().
+ */
+template<class T> inline void
+eigenvalues_3x3(const T (&A)[3][3], T (&w)[3]);
+
+/** Reduce the symmetric @c N x @c N row-major array @c V to tridiagonal
+ * form by Householder similarity transformations.  On return, @c d holds
+ * the diagonal and @c e[1..N-1] the subdiagonal of the tridiagonal
+ * matrix.  If @c vectors is true, @c V is overwritten by the orthogonal
+ * matrix of the transformation; otherwise, its contents are unspecified.
+ * Only the lower triangle of @c V is read.
+ */
+template<class T> inline void
+tridiagonalize(int N, T* V, T* d, T* e, bool vectors);
+
+/** Compute the eigenvalues of the symmetric tridiagonal matrix given by
+ * @c d and @c e from tridiagonalize(), by the implicit QL algorithm with
+ * Wilkinson shifts.  On return, @c d holds the eigenvalues in increasing
+ * order.  If @c V is not null, the rotations are accumulated into the @c
+ * N x @c N row-major array @c V, whose columns become the corresponding
+ * eigenvectors.  @c e is overwritten.
+ */
+template<class T> inline void
+tridiagonal_ql(int N, T* d, T* e, T* V);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_EIGEN_TPP
+#include <cml/matrix/detail/eigen.tpp>
+#undef __CML_MATRIX_DETAIL_EIGEN_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,317 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_EIGEN_TPP
+#error "matrix/detail/eigen.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Apply the Jacobi rotation zeroing A(P,Q) of the symmetric 3x3 array @c
+ * A, where @c R is the remaining index, and return its cosine @c c and
+ * sine @c s.
+ *
+ * @returns false if A(P,Q) was negligible, in which case it is set to 0
+ * without rotating.
+ */
+template<int P, int Q, int R, class T> inline bool
+jacobi_rotate_3x3(T (&A)[3][3], T& c, T& s)
+{
+  T apq = A[P][Q], app = A[P][P], aqq = A[Q][Q];
+
+  /* A(P,Q) is negligible if it cannot change the diagonal: */
+  if(std::abs(apq) <= std::numeric_limits<T>::epsilon()*T(.5)
+    *(std::abs(app) + std::abs(aqq)))
+  {
+    A[P][Q] = A[Q][P] = T(0);
+    return false;
+  }
+
+  /* The tangent t of the smaller rotation angle, and its cosine and sine:
+   */
+  T theta = (aqq - app)/(T(2)*apq);
+  T t = T(1)/(std::abs(theta) + std::sqrt(theta*theta + T(1)));
+  if(theta < T(0)) t = - t;
+  c = T(1)/std::sqrt(t*t + T(1));
+  s = t*c;
+
+  A[P][P] = app - t*apq;
+  A[Q][Q] = aqq + t*apq;
+  A[P][Q] = A[Q][P] = T(0);
+
+  T arp = A[R][P], arq = A[R][Q];
+  A[R][P] = A[P][R] = c*arp - s*arq;
+  A[R][Q] = A[Q][R] = s*arp + c*arq;
+  return true;
+}
+
+/** Apply the Jacobi rotation zeroing A(P,Q) of the symmetric 3x3 array @c
+ * A, and accumulate it into @c V.
+ *
+ * @returns false if A(P,Q) was negligible.
+ */
+template<int P, int Q, int R, class T> inline bool
+jacobi_rotate_3x3(T (&A)[3][3], T (&V)[3][3])
+{
+  T c, s;
+  if(!jacobi_rotate_3x3<P,Q,R>(A, c, s)) return false;
+
+  for(int k = 0; k < 3; ++ k) {
+    T vkp = V[k][P], vkq = V[k][Q];
+    V[k][P] = c*vkp - s*vkq;
+    V[k][Q] = s*vkp + c*vkq;
+  }
+  return true;
+}
+
+/** Swap w[I] and w[J], and columns @c I and @c J of @c V, if w[J] is
+ * smaller than w[I].
+ */
+template<int I, int J, class T> inline void
+sort_eigenpair_3x3(T (&w)[3], T (&V)[3][3])
+{
+  if(w[J] < w[I]) {
+    std::swap(w[I], w[J]);
+    for(int k = 0; k < 3; ++ k) std::swap(V[k][I], V[k][J]);
+  }
+}
+
+} // namespace
+
+template<class T> inline void
+eigen_jacobi_3x3(T (&A)[3][3], T (&w)[3], T (&V)[3][3])
+{
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j) V[i][j] = T(i == j ? 1 : 0);
+
+  /* Convergence is quadratic, so a handful of sweeps reaches working
+   * precision:
+   */
+  for(int sweep = 0; sweep < 16; ++ sweep) {
+    bool rotated = jacobi_rotate_3x3<0,1,2>(A, V);
+    rotated |= jacobi_rotate_3x3<0,2,1>(A, V);
+    rotated |= jacobi_rotate_3x3<1,2,0>(A, V);
+    if(!rotated) break;
+  }
+
+  for(int i = 0; i < 3; ++ i) w[i] = A[i][i];
+  sort_eigenpair_3x3<0,1>(w, V);
+  sort_eigenpair_3x3<1,2>(w, V);
+  sort_eigenpair_3x3<0,1>(w, V);
+}
+
+template<class T> inline void
+eigenvalues_3x3(const T (&A)[3][3], T (&w)[3])
+{
+  T B[3][3];
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j) B[i][j] = A[i][j];
+
+  /* The same sweeps as eigen_jacobi_3x3(), without accumulating the
+   * rotations:
+   */
+  for(int sweep = 0; sweep < 16; ++ sweep) {
+    T c, s;
+    bool rotated = jacobi_rotate_3x3<0,1,2>(B, c, s);
+    rotated |= jacobi_rotate_3x3<0,2,1>(B, c, s);
+    rotated |= jacobi_rotate_3x3<1,2,0>(B, c, s);
+    if(!rotated) break;
+  }
+
+  for(int i = 0; i < 3; ++ i) w[i] = B[i][i];
+  if(w[1] < w[0]) std::swap(w[0], w[1]);
+  if(w[2] < w[1]) std::swap(w[1], w[2]);
+  if(w[1] < w[0]) std::swap(w[0], w[1]);
+}
+
+template<class T> inline void
+tridiagonalize(int N, T* V, T* d, T* e, bool vectors)
+{
+  /* Make V symmetric from its lower triangle: */
+  for(int i = 0; i < N; ++ i)
+    for(int j = i+1; j < N; ++ j) V[i*N + j] = V[j*N + i];
+  for(int j = 0; j < N; ++ j) d[j] = V[(N-1)*N + j];
+
+  /* Householder reduction of rows N-1 down to 1, with d holding the row
+   * being reduced:
+   */
+  for(int i = N-1; i > 0; -- i) {
+    T scale(0), h(0);
+    for(int k = 0; k < i; ++ k) scale += std::abs(d[k]);
+
+    /* Skip the transformation if the row is already reduced: */
+    if(scale == T(0)) {
+      e[i] = d[i-1];
+      for(int j = 0; j < i; ++ j) {
+	d[j] = V[(i-1)*N + j];
+	V[i*N + j] = T(0);
+	V[j*N + i] = T(0);
+      }
+      d[i] = h;
+      continue;
+    }
+
+    /* Generate the Householder vector, scaled against underflow: */
+    for(int k = 0; k < i; ++ k) {
+      d[k] /= scale;
+      h += d[k]*d[k];
+    }
+    T f = d[i-1];
+    T g = std::sqrt(h);
+    if(f > T(0)) g = - g;
+    e[i] = scale*g;
+    h -= f*g;
+    d[i-1] = f - g;
+    for(int j = 0; j < i; ++ j) e[j] = T(0);
+
+    /* Apply the similarity transformation to the remaining columns: */
+    for(int j = 0; j < i; ++ j) {
+      f = d[j];
+      V[j*N + i] = f;
+      g = e[j] + V[j*N + j]*f;
+      for(int k = j+1; k <= i-1; ++ k) {
+	g += V[k*N + j]*d[k];
+	e[k] += V[k*N + j]*f;
+      }
+      e[j] = g;
+    }
+    f = T(0);
+    for(int j = 0; j < i; ++ j) {
+      e[j] /= h;
+      f += e[j]*d[j];
+    }
+    T hh = f/(h + h);
+    for(int j = 0; j < i; ++ j) e[j] -= hh*d[j];
+    for(int j = 0; j < i; ++ j) {
+      f = d[j];
+      g = e[j];
+      for(int k = j; k <= i-1; ++ k) V[k*N + j] -= (f*e[k] + g*d[k]);
+      d[j] = V[(i-1)*N + j];
+      V[i*N + j] = T(0);
+    }
+    d[i] = h;
+  }
+
+  /* Without eigenvectors, only the diagonal is needed: */
+  if(!vectors) {
+    for(int j = 0; j < N; ++ j) d[j] = V[j*N + j];
+    e[0] = T(0);
+    return;
+  }
+
+  /* Accumulate the transformations into V: */
+  for(int i = 0; i < N-1; ++ i) {
+    V[(N-1)*N + i] = V[i*N + i];
+    V[i*N + i] = T(1);
+    T h = d[i+1];
+    if(h != T(0)) {
+      for(int k = 0; k <= i; ++ k) d[k] = V[k*N + i+1]/h;
+      for(int j = 0; j <= i; ++ j) {
+	T g(0);
+	for(int k = 0; k <= i; ++ k) g += V[k*N + i+1]*V[k*N + j];
+	for(int k = 0; k <= i; ++ k) V[k*N + j] -= g*d[k];
+      }
+    }
+    for(int k = 0; k <= i; ++ k) V[k*N + i+1] = T(0);
+  }
+  for(int j = 0; j < N; ++ j) {
+    d[j] = V[(N-1)*N + j];
+    V[(N-1)*N + j] = T(0);
+  }
+  V[(N-1)*N + N-1] = T(1);
+  e[0] = T(0);
+}
+
+template<class T> inline void
+tridiagonal_ql(int N, T* d, T* e, T* V)
+{
+  const T eps = std::numeric_limits<T>::epsilon();
+
+  /* Renumber the subdiagonal to e[0..N-2]: */
+  for(int i = 1; i < N; ++ i) e[i-1] = e[i];
+  e[N-1] = T(0);
+
+  T f(0), tst1(0);
+  for(int l = 0; l < N; ++ l) {
+
+    /* Find a negligible subdiagonal element to split the matrix: */
+    tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+    int m = l;
+    while(m < N-1 && std::abs(e[m]) > eps*tst1) ++ m;
+
+    /* Iterate until d[l] is an eigenvalue: */
+    if(m > l) {
+      do {
+	/* Compute the implicit shift: */
+	T g = d[l];
+	T p = (d[l+1] - g)/(T(2)*e[l]);
+	T r = std::hypot(p, T(1));
+	if(p < T(0)) r = - r;
+	d[l] = e[l]/(p + r);
+	d[l+1] = e[l]*(p + r);
+	T dl1 = d[l+1];
+	T h = g - d[l];
+	for(int i = l+2; i < N; ++ i) d[i] -= h;
+	f += h;
+
+	/* Implicit QL transformation: */
+	p = d[m];
+	T c(1), c2(1), c3(1);
+	T el1 = e[l+1];
+	T s(0), s2(0);
+	for(int i = m-1; i >= l; -- i) {
+	  c3 = c2;
+	  c2 = c;
+	  s2 = s;
+	  g = c*e[i];
+	  h = c*p;
+	  r = std::hypot(p, e[i]);
+	  e[i+1] = s*r;
+	  s = e[i]/r;
+	  c = p/r;
+	  p = c*d[i] - s*g;
+	  d[i+1] = h + s*(c*g + s*d[i]);
+
+	  /* Accumulate the rotation into columns i and i+1 of V: */
+	  if(V) {
+	    for(int k = 0; k < N; ++ k) {
+	      T* v = V + k*N + i;
+	      h = v[1];
+	      v[1] = s*v[0] + c*h;
+	      v[0] = c*v[0] - s*h;
+	    }
+	  }
+	}
+	p = - s*s2*c3*el1*e[l]/dl1;
+	e[l] = s*p;
+	d[l] = c*p;
+      } while(std::abs(e[l]) > eps*tst1);
+    }
+    d[l] += f;
+    e[l] = T(0);
+  }
+
+  /* Sort the eigenvalues and eigenvectors in increasing order: */
+  for(int i = 0; i < N-1; ++ i) {
+    int k = i;
+    for(int j = i+1; j < N; ++ j) if(d[j] < d[k]) k = j;
+    if(k == i) continue;
+    std::swap(d[i], d[k]);
+    if(V) for(int j = 0; j < N; ++ j) std::swap(V[j*N + i], V[j*N + k]);
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
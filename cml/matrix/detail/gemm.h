@@ -0,0 +1,268 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_gemm_h
+#define	cml_matrix_detail_gemm_h
+
+#include <vector>
+#include <type_traits>
+#include <cml/common/type_util.h>
+#include <cml/common/layout_tags.h>
+#include <cml/common/memory_tags.h>
+#include <cml/matrix/traits.h>
+
+namespace cml {
+
+template<class Sub> class matrix_transpose_node;
+
+/** Specializable class holding the cache blocking parameters for the
+ * packed matrix product kernel.  @c mr x @c nr is the size of the register
+ * tile computed by the micro-kernel, @c mc x @c kc is the size of the
+ * packed block of the left operand, and @c kc x @c nc is the size of the
+ * packed panel of the right operand.
+ *
+ * @note Products with fewer than @c small_product multiply-adds skip
+ * packing altogether, and parallel::multiply() uses a single thread for
+ * products with fewer than @c parallel_product multiply-adds.
+ * strassen_product() stops recursing at blocks having a dimension smaller
+ * than @c strassen_cutoff.
+ */
+template<class Element> struct gemm_blocking
+{
+  static const int mr = 4;
+  static const int nr = 8;
+  static const int mc = 96;
+  static const int kc = 256;
+  static const int nc = 2048;
+  static const int small_product = 32*32*32;
+  static const int parallel_product = 128*128*128;
+  static const int strassen_cutoff = 512;
+};
+
+namespace detail {
+
+/** Defines @c value as true if @c Sub can be multiplied using the packed
+ * gemm() kernel: @c Sub must have contiguous, dynamically-allocated or
+ * external memory, and an arithmetic element type.
+ */
+template<class Sub, class Enable = void> struct is_gemm_operand
+{
+  static const bool value = false;
+};
+
+/** is_gemm_operand for matrices exposing data(). */
+template<class Sub>
+struct is_gemm_operand<Sub,
+  typename std::enable_if<has_contiguous_data<Sub>::value>::type>
+{
+  typedef matrix_traits<cml::unqualified_type_t<Sub>>	traits_type;
+  typedef typename traits_type::value_type		value_type;
+  typedef typename traits_type::storage_type		storage_type;
+
+  static const bool value
+    =  std::is_arithmetic<value_type>::value
+    && (is_allocated_memory<storage_type>::value
+      || is_external_memory<storage_type>::value);
+};
+
+/** Return the distance between two consecutive rows of row-major matrix
+ * @c M.
+ */
+template<class Matrix> inline int
+row_stride(const Matrix& M, row_major) { return M.cols(); }
+
+/** Return the distance between two consecutive rows of column-major
+ * matrix @c M.
+ */
+template<class Matrix> inline int
+row_stride(const Matrix&, col_major) { return 1; }
+
+/** Return the distance between two consecutive columns of row-major
+ * matrix @c M.
+ */
+template<class Matrix> inline int
+col_stride(const Matrix&, row_major) { return 1; }
+
+/** Return the distance between two consecutive columns of column-major
+ * matrix @c M.
+ */
+template<class Matrix> inline int
+col_stride(const Matrix& M, col_major) { return M.rows(); }
+
+/** Defines @c value as true if @c Sub can be passed to gemm() as a
+ * pointer and a pair of strides.  If so, data(), row_stride() and
+ * col_stride() return them for an expression of type @c Sub, and source()
+ * returns the address of the matrix owning the elements.
+ */
+template<class Sub, class Enable = void> struct gemm_operand
+{
+  static const bool value = false;
+};
+
+/** gemm_operand for matrices with contiguous storage. */
+template<class Sub>
+struct gemm_operand<Sub,
+  typename std::enable_if<is_gemm_operand<Sub>::value>::type>
+{
+  typedef matrix_traits<Sub>				traits_type;
+  typedef typename traits_type::value_type		value_type;
+  typedef typename traits_type::layout_tag		layout_tag;
+
+  static const bool value = true;
+
+  static const value_type* data(const Sub& M) { return M.data(); }
+  static int row_stride(const Sub& M) {
+    return detail::row_stride(M, layout_tag()); }
+  static int col_stride(const Sub& M) {
+    return detail::col_stride(M, layout_tag()); }
+  static const void* source(const Sub& M) { return &M; }
+};
+
+/** gemm_operand for the transpose of a matrix with contiguous storage,
+ * which reads the elements of the transposed matrix with its strides
+ * swapped.
+ */
+template<class Sub>
+struct gemm_operand<matrix_transpose_node<Sub>,
+  typename std::enable_if<
+    is_gemm_operand<cml::unqualified_type_t<Sub>>::value>::type>
+{
+  typedef matrix_transpose_node<Sub>			node_type;
+  typedef gemm_operand<cml::unqualified_type_t<Sub>>	sub_operand;
+  typedef typename sub_operand::value_type		value_type;
+
+  static const bool value = true;
+
+  static const value_type* data(const node_type& M) {
+    return sub_operand::data(M.sub()); }
+  static int row_stride(const node_type& M) {
+    return sub_operand::col_stride(M.sub()); }
+  static int col_stride(const node_type& M) {
+    return sub_operand::row_stride(M.sub()); }
+  static const void* source(const node_type& M) {
+    return sub_operand::source(M.sub()); }
+};
+
+/** Defines @c type as the type of the matrix transposed by @c Sub if it
+ * is a matrix_transpose_node, or void otherwise.
+ */
+template<class Sub> struct transposed_type_of
+{
+  typedef void type;
+};
+
+/** transposed_type_of for matrix_transpose_node. */
+template<class Sub> struct transposed_type_of<matrix_transpose_node<Sub>>
+{
+  typedef cml::unqualified_type_t<Sub> type;
+};
+
+/** Defines @c value as true if the product of @c Left and @c Right has
+ * the form A^T*A or A*A^T, where A has contiguous storage.  Whether the
+ * two As are the same matrix is only known at run-time, by comparing
+ * gemm_operand<>::source().
+ */
+template<class Left, class Right> struct is_syrk_operand_pair
+{
+  static const bool value
+    =  (std::is_same<typename transposed_type_of<Left>::type, Right>::value
+      && is_gemm_operand<Right>::value)
+    || (std::is_same<typename transposed_type_of<Right>::type, Left>::value
+      && is_gemm_operand<Left>::value);
+};
+
+/** Packing buffers for gemm_blocked().  The buffers only grow, so a
+ * sequence of products reusing one workspace allocates only for the
+ * first product of each size.
+ */
+template<class T> struct gemm_workspace
+{
+  std::vector<T>			a_pack, b_pack;
+};
+
+/** Compute the @c m x @c n product @c C = @c A * @c B, where @c A is @c m
+ * x @c k and @c B is @c k x @c n.  Each matrix is given as a pointer to
+ * its first element, followed by its row and column strides, so any
+ * combination of row- and column-major layouts is supported.
+ *
+ * Large products are computed by packing cache-sized blocks of @c A and
+ * @c B into contiguous buffers, then updating @c C one register tile at a
+ * time.  Products smaller than gemm_blocking<T>::small_product are
+ * computed directly using the same summation order as the generic
+ * product.
+ *
+ * @note @c C must not overlap @c A or @c B.
+ */
+template<class T> inline void gemm(int m, int n, int k,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T* C, int c_rs, int c_cs);
+
+/** Compute the @c m x @c n update @c C = @c alpha * @c A * @c B + @c beta
+ * * @c C, using the same kernel and strides as gemm() above.  If @c beta
+ * is 0, @c C is not read, so it need not be initialized.
+ *
+ * @note @c C must not overlap @c A or @c B.
+ */
+template<class T> inline void gemm(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs);
+
+/** gemm() packing large products into the buffers of @c work. */
+template<class T> inline void gemm(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs, gemm_workspace<T>& work);
+
+/** Return true if gemm() computes the @c m x @c n x @c k product without
+ * packing.
+ */
+template<class T> inline bool gemm_is_small(int m, int n, int k);
+
+/** Compute the update @c C = @c alpha * @c A * @c B + @c beta * @c C
+ * using the packed kernel, regardless of the size of the product.  Each
+ * element of @c C is accumulated in an order that depends only on @c k
+ * and gemm_blocking<T>::kc, so any block of rows or columns of @c C can be
+ * computed separately with an identical result.
+ *
+ * @note @c C must not overlap @c A or @c B.
+ */
+template<class T> inline void gemm_blocked(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs);
+
+/** gemm_blocked() packing into the buffers of @c work. */
+template<class T> inline void gemm_blocked(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs, gemm_workspace<T>& work);
+
+/** Compute the symmetric @c n x @c n product @c C = @c alpha * @c A * @c
+ * A^T, where @c A is @c n x @c k.  Only the blocks of @c C intersecting
+ * its upper triangle are computed, and the lower triangle is copied from
+ * the upper one.  Since each element is accumulated in the same order as
+ * by gemm(), the result is identical to the full product.
+ *
+ * @note @c C must not overlap @c A.
+ */
+template<class T> inline void syrk(int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs, T* C, int c_rs, int c_cs);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_GEMM_TPP
+#include <cml/matrix/detail/gemm.tpp>
+#undef __CML_MATRIX_DETAIL_GEMM_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
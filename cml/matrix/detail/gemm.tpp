@@ -0,0 +1,270 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_GEMM_TPP
+#error "matrix/detail/gemm.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <algorithm>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Pack the @c mc x @c kc block of @c A starting at @c A into panels of
+ * @c MR rows.  Each panel stores its @c MR elements from column @c p
+ * contiguously, and rows past @c mc are zero-padded.
+ */
+template<int MR, class T> inline void
+gemm_pack_a(int mc, int kc, const T* A, int a_rs, int a_cs, T* buffer)
+{
+  for(int ir = 0; ir < mc; ir += MR) {
+    int mr = std::min(MR, mc - ir);
+    const T* a = A + ir*a_rs;
+    for(int p = 0; p < kc; ++ p, buffer += MR) {
+      int i = 0;
+      for(; i < mr; ++ i) buffer[i] = a[i*a_rs + p*a_cs];
+      for(; i < MR; ++ i) buffer[i] = T(0);
+    }
+  }
+}
+
+/** Pack the @c kc x @c nc panel of @c B starting at @c B into panels of
+ * @c NR columns.  Each panel stores its @c NR elements from row @c p
+ * contiguously, and columns past @c nc are zero-padded.
+ */
+template<int NR, class T> inline void
+gemm_pack_b(int kc, int nc, const T* B, int b_rs, int b_cs, T* buffer)
+{
+  for(int jr = 0; jr < nc; jr += NR) {
+    int nr = std::min(NR, nc - jr);
+    const T* b = B + jr*b_cs;
+    for(int p = 0; p < kc; ++ p, buffer += NR) {
+      int j = 0;
+      for(; j < nr; ++ j) buffer[j] = b[p*b_rs + j*b_cs];
+      for(; j < NR; ++ j) buffer[j] = T(0);
+    }
+  }
+}
+
+/** Multiply the packed @c MR x @c kc panel @c a by the packed @c kc x @c
+ * NR panel @c b, and update the top-left @c mr x @c nr corner of @c C
+ * with @c alpha times the result.  @c C is scaled by @c beta first, or
+ * overwritten if @c beta is 0.
+ */
+template<int MR, int NR, class T> inline void
+gemm_micro_kernel(int kc, const T* a, const T* b,
+  T* C, int c_rs, int c_cs, int mr, int nr, T alpha, T beta)
+{
+  /* Accumulate the full register tile, relying on zero-padding of the
+   * packed panels:
+   */
+  T ab[MR*NR];
+  for(int t = 0; t < MR*NR; ++ t) ab[t] = T(0);
+  for(int p = 0; p < kc; ++ p, a += MR, b += NR) {
+    for(int i = 0; i < MR; ++ i)
+      for(int j = 0; j < NR; ++ j) ab[i*NR + j] += a[i]*b[j];
+  }
+
+  /* Write back the valid part of the tile: */
+  if(beta == T(0)) {
+    for(int i = 0; i < mr; ++ i)
+      for(int j = 0; j < nr; ++ j)
+	C[i*c_rs + j*c_cs] = alpha*ab[i*NR + j];
+  } else {
+    for(int i = 0; i < mr; ++ i)
+      for(int j = 0; j < nr; ++ j)
+	C[i*c_rs + j*c_cs] = alpha*ab[i*NR + j] + beta*C[i*c_rs + j*c_cs];
+  }
+}
+
+/** Unblocked product used for small matrices.  This sums over @c k in the
+ * same order as the generic matrix product.
+ */
+template<class T> inline void
+gemm_small(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs)
+{
+  for(int i = 0; i < m; ++ i) {
+    for(int j = 0; j < n; ++ j) {
+      const T* a = A + i*a_rs;
+      const T* b = B + j*b_cs;
+      T c = a[0]*b[0];
+      for(int p = 1; p < k; ++ p) c += a[p*a_cs]*b[p*b_rs];
+      T& cij = C[i*c_rs + j*c_cs];
+      cij = (beta == T(0)) ? alpha*c : alpha*c + beta*cij;
+    }
+  }
+}
+
+} // namespace
+
+template<class T> inline bool
+gemm_is_small(int m, int n, int k)
+{
+  return double(m)*double(n)*double(k)
+    <= double(gemm_blocking<T>::small_product);
+}
+
+template<class T> inline void gemm(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs)
+{
+  gemm_workspace<T> work;
+  detail::gemm(m, n, k, alpha,
+    A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs, work);
+}
+
+template<class T> inline void gemm(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs, gemm_workspace<T>& work)
+{
+  /* Nothing to do for an empty result: */
+  if(m == 0 || n == 0) return;
+
+  /* Packing does not pay off for small products: */
+  if(k > 0 && gemm_is_small<T>(m, n, k)) {
+    gemm_small(m, n, k, alpha,
+      A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs);
+    return;
+  }
+
+  detail::gemm_blocked(m, n, k, alpha,
+    A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs, work);
+}
+
+template<class T> inline void gemm_blocked(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs)
+{
+  gemm_workspace<T> work;
+  detail::gemm_blocked(m, n, k, alpha,
+    A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs, work);
+}
+
+template<class T> inline void gemm_blocked(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs, gemm_workspace<T>& work)
+{
+  typedef gemm_blocking<T>				blocking;
+  static const int MR = blocking::mr;
+  static const int NR = blocking::nr;
+  static const int MC = (blocking::mc + MR - 1)/MR*MR;
+  static const int KC = blocking::kc;
+  static const int NC = (blocking::nc + NR - 1)/NR*NR;
+
+  /* Nothing to do for an empty result: */
+  if(m == 0 || n == 0) return;
+
+  /* An empty inner dimension just scales C: */
+  if(k == 0) {
+    for(int i = 0; i < m; ++ i)
+      for(int j = 0; j < n; ++ j) {
+	T& cij = C[i*c_rs + j*c_cs];
+	cij = (beta == T(0)) ? T(0) : beta*cij;
+      }
+    return;
+  }
+
+  /* Grow the buffers for the packed blocks of A and B if needed: */
+  int mc_max = std::min(MC, (m + MR - 1)/MR*MR);
+  int nc_max = std::min(NC, (n + NR - 1)/NR*NR);
+  int kc_max = std::min(KC, k);
+  std::vector<T>& a_pack = work.a_pack;
+  std::vector<T>& b_pack = work.b_pack;
+  if(a_pack.size() < std::size_t(mc_max)*kc_max)
+    a_pack.resize(std::size_t(mc_max)*kc_max);
+  if(b_pack.size() < std::size_t(kc_max)*nc_max)
+    b_pack.resize(std::size_t(kc_max)*nc_max);
+
+  for(int jc = 0; jc < n; jc += NC) {
+    int nc = std::min(NC, n - jc);
+
+    for(int pc = 0; pc < k; pc += KC) {
+      int kc = std::min(KC, k - pc);
+
+      /* Only the first block of k scales C; the others accumulate: */
+      T beta_pc = (pc == 0) ? beta : T(1);
+
+      /* Pack the kc x nc panel of B: */
+      gemm_pack_b<NR>(kc, nc,
+	B + pc*b_rs + jc*b_cs, b_rs, b_cs, b_pack.data());
+
+      for(int ic = 0; ic < m; ic += MC) {
+	int mc = std::min(MC, m - ic);
+
+	/* Pack the mc x kc block of A: */
+	gemm_pack_a<MR>(mc, kc,
+	  A + ic*a_rs + pc*a_cs, a_rs, a_cs, a_pack.data());
+
+	/* Update the mc x nc block of C one register tile at a time: */
+	for(int jr = 0; jr < nc; jr += NR) {
+	  int nr = std::min(NR, nc - jr);
+	  const T* b = b_pack.data() + jr*kc;
+	  for(int ir = 0; ir < mc; ir += MR) {
+	    int mr = std::min(MR, mc - ir);
+	    const T* a = a_pack.data() + ir*kc;
+	    T* c = C + (ic + ir)*c_rs + (jc + jr)*c_cs;
+	    gemm_micro_kernel<MR,NR>(
+	      kc, a, b, c, c_rs, c_cs, mr, nr, alpha, beta_pc);
+	  }
+	}
+      }
+    }
+  }
+}
+
+template<class T> inline void syrk(int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs, T* C, int c_rs, int c_cs)
+{
+  static const int NB = gemm_blocking<T>::mc;
+
+  /* Small products are not worth splitting: */
+  if(k == 0 || gemm_is_small<T>(n, n, k)) {
+    detail::gemm(n, n, k, alpha,
+      A, a_rs, a_cs, A, a_cs, a_rs, T(0), C, c_rs, c_cs);
+    return;
+  }
+
+  /* Compute the blocks on or above the diagonal; the second operand is
+   * A^T, i.e. A with its strides swapped:
+   */
+  for(int ib = 0; ib < n; ib += NB) {
+    int mb = std::min(NB, n - ib);
+    for(int jb = ib; jb < n; jb += NB) {
+      int nb = std::min(NB, n - jb);
+      detail::gemm_blocked(mb, nb, k, alpha,
+	A + ib*a_rs, a_rs, a_cs, A + jb*a_rs, a_cs, a_rs,
+	T(0), C + ib*c_rs + jb*c_cs, c_rs, c_cs);
+    }
+  }
+
+  /* Mirror the upper triangle: */
+  for(int i = 1; i < n; ++ i)
+    for(int j = 0; j < i; ++ j) C[i*c_rs + j*c_cs] = C[j*c_rs + i*c_cs];
+}
+
+template<class T> inline void gemm(int m, int n, int k,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T* C, int c_rs, int c_cs)
+{
+  detail::gemm(m, n, k, T(1),
+    A, a_rs, a_cs, B, b_rs, b_cs, T(0), C, c_rs, c_cs);
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
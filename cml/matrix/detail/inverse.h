@@ -13,6 +13,9 @@
 #include <vector>
 #include <cml/common/mpl/int_c.h>
 #include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/detail/lu.h>
+#include <cml/matrix/detail/mat44_inverse.h>
+#include <cml/matrix/detail/schur.h>
 
 namespace cml {
 namespace detail {
@@ -59,9 +62,9 @@ inverse(writable_matrix<Sub>& M, int_c<3>)
   M(2,0) = m_02/D;  M(2,1) = m_12/D;  M(2,2) = m_22/D;
 }
 
-/** 4x4 inverse implementation. */
+/** 4x4 inverse implementation for matrices without a SIMD kernel. */
 template<class Sub> inline void
-inverse(writable_matrix<Sub>& M, int_c<4>)
+inverse(writable_matrix<Sub>& M, int_c<4>, std::false_type)
 {
   /* Common cofactors, rows 0,1: */
   auto m_22_33_23_32 = M(2,2)*M(3,3) - M(2,3)*M(3,2);
@@ -109,114 +112,293 @@ inverse(writable_matrix<Sub>& M, int_c<4>)
    * inverse as (1/D) * (cofactor matrix)^T:
    */
   auto D = (M(0,0)*d00 - M(0,1)*d01 + M(0,2)*d02 - M(0,3)*d03);
-  M(0,0) = +d00/D; M(0,1) = -d10/D; M(0,2) = +d20/D; M(0,3) = -d30/D;
-  M(1,0) = -d01/D; M(1,1) = +d11/D; M(1,2) = -d21/D; M(1,3) = +d31/D;
-  M(2,0) = +d02/D; M(2,1) = -d12/D; M(2,2) = +d22/D; M(2,3) = -d32/D;
-  M(3,0) = -d03/D; M(3,1) = +d13/D; M(3,2) = -d23/D; M(3,3) = +d33/D;
+  auto iD = decltype(D)(1)/D;
+  M(0,0) = +d00*iD; M(0,1) = -d10*iD; M(0,2) = +d20*iD; M(0,3) = -d30*iD;
+  M(1,0) = -d01*iD; M(1,1) = +d11*iD; M(1,2) = -d21*iD; M(1,3) = +d31*iD;
+  M(2,0) = +d02*iD; M(2,1) = -d12*iD; M(2,2) = +d22*iD; M(2,3) = -d32*iD;
+  M(3,0) = -d03*iD; M(3,1) = +d13*iD; M(3,2) = -d23*iD; M(3,3) = +d33*iD;
 }
 
-namespace {
+#if defined(CML_SIMD_SSE2)
+/** 4x4 inverse implementation using the SIMD kernel. */
+template<class Sub> inline void
+inverse(writable_matrix<Sub>& M, int_c<4>, std::true_type)
+{
+  detail::mat44_inverse(M.actual().data());
+}
+#endif
 
-/** Internal NxN inverse implementation using pivoting. @c row_index, @c
- * col_index, and @c pivoted should be an appropriately sized array (e.g.
- * std::vector<> or std::array<>).
+/** 4x4 inverse implementation. */
+template<class Sub> inline void
+inverse(writable_matrix<Sub>& M, int_c<4>)
+{
+  detail::inverse(M, int_c<4>(),
+    std::integral_constant<bool, is_mat44_inverse_operand<Sub>::value>());
+}
+
+/** In-place inversion of the @c N x @c N matrix @c M by LU decomposition
+ * with partial pivoting: U is inverted in place, then U^-1 L^-1 is formed
+ * column by column from the right, and the columns are permuted back to
+ * the original row order.  @c N is either an int, or an int_c<> so that
+ * every loop bound of a fixed-size inverse is a compile-time constant.
+ * @c order and @c work must have room for @c N elements.
+ *
+ * @returns false if @c M is singular, in which case its contents are
+ * unspecified.
  */
-template<class Sub, class RowIndexArray, class ColIndexArray, class Markers>
-inline void inverse_pivot(writable_matrix<Sub>& M,
-  RowIndexArray& row_index, ColIndexArray& col_index, Markers& pivoted
-  )
+template<class Sub, class Size, class OrderArray, class WorkArray>
+inline bool inverse_lu(writable_matrix<Sub>& M, Size N,
+  OrderArray& order, WorkArray& work)
 {
   typedef value_type_trait_of_t<Sub>			value_type;
   typedef traits_of_t<value_type>			value_traits;
 
-  /* For each column */
-  int N = M.rows();
-  for(int i = 0; i < N; ++ i) {
-
-    /* Find the pivot */
-    int row = 0, col = 0;
-    auto pivot = value_traits::fabs(M(0,0));
-    for(int j = 0; j < N; ++ j) {
-      if(pivoted[j]) continue;
-
-      for(int k = 0; k < N; ++ k) {
-	if(pivoted[k]) continue;
-
-	value_type mag = value_traits::fabs(M(j,k));
-	if(mag > pivot) {
-	  pivot = mag;
-	  row = j;
-	  col = k;
-	}
+  /* Factor PM = LU: */
+  for(int i = 0; i < N; ++ i) order[i] = i;
+  for(int k = 0; k < N; ++ k) {
+    int row = k;
+    value_type max = value_traits::fabs(M(k,k));
+    for(int i = k+1; i < N; ++ i) {
+      value_type mag = value_traits::fabs(M(i,k));
+      if(mag > max) {
+	max = mag;
+	row = i;
       }
     }
+    if(max < value_traits::epsilon()) return false;
 
-    /* TODO: Check pivot against epsilon here to catch singularity */
-    // cml_require(pivot >= epsilon, singular_matrix_error, /**/);
+    if(row != k) {
+      std::swap(order[k], order[row]);
+      for(int j = 0; j < N; ++ j) std::swap(M(k,j), M(row,j));
+    }
 
-    row_index[i] = row;
-    col_index[i] = col;
+    value_type inv = value_type(1)/M(k,k);
+    for(int i = k+1; i < N; ++ i) {
+      value_type lik = (M(i,k) *= inv);
+      for(int j = k+1; j < N; ++ j) M(i,j) -= lik*M(k,j);
+    }
+  }
 
-    /* Swap rows if necessary */
-    if(row != col) {
-      for(int j = 0; j < N; ++ j)
-       	std::swap(M(row,j), M(col,j));
+  /* Invert U in place, one column at a time: */
+  for(int j = 0; j < N; ++ j) {
+    value_type ujj = M(j,j) = value_type(1)/M(j,j);
+    for(int i = 0; i < j; ++ i) {
+      value_type s(0);
+      for(int k = i; k < j; ++ k) s += M(i,k)*M(k,j);
+      M(i,j) = - s*ujj;
     }
+  }
 
-    /* Process pivot row */
-    pivoted[col] = true;
-    pivot = M(col,col);
-    M(col,col) = value_type(1);
-    value_type k = value_type(1) / pivot;
-    for(int j = 0; j < N; ++ j) M(col,j) *= k;
+  /* Solve X L = U^-1 for X, from the rightmost column: */
+  for(int j = N-1; j >= 0; -- j) {
+    for(int i = j+1; i < N; ++ i) {
+      work[i] = M(i,j);
+      M(i,j) = value_type(0);
+    }
+    for(int r = 0; r < N; ++ r) {
+      value_type s = M(r,j);
+      for(int i = j+1; i < N; ++ i) s -= M(r,i)*work[i];
+      M(r,j) = s;
+    }
+  }
+
+  /* M^-1 = X P, so column i of X is column order[i] of M^-1: */
+  for(int r = 0; r < N; ++ r) {
+    for(int i = 0; i < N; ++ i) work[order[i]] = M(r,i);
+    for(int j = 0; j < N; ++ j) M(r,j) = work[j];
+  }
+  return true;
+}
+
+/** Blocked in-place inversion of the @c N x @c N matrix @c A, given as a
+ * pointer to its first element and its row and column strides.  A is
+ * factored by lu_pivot_blocked(), and both the inversion of U and the
+ * solution of X L = U^-1 proceed by blocks of lu_blocking<T>::nb columns,
+ * with the off-diagonal blocks updated by gemm() packing into @c pack.  @c
+ * order must have room for @c N elements, and @c work must have room for N
+ * x lu_blocking<T>::nb elements.
+ *
+ * @returns false if @c A is singular, in which case its contents are
+ * unspecified.
+ */
+template<class T, class OrderArray> inline bool
+inverse_blocked(int N, T* A, int a_rs, int a_cs,
+  OrderArray& order, std::vector<T>& work, gemm_workspace<T>& pack)
+{
+  static const int NB = lu_blocking<T>::nb;
+  auto a = [=](int i, int j) -> T& { return A[i*a_rs + j*a_cs]; };
 
-    /* Process other rows */
-    for(int j = 0; j < N; ++ j) {
-      if(j == col) continue;
+  /* Factor PA = LU: */
+  if(detail::lu_pivot_blocked(
+      N, A, a_rs, a_cs, order, lu_serial_update<T>(pack)) == 0) return false;
 
-      value_type mult = -M(j,col);
-      M(j,col) = value_type(0);
-      for(int k = 0; k < N; ++ k) M(j,k) += mult * M(col,k);
+  /* Invert U by block columns.  For each block column, the rows above the
+   * diagonal block become -U11^-1 U12 U22^-1, where U11^-1 is already in
+   * place:
+   */
+  for(int j0 = 0; j0 < N; j0 += NB) {
+    int jb = std::min(NB, N - j0), j1 = j0 + jb;
+
+    /* U12 <- U11^-1 U12, by row blocks from the top; each row block only
+     * reads rows of U12 below it, which are not yet updated:
+     */
+    for(int i0 = 0; i0 < j0; i0 += NB) {
+      int i1 = std::min(j0, i0 + NB);
+      for(int i = i0; i < i1; ++ i)
+	for(int j = j0; j < j1; ++ j) {
+	  T s(0);
+	  for(int k = i; k < i1; ++ k) s += a(i,k)*a(k,j);
+	  work[(i - i0)*jb + (j - j0)] = s;
+	}
+      if(i1 < j0) detail::gemm(i1 - i0, jb, j0 - i1, T(1),
+	&a(i0,i1), a_rs, a_cs, &a(i1,j0), a_rs, a_cs,
+	T(1), work.data(), jb, 1, pack);
+      for(int i = i0; i < i1; ++ i)
+	for(int j = j0; j < j1; ++ j) a(i,j) = work[(i - i0)*jb + (j - j0)];
+    }
+
+    /* U12 <- - U12 U22^-1, by forward substitution with U22: */
+    for(int j = j0; j < j1; ++ j) {
+      T inv = T(1)/a(j,j);
+      for(int i = 0; i < j0; ++ i) {
+	T s = a(i,j);
+	for(int k = j0; k < j; ++ k) s -= a(i,k)*a(k,j);
+	a(i,j) = s*inv;
+      }
+    }
+    for(int i = 0; i < j0; ++ i)
+      for(int j = j0; j < j1; ++ j) a(i,j) = - a(i,j);
+
+    /* Invert U22 in place: */
+    for(int j = j0; j < j1; ++ j) {
+      T ujj = a(j,j) = T(1)/a(j,j);
+      for(int i = j0; i < j; ++ i) {
+	T s(0);
+	for(int k = i; k < j; ++ k) s += a(i,k)*a(k,j);
+	a(i,j) = - s*ujj;
+      }
     }
   }
 
-  /* Swap columns if necessary */
-  for(int i = 0; i < N; ++ i) {
-    if(row_index[i] == col_index[i]) continue;
+  /* Solve X L = U^-1 for X by block columns from the right.  The block
+   * column of L is moved to work, and its part below the diagonal block
+   * is applied by gemm():
+   */
+  int last = (N - 1)/NB*NB;
+  for(int j0 = last; j0 >= 0; j0 -= NB) {
+    int jb = std::min(NB, N - j0), j1 = j0 + jb;
+
+    for(int i = j0; i < N; ++ i)
+      for(int j = j0; j < j1; ++ j) {
+	T& aij = a(i,j);
+	work[i*jb + (j - j0)] = (i > j) ? aij : T(0);
+	if(i > j) aij = T(0);
+      }
+
+    if(j1 < N) detail::gemm(N, jb, N - j1, T(-1),
+      &a(0,j1), a_rs, a_cs, work.data() + j1*jb, jb, 1,
+      T(1), &a(0,j0), a_rs, a_cs, pack);
+
+    for(int j = j1 - 1; j >= j0; -- j)
+      for(int k = j+1; k < j1; ++ k) {
+	T lkj = work[k*jb + (j - j0)];
+	for(int r = 0; r < N; ++ r) a(r,j) -= a(r,k)*lkj;
+      }
+  }
 
-    for(int j = 0; j < N; ++ j)
-      std::swap(M(j,row_index[i]), M(j,col_index[i]));
+  /* A^-1 = X P, so column i of X is column order[i] of A^-1: */
+  for(int r = 0; r < N; ++ r) {
+    for(int i = 0; i < N; ++ i) work[order[i]] = a(r,i);
+    for(int j = 0; j < N; ++ j) a(r,j) = work[j];
   }
+  return true;
 }
 
+/** Inverse implementation for statically-sized square matrices with
+ * dimension greater than 7, or when the block inverse fails, using LU
+ * decomposition with compile-time loop bounds.
+ */
+template<class Sub, int N> inline void
+inverse(writable_matrix<Sub>& M, int_c<N>, std::false_type)
+{
+  std::array<int, N> order;
+  std::array<value_type_trait_of_t<Sub>, N> work;
+  inverse_lu(M, int_c<N>(), order, work);
 }
 
 /** Inverse implementation for statically-sized square matrices with
- * dimension greater than 4, using a pivoting algorithm to compute the
- * result.
+ * dimension 5 through 7, using the block inverse from the Schur complement
+ * of the leading (N+1)/2 x (N+1)/2 block.  If that block is singular, or
+ * the residual of the block inverse is too large, LU decomposition is used
+ * instead.  At 8x8, checking the residual costs more than the block
+ * inverse saves.
+ */
+template<class Sub, int N> inline void
+inverse(writable_matrix<Sub>& M, int_c<N>, std::true_type)
+{
+  if(schur_inverse(M, int_c<(N+1)/2>(), int_c<N/2>())) return;
+  detail::inverse(M, int_c<N>(), std::false_type());
+}
+
+/** Inverse implementation for statically-sized square matrices with
+ * dimension greater than 4.
  *
  * @note It is up to the caller to ensure @c M is a square matrix.
  */
 template<class Sub, int N> inline void
 inverse(writable_matrix<Sub>& M, int_c<N>)
 {
-  /* For tracking pivots */
-  std::array<int, N> row_index, col_index;
-  std::array<bool, N> pivoted; pivoted.fill(false);
+  detail::inverse(M, int_c<N>(), std::integral_constant<bool, (N <= 7)>());
+}
 
-  /* Call the implementation: */
-  inverse_pivot(M, row_index, col_index, pivoted);
+/** Inverse implementation for statically-sized square matrices, which
+ * need no scratch space.
+ */
+template<class Sub, int N, class OrderArray, class WorkArray, class Pack>
+inline void
+inverse(writable_matrix<Sub>& M, int_c<N>, OrderArray&, WorkArray&, Pack&)
+{
+  detail::inverse(M, int_c<N>());
 }
 
-/** Inverse implementation for dynamically-sized square matrices.  This
+/** Dynamic-size inverse of a matrix with contiguous storage. */
+template<class Sub> inline void
+inverse(writable_matrix<Sub>& M, std::vector<int>& order,
+  std::vector<value_type_trait_of_t<Sub>>& work,
+  gemm_workspace<value_type_trait_of_t<Sub>>& pack, std::true_type)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  auto& A = M.actual();
+  int N = A.rows();
+  work.resize(std::size_t(N)*lu_blocking<value_type>::nb);
+  inverse_blocked(N, A.data(),
+    row_stride(A, layout()), col_stride(A, layout()), order, work, pack);
+}
+
+/** Dynamic-size inverse of an arbitrary writable matrix. */
+template<class Sub> inline void
+inverse(writable_matrix<Sub>& M, std::vector<int>& order,
+  std::vector<value_type_trait_of_t<Sub>>& work,
+  gemm_workspace<value_type_trait_of_t<Sub>>&, std::false_type)
+{
+  work.resize(M.rows());
+  inverse_lu(M, M.rows(), order, work);
+}
+
+/** Inverse implementation for dynamically-sized square matrices, using @c
+ * order, @c work and the packing buffers @c pack as scratch space.  This
  * dispatches to a small matrix implementation when the dimension of @c M
- * is no more than 4.  Otherwise, the general pivoting implementation is
- * used.
+ * is no more than 4.  Otherwise, matrices with contiguous storage are
+ * inverted by inverse_blocked(), and others by inverse_lu().
  *
  * @note It is up to the caller to ensure @c M is a square matrix.
  */
 template<class Sub> inline void
-inverse(writable_matrix<Sub>& M, int_c<-1>)
+inverse(writable_matrix<Sub>& M, int_c<-1>,
+  std::vector<int>& order, std::vector<value_type_trait_of_t<Sub>>& work,
+  gemm_workspace<value_type_trait_of_t<Sub>>& pack)
 {
   /* Use small matrix inverse if possible: */
   int N = M.rows();
@@ -226,14 +408,24 @@ inverse(writable_matrix<Sub>& M, int_c<-1>)
     case 4: inverse(M, int_c<4>()); return; break;
   }
 
-  /* Otherwise, use the pivoting inverse: */
-
-  /* For tracking pivots */
-  std::vector<int> row_index(N), col_index(N);
-  std::vector<bool> pivoted(N, false);
+  /* Otherwise, use the LU inverse: */
+  order.resize(N);
+  detail::inverse(M, order, work, pack,
+    std::integral_constant<bool, is_gemm_operand<Sub>::value>());
+}
 
-  /* Call the implementation: */
-  inverse_pivot(M, row_index, col_index, pivoted);
+/** Inverse implementation for dynamically-sized square matrices, using
+ * temporary scratch space.
+ *
+ * @note It is up to the caller to ensure @c M is a square matrix.
+ */
+template<class Sub> inline void
+inverse(writable_matrix<Sub>& M, int_c<-1>)
+{
+  std::vector<int> order;
+  std::vector<value_type_trait_of_t<Sub>> work;
+  gemm_workspace<value_type_trait_of_t<Sub>> pack;
+  detail::inverse(M, int_c<-1>(), order, work, pack);
 }
 
 } // namespace detail
@@ -9,11 +9,38 @@
 #ifndef	cml_matrix_detail_lu_h
 #define	cml_matrix_detail_lu_h
 
+#include <array>
+#include <vector>
 #include <cml/matrix/fwd.h>
+#include <cml/matrix/detail/gemm.h>
 
 namespace cml {
+
+/** Specializable class holding the blocking parameters for the blocked LU
+ * decomposition: @c nb is the number of columns factored per panel.
+ */
+template<class Element> struct lu_blocking
+{
+  static const int nb = 64;
+};
+
 namespace detail {
 
+/** Trailing-update policy for lu_pivot_inplace(), computing each update
+ * with gemm() on the calling thread, packing into @c work.
+ */
+template<class T> struct lu_serial_update
+{
+  explicit lu_serial_update(gemm_workspace<T>& work) : work(work) {}
+
+  void operator()(int m, int n, int k, T alpha,
+    const T* A, int a_rs, int a_cs,
+    const T* B, int b_rs, int b_cs,
+    T beta, T* C, int c_rs, int c_cs) const;
+
+  gemm_workspace<T>&			work;
+};
+
 /** In-place LU decomposition using Doolittle's method.
  *
  * @tparam Sub Derived output matrix type.
@@ -40,6 +67,99 @@ lu_inplace(writable_matrix<Sub>& M);
 template<class Sub, class OrderArray> inline int
 lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order);
 
+/** In-place LU decomposition using partial pivoting, like
+ * lu_pivot_inplace(M, order) above.  If @c M has contiguous storage, it
+ * is factored by lu_pivot_blocked(), with @c update computing the
+ * trailing updates.  Otherwise, @c update is not used.
+ */
+template<class Sub, class OrderArray, class Update> inline int
+lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order, Update update);
+
+/** Blocked right-looking LU decomposition with partial pivoting of the @c
+ * N x @c N matrix @c A, given as a pointer to its first element and its
+ * row and column strides.  Each panel of lu_blocking<T>::nb columns is
+ * factored with row interchanges limited to the panel; the interchanges
+ * are then applied to the rest of the matrix in a single pass, the block
+ * row of U is computed by forward substitution, and the trailing
+ * submatrix is updated by calling @c update like gemm().
+ *
+ * The pivots are the same as those of the unblocked algorithm in exact
+ * arithmetic, and the return value and @c order are as for
+ * lu_pivot_inplace().
+ */
+template<class T, class OrderArray, class Update> inline int
+lu_pivot_blocked(int N, T* A, int a_rs, int a_cs,
+  OrderArray& order, Update update);
+
+/** Permute the rows of @c X in place, so that row @c i of the result is
+ * row @c order[i] of the input.  Each cycle of the permutation is
+ * followed once from its smallest row, swapping single elements, so @c
+ * order is not modified and no temporary storage is needed.
+ */
+template<class Sub, class OrderArray> inline void
+lu_permute_rows(writable_matrix<Sub>& X, const OrderArray& order);
+
+/** Resize the row order array of a dynamic-size lu_pivot_result, or a
+ * work array from lu_work_array, to @c N elements.
+ */
+template<class T> inline void lu_resize_order(std::vector<T>& order, int N);
+
+/** The arrays of a fixed-size lu_pivot_result are not resized. */
+template<class T, std::size_t N> inline void
+lu_resize_order(std::array<T,N>& order, int);
+
+/** Defines @c type as an array of values of type @c T, with the same size
+ * as the row order array @c OrderArray of an lu_pivot_result.
+ */
+template<class OrderArray, class T> struct lu_work_array;
+
+/** lu_work_array for fixed-size factorizations. */
+template<std::size_t N, class T> struct lu_work_array<std::array<int,N>, T>
+{
+  typedef std::array<T,N> type;
+};
+
+/** lu_work_array for dynamic-size factorizations. */
+template<class T> struct lu_work_array<std::vector<int>, T>
+{
+  typedef std::vector<T> type;
+};
+
+/** Solve A @c x = @c b for the array @c x, where @c LU and @c order are
+ * the partial-pivoting LU decomposition of A, and @c inv_diag holds the
+ * reciprocals of the diagonal of U.  @c b and @c x must not overlap.
+ */
+template<class Matrix, class OrderArray, class T> inline void
+lu_solve_array(const Matrix& LU, const OrderArray& order,
+  const T* inv_diag, const T* b, T* x);
+
+/** Solve A^T @c x = @c b for the array @c x, like lu_solve_array(), by
+ * substitution with U^T then L^T.  @c b is overwritten, and must not
+ * overlap @c x.
+ */
+template<class Matrix, class OrderArray, class T> inline void
+lu_solve_transpose_array(const Matrix& LU, const OrderArray& order,
+  const T* inv_diag, T* b, T* x);
+
+/** Overwrite @c X with the solution of @c LU Y = @c X, where @c LU holds a
+ * unit lower triangle below its diagonal, and an upper triangle at and
+ * above it.
+ *
+ * @note It is up to the caller to ensure @c LU is square, and has as many
+ * rows as @c X.
+ */
+template<class LUSub, class XSub> inline void
+lu_substitute(const readable_matrix<LUSub>& LU, writable_matrix<XSub>& X);
+
+/** Blocked lu_substitute() for the @c N x @c N factors @c LU and the @c N
+ * x @c nrhs right-hand sides @c X, given as pointers and strides.  Blocks
+ * of lu_blocking<T>::nb rows are substituted directly, and their
+ * contribution to the remaining rows is subtracted using gemm().
+ */
+template<class T> inline void
+lu_substitute_blocked(int N, int nrhs,
+  const T* LU, int lu_rs, int lu_cs, T* X, int x_rs, int x_cs);
+
 } // namespace detail
 } // namespace cml
 
@@ -8,7 +8,10 @@
 #error "matrix/detail/lu.tpp not included correctly"
 #endif
 
+#include <vector>
+#include <algorithm>
 #include <cml/common/traits.h>
+#include <cml/matrix/detail/gemm.h>
 
 namespace cml {
 namespace detail {
@@ -37,8 +40,22 @@ lu_inplace(writable_matrix<Sub>& M)
   }
 }
 
-template<class Sub, class OrderArray> inline int
-lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order)
+template<class T> inline void
+lu_serial_update<T>::operator()(int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs) const
+{
+  detail::gemm(m, n, k, alpha,
+    A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs, this->work);
+}
+
+/** lu_pivot_inplace() for arbitrary writable matrices, using the
+ * unblocked algorithm.
+ */
+template<class Sub, class OrderArray, class Update> inline int
+lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order,
+  Update, std::false_type)
 {
   typedef value_type_trait_of_t<Sub>			value_type;
   typedef traits_of_t<value_type>			value_traits;
@@ -53,7 +70,7 @@ lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order)
 
     /* Find the next pivot row: */
     int row = k;
-    value_type max = M(k,k);
+    value_type max = value_traits::fabs(M(k,k));
     for(int i = k+1; i < N; ++ i) {
       value_type mag = value_traits::fabs(M(i,k));
       if(mag > max) {
@@ -85,6 +102,316 @@ lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order)
   return flag;
 }
 
+/** lu_pivot_inplace() for matrices with contiguous storage, using the
+ * blocked algorithm.
+ */
+template<class Sub, class OrderArray, class Update> inline int
+lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order,
+  Update update, std::true_type)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+
+  auto& A = M.actual();
+  return detail::lu_pivot_blocked(A.rows(), A.data(),
+    row_stride(A, layout()), col_stride(A, layout()), order, update);
+}
+
+template<class Sub, class OrderArray, class Update> inline int
+lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order, Update update)
+{
+  typedef std::integral_constant<bool,
+    is_gemm_operand<Sub>::value>			blocked_tag;
+  return detail::lu_pivot_inplace(M, order, update, blocked_tag());
+}
+
+template<class Sub, class OrderArray> inline int
+lu_pivot_inplace(writable_matrix<Sub>& M, OrderArray& order)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  gemm_workspace<value_type> work;
+  return detail::lu_pivot_inplace(
+    M, order, lu_serial_update<value_type>(work));
+}
+
+template<class T, class OrderArray, class Update> inline int
+lu_pivot_blocked(int N, T* A, int a_rs, int a_cs,
+  OrderArray& order, Update update)
+{
+  typedef traits_of_t<T>				value_traits;
+  static const int NB = lu_blocking<T>::nb;
+
+  /* Initialize the order: */
+  for(int i = 0; i < N; ++ i) order[i] = i;
+
+  /* Pivot rows chosen for the current panel: */
+  int pivots[NB];
+
+  int flag = 1;
+  for(int j0 = 0; j0 < N; j0 += NB) {
+    int nb = std::min(NB, N - j0), j1 = j0 + nb;
+
+    /* Factor the N-j0 x nb panel, swapping rows only within it: */
+    for(int k = j0; k < j1; ++ k) {
+      pivots[k - j0] = k;
+
+      /* The last column has no pivot to choose: */
+      if(k == N-1) break;
+
+      /* Find the next pivot row: */
+      int row = k;
+      T max = value_traits::fabs(A[k*a_rs + k*a_cs]);
+      for(int i = k+1; i < N; ++ i) {
+	T mag = value_traits::fabs(A[i*a_rs + k*a_cs]);
+	if(mag > max) {
+	  max = mag;
+	  row = i;
+	}
+      }
+
+      /* Check for a singular matrix: */
+      if(max < value_traits::epsilon()) return 0;
+
+      /* Update order and swap the panel rows: */
+      if(row != k) {
+	pivots[k - j0] = row;
+	std::swap(order[k], order[row]);
+	for(int j = j0; j < j1; ++ j)
+	  std::swap(A[k*a_rs + j*a_cs], A[row*a_rs + j*a_cs]);
+	flag = - flag;
+      }
+
+      /* Compute the Schur complement within the panel: */
+      T pivot = A[k*a_rs + k*a_cs];
+      for(int i = k+1; i < N; ++ i) {
+	T& lik = A[i*a_rs + k*a_cs];
+	lik /= pivot;
+	for(int j = k+1; j < j1; ++ j)
+	  A[i*a_rs + j*a_cs] -= lik*A[k*a_rs + j*a_cs];
+      }
+    }
+
+    /* Apply the panel's interchanges to the columns left and right of the
+     * panel, walking along the contiguous dimension:
+     */
+    auto swap_columns = [&](int first, int last) {
+      if(a_cs == 1) {
+	for(int k = j0; k < j1; ++ k) {
+	  int row = pivots[k - j0];
+	  if(row != k) std::swap_ranges(
+	    A + k*a_rs + first, A + k*a_rs + last, A + row*a_rs + first);
+	}
+      } else {
+	for(int j = first; j < last; ++ j)
+	  for(int k = j0; k < j1; ++ k) {
+	    int row = pivots[k - j0];
+	    if(row != k) std::swap(A[k*a_rs + j*a_cs], A[row*a_rs + j*a_cs]);
+	  }
+      }
+    };
+    swap_columns(0, j0);
+    swap_columns(j1, N);
+
+    /* Nothing remains to the right of the last panel: */
+    if(j1 == N) break;
+
+    /* Compute the block row of U by forward substitution with the unit
+     * lower triangle of the panel:
+     */
+    for(int k = j0; k < j1; ++ k)
+      for(int i = k+1; i < j1; ++ i) {
+	T lik = A[i*a_rs + k*a_cs];
+	for(int j = j1; j < N; ++ j)
+	  A[i*a_rs + j*a_cs] -= lik*A[k*a_rs + j*a_cs];
+      }
+
+    /* Update the trailing submatrix, A22 -= L21*U12: */
+    update(N - j1, N - j1, nb, T(-1),
+      A + j1*a_rs + j0*a_cs, a_rs, a_cs,
+      A + j0*a_rs + j1*a_cs, a_rs, a_cs,
+      T(1), A + j1*a_rs + j1*a_cs, a_rs, a_cs);
+  }
+
+  /* Done: */
+  return flag;
+}
+
+template<class T> inline void
+lu_resize_order(std::vector<T>& order, int N)
+{
+  order.resize(N);
+}
+
+template<class T, std::size_t N> inline void
+lu_resize_order(std::array<T,N>&, int)
+{
+}
+
+template<class Matrix, class OrderArray, class T> inline void
+lu_solve_array(const Matrix& LU, const OrderArray& order,
+  const T* inv_diag, const T* b, T* x)
+{
+  const int N = LU.rows();
+
+  /* Solve Ly = Pb, then Ux = y, in place in x: */
+  for(int i = 0; i < N; ++ i) {
+    T sum(0);
+    for(int j = 0; j < i; ++ j) sum += T(LU(i,j))*x[j];
+    x[i] = b[order[i]] - sum;
+  }
+  for(int i = N-1; i >= 0; -- i) {
+    T sum(0);
+    for(int j = i+1; j < N; ++ j) sum += T(LU(i,j))*x[j];
+    x[i] = (x[i] - sum)*inv_diag[i];
+  }
+}
+
+template<class Matrix, class OrderArray, class T> inline void
+lu_solve_transpose_array(const Matrix& LU, const OrderArray& order,
+  const T* inv_diag, T* b, T* x)
+{
+  const int N = LU.rows();
+
+  /* A^T = U^T L^T P, so solve U^T w = b, then L^T v = w, in place in b:
+   */
+  for(int i = 0; i < N; ++ i) {
+    T sum(0);
+    for(int j = 0; j < i; ++ j) sum += T(LU(j,i))*b[j];
+    b[i] = (b[i] - sum)*inv_diag[i];
+  }
+  for(int i = N-1; i >= 0; -- i) {
+    T sum(0);
+    for(int j = i+1; j < N; ++ j) sum += T(LU(j,i))*b[j];
+    b[i] -= sum;
+  }
+
+  /* Then x = P^T v: */
+  for(int i = 0; i < N; ++ i) x[order[i]] = b[i];
+}
+
+template<class Sub, class OrderArray> inline void
+lu_permute_rows(writable_matrix<Sub>& X, const OrderArray& order)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  int N = X.rows(), M = X.cols();
+  for(int i = 0; i < N; ++ i) {
+    /* Skip i unless it is the smallest row of its cycle: */
+    int k = order[i];
+    while(k > i) k = order[k];
+    if(k != i) continue;
+
+    /* Rotate the rows of the cycle by swapping rows k and order[k]: */
+    for(int next = order[k]; next != i; k = next, next = order[k])
+      for(int j = 0; j < M; ++ j) {
+	value_type t = X.get(k,j);
+	X.put(k,j, X.get(next,j));
+	X.put(next,j, t);
+      }
+  }
+}
+
+/** lu_substitute() for arbitrary matrix expressions. */
+template<class LUSub, class XSub> inline void
+lu_substitute(const readable_matrix<LUSub>& LU, writable_matrix<XSub>& X,
+  std::false_type)
+{
+  int N = X.rows(), M = X.cols();
+
+  /* Forward substitution with the unit lower triangle: */
+  for(int i = 1; i < N; ++ i)
+    for(int k = 0; k < i; ++ k) {
+      auto l = LU(i,k);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j) - l*X.get(k,j));
+    }
+
+  /* Backward substitution with the upper triangle: */
+  for(int i = N-1; i >= 0; -- i) {
+    for(int k = i+1; k < N; ++ k) {
+      auto u = LU(i,k);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j) - u*X.get(k,j));
+    }
+    auto d = LU(i,i);
+    for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j)/d);
+  }
+}
+
+/** lu_substitute() for factors and right-hand sides with contiguous
+ * storage and the same element type.
+ */
+template<class LUSub, class XSub> inline void
+lu_substitute(const readable_matrix<LUSub>& LU, writable_matrix<XSub>& X,
+  std::true_type)
+{
+  typedef layout_tag_trait_of_t<LUSub>			lu_layout;
+  typedef layout_tag_trait_of_t<XSub>			x_layout;
+
+  const auto& A = LU.actual();
+  auto& B = X.actual();
+  detail::lu_substitute_blocked(B.rows(), B.cols(),
+    A.data(), row_stride(A, lu_layout()), col_stride(A, lu_layout()),
+    B.data(), row_stride(B, x_layout()), col_stride(B, x_layout()));
+}
+
+template<class LUSub, class XSub> inline void
+lu_substitute(const readable_matrix<LUSub>& LU, writable_matrix<XSub>& X)
+{
+  typedef std::integral_constant<bool,
+    is_gemm_operand<LUSub>::value && has_contiguous_data<XSub>::value
+    && std::is_same<value_type_trait_of_t<LUSub>,
+      value_type_trait_of_t<XSub>>::value>		blocked_tag;
+  detail::lu_substitute(LU, X, blocked_tag());
+}
+
+template<class T> inline void
+lu_substitute_blocked(int N, int nrhs,
+  const T* LU, int lu_rs, int lu_cs, T* X, int x_rs, int x_cs)
+{
+  static const int NB = lu_blocking<T>::nb;
+
+  /* Forward substitution with the unit lower triangle: */
+  for(int i0 = 0; i0 < N; i0 += NB) {
+    int i1 = std::min(N, i0 + NB);
+
+    /* Substitute within the diagonal block: */
+    for(int i = i0 + 1; i < i1; ++ i)
+      for(int k = i0; k < i; ++ k) {
+	T l = LU[i*lu_rs + k*lu_cs];
+	for(int j = 0; j < nrhs; ++ j)
+	  X[i*x_rs + j*x_cs] -= l*X[k*x_rs + j*x_cs];
+      }
+
+    /* Update the rows below the block: */
+    if(i1 < N) {
+      detail::gemm(N - i1, nrhs, i1 - i0, T(-1),
+	LU + i1*lu_rs + i0*lu_cs, lu_rs, lu_cs,
+	X + i0*x_rs, x_rs, x_cs, T(1), X + i1*x_rs, x_rs, x_cs);
+    }
+  }
+
+  /* Backward substitution with the upper triangle: */
+  for(int i1 = N; i1 > 0; i1 -= NB) {
+    int i0 = std::max(0, i1 - NB);
+
+    /* Substitute within the diagonal block: */
+    for(int i = i1 - 1; i >= i0; -- i) {
+      for(int k = i + 1; k < i1; ++ k) {
+	T u = LU[i*lu_rs + k*lu_cs];
+	for(int j = 0; j < nrhs; ++ j)
+	  X[i*x_rs + j*x_cs] -= u*X[k*x_rs + j*x_cs];
+      }
+      T d = LU[i*lu_rs + i*lu_cs];
+      for(int j = 0; j < nrhs; ++ j) X[i*x_rs + j*x_cs] /= d;
+    }
+
+    /* Update the rows above the block: */
+    if(i0 > 0) {
+      detail::gemm(i0, nrhs, i1 - i0, T(-1),
+	LU + i0*lu_cs, lu_rs, lu_cs,
+	X + i0*x_rs, x_rs, x_cs, T(1), X, x_rs, x_cs);
+    }
+  }
+}
+
 } // namespace detail
 } // namespace cml
 
@@ -0,0 +1,68 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_mat44_inverse_h
+#define	cml_matrix_detail_mat44_inverse_h
+
+#include <cml/common/simd.h>
+#include <cml/matrix/detail/mat44_product.h>
+
+namespace cml {
+namespace detail {
+
+/** Defines @c value as true if @c Sub can be inverted in place by
+ * mat44_inverse(): @c Sub must store its elements contiguously, and they
+ * must be float with SSE enabled, or double with AVX enabled.  The size of
+ * a dynamic-size matrix must be checked at run-time.
+ */
+template<class Sub> struct is_mat44_inverse_operand
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  static const bool value
+    =  (is_mat44_operand<Sub>::value || is_gemm_operand<Sub>::value)
+#if defined(CML_SIMD_AVX)
+    && (std::is_same<value_type, float>::value
+      || std::is_same<value_type, double>::value);
+#elif defined(CML_SIMD_SSE2)
+    && std::is_same<value_type, float>::value;
+#else
+    && false;
+#endif
+};
+
+#if defined(CML_SIMD_SSE2)
+/** Invert the 4x4 matrix stored as 16 contiguous elements at @c M, in
+ * place.  The inverse is computed from the four 2x2 blocks of @c M as the
+ * adjugate scaled by the reciprocal of the determinant, so the storage
+ * order does not matter: the inverse of the transpose is the transpose of
+ * the inverse.
+ *
+ * @note The result is unspecified if @c M is singular.
+ */
+inline void mat44_inverse(float* M);
+#endif
+
+#if defined(CML_SIMD_AVX)
+/** AVX 4x4 double-precision inverse.  There is no SSE2 version, since
+ * two-element vectors are no faster than the scalar inverse.
+ */
+inline void mat44_inverse(double* M);
+#endif
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_MAT44_INVERSE_TPP
+#include <cml/matrix/detail/mat44_inverse.tpp>
+#undef __CML_MATRIX_DETAIL_MAT44_INVERSE_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,224 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_MAT44_INVERSE_TPP
+#error "matrix/detail/mat44_inverse.tpp not included correctly"
+#endif
+
+#if defined(CML_SIMD_SSE2)
+
+namespace cml {
+namespace detail {
+namespace {
+
+/* In the single-precision kernel, each 2x2 block (a0 a1; a2 a3) is held in
+ * one register as (a0, a1, a2, a3).
+ */
+
+/** Return the 2x2 product A*B. */
+inline __m128
+mat22_mul(__m128 A, __m128 B)
+{
+  return _mm_add_ps(
+    _mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(3,0,3,0))),
+    _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2,3,0,1)),
+      _mm_shuffle_ps(B, B, _MM_SHUFFLE(1,2,1,2))));
+}
+
+/** Return the 2x2 product adj(A)*B. */
+inline __m128
+mat22_adj_mul(__m128 A, __m128 B)
+{
+  return _mm_sub_ps(
+    _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(0,0,3,3)), B),
+    _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2,2,1,1)),
+      _mm_shuffle_ps(B, B, _MM_SHUFFLE(1,0,3,2))));
+}
+
+/** Return the 2x2 product A*adj(B). */
+inline __m128
+mat22_mul_adj(__m128 A, __m128 B)
+{
+  return _mm_sub_ps(
+    _mm_mul_ps(A, _mm_shuffle_ps(B, B, _MM_SHUFFLE(0,3,0,3))),
+    _mm_mul_ps(_mm_shuffle_ps(A, A, _MM_SHUFFLE(2,3,0,1)),
+      _mm_shuffle_ps(B, B, _MM_SHUFFLE(1,2,1,2))));
+}
+
+#if defined(CML_SIMD_AVX)
+/* The double-precision kernel holds each 2x2 block in one AVX register,
+ * like the single-precision one.  Since AVX only shuffles within
+ * 128-bit lanes, the swizzles are built from in-lane permutes, swaps of
+ * the two lanes, and blends.
+ */
+
+/** Return (a2, a3, a0, a1). */
+inline __m256d
+mat22_swap(__m256d A)
+{
+  return _mm256_permute2f128_pd(A, A, 0x01);
+}
+
+/** Return the 2x2 product A*B. */
+inline __m256d
+mat22_mul(__m256d A, __m256d B)
+{
+  __m256d Bs = mat22_swap(B);
+  return _mm256_add_pd(
+    _mm256_mul_pd(A, _mm256_blend_pd(B, Bs, 0x6)),
+    _mm256_mul_pd(_mm256_permute_pd(A, 0x5), _mm256_blend_pd(B, Bs, 0x9)));
+}
+
+/** Return the 2x2 product adj(A)*B. */
+inline __m256d
+mat22_adj_mul(__m256d A, __m256d B)
+{
+  return _mm256_sub_pd(
+    _mm256_mul_pd(_mm256_permute_pd(mat22_swap(A), 0x3), B),
+    _mm256_mul_pd(_mm256_permute_pd(A, 0x3), mat22_swap(B)));
+}
+
+/** Return the 2x2 product A*adj(B). */
+inline __m256d
+mat22_mul_adj(__m256d A, __m256d B)
+{
+  __m256d Bs = mat22_swap(B);
+  return _mm256_sub_pd(
+    _mm256_mul_pd(A, _mm256_permute_pd(_mm256_blend_pd(B, Bs, 0x6), 0x5)),
+    _mm256_mul_pd(_mm256_permute_pd(A, 0x5), _mm256_blend_pd(B, Bs, 0x9)));
+}
+#endif
+
+} // namespace
+
+inline void
+mat44_inverse(float* M)
+{
+  __m128 r0 = _mm_loadu_ps(M);
+  __m128 r1 = _mm_loadu_ps(M + 4);
+  __m128 r2 = _mm_loadu_ps(M + 8);
+  __m128 r3 = _mm_loadu_ps(M + 12);
+
+  /* The 2x2 blocks of M = (A B; C D): */
+  __m128 A = _mm_movelh_ps(r0, r1);
+  __m128 B = _mm_movehl_ps(r1, r0);
+  __m128 C = _mm_movelh_ps(r2, r3);
+  __m128 D = _mm_movehl_ps(r3, r2);
+
+  /* The block determinants (|A|, |B|, |C|, |D|): */
+  __m128 det = _mm_sub_ps(
+    _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2,0,2,0)),
+      _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3,1,3,1))),
+    _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3,1,3,1)),
+      _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2,0,2,0))));
+  __m128 detA = _mm_shuffle_ps(det, det, _MM_SHUFFLE(0,0,0,0));
+  __m128 detB = _mm_shuffle_ps(det, det, _MM_SHUFFLE(1,1,1,1));
+  __m128 detC = _mm_shuffle_ps(det, det, _MM_SHUFFLE(2,2,2,2));
+  __m128 detD = _mm_shuffle_ps(det, det, _MM_SHUFFLE(3,3,3,3));
+
+  /* The adjugates of the blocks (X Y; Z W) of |M| * inverse(M): */
+  __m128 DC = mat22_adj_mul(D, C);
+  __m128 AB = mat22_adj_mul(A, B);
+  __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mat22_mul(B, DC));
+  __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mat22_mul(C, AB));
+  __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mat22_mul_adj(D, AB));
+  __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mat22_mul_adj(A, DC));
+
+  /* |M| = |A||D| + |B||C| - trace(adj(A)B adj(D)C): */
+  __m128 tr = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3,1,2,0)));
+  tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1,0,3,2)));
+  tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2,3,0,1)));
+  __m128 detM = _mm_sub_ps(
+    _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+  /* Scale by 1/|M| once, with the signs of the adjugate: */
+  __m128 rdetM = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+  X = _mm_mul_ps(X, rdetM);
+  Y = _mm_mul_ps(Y, rdetM);
+  Z = _mm_mul_ps(Z, rdetM);
+  W = _mm_mul_ps(W, rdetM);
+
+  /* Take the adjugates while storing the rows: */
+  _mm_storeu_ps(M, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1,3,1,3)));
+  _mm_storeu_ps(M + 4, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0,2,0,2)));
+  _mm_storeu_ps(M + 8, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1,3,1,3)));
+  _mm_storeu_ps(M + 12, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0,2,0,2)));
+}
+
+#if defined(CML_SIMD_AVX)
+inline void
+mat44_inverse(double* M)
+{
+  __m256d r0 = _mm256_loadu_pd(M);
+  __m256d r1 = _mm256_loadu_pd(M + 4);
+  __m256d r2 = _mm256_loadu_pd(M + 8);
+  __m256d r3 = _mm256_loadu_pd(M + 12);
+
+  /* The 2x2 blocks of M = (A B; C D): */
+  __m256d A = _mm256_permute2f128_pd(r0, r1, 0x20);
+  __m256d B = _mm256_permute2f128_pd(r0, r1, 0x31);
+  __m256d C = _mm256_permute2f128_pd(r2, r3, 0x20);
+  __m256d D = _mm256_permute2f128_pd(r2, r3, 0x31);
+
+  /* The block determinants, (|A|, |B|, -|A|, -|B|) and (|C|, |D|, -|C|,
+   * -|D|):
+   */
+  __m256d pAB = _mm256_mul_pd(_mm256_unpacklo_pd(A, B),
+    mat22_swap(_mm256_unpackhi_pd(A, B)));
+  __m256d pCD = _mm256_mul_pd(_mm256_unpacklo_pd(C, D),
+    mat22_swap(_mm256_unpackhi_pd(C, D)));
+  __m256d detAB = _mm256_sub_pd(pAB, mat22_swap(pAB));
+  __m256d detCD = _mm256_sub_pd(pCD, mat22_swap(pCD));
+  detAB = _mm256_permute2f128_pd(detAB, detAB, 0x00);
+  detCD = _mm256_permute2f128_pd(detCD, detCD, 0x00);
+  __m256d detA = _mm256_permute_pd(detAB, 0x0);
+  __m256d detB = _mm256_permute_pd(detAB, 0xf);
+  __m256d detC = _mm256_permute_pd(detCD, 0x0);
+  __m256d detD = _mm256_permute_pd(detCD, 0xf);
+
+  /* The adjugates of the blocks (X Y; Z W) of |M| * inverse(M): */
+  __m256d DC = mat22_adj_mul(D, C);
+  __m256d AB = mat22_adj_mul(A, B);
+  __m256d X = _mm256_sub_pd(_mm256_mul_pd(detD, A), mat22_mul(B, DC));
+  __m256d W = _mm256_sub_pd(_mm256_mul_pd(detA, D), mat22_mul(C, AB));
+  __m256d Y = _mm256_sub_pd(_mm256_mul_pd(detB, C), mat22_mul_adj(D, AB));
+  __m256d Z = _mm256_sub_pd(_mm256_mul_pd(detC, B), mat22_mul_adj(A, DC));
+
+  /* |M| = |A||D| + |B||C| - trace(adj(A)B adj(D)C): */
+  __m256d DCs = mat22_swap(DC);
+  __m256d tr = _mm256_mul_pd(AB, _mm256_blend_pd(
+      _mm256_unpacklo_pd(DC, DCs), _mm256_unpackhi_pd(DCs, DC), 0xc));
+  tr = _mm256_add_pd(tr, _mm256_permute_pd(tr, 0x5));
+  tr = _mm256_add_pd(tr, mat22_swap(tr));
+  __m256d detM = _mm256_sub_pd(
+    _mm256_add_pd(_mm256_mul_pd(detA, detD), _mm256_mul_pd(detB, detC)), tr);
+
+  /* Scale by 1/|M| once, with the signs of the adjugate: */
+  __m256d rdetM = _mm256_div_pd(_mm256_setr_pd(1., -1., -1., 1.), detM);
+  X = _mm256_mul_pd(X, rdetM);
+  Y = _mm256_mul_pd(Y, rdetM);
+  Z = _mm256_mul_pd(Z, rdetM);
+  W = _mm256_mul_pd(W, rdetM);
+
+  /* Take the adjugates while storing the rows: */
+  __m256d XYlo = _mm256_permute2f128_pd(X, Y, 0x20);
+  __m256d XYhi = _mm256_permute2f128_pd(X, Y, 0x31);
+  __m256d ZWlo = _mm256_permute2f128_pd(Z, W, 0x20);
+  __m256d ZWhi = _mm256_permute2f128_pd(Z, W, 0x31);
+  _mm256_storeu_pd(M, _mm256_shuffle_pd(XYhi, XYlo, 0xf));
+  _mm256_storeu_pd(M + 4, _mm256_shuffle_pd(XYhi, XYlo, 0x0));
+  _mm256_storeu_pd(M + 8, _mm256_shuffle_pd(ZWhi, ZWlo, 0xf));
+  _mm256_storeu_pd(M + 12, _mm256_shuffle_pd(ZWhi, ZWlo, 0x0));
+}
+#endif
+
+} // namespace detail
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
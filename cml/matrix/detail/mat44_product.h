@@ -0,0 +1,81 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_mat44_product_h
+#define	cml_matrix_detail_mat44_product_h
+
+#include <cml/common/simd.h>
+#include <cml/common/size_tags.h>
+#include <cml/matrix/detail/gemm.h>
+
+namespace cml {
+namespace detail {
+
+/** Defines @c value as true if @c Sub is a fixed-size 4x4 matrix of float
+ * or double stored in a single array accessible through data(), or false
+ * otherwise.
+ */
+template<class Sub, class Enable = void> struct is_mat44_operand
+{
+  static const bool value = false;
+};
+
+/** is_mat44_operand for matrices exposing data(). */
+template<class Sub>
+struct is_mat44_operand<Sub,
+  typename std::enable_if<has_contiguous_data<Sub>::value>::type>
+{
+  typedef cml::unqualified_type_t<Sub>			matrix_type;
+  typedef matrix_traits<matrix_type>			traits_type;
+  typedef typename traits_type::value_type		value_type;
+  typedef typename traits_type::size_tag		size_tag;
+
+  static const bool value
+    =  std::is_same<size_tag, fixed_size_tag>::value
+    && matrix_type::array_rows == 4 && matrix_type::array_cols == 4
+    && (std::is_same<value_type, float>::value
+      || std::is_same<value_type, double>::value);
+};
+
+/** Compute the 4x4 product @c C = @c A * @c B, where each matrix is stored
+ * as 16 contiguous elements in row-major order.  Column-major products can
+ * be computed by swapping @c A and @c B, since the transpose of the
+ * product is B^T * A^T.
+ *
+ * Each element of @c C is accumulated with one multiply and one add per
+ * term, in the same order as the generic matrix product, so the result is
+ * bit-for-bit identical to it.  The one exception is when the compiler is
+ * allowed to contract multiply-adds into fused multiply-adds (e.g.
+ * -ffp-contract=fast with FMA enabled), which may be applied differently
+ * to the two paths.  Each element then stays within 4*epsilon*sum_k
+ * |a(i,k)*b(k,j)| of the generic result.
+ *
+ * @note @c C must not overlap @c A or @c B.
+ */
+template<class T> inline void
+mat44_product(const T* A, const T* B, T* C);
+
+#if defined(CML_SIMD_SSE2)
+/** SSE 4x4 single-precision product. */
+inline void mat44_product(const float* A, const float* B, float* C);
+
+/** SSE2 or AVX 4x4 double-precision product. */
+inline void mat44_product(const double* A, const double* B, double* C);
+#endif
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_MAT44_PRODUCT_TPP
+#include <cml/matrix/detail/mat44_product.tpp>
+#undef __CML_MATRIX_DETAIL_MAT44_PRODUCT_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,92 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_MAT44_PRODUCT_TPP
+#error "matrix/detail/mat44_product.tpp not included correctly"
+#endif
+
+namespace cml {
+namespace detail {
+
+template<class T> inline void
+mat44_product(const T* A, const T* B, T* C)
+{
+  for(int i = 0; i < 4; ++ i, A += 4, C += 4) {
+    for(int j = 0; j < 4; ++ j) {
+      T c = A[0]*B[j];
+      c += A[1]*B[4 + j];
+      c += A[2]*B[8 + j];
+      c += A[3]*B[12 + j];
+      C[j] = c;
+    }
+  }
+}
+
+#if defined(CML_SIMD_SSE2)
+inline void
+mat44_product(const float* A, const float* B, float* C)
+{
+  /* Each row of C is a combination of the rows of B: */
+  __m128 b0 = _mm_loadu_ps(B);
+  __m128 b1 = _mm_loadu_ps(B + 4);
+  __m128 b2 = _mm_loadu_ps(B + 8);
+  __m128 b3 = _mm_loadu_ps(B + 12);
+  for(int i = 0; i < 4; ++ i, A += 4, C += 4) {
+    __m128 c = _mm_mul_ps(_mm_set1_ps(A[0]), b0);
+    c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(A[1]), b1));
+    c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(A[2]), b2));
+    c = _mm_add_ps(c, _mm_mul_ps(_mm_set1_ps(A[3]), b3));
+    _mm_storeu_ps(C, c);
+  }
+}
+
+#if defined(CML_SIMD_AVX)
+inline void
+mat44_product(const double* A, const double* B, double* C)
+{
+  /* Each row of C is a combination of the rows of B: */
+  __m256d b0 = _mm256_loadu_pd(B);
+  __m256d b1 = _mm256_loadu_pd(B + 4);
+  __m256d b2 = _mm256_loadu_pd(B + 8);
+  __m256d b3 = _mm256_loadu_pd(B + 12);
+  for(int i = 0; i < 4; ++ i, A += 4, C += 4) {
+    __m256d c = _mm256_mul_pd(_mm256_set1_pd(A[0]), b0);
+    c = _mm256_add_pd(c, _mm256_mul_pd(_mm256_set1_pd(A[1]), b1));
+    c = _mm256_add_pd(c, _mm256_mul_pd(_mm256_set1_pd(A[2]), b2));
+    c = _mm256_add_pd(c, _mm256_mul_pd(_mm256_set1_pd(A[3]), b3));
+    _mm256_storeu_pd(C, c);
+  }
+}
+#else
+inline void
+mat44_product(const double* A, const double* B, double* C)
+{
+  /* Each row of C is a combination of the rows of B, computed as two
+   * halves:
+   */
+  for(int h = 0; h < 4; h += 2) {
+    __m128d b0 = _mm_loadu_pd(B + h);
+    __m128d b1 = _mm_loadu_pd(B + 4 + h);
+    __m128d b2 = _mm_loadu_pd(B + 8 + h);
+    __m128d b3 = _mm_loadu_pd(B + 12 + h);
+    const double* a = A;
+    for(int i = 0; i < 4; ++ i, a += 4) {
+      __m128d c = _mm_mul_pd(_mm_set1_pd(a[0]), b0);
+      c = _mm_add_pd(c, _mm_mul_pd(_mm_set1_pd(a[1]), b1));
+      c = _mm_add_pd(c, _mm_mul_pd(_mm_set1_pd(a[2]), b2));
+      c = _mm_add_pd(c, _mm_mul_pd(_mm_set1_pd(a[3]), b3));
+      _mm_storeu_pd(C + 4*i + h, c);
+    }
+  }
+}
+#endif
+#endif
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
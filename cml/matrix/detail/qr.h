@@ -0,0 +1,68 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_qr_h
+#define	cml_matrix_detail_qr_h
+
+#include <cml/vector/fwd.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+
+/** Specializable class holding the blocking parameters for the Householder
+ * QR decomposition: @c nb is the number of reflectors generated per panel
+ * and applied together to the rest of the matrix.
+ */
+template<class Element> struct qr_blocking
+{
+  static const int nb = 64;
+};
+
+namespace detail {
+
+/** Unblocked Householder QR decomposition of the @c m x @c n matrix @c A,
+ * with @c m >= @c n, given as a pointer to its first element and its row
+ * and column strides.  On return, @c R is stored at and above the
+ * diagonal of @c A, and the vector @c v_k defining reflector @c k, H_k = I
+ * - @c tau[k] v_k v_k^T, is stored below the diagonal in column @c k; its
+ * first element is an implicit 1.
+ */
+template<class T> inline void
+qr_householder(int m, int n, T* A, int a_rs, int a_cs, T* tau);
+
+/** Blocked Householder QR decomposition, with the same result as
+ * qr_householder().  Each panel of qr_blocking<T>::nb columns is factored
+ * by qr_householder(), and its reflectors are applied to the trailing
+ * columns at once in the compact WY form I - V T V^T, using gemm().
+ */
+template<class T> inline void
+qr_blocked(int m, int n, T* A, int a_rs, int a_cs, T* tau);
+
+/** Overwrite @c x with Q^T @c x, where Q is defined by the reflectors
+ * stored in @c QR and @c tau as by qr_householder().  Q is not formed.
+ */
+template<class QRSub, class Tau, class XSub> inline void
+qr_apply_transpose(const readable_matrix<QRSub>& QR, const Tau& tau,
+  writable_vector<XSub>& x);
+
+/** Overwrite each column of @c X with Q^T times the column. */
+template<class QRSub, class Tau, class XSub> inline void
+qr_apply_transpose(const readable_matrix<QRSub>& QR, const Tau& tau,
+  writable_matrix<XSub>& X);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_QR_TPP
+#include <cml/matrix/detail/qr.tpp>
+#undef __CML_MATRIX_DETAIL_QR_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
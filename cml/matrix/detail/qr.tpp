@@ -0,0 +1,206 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_QR_TPP
+#error "matrix/detail/qr.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <cml/common/traits.h>
+#include <cml/common/mpl/int_c.h>
+#include <cml/matrix/detail/gemm.h>
+
+namespace cml {
+namespace detail {
+
+/** qr_householder() with column stride @c a_cs, which is int_c<1> for
+ * row-major storage so that the loops along the rows vectorize.
+ */
+template<class T, class Stride> inline void
+qr_householder(int m, int n, T* A, int a_rs, Stride a_cs, T* tau)
+{
+  typedef traits_of_t<T>				value_traits;
+
+  /* Each reflector is generated and applied in a single pass over the
+   * rows below it.  u[j] accumulates the products of column k below row k
+   * with the columns j >= k, so that u[k] is the squared norm needed to
+   * generate reflector k, and the other elements give v_k^T A before v_k
+   * is scaled.  The products for column 0 need a pass of their own:
+   */
+  std::vector<T> u(n, T(0)), w(n);
+  for(int i = 1; i < m; ++ i) {
+    const T* ai = A + i*a_rs;
+    T c = ai[0];
+    for(int j = 0; j < n; ++ j) u[j] += c*ai[j*a_cs];
+  }
+
+  for(int k = 0; k < n; ++ k) {
+    T* ak = A + k*a_rs;
+
+    /* Generate the reflector zeroing A(k+1:m,k); if the column is already
+     * zero below the diagonal, H_k = I:
+     */
+    T alpha = ak[k*a_cs], xnorm2 = u[k], scale(0);
+    tau[k] = T(0);
+    if(xnorm2 != T(0)) {
+      T beta = value_traits::sqrt(alpha*alpha + xnorm2);
+      if(alpha > T(0)) beta = - beta;
+      tau[k] = (beta - alpha)/beta;
+      scale = T(1)/(alpha - beta);
+      ak[k*a_cs] = beta;
+    }
+
+    /* w = tau v_k^T A(k:m,k+1:n), with v_k(k) = 1: */
+    for(int j = k+1; j < n; ++ j) {
+      w[j] = tau[k]*(ak[j*a_cs] + scale*u[j]);
+      ak[j*a_cs] -= w[j];
+      u[j] = T(0);
+    }
+
+    /* Scale v_k, apply H_k to the rows below k, and accumulate the
+     * products for column k+1 from the updated rows:
+     */
+    if(k+1 < m) {
+      T* ai = A + (k+1)*a_rs;
+      T v = (ai[k*a_cs] *= scale);
+      for(int j = k+1; j < n; ++ j) ai[j*a_cs] -= v*w[j];
+    }
+    for(int i = k+2; i < m; ++ i) {
+      T* ai = A + i*a_rs;
+      T v = (ai[k*a_cs] *= scale);
+      T c = (k+1 < n) ? ai[(k+1)*a_cs] - v*w[k+1] : T(0);
+      for(int j = k+1; j < n; ++ j) {
+	T a = ai[j*a_cs] - v*w[j];
+	ai[j*a_cs] = a;
+	u[j] += c*a;
+      }
+    }
+  }
+}
+
+template<class T> inline void
+qr_householder(int m, int n, T* A, int a_rs, int a_cs, T* tau)
+{
+  if(n == 0) return;
+  if(a_cs == 1)
+    detail::qr_householder(m, n, A, a_rs, int_c<1>(), tau);
+  else
+    detail::qr_householder<T, int>(m, n, A, a_rs, a_cs, tau);
+}
+
+/** Apply the transpose of the block reflector H_0 ... H_nb-1 = I - V T V^T
+ * to the @c m x @c nt matrix @c C, where the @c m x @c nb matrix @c Y
+ * holds the reflectors as stored by qr_householder().
+ */
+template<class T> inline void
+qr_apply_block(int m, int nb, int nt, const T* Y, const T* tau,
+  T* C, int a_rs, int a_cs)
+{
+  /* Row-major buffers for the explicit reflectors V, V^T V, the
+   * triangular factor T, and W = T^T V^T C:
+   */
+  std::vector<T> V(std::size_t(m)*nb), G(nb*nb), Tf(nb*nb);
+  std::vector<T> W(std::size_t(nb)*nt);
+
+  /* Copy the reflectors to V, with their implicit unit diagonal: */
+  for(int i = 0; i < m; ++ i)
+    for(int j = 0; j < nb; ++ j)
+      V[i*nb + j] = (i > j) ? Y[i*a_rs + j*a_cs] : T(i == j);
+
+  /* Form the upper triangular T such that H_0 ... H_nb-1 = I - V T V^T,
+   * column by column from G = V^T V:
+   */
+  detail::gemm(nb, nb, m, T(1),
+    V.data(), 1, nb, V.data(), nb, 1, T(0), G.data(), nb, 1);
+  for(int i = 0; i < nb; ++ i) {
+    for(int r = 0; r < i; ++ r) {
+      T s(0);
+      for(int c = r; c < i; ++ c) s += Tf[r*nb + c]*G[c*nb + i];
+      Tf[r*nb + i] = - tau[i]*s;
+    }
+    Tf[i*nb + i] = tau[i];
+  }
+
+  /* C -= V T^T V^T C: */
+  detail::gemm(nb, nt, m, T(1),
+    V.data(), 1, nb, C, a_rs, a_cs, T(0), W.data(), nt, 1);
+  for(int r = nb-1; r >= 0; -- r) {
+    T* wr = W.data() + r*nt;
+    T trr = Tf[r*nb + r];
+    for(int j = 0; j < nt; ++ j) wr[j] *= trr;
+    for(int c = 0; c < r; ++ c) {
+      T tcr = Tf[c*nb + r];
+      const T* wc = W.data() + c*nt;
+      for(int j = 0; j < nt; ++ j) wr[j] += tcr*wc[j];
+    }
+  }
+  detail::gemm(m, nt, nb, T(-1),
+    V.data(), nb, 1, W.data(), nt, 1, T(1), C, a_rs, a_cs);
+}
+
+template<class T> inline void
+qr_blocked(int m, int n, T* A, int a_rs, int a_cs, T* tau)
+{
+  static const int NB = qr_blocking<T>::nb;
+
+  for(int j0 = 0; j0 < n; j0 += NB) {
+    int nb = std::min(NB, n - j0), j1 = j0 + nb;
+    T* panel = A + j0*a_rs + j0*a_cs;
+
+    /* Factor the panel, then apply its reflectors to the trailing
+     * columns:
+     */
+    detail::qr_householder(m - j0, nb, panel, a_rs, a_cs, tau + j0);
+    if(j1 < n) detail::qr_apply_block(
+      m - j0, nb, n - j1, panel, tau + j0, panel + nb*a_cs, a_rs, a_cs);
+  }
+}
+
+template<class QRSub, class Tau, class XSub> inline void
+qr_apply_transpose(const readable_matrix<QRSub>& QR, const Tau& tau,
+  writable_vector<XSub>& x)
+{
+  int m = QR.rows(), n = QR.cols();
+  for(int k = 0; k < n; ++ k) {
+    if(tau[k] == 0) continue;
+    auto s = x.get(k);
+    for(int i = k+1; i < m; ++ i) s += QR(i,k)*x.get(i);
+    s *= tau[k];
+    x.put(k, x.get(k) - s);
+    for(int i = k+1; i < m; ++ i) x.put(i, x.get(i) - s*QR(i,k));
+  }
+}
+
+template<class QRSub, class Tau, class XSub> inline void
+qr_apply_transpose(const readable_matrix<QRSub>& QR, const Tau& tau,
+  writable_matrix<XSub>& X)
+{
+  typedef value_type_trait_of_t<XSub>			value_type;
+
+  int m = QR.rows(), n = QR.cols(), M = X.cols();
+  std::vector<value_type> w(M);
+  for(int k = 0; k < n; ++ k) {
+    if(tau[k] == 0) continue;
+    for(int j = 0; j < M; ++ j) w[j] = X.get(k,j);
+    for(int i = k+1; i < m; ++ i) {
+      auto v = QR(i,k);
+      for(int j = 0; j < M; ++ j) w[j] += v*X.get(i,j);
+    }
+    for(int j = 0; j < M; ++ j) w[j] *= tau[k];
+    for(int j = 0; j < M; ++ j) X.put(k,j, X.get(k,j) - w[j]);
+    for(int i = k+1; i < m; ++ i) {
+      auto v = QR(i,k);
+      for(int j = 0; j < M; ++ j) X.put(i,j, X.get(i,j) - v*w[j]);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,64 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_relayout_h
+#define	cml_matrix_detail_relayout_h
+
+#include <algorithm>
+#include <cml/common/layout_tags.h>
+
+namespace cml {
+namespace detail {
+
+/** Return the number of rows of a dense row-major array. */
+inline int array_lines(int rows, int, row_major) { return rows; }
+
+/** Return the number of columns of a dense column-major array. */
+inline int array_lines(int, int cols, col_major) { return cols; }
+
+/** Return the distance between rows of a dense row-major array. */
+inline int array_stride(int, int cols, row_major) { return cols; }
+
+/** Return the distance between columns of a dense column-major array. */
+inline int array_stride(int rows, int, col_major) { return rows; }
+
+/** Change the distance between the first @c lines rows or columns of the
+ * dense array @c data from @c from_stride to @c to_stride in place,
+ * keeping the first @c count elements of each.  Lines are moved in an
+ * order that never overwrites elements that have not been moved yet.
+ *
+ * @note @c count must be no larger than @c from_stride or @c to_stride.
+ * @c data may be null if @c lines or @c count is 0.
+ */
+template<class Pointer> inline void relayout(
+  Pointer data, int lines, int count, int from_stride, int to_stride
+  )
+{
+  /* Nothing moves if there is no array, or at most one line to keep: */
+  if(data == nullptr || lines < 2 || count < 1) return;
+
+  if(to_stride > from_stride) {
+    for(int k = lines - 1; k > 0; -- k) {
+      Pointer src = data + k*from_stride;
+      std::copy_backward(src, src + count, data + k*to_stride + count);
+    }
+  } else if(to_stride < from_stride) {
+    for(int k = 1; k < lines; ++ k) {
+      Pointer src = data + k*from_stride;
+      std::copy(src, src + count, data + k*to_stride);
+    }
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
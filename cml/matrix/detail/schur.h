@@ -0,0 +1,82 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_schur_h
+#define	cml_matrix_detail_schur_h
+
+#include <cml/common/mpl/int_c.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+namespace detail {
+
+/** The largest residual ||M X - I||_F of an inverse X accepted by
+ * schur_inverse(), in units of epsilon ||M||_inf ||X||_inf.  LU
+ * decomposition with partial pivoting keeps max |M X - I| within about
+ * epsilon ||M||_inf ||M^-1||_inf, and the Frobenius norm covers the
+ * rounding of the residual itself for well-conditioned matrices.
+ */
+const int schur_max_residual = 2;
+
+/** The largest ratio accepted by schur_determinant() between its
+ * first-order estimate of the relative error of det(A) det(S), in units of
+ * epsilon, and the lower bound ||M||_F ||S^-1||_F on the condition number
+ * of the whole matrix.  Matrices above this ratio are rejected, so that the
+ * caller can fall back to LU decomposition with partial pivoting, whose
+ * error is proportional to the condition number.  The value keeps the
+ * error of the accepted determinants within that of the LU path on random
+ * matrices.
+ */
+const int schur_max_det_error = 64;
+
+/* The closed-form inverses of the blocks, defined in detail/inverse.h: */
+template<class Sub> void inverse(writable_matrix<Sub>& M, int_c<2>);
+template<class Sub> void inverse(writable_matrix<Sub>& M, int_c<3>);
+template<class Sub> void inverse(writable_matrix<Sub>& M, int_c<4>);
+
+/** Invert the statically-sized @c N x @c N matrix @c M in place, where @c
+ * N = @c P + @c Q, by partitioning it into blocks [A B; C D] with A @c P x
+ * @c P, and inverting A and the Schur complement S = D - C A^-1 B with the
+ * closed-form 2x2, 3x3 and 4x4 inverses.  The blocks are held in local
+ * fixed-size matrices, so the block products are fully unrolled.
+ *
+ * The elimination does not pivot, so the result X is accepted only if the
+ * residual M X - I is within the bound given by schur_max_residual.
+ *
+ * @returns false, leaving @c M unchanged, if A or S is singular, or if the
+ * residual is too large.
+ */
+template<class Sub, int P, int Q> bool
+schur_inverse(writable_matrix<Sub>& M, int_c<P>, int_c<Q>);
+
+/** Compute the determinant of the statically-sized matrix @c M as det(A)
+ * det(S), using the blocks of schur_inverse().
+ *
+ * @returns false if A or S is singular, or if the estimated error exceeds
+ * the bound given by schur_max_det_error, in which case @c det is
+ * unspecified.
+ */
+template<class Sub, int P, int Q, class T> bool
+schur_determinant(const readable_matrix<Sub>& M, int_c<P>, int_c<Q>, T& det);
+
+} // namespace detail
+} // namespace cml
+
+/* The block determinants are defined in detail/determinant.h, which uses
+ * schur_determinant():
+ */
+#include <cml/matrix/detail/determinant.h>
+
+#define __CML_MATRIX_DETAIL_SCHUR_TPP
+#include <cml/matrix/detail/schur.tpp>
+#undef __CML_MATRIX_DETAIL_SCHUR_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,213 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_SCHUR_TPP
+#error "matrix/detail/schur.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cml/common/traits.h>
+#include <cml/storage/compiled_selector.h>
+#include <cml/matrix/matrix.h>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Return the square of the Frobenius norm of @c A. */
+template<class Matrix> inline auto
+frobenius_norm2(const Matrix& A) -> value_type_of_t<Matrix>
+{
+  value_type_of_t<Matrix> s(0);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j) s += A(i,j)*A(i,j);
+  return s;
+}
+
+/** Return the infinity norm (largest row sum) of @c A. */
+template<class Matrix> inline auto
+infinity_norm(const Matrix& A) -> value_type_of_t<Matrix>
+{
+  value_type_of_t<Matrix> n(0);
+  for(int i = 0; i < A.rows(); ++ i) {
+    value_type_of_t<Matrix> s(0);
+    for(int j = 0; j < A.cols(); ++ j) s += std::abs(A(i,j));
+    n = std::max(n, s);
+  }
+  return n;
+}
+
+} // namespace
+
+/** The blocks of an @c N x @c N matrix partitioned as [A B; C D], where A
+ * is @c P x @c P and @c N = @c P + @c Q.  factor() replaces A by its
+ * inverse and D by the inverse of the Schur complement S = D - C A^-1 B,
+ * and X holds A^-1 B.  The squared Frobenius norms of the blocks are
+ * kept for the error estimate of schur_determinant().
+ */
+template<class T, int P, int Q> struct schur_blocks
+{
+  matrix<T, compiled<P,P>>	A;
+  matrix<T, compiled<P,Q>>	B, X;
+  matrix<T, compiled<Q,P>>	C;
+  matrix<T, compiled<Q,Q>>	D;
+  T				detA, detS;
+  T				normA, normB, normC, normD, normAi, normSi;
+
+  template<class Sub> explicit schur_blocks(const readable_matrix<Sub>& M)
+  {
+    for(int i = 0; i < P; ++ i) {
+      for(int j = 0; j < P; ++ j) A(i,j) = M.get(i,j);
+      for(int j = 0; j < Q; ++ j) B(i,j) = M.get(i,P+j);
+    }
+    for(int i = 0; i < Q; ++ i) {
+      for(int j = 0; j < P; ++ j) C(i,j) = M.get(P+i,j);
+      for(int j = 0; j < Q; ++ j) D(i,j) = M.get(P+i,P+j);
+    }
+    normA = frobenius_norm2(A);
+    normB = frobenius_norm2(B);
+    normC = frobenius_norm2(C);
+    normD = frobenius_norm2(D);
+  }
+
+  /** Invert A and S, returning false if either is singular. */
+  bool factor()
+  {
+    detA = detail::determinant(A, int_c<P>());
+    if(detA == T(0)) return false;
+    detail::inverse(A, int_c<P>());
+    normAi = frobenius_norm2(A);
+
+    for(int i = 0; i < P; ++ i)
+      for(int j = 0; j < Q; ++ j) {
+	T s(0);
+	for(int k = 0; k < P; ++ k) s += A(i,k)*B(k,j);
+	X(i,j) = s;
+      }
+
+    for(int i = 0; i < Q; ++ i)
+      for(int j = 0; j < Q; ++ j) {
+	T s(0);
+	for(int k = 0; k < P; ++ k) s += C(i,k)*X(k,j);
+	D(i,j) -= s;
+      }
+
+    detS = detail::determinant(D, int_c<Q>());
+    if(detS == T(0)) return false;
+    detail::inverse(D, int_c<Q>());
+    normSi = frobenius_norm2(D);
+    return true;
+  }
+};
+
+template<class Sub, int P, int Q> inline bool
+schur_inverse(writable_matrix<Sub>& M, int_c<P>, int_c<Q>)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  const int N = P + Q;
+
+  schur_blocks<value_type, P, Q> blocks(M);
+  if(!blocks.factor()) return false;
+  const auto& Ai = blocks.A;
+  const auto& C = blocks.C;
+  const auto& X = blocks.X;
+  const auto& Si = blocks.D;
+
+  /* Y = C A^-1: */
+  matrix<value_type, compiled<Q,P>> Y;
+  for(int i = 0; i < Q; ++ i)
+    for(int j = 0; j < P; ++ j) {
+      value_type s(0);
+      for(int k = 0; k < P; ++ k) s += C(i,k)*Ai(k,j);
+      Y(i,j) = s;
+    }
+
+  /* Z = M^-1 = [A^-1 + X S^-1 Y, -X S^-1; -S^-1 Y, S^-1]: */
+  matrix<value_type, compiled<N,N>> Z;
+  matrix<value_type, compiled<P,Q>> XS;
+  for(int i = 0; i < P; ++ i)
+    for(int j = 0; j < Q; ++ j) {
+      value_type s(0);
+      for(int k = 0; k < Q; ++ k) s += X(i,k)*Si(k,j);
+      XS(i,j) = s;
+      Z(i,P+j) = - s;
+    }
+  for(int i = 0; i < P; ++ i)
+    for(int j = 0; j < P; ++ j) {
+      value_type s = Ai(i,j);
+      for(int k = 0; k < Q; ++ k) s += XS(i,k)*Y(k,j);
+      Z(i,j) = s;
+    }
+  for(int i = 0; i < Q; ++ i) {
+    for(int j = 0; j < P; ++ j) {
+      value_type s(0);
+      for(int k = 0; k < Q; ++ k) s -= Si(i,k)*Y(k,j);
+      Z(P+i,j) = s;
+    }
+    for(int j = 0; j < Q; ++ j) Z(P+i,P+j) = Si(i,j);
+  }
+
+  /* Reject Z unless ||M Z - I||_F is within schur_max_residual times
+   * epsilon ||M||_inf ||Z||_inf, which also rejects non-finite results.
+   * The rows of M Z are accumulated in local arrays so that the product
+   * vectorizes:
+   */
+  value_type W[N][N], R[N], normW(0), residual(0);
+  for(int i = 0; i < N; ++ i) {
+    value_type s(0);
+    for(int j = 0; j < N; ++ j) {
+      W[i][j] = M.get(i,j);
+      s += std::abs(W[i][j]);
+    }
+    normW = std::max(normW, s);
+  }
+  for(int i = 0; i < N; ++ i) {
+    for(int j = 0; j < N; ++ j) R[j] = value_type(i == j ? -1 : 0);
+    for(int k = 0; k < N; ++ k)
+      for(int j = 0; j < N; ++ j) R[j] += W[i][k]*Z(k,j);
+    for(int j = 0; j < N; ++ j) residual += R[j]*R[j];
+  }
+  value_type limit = std::numeric_limits<value_type>::epsilon()
+    *normW*infinity_norm(Z)*value_type(schur_max_residual);
+  if(!(residual <= limit*limit)) return false;
+
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) M.put(i,j, Z(i,j));
+  return true;
+}
+
+template<class Sub, int P, int Q, class T> inline bool
+schur_determinant(const readable_matrix<Sub>& M, int_c<P>, int_c<Q>, T& det)
+{
+  schur_blocks<T, P, Q> blocks(M);
+  if(!blocks.factor()) return false;
+
+  /* First-order relative error of det(A) det(S), in units of epsilon,
+   * from the error of A^-1 propagated through S:
+   */
+  T kappaA = std::sqrt(blocks.normA*blocks.normAi);
+  T error = kappaA + std::sqrt(blocks.normSi)*(
+    kappaA*std::sqrt(blocks.normC*blocks.normAi*blocks.normB)
+    + std::sqrt(blocks.normD));
+
+  /* Reject the matrix if the error is too large relative to the lower
+   * bound ||M||_F ||S^-1||_F on its condition number:
+   */
+  T normM = blocks.normA + blocks.normB + blocks.normC + blocks.normD;
+  if(!(error <= T(schur_max_det_error)*std::sqrt(normM*blocks.normSi)))
+    return false;
+
+  det = blocks.detA*blocks.detS;
+  return true;
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,43 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_strassen_h
+#define	cml_matrix_detail_strassen_h
+
+#include <cml/matrix/detail/gemm.h>
+
+namespace cml {
+namespace detail {
+
+/** Compute the @c m x @c n product @c C = @c A * @c B using the
+ * Strassen-Winograd recursion, with the same pointer and stride
+ * conventions as gemm().  Each level splits the operands into 2x2 blocks,
+ * and computes their product using 7 recursive products and 15 additions,
+ * storing intermediate results in @c C and two temporaries.  Odd
+ * dimensions are handled by peeling the last row or column and updating
+ * it with gemm().  Products with a dimension smaller than @c cutoff are
+ * computed directly by gemm().
+ *
+ * @note @c C must not overlap @c A or @c B.
+ */
+template<class T> inline void strassen(int m, int n, int k,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T* C, int c_rs, int c_cs, int cutoff);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_STRASSEN_TPP
+#include <cml/matrix/detail/strassen.tpp>
+#undef __CML_MATRIX_DETAIL_STRASSEN_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,143 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_STRASSEN_TPP
+#error "matrix/detail/strassen.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <algorithm>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Compute the @c m x @c n sum @c Z = @c X + @c Y.  @c Z may be @c X or
+ * @c Y.
+ */
+template<class T> inline void
+strassen_add(int m, int n,
+  const T* X, int x_rs, int x_cs, const T* Y, int y_rs, int y_cs,
+  T* Z, int z_rs, int z_cs)
+{
+  for(int i = 0; i < m; ++ i)
+    for(int j = 0; j < n; ++ j)
+      Z[i*z_rs + j*z_cs] = X[i*x_rs + j*x_cs] + Y[i*y_rs + j*y_cs];
+}
+
+/** Compute the @c m x @c n difference @c Z = @c X - @c Y.  @c Z may be @c
+ * X or @c Y.
+ */
+template<class T> inline void
+strassen_sub(int m, int n,
+  const T* X, int x_rs, int x_cs, const T* Y, int y_rs, int y_cs,
+  T* Z, int z_rs, int z_cs)
+{
+  for(int i = 0; i < m; ++ i)
+    for(int j = 0; j < n; ++ j)
+      Z[i*z_rs + j*z_cs] = X[i*x_rs + j*x_cs] - Y[i*y_rs + j*y_cs];
+}
+
+} // namespace
+
+template<class T> inline void strassen(int m, int n, int k,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T* C, int c_rs, int c_cs, int cutoff)
+{
+  /* Each half must be at least 1: */
+  cutoff = std::max(cutoff, 2);
+  if(m < cutoff || n < cutoff || k < cutoff) {
+    detail::gemm(m, n, k, A, a_rs, a_cs, B, b_rs, b_cs, C, c_rs, c_cs);
+    return;
+  }
+
+  /* Sizes of the 2x2 blocks of the even part of the product: */
+  int mh = m/2, nh = n/2, kh = k/2;
+
+  const T* A11 = A;
+  const T* A12 = A + kh*a_cs;
+  const T* A21 = A + mh*a_rs;
+  const T* A22 = A + mh*a_rs + kh*a_cs;
+  const T* B11 = B;
+  const T* B12 = B + nh*b_cs;
+  const T* B21 = B + kh*b_rs;
+  const T* B22 = B + kh*b_rs + nh*b_cs;
+  T* C11 = C;
+  T* C12 = C + nh*c_cs;
+  T* C21 = C + mh*c_rs;
+  T* C22 = C + mh*c_rs + nh*c_cs;
+
+  /* Row-major temporaries holding the sums of blocks of A (mh x kh), or
+   * of a product (mh x nh), and the sums of blocks of B (kh x nh):
+   */
+  int x_rs = std::max(kh, nh), y_rs = nh;
+  std::vector<T> x_buffer(std::size_t(mh)*x_rs);
+  std::vector<T> y_buffer(std::size_t(kh)*y_rs);
+  T* X = x_buffer.data();
+  T* Y = y_buffer.data();
+
+  /* The Winograd schedule: */
+  strassen_sub(mh, kh, A11, a_rs, a_cs, A21, a_rs, a_cs, X, x_rs, 1);
+  strassen_sub(kh, nh, B22, b_rs, b_cs, B12, b_rs, b_cs, Y, y_rs, 1);
+  detail::strassen(mh, nh, kh,
+    X, x_rs, 1, Y, y_rs, 1, C21, c_rs, c_cs, cutoff);		// P7
+
+  strassen_add(mh, kh, A21, a_rs, a_cs, A22, a_rs, a_cs, X, x_rs, 1);
+  strassen_sub(kh, nh, B12, b_rs, b_cs, B11, b_rs, b_cs, Y, y_rs, 1);
+  detail::strassen(mh, nh, kh,
+    X, x_rs, 1, Y, y_rs, 1, C22, c_rs, c_cs, cutoff);		// P5
+
+  strassen_sub(mh, kh, X, x_rs, 1, A11, a_rs, a_cs, X, x_rs, 1);
+  strassen_sub(kh, nh, B22, b_rs, b_cs, Y, y_rs, 1, Y, y_rs, 1);
+  detail::strassen(mh, nh, kh,
+    X, x_rs, 1, Y, y_rs, 1, C12, c_rs, c_cs, cutoff);		// P6
+
+  strassen_sub(mh, kh, A12, a_rs, a_cs, X, x_rs, 1, X, x_rs, 1);
+  detail::strassen(mh, nh, kh,
+    X, x_rs, 1, B22, b_rs, b_cs, C11, c_rs, c_cs, cutoff);	// P3
+
+  detail::strassen(mh, nh, kh,
+    A11, a_rs, a_cs, B11, b_rs, b_cs, X, x_rs, 1, cutoff);	// P1
+
+  strassen_add(mh, nh, X, x_rs, 1, C12, c_rs, c_cs, C12, c_rs, c_cs);
+  strassen_add(mh, nh, C12, c_rs, c_cs, C21, c_rs, c_cs, C21, c_rs, c_cs);
+  strassen_add(mh, nh, C12, c_rs, c_cs, C22, c_rs, c_cs, C12, c_rs, c_cs);
+  strassen_add(mh, nh, C21, c_rs, c_cs, C22, c_rs, c_cs, C22, c_rs, c_cs);
+  strassen_add(mh, nh, C12, c_rs, c_cs, C11, c_rs, c_cs, C12, c_rs, c_cs);
+
+  strassen_sub(kh, nh, Y, y_rs, 1, B21, b_rs, b_cs, Y, y_rs, 1);
+  detail::strassen(mh, nh, kh,
+    A22, a_rs, a_cs, Y, y_rs, 1, C11, c_rs, c_cs, cutoff);	// P4
+  strassen_sub(mh, nh, C21, c_rs, c_cs, C11, c_rs, c_cs, C21, c_rs, c_cs);
+
+  detail::strassen(mh, nh, kh,
+    A12, a_rs, a_cs, B21, b_rs, b_cs, C11, c_rs, c_cs, cutoff);	// P2
+  strassen_add(mh, nh, X, x_rs, 1, C11, c_rs, c_cs, C11, c_rs, c_cs);
+
+  /* Peel the odd row and column of the product, and the odd column of A
+   * and row of B:
+   */
+  int m2 = 2*mh, n2 = 2*nh, k2 = 2*kh;
+  if(k2 < k) {
+    detail::gemm(m2, n2, 1, T(1), A + k2*a_cs, a_rs, a_cs,
+      B + k2*b_rs, b_rs, b_cs, T(1), C, c_rs, c_cs);
+  }
+  if(n2 < n) {
+    detail::gemm(m, 1, k, A, a_rs, a_cs,
+      B + n2*b_cs, b_rs, b_cs, C + n2*c_cs, c_rs, c_cs);
+  }
+  if(m2 < m) {
+    detail::gemm(1, n2, k, A + m2*a_rs, a_rs, a_cs,
+      B, b_rs, b_cs, C + m2*c_rs, c_rs, c_cs);
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
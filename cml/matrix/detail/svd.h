@@ -0,0 +1,101 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_detail_svd_h
+#define	cml_matrix_detail_svd_h
+
+#include <array>
+#include <vector>
+#include <cml/common/mpl/int_c.h>
+
+namespace cml {
+namespace detail {
+
+/** Maximum number of sweeps taken by svd_jacobi() when the sweep count is
+ * not given.  Convergence is quadratic, so well-scaled matrices need 5 to
+ * 10 sweeps.
+ */
+const int svd_max_sweeps = 32;
+
+/** Scratch space for the SVD of an @c R x @c C matrix.  @c W holds the
+ * matrix in column-major order, @c V the @c C x @c C right singular
+ * vectors in column-major order, and @c s the singular values.  rows() and
+ * cols() return int_c<> constants, so every loop of svd_jacobi() has
+ * compile-time bounds.
+ */
+template<class T, int R, int C> struct svd_workspace
+{
+  typedef T					value_type;
+
+  std::array<T, R*C>		W;
+  std::array<T, C*C>		V;
+  std::array<T, C>		s;
+
+  svd_workspace(int, int) {}
+  int_c<R> rows() const { return int_c<R>(); }
+  int_c<C> cols() const { return int_c<C>(); }
+};
+
+/** Scratch space for the SVD of a dynamic-size matrix. */
+template<class T> struct svd_workspace<T, -1, -1>
+{
+  typedef T					value_type;
+
+  std::vector<T>		W;
+  std::vector<T>		V;
+  std::vector<T>		s;
+
+  svd_workspace(int m, int n) : W(std::size_t(m)*n), V(std::size_t(n)*n),
+    s(n), m_rows(m), m_cols(n) {}
+  int rows() const { return m_rows; }
+  int cols() const { return m_cols; }
+
+  private:
+
+  int				m_rows, m_cols;
+};
+
+/** Compute the singular values of the @c m x @c n column-major array @c
+ * W, where @c m >= @c n, by one-sided (Hestenes) Jacobi rotations applied
+ * to pairs of columns until they are mutually orthogonal.  On return, @c
+ * W holds U diag(s), and @c s the column norms of @c W, in decreasing
+ * order with the columns of @c W permuted to match.  If @c V is not null,
+ * the rotations are accumulated into the @c n x @c n column-major array @c
+ * V, which becomes the right singular vectors.
+ *
+ * If @c sweeps is positive, exactly that many sweeps over all column pairs
+ * are taken, for a latency that does not depend on the input.  Otherwise,
+ * iteration stops after the first sweep that rotates nothing, or after
+ * svd_max_sweeps sweeps.  @c m and @c n are either ints, or int_c<>
+ * constants.
+ *
+ * @returns the number of sweeps taken.
+ */
+template<class T, class Rows, class Cols> int
+svd_jacobi(Rows m, Cols n, T* W, T* V, T* s, int sweeps);
+
+/** Scale the columns of the @c m x @c n column-major array @c W returned
+ * by svd_jacobi() by the reciprocals of the singular values @c s, to form
+ * the left singular vectors U.  Columns whose singular value is negligible
+ * relative to @c s[0] are replaced by unit vectors orthogonal to the
+ * previous ones, so that U always has orthonormal columns.
+ */
+template<class T, class Rows, class Cols> void
+svd_normalize(Rows m, Cols n, T* W, const T* s);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_MATRIX_DETAIL_SVD_TPP
+#include <cml/matrix/detail/svd.tpp>
+#undef __CML_MATRIX_DETAIL_SVD_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,143 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DETAIL_SVD_TPP
+#error "matrix/detail/svd.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace cml {
+namespace detail {
+
+template<class T, class Rows, class Cols> inline int
+svd_jacobi(Rows m, Cols n, T* W, T* V, T* s, int sweeps)
+{
+  const T eps = std::numeric_limits<T>::epsilon();
+
+  if(V) {
+    for(int j = 0; j < n; ++ j)
+      for(int i = 0; i < n; ++ i) V[j*n + i] = T(i == j ? 1 : 0);
+  }
+
+  int max_sweeps = (sweeps > 0) ? sweeps : svd_max_sweeps;
+  int sweep = 0;
+  while(sweep < max_sweeps) {
+    bool rotated = false;
+    for(int p = 0; p < n-1; ++ p) {
+      T* wp = W + p*m;
+      for(int q = p+1; q < n; ++ q) {
+	T* wq = W + q*m;
+
+	/* The 2x2 Gram matrix of columns p and q: */
+	T a(0), b(0), g(0);
+	for(int i = 0; i < m; ++ i) {
+	  a += wp[i]*wp[i];
+	  b += wq[i]*wq[i];
+	  g += wp[i]*wq[i];
+	}
+
+	/* Skip the pair if it is already orthogonal to working precision,
+	 * which includes zero columns:
+	 */
+	if(std::abs(g) <= eps*std::sqrt(a*b)) continue;
+	rotated = true;
+
+	/* The rotation diagonalizing the Gram matrix, with |t| <= 1: */
+	T zeta = (b - a)/(T(2)*g);
+	T t = T(1)/(std::abs(zeta) + std::sqrt(T(1) + zeta*zeta));
+	if(zeta < T(0)) t = - t;
+	T c = T(1)/std::sqrt(T(1) + t*t), sn = c*t;
+
+	for(int i = 0; i < m; ++ i) {
+	  T x = wp[i], y = wq[i];
+	  wp[i] = c*x - sn*y;
+	  wq[i] = sn*x + c*y;
+	}
+	if(V) {
+	  T* vp = V + p*n;
+	  T* vq = V + q*n;
+	  for(int i = 0; i < n; ++ i) {
+	    T x = vp[i], y = vq[i];
+	    vp[i] = c*x - sn*y;
+	    vq[i] = sn*x + c*y;
+	  }
+	}
+      }
+    }
+    ++ sweep;
+    if(sweeps <= 0 && !rotated) break;
+  }
+
+  /* The singular values are the column norms: */
+  for(int j = 0; j < n; ++ j) {
+    T ss(0);
+    for(int i = 0; i < m; ++ i) ss += W[j*m + i]*W[j*m + i];
+    s[j] = std::sqrt(ss);
+  }
+
+  /* Sort in decreasing order: */
+  for(int j = 0; j < n-1; ++ j) {
+    int k = j;
+    for(int i = j+1; i < n; ++ i) if(s[i] > s[k]) k = i;
+    if(k == j) continue;
+    std::swap(s[j], s[k]);
+    for(int i = 0; i < m; ++ i) std::swap(W[j*m + i], W[k*m + i]);
+    if(V) for(int i = 0; i < n; ++ i) std::swap(V[j*n + i], V[k*n + i]);
+  }
+  return sweep;
+}
+
+template<class T, class Rows, class Cols> inline void
+svd_normalize(Rows m, Cols n, T* W, const T* s)
+{
+  const T tol = T(m)*std::numeric_limits<T>::epsilon()*s[0];
+  for(int j = 0; j < n; ++ j) {
+    T* u = W + j*m;
+    if(s[j] > tol) {
+      T r = T(1)/s[j];
+      for(int i = 0; i < m; ++ i) u[i] *= r;
+      continue;
+    }
+
+    /* Complete U with the unit vector e_k having the largest component
+     * orthogonal to the previous columns, which is at least 1/sqrt(m).
+     * Since the columns are sorted, the remaining ones are all completed
+     * the same way:
+     */
+    int best = 0;
+    T best_ss(-1);
+    for(int e = 0; e < m; ++ e) {
+      T ss(1);
+      for(int k = 0; k < j; ++ k) ss -= W[k*m + e]*W[k*m + e];
+      if(ss > best_ss) {
+	best_ss = ss;
+	best = e;
+      }
+    }
+    for(int i = 0; i < m; ++ i) u[i] = T(i == best ? 1 : 0);
+    for(int pass = 0; pass < 2; ++ pass) {
+      for(int k = 0; k < j; ++ k) {
+	const T* v = W + k*m;
+	T d(0);
+	for(int i = 0; i < m; ++ i) d += v[i]*u[i];
+	for(int i = 0; i < m; ++ i) u[i] -= d*v[i];
+      }
+    }
+    T ss(0);
+    for(int i = 0; i < m; ++ i) ss += u[i]*u[i];
+    T r = T(1)/std::sqrt(ss);
+    for(int i = 0; i < m; ++ i) u[i] *= r;
+  }
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -26,6 +26,24 @@ namespace cml {
 template<class Sub> auto
 determinant(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>;
 
+/** Compute the natural logarithm of the absolute value of the determinant
+ * of square matrix @c M from its LU decomposition with partial pivoting,
+ * and set @c sign to the sign of the determinant.  Unlike determinant(),
+ * the result does not overflow or underflow for large matrices.  If @c M
+ * is singular, @c sign is set to 0 and -infinity is returned.
+ *
+ * @note To avoid allocating the factorization of a dynamic-size matrix on
+ * every call, or to reuse it for solving, use the lu_pivot_result
+ * overloads in cml/matrix/lu.h instead.
+ *
+ * @throws non_square_matrix_error at run-time if the matrix is
+ * dynamically-sized and not square.  Fixed-size matrices are checked at
+ * compile-time.
+ */
+template<class Sub> auto
+log_abs_determinant(const readable_matrix<Sub>& M, int& sign)
+-> value_type_trait_of_t<Sub>;
+
 } // namespace cml
 
 #define __CML_MATRIX_DETERMINANT_TPP
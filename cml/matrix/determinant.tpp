@@ -9,6 +9,7 @@
 #endif
 
 #include <cml/matrix/readable_matrix.h>
+#include <cml/matrix/lu.h>
 
 namespace cml {
 
@@ -19,6 +20,13 @@ determinant(const readable_matrix<Sub>& M)
   return M.determinant();
 }
 
+template<class Sub> inline auto
+log_abs_determinant(const readable_matrix<Sub>& M, int& sign)
+-> value_type_trait_of_t<Sub>
+{
+  return log_abs_determinant(lu_pivot(M), sign);
+}
+
 } // namespace cml
 
 // -------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #define	cml_matrix_dynamic_h
 
 #include <cml/matrix/dynamic_allocated.h>
+#include <cml/matrix/dynamic_small.h>
 
 #endif
 
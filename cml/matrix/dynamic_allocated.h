@@ -12,6 +12,8 @@
 #include <cml/common/mpl/enable_if_t.h>
 #include <cml/common/mpl/are_convertible.h>
 #include <cml/common/mpl/rebind.h>
+#include <cml/common/alignment.h>
+#include <cml/common/allocator.h>
 #include <cml/storage/allocated_selector.h>
 #include <cml/matrix/writable_matrix.h>
 #include <cml/matrix/matrix.h>
@@ -50,6 +52,10 @@ struct matrix_traits< matrix<Element, dynamic<Allocator>, BasisOrient, Layout> >
   static const int array_cols = storage_type::array_cols;
   static_assert(array_cols == -1, "invalid column size");
 
+  /* Array alignment in bytes, from the allocator: */
+  static const int alignment
+    = storage_alignment_of<rebind_alloc_t<Allocator, Element>>::value;
+
   /* Basis orientation: */
   typedef BasisOrient					basis_tag;
 
@@ -63,20 +69,26 @@ struct matrix_traits< matrix<Element, dynamic<Allocator>, BasisOrient, Layout> >
   static const layout_kind array_layout = layout_tag::value;
 };
 
-/** Fixed-size matrix. */
+/** Resizable matrix.  The matrix stores an instance of its allocator,
+ * which is propagated on copy and move as directed by
+ * std::allocator_traits, and inherited by matrices constructed from it.
+ */
 template<class Element, class Allocator, typename BasisOrient, typename Layout>
 class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 : public writable_matrix<
   matrix<Element, dynamic<Allocator>, BasisOrient, Layout>>
+, private detail::allocator_base<rebind_alloc_t<Allocator, Element>>
 {
-  protected:
+  public:
 
     /** The real allocator type. */
-    typedef rebind_t<Allocator, Element>		allocator_type;
+    typedef rebind_alloc_t<Allocator, Element>		allocator_type;
 
-    /** Require a stateless allocator. */
-    static_assert(std::is_empty<allocator_type>::value,
-      "cannot use a stateful allocator for dynamic<> matrices");
+
+  protected:
+
+    /** Base class storing the allocator. */
+    typedef detail::allocator_base<allocator_type>	allocator_base_type;
 
 
   public:
@@ -123,6 +135,9 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
     /** Constant containing the array layout enumeration value. */
     static const layout_kind array_layout = traits_type::array_layout;
 
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
 
   public:
 
@@ -132,21 +147,43 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
      */
     matrix();
 
+    /** Construct an empty matrix using @c alloc. */
+    explicit matrix(const allocator_type& alloc);
+
     /** Construct given a size.
      *
      * @throws std::invalid_argument if  @c rows < 0 or @c cols < 0.
      */
     matrix(int rows, int cols);
 
-    /** Copy constructor. */
+    /** Construct given a size, using @c alloc.
+     *
+     * @throws std::invalid_argument if  @c rows < 0 or @c cols < 0.
+     */
+    matrix(int rows, int cols, const allocator_type& alloc);
+
+    /** Copy constructor.  The allocator is copied from @c other by
+     * select_on_container_copy_construction().
+     */
     matrix(const matrix_type& other);
 
-    /** Move constructor. */
+    /** Copy @c other, using @c alloc. */
+    matrix(const matrix_type& other, const allocator_type& alloc);
+
+    /** Move constructor.  The allocator and array are taken from @c other.
+     */
     matrix(matrix_type&& other);
 
-    /** Construct from a readable_matrix. */
+    /** Construct from a readable_matrix.  If @c sub is a matrix with a
+     * compatible allocator, its allocator is copied as by the copy
+     * constructor.
+     */
     template<class Sub> matrix(const readable_matrix<Sub>& sub);
 
+    /** Construct from a readable_matrix, using @c alloc. */
+    template<class Sub>
+      matrix(const readable_matrix<Sub>& sub, const allocator_type& alloc);
+
     /** Construct from at least 1 value.
      *
      * @note This overload is enabled only if all of the arguments are
@@ -166,7 +203,7 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 	matrix(RowsT rows, ColsT cols, const E0& e0, const Elements&... eN)
 	// XXX Should be in matrix/dynamic_allocated.tpp, but VC++12 has
 	// brain-dead out-of-line template argument matching...
-	: m_data(0), m_rows(0), m_cols(0)
+	: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 	{
 	  this->resize_fast(rows,cols);
 	  this->assign_elements(e0, eN...);
@@ -194,6 +231,9 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 
   public:
 
+    /** Return a copy of the allocator. */
+    allocator_type get_allocator() const;
+
     /** Return access to the matrix data as a raw pointer. */
     pointer data();
 
@@ -206,10 +246,28 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
     /** Read-only iterator over the elements as a 1D array. */
     const_pointer end() const;
 
-    /** Resize the matrix to the specified size.
+    /** Return the number of elements the matrix can hold without
+     * reallocating.
+     */
+    int capacity() const;
+
+    /** Ensure the matrix can hold at least @c rows x @c cols elements
+     * without reallocating.  The size and elements are unchanged.
+     *
+     * @throws std::invalid_argument if @c rows or @c cols is negative.
+     */
+    void reserve(int rows, int cols);
+
+    /** Reallocate the array to exactly fit the current size, if it is
+     * larger.
+     */
+    void shrink_to_fit();
+
+    /** Resize the matrix to the specified size.  Element (i,j) keeps its
+     * value if it is within both the old and new sizes.
      *
-     * @note This will reallocate the array and copy existing elements, if
-     * any.
+     * @note This only reallocates if @c rows*cols exceeds capacity(), in
+     * which case the capacity grows geometrically.
      *
      * @throws std::invalid_argument if @c rows or @c cols is negative.
      */
@@ -225,10 +283,15 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 
   public:
 
-    /** Copy assignment. */
+    /** Copy assignment.  The allocator is copied if it propagates on
+     * copy assignment.
+     */
     matrix_type& operator=(const matrix_type& other);
 
-    /** Move assignment. */
+    /** Move assignment.  The array of @c other is taken if the allocators
+     * are equal or the allocator propagates on move assignment, and
+     * otherwise the elements are copied.
+     */
     matrix_type& operator=(matrix_type&& other);
 
 #ifdef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
@@ -256,6 +319,23 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 
   protected:
 
+    /** Return the capacity to allocate for at least @c n elements, growing
+     * the current capacity geometrically.
+     */
+    int grown_capacity(int n) const;
+
+    /** Replace the array with a new one of @c capacity elements, copying
+     * the first @c count elements of the first @c lines rows (row-major)
+     * or columns (column-major) of the current array.  Lines are @c
+     * to_stride elements apart in the new array.
+     */
+    void reallocate(int capacity, int lines, int count, int to_stride);
+
+    /** Exchange the arrays of this matrix and @c other, without exchanging
+     * their allocators.
+     */
+    void swap_arrays(matrix_type& other);
+
     /** No-op for trivially destructible elements
      * (is_trivially_destructible).
      */
@@ -336,6 +416,9 @@ class matrix<Element, dynamic<Allocator>, BasisOrient, Layout>
 
     /** Matrix columns. */
     int				m_cols;
+
+    /** Number of elements allocated at m_data. */
+    int				m_capacity;
 };
 
 } // namespace cml
@@ -13,7 +13,10 @@
 #error "matrix/dynamic_allocated.tpp not included correctly"
 #endif
 
+#include <algorithm>
+#include <memory>
 #include <cml/common/exception.h>
+#include <cml/matrix/detail/relayout.h>
 
 namespace cml {
 
@@ -21,34 +24,71 @@ namespace cml {
 
 template<class E, class A, typename BO, typename L>
 matrix<E, dynamic<A>, BO, L>::matrix()
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
+{
+}
+
+template<class E, class A, typename BO, typename L>
+matrix<E, dynamic<A>, BO, L>::matrix(const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
 }
 
 template<class E, class A, typename BO, typename L>
 matrix<E, dynamic<A>, BO, L>::matrix(int rows, int cols)
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
+{
+  this->resize_fast(rows,cols);
+}
+
+template<class E, class A, typename BO, typename L>
+matrix<E, dynamic<A>, BO, L>::matrix(
+  int rows, int cols, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->resize_fast(rows,cols);
 }
 
 template<class E, class A, typename BO, typename L>
 matrix<E, dynamic<A>, BO, L>::matrix(const matrix_type& other)
-: m_data(0), m_rows(0), m_cols(0)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(0), m_rows(0), m_cols(0), m_capacity(0)
+{
+  this->assign(other);
+}
+
+template<class E, class A, typename BO, typename L>
+matrix<E, dynamic<A>, BO, L>::matrix(
+  const matrix_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->assign(other);
 }
 
 template<class E, class A, typename BO, typename L>
 matrix<E, dynamic<A>, BO, L>::matrix(matrix_type&& other)
-: m_data(0), m_rows(0), m_cols(0)
+: allocator_base_type(other.stored_allocator())
+, m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
-  this->operator=(std::move(other));
+  this->swap_arrays(other);
 }
 
 template<class E, class A, typename BO, typename L> template<class Sub>
 matrix<E, dynamic<A>, BO, L>::matrix(const readable_matrix<Sub>& sub)
-: m_data(0), m_rows(0), m_cols(0)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(0), m_rows(0), m_cols(0), m_capacity(0)
+{
+  this->assign(sub);
+}
+
+template<class E, class A, typename BO, typename L> template<class Sub>
+matrix<E, dynamic<A>, BO, L>::matrix(
+  const readable_matrix<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->assign(sub);
 }
@@ -58,7 +98,7 @@ template<class Array, enable_if_array_t<Array>*>
 matrix<E, dynamic<A>, BO, L>::matrix(
   int rows, int cols, const Array& array
   )
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->resize_fast(rows,cols);
   this->assign(array);
@@ -67,7 +107,7 @@ matrix<E, dynamic<A>, BO, L>::matrix(
 template<class E, class A, typename BO, typename L>
 template<class Other, int R, int C>
 matrix<E, dynamic<A>, BO, L>::matrix(Other const (&array)[R][C])
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
  this->assign(array);
 }
@@ -77,7 +117,7 @@ template<class Pointer, enable_if_pointer_t<Pointer>*>
 matrix<E, dynamic<A>, BO, L>::matrix(
   int rows, int cols, const Pointer& array
   )
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->resize_fast(rows,cols);
   this->assign(array);
@@ -88,7 +128,7 @@ template<class Pointer, enable_if_pointer_t<Pointer>*>
 matrix<E, dynamic<A>, BO, L>::matrix(
   const Pointer& array, int rows, int cols
   )
-: m_data(0), m_rows(0), m_cols(0)
+: m_data(0), m_rows(0), m_cols(0), m_capacity(0)
 {
   this->resize_fast(rows,cols);
   this->assign(array);
@@ -97,17 +137,25 @@ matrix<E, dynamic<A>, BO, L>::matrix(
 template<class E, class A, typename BO, typename L>
 matrix<E, dynamic<A>, BO, L>::~matrix()
 {
-  typedef typename allocator_type::size_type size_type;
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
   int n = this->m_rows*this->m_cols;
   this->destruct(this->m_data, n,
     typename std::is_trivially_destructible<E>::type());
-  allocator_type().deallocate(this->m_data, size_type(n));
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
 }
 
 
 
 /* Public methods: */
 
+template<class E, class A, typename BO, typename L> auto
+matrix<E, dynamic<A>, BO, L>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
 template<class E, class A, typename BO, typename L> auto
 matrix<E, dynamic<A>, BO, L>::data() -> pointer
 {
@@ -132,51 +180,66 @@ matrix<E, dynamic<A>, BO, L>::end() const -> const_pointer
   return this->m_data + this->m_rows*this->m_cols;
 }
 
+template<class E, class A, typename BO, typename L> int
+matrix<E, dynamic<A>, BO, L>::capacity() const
+{
+  return this->m_capacity;
+}
+
 template<class E, class A, typename BO, typename L> void
-matrix<E, dynamic<A>, BO, L>::resize(int rows, int cols)
+matrix<E, dynamic<A>, BO, L>::reserve(int rows, int cols)
 {
   cml_require(rows >= 0, std::invalid_argument, "rows < 0");
   cml_require(cols >= 0, std::invalid_argument, "cols < 0");
 
-  int n_old = this->m_rows*this->m_cols;
-  int n_new = rows*cols;
+  int n = rows*cols;
+  if(n > this->m_capacity) {
+    int lines = detail::array_lines(this->m_rows, this->m_cols, layout_tag());
+    int stride = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+    this->reallocate(n, lines, stride, stride);
+  }
+}
 
-  /* Short-circuit same size: */
-  if(n_new == n_old) {
-    this->m_rows = rows;
-    this->m_cols = cols;
-    return;
+template<class E, class A, typename BO, typename L> void
+matrix<E, dynamic<A>, BO, L>::shrink_to_fit()
+{
+  int n = this->m_rows*this->m_cols;
+  if(this->m_capacity > n) {
+    int lines = detail::array_lines(this->m_rows, this->m_cols, layout_tag());
+    int stride = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+    this->reallocate(n, lines, stride, stride);
   }
+}
 
-  /* Allocator to use: */
-  auto allocator = allocator_type();
-
-  /* Allocate the new array: */
-  pointer data = this->m_data;
-  pointer copy = allocator.allocate(n_new);
-  try {
-
-    /* Destruct elements if necessary: */
-    this->destruct(data, n_old,
-      typename std::is_trivially_destructible<E>::type());
-
-    /* Copy elements to the new array if necessary: */
-    if(data) {
-      int to = std::min(n_old, n_new);
-      for(pointer src = data, dst = copy; src < data + to; ++ src, ++ dst) {
-	allocator.construct(dst, *src);
-      }
+template<class E, class A, typename BO, typename L> void
+matrix<E, dynamic<A>, BO, L>::resize(int rows, int cols)
+{
+  cml_require(rows >= 0, std::invalid_argument, "rows < 0");
+  cml_require(cols >= 0, std::invalid_argument, "cols < 0");
 
-      /* Deallocate the old array: */
-      allocator.deallocate(data, n_old);
-    }
-  } catch(...) {
-    allocator_type().deallocate(copy, n_new);
-    throw;
-  }
+  /* Short-circuit same size: */
+  if(rows == this->m_rows && cols == this->m_cols) return;
+
+  /* The rows (row-major) or columns (column-major) to keep, and their
+   * distance in the old and new arrays:
+   */
+  int lines = std::min(
+    detail::array_lines(this->m_rows, this->m_cols, layout_tag()),
+    detail::array_lines(rows, cols, layout_tag()));
+  int from_stride
+    = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+  int to_stride = detail::array_stride(rows, cols, layout_tag());
+  int count = std::min(from_stride, to_stride);
+
+  /* Move elements within the current array if it is large enough, or
+   * copy them to a new one:
+   */
+  int n = rows*cols;
+  if(n <= this->m_capacity)
+    detail::relayout(this->m_data, lines, count, from_stride, to_stride);
+  else
+    this->reallocate(this->grown_capacity(n), lines, count, to_stride);
 
-  /* Save the new array: */
-  this->m_data = copy;
   this->m_rows = rows;
   this->m_cols = cols;
 }
@@ -187,37 +250,10 @@ matrix<E, dynamic<A>, BO, L>::resize_fast(int rows, int cols)
   cml_require(rows >= 0, std::invalid_argument, "rows < 0");
   cml_require(cols >= 0, std::invalid_argument, "cols < 0");
 
-  int n_old = this->m_rows*this->m_cols;
-  int n_new = rows*cols;
-
-  /* Short-circuit same size: */
-  if(n_new == n_old) {
-    this->m_rows = rows;
-    this->m_cols = cols;
-    return;
-  }
-
-  /* Allocator to use: */
-  auto allocator = allocator_type();
-
-  /* Allocate the new array: */
-  pointer data = this->m_data;
-  pointer copy = allocator.allocate(n_new);
-  try {
-
-    /* Destruct elements if necessary: */
-    this->destruct(data, n_old,
-      typename std::is_trivially_destructible<E>::type());
-
-    /* Deallocate the old array: */
-    allocator.deallocate(data, n_old);
-  } catch(...) {
-    allocator_type().deallocate(copy, n_new);
-    throw;
-  }
-
-  /* Save the new array: */
-  this->m_data = copy;
+  /* Reuse the current array if it is large enough: */
+  int n = rows*cols;
+  if(n > this->m_capacity)
+    this->reallocate(this->grown_capacity(n), 0, 0, 0);
   this->m_rows = rows;
   this->m_cols = cols;
 }
@@ -227,6 +263,18 @@ template<class E, class A, typename BO, typename L> auto
 matrix<E, dynamic<A>, BO, L>::operator=(const matrix_type& other)
 -> matrix_type&
 {
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    this->reallocate(0, 0, 0, 0);
+    this->m_rows = this->m_cols = 0;
+  }
+  this->copy_assign_allocator(other);
   return this->assign(other);
 }
 
@@ -234,11 +282,29 @@ template<class E, class A, typename BO, typename L> auto
 matrix<E, dynamic<A>, BO, L>::operator=(matrix_type&& other)
 -> matrix_type&
 {
-  /* Ensure deletion of the current array, if any: */
-  std::swap(this->m_data, other.m_data);
-  std::swap(this->m_rows, other.m_rows);
-  std::swap(this->m_cols, other.m_cols);
-  /* Note: swap() can't throw here, so this is exception-safe. */
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  if(this->stored_allocator() == other.stored_allocator()) {
+    /* Ensure deletion of the current array, if any, by other: */
+    this->swap_arrays(other);
+  }
+
+  else if(propagate::value) {
+    /* Release the current array before taking the allocator of other: */
+    this->reallocate(0, 0, 0, 0);
+    this->m_rows = this->m_cols = 0;
+    this->move_assign_allocator(other);
+    this->swap_arrays(other);
+  }
+
+  else {
+    /* The array of other cannot be released by this allocator: */
+    this->assign(other);
+  }
 
   return *this;
 }
@@ -247,6 +313,61 @@ matrix<E, dynamic<A>, BO, L>::operator=(matrix_type&& other)
 
 /* Internal methods: */
 
+template<class E, class A, typename BO, typename L> int
+matrix<E, dynamic<A>, BO, L>::grown_capacity(int n) const
+{
+  return std::max(n, 2*this->m_capacity);
+}
+
+template<class E, class A, typename BO, typename L> void
+matrix<E, dynamic<A>, BO, L>::reallocate(
+  int capacity, int lines, int count, int to_stride
+  )
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef std::allocator_traits<allocator_type> alloc_traits;
+
+  /* Allocator to use: */
+  allocator_type allocator = this->stored_allocator();
+
+  /* Allocate the new array, and copy elements if necessary: */
+  int from_stride
+    = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+  pointer data = nullptr;
+  if(capacity > 0) {
+    data = allocator.allocate(size_type(capacity));
+    try {
+      for(int k = 0; k < lines; ++ k) {
+	pointer src = this->m_data + k*from_stride;
+	pointer dst = data + k*to_stride;
+	for(int i = 0; i < count; ++ i)
+	  alloc_traits::construct(allocator, dst + i, src[i]);
+      }
+    } catch(...) {
+      allocator.deallocate(data, size_type(capacity));
+      throw;
+    }
+  }
+
+  /* Release the old array, and save the new one: */
+  this->destruct(this->m_data, this->m_rows*this->m_cols,
+    typename std::is_trivially_destructible<E>::type());
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
+  this->m_data = data;
+  this->m_capacity = capacity;
+}
+
+template<class E, class A, typename BO, typename L> void
+matrix<E, dynamic<A>, BO, L>::swap_arrays(matrix_type& other)
+{
+  /* Note: swap() can't throw here, so this is exception-safe. */
+  std::swap(this->m_data, other.m_data);
+  std::swap(this->m_rows, other.m_rows);
+  std::swap(this->m_cols, other.m_cols);
+  std::swap(this->m_capacity, other.m_capacity);
+}
+
 template<class E, class A, typename BO, typename L> void
 matrix<E, dynamic<A>, BO, L>::destruct(pointer, int, std::true_type)
 {
@@ -260,7 +381,9 @@ matrix<E, dynamic<A>, BO, L>::destruct(pointer data, int n, std::false_type)
   if(data == nullptr) return;
 
   /* Destruct each element: */
-  else for(pointer e = data; e < data + n; ++ e) allocator_type().destroy(e);
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
 }
 
 
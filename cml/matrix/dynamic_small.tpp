@@ -0,0 +1,464 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_DYNAMIC_SMALL_TPP
+#error "matrix/dynamic_small.tpp not included correctly"
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <cml/common/exception.h>
+#include <cml/matrix/detail/relayout.h>
+
+namespace cml {
+
+/* small 'structors: */
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix()
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(const allocator_type& alloc)
+: allocator_base_type(alloc)
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(int rows, int cols)
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->resize_fast(rows,cols);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(
+  int rows, int cols, const allocator_type& alloc
+  )
+: allocator_base_type(alloc)
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->resize_fast(rows,cols);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(const matrix_type& other)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->assign(other);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(
+  const matrix_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc)
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->assign(other);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::matrix(matrix_type&& other)
+: allocator_base_type(other.stored_allocator())
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->operator=(std::move(other));
+}
+
+template<class E, int N, class A, typename BO, typename L> template<class Sub>
+matrix<E, small<N, A>, BO, L>::matrix(const readable_matrix<Sub>& sub)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->assign(sub);
+}
+
+template<class E, int N, class A, typename BO, typename L> template<class Sub>
+matrix<E, small<N, A>, BO, L>::matrix(
+  const readable_matrix<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc)
+, m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->assign(sub);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+template<class Array, enable_if_array_t<Array>*>
+matrix<E, small<N, A>, BO, L>::matrix(
+  int rows, int cols, const Array& array
+  )
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->resize_fast(rows,cols);
+  this->assign(array);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+template<class Other, int R, int C>
+matrix<E, small<N, A>, BO, L>::matrix(Other const (&array)[R][C])
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+ this->assign(array);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+matrix<E, small<N, A>, BO, L>::matrix(
+  int rows, int cols, const Pointer& array
+  )
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->resize_fast(rows,cols);
+  this->assign(array);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+matrix<E, small<N, A>, BO, L>::matrix(
+  const Pointer& array, int rows, int cols
+  )
+: m_data(m_buffer), m_rows(0), m_cols(0), m_capacity(N)
+{
+  this->resize_fast(rows,cols);
+  this->assign(array);
+}
+
+template<class E, int N, class A, typename BO, typename L>
+matrix<E, small<N, A>, BO, L>::~matrix()
+{
+  this->release();
+}
+
+
+
+/* Public methods: */
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::data() -> pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::data() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::begin() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::end() const -> const_pointer
+{
+  return this->m_data + this->m_rows*this->m_cols;
+}
+
+template<class E, int N, class A, typename BO, typename L> bool
+matrix<E, small<N, A>, BO, L>::is_inline() const
+{
+  return this->m_data == this->m_buffer;
+}
+
+template<class E, int N, class A, typename BO, typename L> int
+matrix<E, small<N, A>, BO, L>::capacity() const
+{
+  return this->m_capacity;
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::reserve(int rows, int cols)
+{
+  cml_require(rows >= 0, std::invalid_argument, "rows < 0");
+  cml_require(cols >= 0, std::invalid_argument, "cols < 0");
+
+  int n = rows*cols;
+  if(n > this->m_capacity) {
+    int lines = detail::array_lines(this->m_rows, this->m_cols, layout_tag());
+    int stride = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+    this->reallocate(n, lines, stride, stride);
+  }
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::shrink_to_fit()
+{
+  /* Short-circuit inline storage: */
+  if(this->is_inline()) return;
+
+  int n = this->m_rows*this->m_cols;
+  if(n <= N) {
+    /* Move the elements back to the inline buffer: */
+    std::copy(this->m_data, this->m_data + n, this->m_buffer);
+    this->release();
+  }
+
+  else if(this->m_capacity > n) {
+    int lines = detail::array_lines(this->m_rows, this->m_cols, layout_tag());
+    int stride = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+    this->reallocate(n, lines, stride, stride);
+  }
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::resize(int rows, int cols)
+{
+  cml_require(rows >= 0, std::invalid_argument, "rows < 0");
+  cml_require(cols >= 0, std::invalid_argument, "cols < 0");
+
+  /* Short-circuit same size: */
+  if(rows == this->m_rows && cols == this->m_cols) return;
+
+  /* The rows (row-major) or columns (column-major) to keep, and their
+   * distance in the old and new arrays:
+   */
+  int lines = std::min(
+    detail::array_lines(this->m_rows, this->m_cols, layout_tag()),
+    detail::array_lines(rows, cols, layout_tag()));
+  int from_stride
+    = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+  int to_stride = detail::array_stride(rows, cols, layout_tag());
+  int count = std::min(from_stride, to_stride);
+
+  /* Move elements within the current array if it is large enough, or
+   * copy them to a new one:
+   */
+  int n = rows*cols;
+  if(n <= this->m_capacity)
+    detail::relayout(this->m_data, lines, count, from_stride, to_stride);
+  else
+    this->reallocate(this->grown_capacity(n), lines, count, to_stride);
+
+  this->m_rows = rows;
+  this->m_cols = cols;
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::resize_fast(int rows, int cols)
+{
+  cml_require(rows >= 0, std::invalid_argument, "rows < 0");
+  cml_require(cols >= 0, std::invalid_argument, "cols < 0");
+
+  /* Reuse the current array if it is large enough: */
+  int n = rows*cols;
+  if(n > this->m_capacity)
+    this->reallocate(this->grown_capacity(n), 0, 0, 0);
+  this->m_rows = rows;
+  this->m_cols = cols;
+}
+
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::operator=(const matrix_type& other)
+-> matrix_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the heap array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    this->release();
+    this->m_rows = this->m_cols = 0;
+  }
+  this->copy_assign_allocator(other);
+  return this->assign(other);
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::operator=(matrix_type&& other)
+-> matrix_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  /* Release the heap array before taking an unequal allocator: */
+  bool equal = this->stored_allocator() == other.stored_allocator();
+  if(propagate::value && !equal) {
+    this->release();
+    this->m_rows = this->m_cols = 0;
+    this->move_assign_allocator(other);
+    equal = true;
+  }
+
+  if(other.is_inline()) {
+    /* Copy inline elements; this cannot allocate, since other has at most
+     * N <= this->m_capacity elements:
+     */
+    this->resize_fast(other.m_rows, other.m_cols);
+    std::copy(other.m_data,
+      other.m_data + other.m_rows*other.m_cols, this->m_data);
+  } else if(!equal) {
+    /* The heap array of other cannot be released by this allocator: */
+    this->assign(other);
+  } else {
+    /* Take ownership of the heap array, leaving other empty: */
+    this->release();
+    this->m_data = other.m_data;
+    this->m_rows = other.m_rows;
+    this->m_cols = other.m_cols;
+    this->m_capacity = other.m_capacity;
+    other.m_data = other.m_buffer;
+    other.m_capacity = N;
+  }
+  other.m_rows = other.m_cols = 0;
+  return *this;
+}
+
+
+
+/* Internal methods: */
+
+template<class E, int N, class A, typename BO, typename L> int
+matrix<E, small<N, A>, BO, L>::grown_capacity(int n) const
+{
+  return std::max(n, 2*this->m_capacity);
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::reallocate(
+  int capacity, int lines, int count, int to_stride
+  )
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef std::allocator_traits<allocator_type> alloc_traits;
+
+  /* Allocator to use: */
+  allocator_type allocator = this->stored_allocator();
+
+  /* Allocate the new array, and copy elements if necessary: */
+  int from_stride
+    = detail::array_stride(this->m_rows, this->m_cols, layout_tag());
+  pointer data = allocator.allocate(size_type(capacity));
+  try {
+    for(int k = 0; k < lines; ++ k) {
+      pointer src = this->m_data + k*from_stride;
+      pointer dst = data + k*to_stride;
+      for(int i = 0; i < count; ++ i)
+	alloc_traits::construct(allocator, dst + i, src[i]);
+    }
+  } catch(...) {
+    allocator.deallocate(data, size_type(capacity));
+    throw;
+  }
+
+  /* Release the old array, and save the new one: */
+  this->release();
+  this->m_data = data;
+  this->m_capacity = capacity;
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::release()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  /* Short-circuit inline storage: */
+  if(this->is_inline()) return;
+
+  this->destruct(this->m_data, this->m_rows*this->m_cols,
+    typename std::is_trivially_destructible<E>::type());
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
+  this->m_data = this->m_buffer;
+  this->m_capacity = N;
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::destruct(pointer, int, std::true_type)
+{
+  /* Nothing to do. */
+}
+
+template<class E, int N, class A, typename BO, typename L> void
+matrix<E, small<N, A>, BO, L>::destruct(pointer data, int n, std::false_type)
+{
+  /* Short-circuit null: */
+  if(data == nullptr) return;
+
+  /* Destruct each element: */
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
+}
+
+
+/* readable_matrix interface: */
+
+template<class E, int N, class A, typename BO, typename L> int
+matrix<E, small<N, A>, BO, L>::i_rows() const
+{
+  return this->m_rows;
+}
+
+template<class E, int N, class A, typename BO, typename L> int
+matrix<E, small<N, A>, BO, L>::i_cols() const
+{
+  return this->m_cols;
+}
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::i_get(int i, int j) const -> immutable_value
+{
+  return s_access(*this, i, j, layout_tag());
+}
+
+
+/* writable_matrix interface: */
+
+template<class E, int N, class A, typename BO, typename L> auto
+matrix<E, small<N, A>, BO, L>::i_get(int i, int j) -> mutable_value
+{
+  return s_access(*this, i, j, layout_tag());
+}
+
+template<class E, int N, class A, typename BO, typename L>
+template<class Other> auto matrix<E, small<N, A>, BO, L>::i_put(
+  int i, int j, const Other& v
+  ) __CML_REF -> matrix_type&
+{
+  s_access(*this, i, j, layout_tag()) = value_type(v);
+  return *this;
+}
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+template<class E, int N, class A, typename BO, typename L>
+template<class Other> auto matrix<E, small<N, A>, BO, L>::i_put(
+  int i, int j, const Other& v
+  ) && -> matrix_type&&
+{
+  s_access(*this, i, j, layout_tag()) = value_type(v);
+  return (matrix_type&&) *this;
+}
+#endif
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
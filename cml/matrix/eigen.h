@@ -0,0 +1,61 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_eigen_h
+#define	cml_matrix_eigen_h
+
+#include <cml/vector/fwd.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+
+/** Compute the eigenvalues of the symmetric matrix @c M into @c values,
+ * in increasing order.  Only the lower triangle of @c M is read.  @c
+ * values is resized to the number of rows of @c M if possible, and its
+ * element type is used for the computation.
+ *
+ * 3x3 matrices are solved by cyclic Jacobi rotations without
+ * accumulating the eigenvectors, giving the same eigenvalues as the
+ * overload computing the eigenvectors.  Larger matrices are reduced to
+ * tridiagonal form by Householder transformations, then solved by the
+ * implicit QL algorithm without accumulating the eigenvectors.
+ *
+ * @throws non_square_matrix_error at run-time if @c M is dynamically-sized
+ * and not square.
+ */
+template<class Sub, class VSub> void
+eigen_symmetric(const readable_matrix<Sub>& M, writable_vector<VSub>& values);
+
+/** Compute the eigenvalues and eigenvectors of the symmetric matrix @c M.
+ * @c values receives the eigenvalues in increasing order, and column @c j
+ * of @c vectors the unit eigenvector for @c values[j].  Only the lower
+ * triangle of @c M is read.  @c values and @c vectors are resized to fit
+ * @c M if possible.
+ *
+ * 3x3 matrices are solved by cyclic Jacobi rotations in local storage,
+ * which is fast for large batches of small problems and accurate for
+ * nearly equal eigenvalues.  Larger matrices use Householder
+ * tridiagonalization followed by the implicit QL algorithm.
+ *
+ * @throws non_square_matrix_error at run-time if @c M is dynamically-sized
+ * and not square.
+ */
+template<class Sub, class VSub, class XSub> void
+eigen_symmetric(const readable_matrix<Sub>& M, writable_vector<VSub>& values,
+  writable_matrix<XSub>& vectors);
+
+} // namespace cml
+
+#define __CML_MATRIX_EIGEN_TPP
+#include <cml/matrix/eigen.tpp>
+#undef __CML_MATRIX_EIGEN_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,100 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_EIGEN_TPP
+#error "matrix/eigen.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <cml/vector/writable_vector.h>
+#include <cml/vector/detail/check_or_resize.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/temporary.h>
+#include <cml/matrix/size_checking.h>
+#include <cml/matrix/detail/check_or_resize.h>
+#include <cml/matrix/detail/eigen.h>
+
+namespace cml {
+namespace detail {
+
+/** Copy the lower triangle of the symmetric 3x3 matrix @c M to @c A. */
+template<class Sub, class T> inline void
+eigen_copy_3x3(const readable_matrix<Sub>& M, T (&A)[3][3])
+{
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j <= i; ++ j) A[i][j] = A[j][i] = T(M.get(i,j));
+}
+
+/** Solve the symmetric eigenproblem for @c M into the @c values and, if
+ * @c vectors is not null, the eigenvectors of @c M.
+ */
+template<class Sub, class VSub, class XSub> inline void
+eigen_symmetric(const readable_matrix<Sub>& M,
+  writable_vector<VSub>& values, writable_matrix<XSub>* vectors)
+{
+  typedef value_type_trait_of_t<VSub>			value_type;
+
+  int N = M.rows();
+  if(N == 0) return;
+
+  /* 3x3 matrices are solved in local arrays: */
+  if(N == 3) {
+    value_type A[3][3], w[3];
+    detail::eigen_copy_3x3(M, A);
+    if(vectors) {
+      value_type V[3][3];
+      detail::eigen_jacobi_3x3(A, w, V);
+      for(int i = 0; i < 3; ++ i)
+	for(int j = 0; j < 3; ++ j) vectors->put(i,j, V[i][j]);
+    } else
+      detail::eigenvalues_3x3(A, w);
+    for(int i = 0; i < 3; ++ i) values.put(i, w[i]);
+    return;
+  }
+
+  /* Otherwise, tridiagonalize a row-major copy of the lower triangle, and
+   * find the eigenvalues by implicit QL:
+   */
+  std::vector<value_type> V(std::size_t(N)*N), d(N), e(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j <= i; ++ j) V[i*N + j] = value_type(M.get(i,j));
+  detail::tridiagonalize(N, V.data(), d.data(), e.data(), vectors != 0);
+  detail::tridiagonal_ql(N, d.data(), e.data(),
+    vectors ? V.data() : (value_type*) 0);
+
+  for(int i = 0; i < N; ++ i) values.put(i, d[i]);
+  if(vectors) {
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j) vectors->put(i,j, V[i*N + j]);
+  }
+}
+
+} // namespace detail
+
+
+template<class Sub, class VSub> inline void
+eigen_symmetric(const readable_matrix<Sub>& M, writable_vector<VSub>& values)
+{
+  cml::check_square(M);
+  detail::check_or_resize(values, M.rows());
+  typedef temporary_of_t<Sub>				vectors_type;
+  detail::eigen_symmetric(M, values, (writable_matrix<vectors_type>*) 0);
+}
+
+template<class Sub, class VSub, class XSub> inline void
+eigen_symmetric(const readable_matrix<Sub>& M, writable_vector<VSub>& values,
+  writable_matrix<XSub>& vectors)
+{
+  cml::check_square(M);
+  detail::check_or_resize(values, M.rows());
+  detail::check_or_resize(vectors, M.rows(), M.cols());
+  detail::eigen_symmetric(M, values, &vectors);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -10,6 +10,7 @@
 #define	cml_matrix_fixed_h
 
 #include <cml/matrix/fixed_compiled.h>
+#include <cml/matrix/fixed_allocated.h>
 
 #endif
 
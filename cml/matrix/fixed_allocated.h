@@ -0,0 +1,376 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_fixed_allocated_h
+#define	cml_matrix_fixed_allocated_h
+
+#include <cml/common/mpl/enable_if_t.h>
+#include <cml/common/mpl/rebind.h>
+#include <cml/common/alignment.h>
+#include <cml/common/allocator.h>
+#include <cml/storage/allocated_selector.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/matrix.h>
+
+namespace cml {
+
+template<class Element,
+  int Rows, int Cols, class Allocator, typename BasisOrient, typename Layout>
+struct matrix_traits<
+  matrix<Element, allocated<Allocator, Rows, Cols>, BasisOrient, Layout> >
+{
+  /* The basis must be col_basis or row_basis: */
+  static_assert(std::is_same<BasisOrient,row_basis>::value
+    || std::is_same<BasisOrient,col_basis>::value, "invalid basis");
+
+  /* Traits and types for the matrix element: */
+  typedef scalar_traits<Element>			element_traits;
+  typedef typename element_traits::value_type		value_type;
+  typedef typename element_traits::pointer		pointer;
+  typedef typename element_traits::reference		reference;
+  typedef typename element_traits::const_pointer	const_pointer;
+  typedef typename element_traits::const_reference	const_reference;
+  typedef typename element_traits::mutable_value	mutable_value;
+  typedef typename element_traits::immutable_value	immutable_value;
+
+  /* The matrix storage type: */
+  typedef rebind_t<allocated<Allocator, Rows, Cols>,
+	  matrix_storage_tag>				storage_type;
+  typedef typename storage_type::size_tag		size_tag;
+  static_assert(std::is_same<size_tag, fixed_size_tag>::value,
+    "invalid size tag");
+
+  /* Array rows (should be positive): */
+  static const int array_rows = storage_type::array_rows;
+  static_assert(array_rows > 0, "invalid row size");
+
+  /* Array columns (should be positive): */
+  static const int array_cols = storage_type::array_cols;
+  static_assert(array_cols > 0, "invalid column size");
+
+  /* Array alignment in bytes, from the allocator: */
+  static const int alignment
+    = storage_alignment_of<rebind_alloc_t<Allocator, Element>>::value;
+
+  /* Basis orientation: */
+  typedef BasisOrient					basis_tag;
+
+  /* Layout: */
+  typedef Layout					layout_tag;
+
+  /** Constant containing the matrix basis enumeration value. */
+  static const basis_kind matrix_basis = basis_tag::value;
+
+  /** Constant containing the array layout enumeration value. */
+  static const layout_kind array_layout = layout_tag::value;
+};
+
+/** Fixed-size matrix with its elements on the heap.  Unlike
+ * matrix<Element, compiled<Rows,Cols>>, the matrix itself is the size of
+ * a pointer (plus the allocator, if stateful), so large matrices do not
+ * occupy the stack, and moving a matrix transfers the array instead of
+ * copying the elements.
+ *
+ * @note A moved-from matrix has no array until it is next written through
+ * assignment, element access or data(); its elements must not be read
+ * before then.
+ */
+template<class Element,
+  int Rows, int Cols, class Allocator, typename BasisOrient, typename Layout>
+class matrix<Element, allocated<Allocator, Rows, Cols>, BasisOrient, Layout>
+: public writable_matrix<
+  matrix<Element, allocated<Allocator, Rows, Cols>, BasisOrient, Layout>>
+, private detail::allocator_base<rebind_alloc_t<Allocator, Element>>
+{
+  public:
+
+    /** The real allocator type. */
+    typedef rebind_alloc_t<Allocator, Element>		allocator_type;
+
+
+  protected:
+
+    /** Base class storing the allocator. */
+    typedef detail::allocator_base<allocator_type>	allocator_base_type;
+
+
+  public:
+
+    typedef matrix<Element, allocated<Allocator, Rows, Cols>,
+	    BasisOrient, Layout>			matrix_type;
+    typedef readable_matrix<matrix_type>		readable_type;
+    typedef writable_matrix<matrix_type>		writable_type;
+    typedef matrix_traits<matrix_type>			traits_type;
+    typedef typename traits_type::storage_type		storage_type;
+    typedef typename traits_type::element_traits	element_traits;
+    typedef typename traits_type::value_type		value_type;
+    typedef typename traits_type::pointer		pointer;
+    typedef typename traits_type::reference		reference;
+    typedef typename traits_type::const_pointer		const_pointer;
+    typedef typename traits_type::const_reference	const_reference;
+    typedef typename traits_type::mutable_value		mutable_value;
+    typedef typename traits_type::immutable_value	immutable_value;
+    typedef typename traits_type::size_tag		size_tag;
+    typedef typename traits_type::basis_tag		basis_tag;
+    typedef typename traits_type::layout_tag		layout_tag;
+
+
+  public:
+
+    /* Include methods from writable_matrix: */
+    using writable_type::operator();
+#ifndef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
+    using writable_type::operator=;
+#endif
+
+
+  public:
+
+    /** Constant containing the number of rows. */
+    static const int array_rows = traits_type::array_rows;
+
+    /** Constant containing the number of columns. */
+    static const int array_cols = traits_type::array_cols;
+
+    /** Constant containing the matrix basis enumeration value. */
+    static const basis_kind matrix_basis = traits_type::matrix_basis;
+
+    /** Constant containing the array layout enumeration value. */
+    static const layout_kind array_layout = traits_type::array_layout;
+
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
+
+  public:
+
+    /** Default constructor.
+     *
+     * @note The matrix elements are uninitialized.
+     */
+    matrix();
+
+    /** Construct using @c alloc.
+     *
+     * @note The matrix elements are uninitialized.
+     */
+    explicit matrix(const allocator_type& alloc);
+
+    /** Copy constructor.  The allocator is copied from @c other by
+     * select_on_container_copy_construction().
+     */
+    matrix(const matrix_type& other);
+
+    /** Copy @c other, using @c alloc. */
+    matrix(const matrix_type& other, const allocator_type& alloc);
+
+    /** Move constructor.  The allocator and array are taken from @c other,
+     * without copying the elements or allocating, and @c other is left
+     * without an array.
+     */
+    matrix(matrix_type&& other) noexcept;
+
+    /** Construct from a readable_matrix.  If @c sub is a matrix with a
+     * compatible allocator, its allocator is copied as by the copy
+     * constructor.
+     */
+    template<class Sub> matrix(const readable_matrix<Sub>& sub);
+
+    /** Construct from a readable_matrix, using @c alloc. */
+    template<class Sub>
+      matrix(const readable_matrix<Sub>& sub, const allocator_type& alloc);
+
+    /** Construct from at least 1 value.
+     *
+     * @note This overload is enabled only if all of the arguments are
+     * convertible to value_type.
+     */
+    template<class E0, class... Elements,
+      // XXX This could be enable_if_convertible_t, but VC++12 ICEs:
+      typename enable_if_convertible<
+	value_type, E0, Elements...>::type* = nullptr>
+	matrix(const E0& e0, const Elements&... eN)
+	// XXX Should be in matrix/fixed_allocated.tpp, but VC++12 has
+	// brain-dead out-of-line template argument matching...
+	: m_data(0)
+	{
+	  this->allocate_array();
+	  this->assign_elements(e0, eN...);
+	}
+
+    /** Construct from an array type. */
+    template<class Array, enable_if_array_t<Array>* = nullptr>
+      matrix(const Array& array);
+
+    /** Construct from a C-array type. */
+    template<class Other, int Rows2, int Cols2>
+      matrix(Other const (&array)[Rows2][Cols2]);
+
+    /** Construct from a pointer to an array. */
+    template<class Pointer, enable_if_pointer_t<Pointer>* = nullptr>
+      matrix(const Pointer& array);
+
+    /** Construct from std::initializer_list. */
+    template<class Other> matrix(std::initializer_list<Other> l);
+
+    /** Destructor. */
+    ~matrix();
+
+
+  public:
+
+    /** Return a copy of the allocator. */
+    allocator_type get_allocator() const;
+
+    /** Return access to the matrix data as a raw pointer. */
+    pointer data();
+
+    /** Return const access to the matrix data as a raw pointer. */
+    const_pointer data() const;
+
+    /** Read-only iterator over the elements as a 1D array. */
+    const_pointer begin() const;
+
+    /** Read-only iterator over the elements as a 1D array. */
+    const_pointer end() const;
+
+
+  public:
+
+    /** Copy assignment.  The allocator is copied if it propagates on
+     * copy assignment.
+     */
+    matrix_type& operator=(const matrix_type& other);
+
+    /** Move assignment.  The array of @c other is taken if the allocators
+     * are equal or the allocator propagates on move assignment, in which
+     * case @c other is left with the old array or none, and otherwise the
+     * elements are copied.  The move does not throw if the allocator
+     * propagates.
+     */
+    matrix_type& operator=(matrix_type&& other) noexcept(
+      std::allocator_traits<allocator_type>
+      ::propagate_on_container_move_assignment::value);
+
+#ifdef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
+    template<class Other>
+      inline matrix_type& operator=(const readable_matrix<Other>& other) {
+	return this->assign(other);
+      }
+
+    template<class Array, enable_if_array_t<Array>* = nullptr>
+      inline matrix_type& operator=(const Array& array) {
+	return this->assign(array);
+      }
+
+    template<class Other, int R, int C>
+      inline matrix_type& operator=(Other const (&array)[R][C]) {
+	return this->assign(array);
+      }
+
+    template<class Other>
+      inline matrix_type& operator=(std::initializer_list<Other> l) {
+	return this->assign(l);
+      }
+#endif
+
+
+  protected:
+
+    /** Allocate the array if the matrix does not have one. */
+    void allocate_array();
+
+    /** Release the array, if any. */
+    void release_array();
+
+    /** No-op for trivially destructible elements
+     * (is_trivially_destructible).
+     */
+    void destruct(pointer, int, std::true_type);
+
+    /** Invoke non-trivial destructors for @c n elements starting at @c
+     * data.
+     */
+    void destruct(pointer data, int n, std::false_type);
+
+
+  protected:
+
+    /** @name readable_matrix Interface */
+    /*@{*/
+
+    friend readable_type;
+
+    /** Return the number of rows. */
+    int i_rows() const;
+
+    /** Return the number of columns. */
+    int i_cols() const;
+
+    /** Return matrix const element @c (i,j). */
+    immutable_value i_get(int i, int j) const;
+
+    /*@}*/
+
+
+  protected:
+
+    /** @name writeable_matrix Interface */
+    /*@{*/
+
+    friend writable_type;
+
+    /** Return matrix element @c (i,j). */
+    mutable_value i_get(int i, int j);
+
+    /** Set element @c i. */
+    template<class Other> matrix_type&
+      i_put(int i, int j, const Other& v) __CML_REF;
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+    /** Set element @c i on a temporary. */
+    template<class Other> matrix_type&&
+      i_put(int i, int j, const Other& v) &&;
+#endif
+
+    /*@}*/
+
+
+  protected:
+
+    /** Row-major access to const or non-const @c M. */
+    template<class Matrix> inline static auto s_access(
+      Matrix& M, int i, int j, row_major) -> decltype(M.m_data[0])
+    {
+      return M.m_data[i*Cols + j];
+    }
+
+    /** Column-major access to const or non-const @c M. */
+    template<class Matrix> inline static auto s_access(
+      Matrix& M, int i, int j, col_major) -> decltype(M.m_data[0])
+    {
+      return M.m_data[j*Rows + i];
+    }
+
+
+  protected:
+
+    /** Array of Rows*Cols elements. */
+    pointer			m_data;
+};
+
+} // namespace cml
+
+#define __CML_MATRIX_FIXED_ALLOCATED_TPP
+#include <cml/matrix/fixed_allocated.tpp>
+#undef __CML_MATRIX_FIXED_ALLOCATED_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
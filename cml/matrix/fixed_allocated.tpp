@@ -0,0 +1,317 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_FIXED_ALLOCATED_TPP
+#error "matrix/fixed_allocated.tpp not included correctly"
+#endif
+
+#include <memory>
+
+namespace cml {
+
+/* fixed allocated 'structors: */
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::matrix()
+: m_data(0)
+{
+  this->allocate_array();
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(const matrix_type& other)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(0)
+{
+  this->allocate_array();
+  this->assign(other);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(
+  const matrix_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+  this->assign(other);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(matrix_type&& other) noexcept
+: allocator_base_type(other.stored_allocator()), m_data(other.m_data)
+{
+  /* other is given an array when it is next written: */
+  other.m_data = nullptr;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Sub>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(const readable_matrix<Sub>& sub)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(0)
+{
+  this->allocate_array();
+  this->assign(sub);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Sub>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(
+  const readable_matrix<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+  this->assign(sub);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Array, enable_if_array_t<Array>*>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(const Array& array)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(array);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Other, int R2, int C2>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(Other const (&array)[R2][C2])
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(array);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(const Pointer& array)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(array);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Other>
+matrix<E, allocated<A,R,C>, BO, L>::matrix(std::initializer_list<Other> l)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(l);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+matrix<E, allocated<A,R,C>, BO, L>::~matrix()
+{
+  this->release_array();
+}
+
+
+
+/* Public methods: */
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::data() -> pointer
+{
+  this->allocate_array();
+  return this->m_data;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::data() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::begin() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::end() const -> const_pointer
+{
+  return this->m_data + R*C;
+}
+
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::operator=(const matrix_type& other)
+-> matrix_type&
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    allocator_type allocator = other.stored_allocator();
+    pointer data = allocator.allocate(size_type(R*C));
+    this->release_array();
+    this->copy_assign_allocator(other);
+    this->m_data = data;
+  }
+  return this->assign(other);
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::operator=(matrix_type&& other) noexcept(
+  std::allocator_traits<allocator_type>
+  ::propagate_on_container_move_assignment::value) -> matrix_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  if(this->stored_allocator() == other.stored_allocator()) {
+    /* Ensure deletion of the current array by other: */
+    std::swap(this->m_data, other.m_data);
+  }
+
+  else if(propagate::value) {
+    /* Release the current array before taking the allocator of other: */
+    this->release_array();
+    this->move_assign_allocator(other);
+    this->m_data = other.m_data;
+    other.m_data = nullptr;
+  }
+
+  else {
+    /* The array of other cannot be released by this allocator: */
+    this->assign(other);
+  }
+
+  return *this;
+}
+
+
+
+/* Internal methods: */
+
+template<class E, int R, int C, class A, typename BO, typename L> void
+matrix<E, allocated<A,R,C>, BO, L>::allocate_array()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  if(this->m_data == nullptr) {
+    allocator_type allocator = this->stored_allocator();
+    this->m_data = allocator.allocate(size_type(R*C));
+  }
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> void
+matrix<E, allocated<A,R,C>, BO, L>::release_array()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  if(this->m_data == nullptr) return;
+  this->destruct(this->m_data, R*C,
+    typename std::is_trivially_destructible<E>::type());
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(R*C));
+  this->m_data = nullptr;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> void
+matrix<E, allocated<A,R,C>, BO, L>::destruct(pointer, int, std::true_type)
+{
+  /* Nothing to do. */
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> void
+matrix<E, allocated<A,R,C>, BO, L>::destruct(
+  pointer data, int n, std::false_type
+  )
+{
+  /* Destruct each element: */
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
+}
+
+
+/* readable_matrix interface: */
+
+template<class E, int R, int C, class A, typename BO, typename L> int
+matrix<E, allocated<A,R,C>, BO, L>::i_rows() const
+{
+  return R;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> int
+matrix<E, allocated<A,R,C>, BO, L>::i_cols() const
+{
+  return C;
+}
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::i_get(int i, int j) const
+-> immutable_value
+{
+  return s_access(*this, i, j, layout_tag());
+}
+
+
+/* writable_matrix interface: */
+
+template<class E, int R, int C, class A, typename BO, typename L> auto
+matrix<E, allocated<A,R,C>, BO, L>::i_get(int i, int j) -> mutable_value
+{
+  this->allocate_array();
+  return s_access(*this, i, j, layout_tag());
+}
+
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Other> auto matrix<E, allocated<A,R,C>, BO, L>::i_put(
+  int i, int j, const Other& v
+  ) __CML_REF -> matrix_type&
+{
+  this->allocate_array();
+  s_access(*this, i, j, layout_tag()) = value_type(v);
+  return *this;
+}
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+template<class E, int R, int C, class A, typename BO, typename L>
+template<class Other> auto matrix<E, allocated<A,R,C>, BO, L>::i_put(
+  int i, int j, const Other& v
+  ) && -> matrix_type&&
+{
+  this->allocate_array();
+  s_access(*this, i, j, layout_tag()) = value_type(v);
+  return (matrix_type&&) *this;
+}
+#endif
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
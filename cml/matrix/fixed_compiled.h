@@ -9,6 +9,7 @@
 #ifndef	cml_matrix_fixed_compiled_h
 #define	cml_matrix_fixed_compiled_h
 
+#include <cml/common/alignment.h>
 #include <cml/storage/compiled_selector.h>
 #include <cml/matrix/writable_matrix.h>
 #include <cml/matrix/matrix.h>
@@ -16,8 +17,9 @@
 namespace cml {
 
 template<class Element,
-  int Rows, int Cols, typename BasisOrient, typename Layout>
-struct matrix_traits< matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout> >
+  int Rows, int Cols, int Align, typename BasisOrient, typename Layout>
+struct matrix_traits<
+  matrix<Element, fixed<Rows,Cols,Align>, BasisOrient, Layout> >
 {
   /* The basis must be col_basis or row_basis: */
   static_assert(std::is_same<BasisOrient,row_basis>::value
@@ -34,7 +36,8 @@ struct matrix_traits< matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout> >
   typedef typename element_traits::immutable_value	immutable_value;
 
   /* The matrix storage type: */
-  typedef rebind_t<compiled<Rows,Cols>, matrix_storage_tag> storage_type;
+  typedef rebind_t<
+    compiled<Rows,Cols,Align>, matrix_storage_tag>	storage_type;
   typedef typename storage_type::size_tag		size_tag;
   static_assert(std::is_same<size_tag, fixed_size_tag>::value,
     "invalid size tag");
@@ -47,6 +50,10 @@ struct matrix_traits< matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout> >
   static const int array_cols = storage_type::array_cols;
   static_assert(array_cols > 0, "invalid column size");
 
+  /* Array alignment in bytes: */
+  static const int alignment
+    = storage_alignment<value_type, array_rows*array_cols, Align>::value;
+
   /* Basis orientation: */
   typedef BasisOrient					basis_tag;
 
@@ -62,15 +69,15 @@ struct matrix_traits< matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout> >
 
 /** Fixed-size matrix. */
 template<class Element,
-  int Rows, int Cols, typename BasisOrient, typename Layout>
-class matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout>
+  int Rows, int Cols, int Align, typename BasisOrient, typename Layout>
+class matrix<Element, fixed<Rows,Cols,Align>, BasisOrient, Layout>
 : public writable_matrix<
-  matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout>>
+  matrix<Element, fixed<Rows,Cols,Align>, BasisOrient, Layout>>
 {
   public:
 
     typedef matrix<Element,
-	    fixed<Rows,Cols>, BasisOrient, Layout>	matrix_type;
+	    fixed<Rows,Cols,Align>, BasisOrient, Layout>	matrix_type;
     typedef readable_matrix<matrix_type>		readable_type;
     typedef writable_matrix<matrix_type>		writable_type;
     typedef matrix_traits<matrix_type>			traits_type;
@@ -111,6 +118,9 @@ class matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout>
     /** Constant containing the array layout enumeration value. */
     static const layout_kind array_layout = traits_type::array_layout;
 
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
 
   public:
 
@@ -279,7 +289,7 @@ class matrix<Element, fixed<Rows,Cols>, BasisOrient, Layout>
       , value_type[Cols][Rows]>				matrix_data_type;
 
     /** Fixed-size array, based on the layout. */
-    matrix_data_type		m_data;
+    alignas(alignment) matrix_data_type	m_data;
 };
 
 } // namespace cml
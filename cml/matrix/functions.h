@@ -14,6 +14,7 @@
 #include <cml/matrix/transpose.h>
 #include <cml/matrix/determinant.h>
 #include <cml/matrix/trace.h>
+#include <cml/matrix/norms.h>
 
 #endif
 
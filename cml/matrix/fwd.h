@@ -14,6 +14,8 @@ namespace cml {
 template<class DerivedT> class readable_matrix;
 template<class DerivedT> class writable_matrix;
 
+namespace detail { struct alias_target; }
+
 } // namespace cml
 
 #endif
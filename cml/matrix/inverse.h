@@ -9,12 +9,33 @@
 #ifndef	cml_matrix_inverse_h
 #define	cml_matrix_inverse_h
 
+#include <vector>
 #include <cml/matrix/temporary.h>
 #include <cml/matrix/size_checking.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/detail/gemm.h>
 
 namespace cml {
 
-/** Compute the inverse of @c M and return the result in a temporary. */
+/** Scratch space for inverting dynamic-size matrices of @c Element with
+ * inverse_inplace(), including the packing buffers of the blocked
+ * inverse.  The workspace grows to fit the largest matrix inverted with
+ * it, so inverting a sequence of same-size matrices allocates only for the
+ * first one.
+ */
+template<class Element> struct inverse_workspace
+{
+  std::vector<int>			order;
+  std::vector<Element>			work;
+  detail::gemm_workspace<Element>	pack;
+};
+
+/** Compute the inverse of @c M and return the result in a temporary.
+ * Matrices larger than 4x4 are inverted through LU decomposition with
+ * partial pivoting.
+ *
+ * @note The result is unspecified if @c M is singular.
+ */
 template<class Sub> inline temporary_of_t<Sub>
 inverse(const readable_matrix<Sub>& M)
 {
@@ -22,6 +43,35 @@ inverse(const readable_matrix<Sub>& M)
   return temporary_of_t<Sub>(M).inverse();
 }
 
+/** Set @c M to its inverse, using @c workspace for scratch space if @c M
+ * is a dynamic-size matrix.
+ *
+ * @note The result is unspecified if @c M is singular.
+ */
+template<class Sub> inline void
+inverse_inplace(writable_matrix<Sub>& M,
+  inverse_workspace<value_type_trait_of_t<Sub>>& workspace)
+{
+  cml::check_square(M);
+  detail::inverse(M, int_c<array_rows_of_c<matrix_traits<Sub>>::value>(),
+    workspace.order, workspace.work, workspace.pack);
+}
+
+/** Compute the inverse of @c M and return the result in a temporary,
+ * using @c workspace for scratch space if @c M is a dynamic-size matrix.
+ *
+ * @note The result is unspecified if @c M is singular.
+ */
+template<class Sub> inline temporary_of_t<Sub>
+inverse(const readable_matrix<Sub>& M,
+  inverse_workspace<value_type_trait_of_t<Sub>>& workspace)
+{
+  cml::check_square(M);
+  temporary_of_t<Sub> result(M);
+  inverse_inplace(result, workspace);
+  return result;
+}
+
 } // namespace cml
 
 #endif
@@ -15,6 +15,7 @@
 #include <cml/common/array_size_of.h>
 #include <cml/vector/temporary.h>
 #include <cml/matrix/temporary.h>
+#include <cml/matrix/detail/gemm.h>
 
 namespace cml {
 
@@ -40,10 +41,15 @@ struct lu_pivot_result<Matrix, enable_if_fixed_size_t<matrix_traits<Matrix>>>
 template<class Matrix>
 struct lu_pivot_result<Matrix, enable_if_dynamic_size_t<matrix_traits<Matrix>>>
 {
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+
   Matrix			lu;
   std::vector<int>		order;
   int				sign;
 
+  /** Packing buffers for the blocked factorization. */
+  detail::gemm_workspace<value_type>	work;
+
   explicit lu_pivot_result(const Matrix& M) : lu(M), order(M.rows()) {}
 };
 
@@ -65,6 +71,101 @@ lu_pivot(const readable_matrix<Sub>& M)
 template<class Matrix> void
 lu_pivot(lu_pivot_result<Matrix>& result);
 
+/** Compute the LU decomposition of @c M, with partial pivoting, into @c
+ * result.  The storage of @c result, including its packing buffers, is
+ * reused when it already has the size of @c M, so factoring a sequence of
+ * same-size dynamic matrices with the same lu_pivot_result allocates only
+ * for the first one.
+ *
+ * @note if @c result.sign is 0, the input matrix is singular.
+ *
+ * @throws non_square_matrix_error at run-time if @c M is
+ * dynamically-sized and not square.
+ */
+template<class Sub, class Matrix> void
+lu_pivot(const readable_matrix<Sub>& M, lu_pivot_result<Matrix>& result);
+
+/** Return the determinant of the matrix factored into @c lup, from the
+ * diagonal of U and the parity of the row interchanges.  This is 0 if @c
+ * lup.sign is 0.
+ */
+template<class Matrix> auto
+determinant(const lu_pivot_result<Matrix>& lup)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
+/** Return the natural logarithm of the absolute value of the determinant
+ * of the matrix factored into @c lup, and set @c sign to the sign of the
+ * determinant.  The logarithms of the diagonal elements of U are summed,
+ * so the result neither overflows nor underflows for large matrices.  If
+ * @c lup.sign is 0 or any diagonal element of U is 0, @c sign is set to
+ * 0, and -infinity is returned.
+ */
+template<class Matrix> auto
+log_abs_determinant(const lu_pivot_result<Matrix>& lup, int& sign)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
+/** Compute the determinant of @c M, using @c workspace to hold its LU
+ * decomposition.  On return, @c workspace holds the factorization of @c M,
+ * which can be reused to solve systems with lu_solve() or to compute the
+ * inverse.
+ *
+ * @throws non_square_matrix_error at run-time if @c M is
+ * dynamically-sized and not square.
+ */
+template<class Sub, class Matrix> auto
+determinant(const readable_matrix<Sub>& M, lu_pivot_result<Matrix>& workspace)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
+/** Compute the logarithm of the absolute value of the determinant of @c
+ * M, and its @c sign, using @c workspace to hold the LU decomposition of @c
+ * M, as for determinant(M, workspace).
+ *
+ * @throws non_square_matrix_error at run-time if @c M is
+ * dynamically-sized and not square.
+ */
+template<class Sub, class Matrix> auto
+log_abs_determinant(const readable_matrix<Sub>& M, int& sign,
+  lu_pivot_result<Matrix>& workspace)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
+/** Return the inverse of the matrix factored into @c lup, computed by
+ * solving for the columns of the identity matrix.
+ *
+ * @throws std::invalid_argument @c lup.sign is 0.
+ */
+template<class Matrix> Matrix
+inverse(const lu_pivot_result<Matrix>& lup);
+
+/** Return an estimate of the 1-norm of the inverse of the matrix factored
+ * into @c lup, by Hager's method with Higham's refinements (as in LAPACK's
+ * xLACON).  At most five pairs of solves with A and A^T are needed, so
+ * this is O(N^2).  The estimate never exceeds the true norm, and is
+ * usually exact or within a factor of 3 of it.  If @c lup.sign is 0,
+ * infinity is returned.
+ */
+template<class Matrix> auto
+inverse_norm_1_estimate(const lu_pivot_result<Matrix>& lup)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
+/** Return an estimate of the reciprocal of the 1-norm condition number
+ * of the matrix A factored into @c lup, given @c norm = norm_1(A):
+ *
+ * @code
+ * lu_pivot(A, lup);
+ * if(rcond_estimate(lup, norm_1(A)) < tolerance) ...
+ * @endcode
+ *
+ * The norm of A is not recoverable from its factors in O(N^2), so it must
+ * be computed before A is factored in place.  The result is 0 if @c
+ * lup.sign or @c norm is 0, and is otherwise 1/(norm *
+ * inverse_norm_1_estimate(lup)), which is at least the true reciprocal
+ * condition number.
+ */
+template<class Matrix> auto
+rcond_estimate(const lu_pivot_result<Matrix>& lup,
+  value_type_of_t<matrix_traits<Matrix>> norm)
+-> value_type_of_t<matrix_traits<Matrix>>;
+
 /** Compute the LU decomposition of @c M using Doolittle's method,
  * returning the result as a temporary matrix.
  *
@@ -118,6 +219,43 @@ template<class Matrix, class XSub, class BSub> void
 lu_solve(const lu_pivot_result<Matrix>& lup,
   writable_vector<XSub>& x, const readable_vector<BSub>& b);
 
+/** Solve @c LUX = @c PB for the matrix @c X, where the partial-pivot LU
+ * decomposition is provided as lu_pivot_result, and @c X is returned as a
+ * matrix temporary.  Each column of @c B is a right-hand side, and @c B
+ * must have as many rows as @c lup.lu.
+ *
+ * @throws std::invalid_argument @c lup.sign is 0.
+ */
+template<class Matrix, class BSub> auto
+lu_solve(const lu_pivot_result<Matrix>& lup, const readable_matrix<BSub>& B)
+-> temporary_of_t<BSub>;
+
+/** Solve @c LUX = @c PB for the matrix @c X, where the partial-pivot LU
+ * decomposition is provided as lu_pivot_result.  All of the right-hand
+ * sides are solved in a single pass over @c lup.lu; if both @c lup.lu and
+ * @c X have contiguous storage, this uses blocked substitution, with the
+ * off-diagonal blocks applied by the packed matrix product kernel.  @c X
+ * is resized to the size of @c B if possible.
+ *
+ * @note @c X can be the same matrix as @c B, but must not otherwise share
+ * memory with it.
+ *
+ * @throws std::invalid_argument @c lup.sign is 0.
+ */
+template<class Matrix, class XSub, class BSub> void
+lu_solve(const lu_pivot_result<Matrix>& lup,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B);
+
+/** Solve @c LUX = @c PB in place, overwriting the right-hand sides in @c
+ * B with the solution @c X.  The rows of @c B are permuted in place, so
+ * @c B is not copied.
+ *
+ * @throws std::invalid_argument @c lup.sign is 0.
+ */
+template<class Matrix, class BSub> void
+lu_solve_inplace(const lu_pivot_result<Matrix>& lup,
+  writable_matrix<BSub>& B);
+
 } // namespace cml
 
 #define __CML_MATRIX_LU_TPP
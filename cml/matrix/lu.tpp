@@ -8,11 +8,44 @@
 #error "matrix/lu.tpp not included correctly"
 #endif
 
+#include <limits>
+#include <cml/common/allocator.h>
 #include <cml/vector/writable_vector.h>
+#include <cml/matrix/writable_matrix.h>
 #include <cml/matrix/size_checking.h>
+#include <cml/matrix/detail/check_or_resize.h>
 #include <cml/matrix/detail/lu.h>
 
 namespace cml {
+namespace detail {
+
+/** lu_pivot_inplace() for the matrix and order of a fixed-size @c result. */
+template<class Matrix> inline int
+lu_pivot_inplace(lu_pivot_result<Matrix>& result, fixed_size_tag)
+{
+  return detail::lu_pivot_inplace(result.lu, result.order);
+}
+
+/** lu_pivot_inplace() for a dynamic-size @c result, packing the trailing
+ * updates into @c result.work.
+ */
+template<class Matrix> inline int
+lu_pivot_inplace(lu_pivot_result<Matrix>& result, dynamic_size_tag)
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+  return detail::lu_pivot_inplace(result.lu, result.order,
+    lu_serial_update<value_type>(result.work));
+}
+
+/** In-place LU decomposition of @c result.lu into @c result.order. */
+template<class Matrix> inline int
+lu_pivot_inplace(lu_pivot_result<Matrix>& result)
+{
+  typedef size_tag_of_t<matrix_traits<Matrix>>		size_tag;
+  return detail::lu_pivot_inplace(result, size_tag());
+}
+
+} // namespace detail
 
 template<class Sub> inline auto
 lu_pivot(const readable_matrix<Sub>& M)
@@ -20,7 +53,7 @@ lu_pivot(const readable_matrix<Sub>& M)
 {
   cml::check_square(M);
   lu_pivot_result<temporary_of_t<Sub>> result(M);
-  result.sign = detail::lu_pivot_inplace(result.lu, result.order);
+  result.sign = detail::lu_pivot_inplace(result);
   return result;
 }
 
@@ -28,7 +61,164 @@ template<class Matrix> inline void
 lu_pivot(lu_pivot_result<Matrix>& result)
 {
   cml::check_square(result.lu);
-  result.sign = detail::lu_pivot_inplace(result.lu, result.order);
+  result.sign = detail::lu_pivot_inplace(result);
+}
+
+template<class Sub, class Matrix> inline void
+lu_pivot(const readable_matrix<Sub>& M, lu_pivot_result<Matrix>& result)
+{
+  cml::check_square(M);
+  result.lu = M;
+  detail::lu_resize_order(result.order, M.rows());
+  result.sign = detail::lu_pivot_inplace(result);
+}
+
+template<class Matrix> inline auto
+determinant(const lu_pivot_result<Matrix>& lup)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+
+  if(lup.sign == 0) return value_type(0);
+  const auto& LU = lup.lu;
+  value_type D = value_type(lup.sign);
+  for(int i = 0; i < LU.rows(); ++ i) D *= LU(i,i);
+  return D;
+}
+
+template<class Matrix> inline auto
+log_abs_determinant(const lu_pivot_result<Matrix>& lup, int& sign)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+  typedef traits_of_t<value_type>			value_traits;
+
+  sign = lup.sign;
+  if(sign == 0) return - std::numeric_limits<value_type>::infinity();
+
+  const auto& LU = lup.lu;
+  value_type L(0);
+  for(int i = 0; i < LU.rows(); ++ i) {
+    value_type u = LU(i,i);
+
+    /* lu_pivot() does not flag a zero last pivot as singular: */
+    if(u == value_type(0)) {
+      sign = 0;
+      return - std::numeric_limits<value_type>::infinity();
+    }
+
+    if(u < value_type(0)) sign = - sign;
+    L += value_traits::log(value_traits::fabs(u));
+  }
+  return L;
+}
+
+template<class Sub, class Matrix> inline auto
+determinant(const readable_matrix<Sub>& M, lu_pivot_result<Matrix>& workspace)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  lu_pivot(M, workspace);
+  return determinant(workspace);
+}
+
+template<class Sub, class Matrix> inline auto
+log_abs_determinant(const readable_matrix<Sub>& M, int& sign,
+  lu_pivot_result<Matrix>& workspace)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  lu_pivot(M, workspace);
+  return log_abs_determinant(workspace, sign);
+}
+
+template<class Matrix> inline Matrix
+inverse(const lu_pivot_result<Matrix>& lup)
+{
+  Matrix X(lup.lu);
+  X.identity();
+  lu_solve_inplace(lup, X);
+  return X;
+}
+
+template<class Matrix> inline auto
+inverse_norm_1_estimate(const lu_pivot_result<Matrix>& lup)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+  typedef traits_of_t<value_type>			value_traits;
+  typedef typename detail::lu_work_array<
+    cml::unqualified_type_t<decltype(lup.order)>, value_type>::type
+							work_type;
+
+  if(lup.sign == 0) return std::numeric_limits<value_type>::infinity();
+
+  const auto& LU = lup.lu;
+  const auto& P = lup.order;
+  const int N = LU.rows();
+  work_type x, y, z, d;
+  detail::lu_resize_order(x, N);
+  detail::lu_resize_order(y, N);
+  detail::lu_resize_order(z, N);
+  detail::lu_resize_order(d, N);
+  for(int i = 0; i < N; ++ i) d[i] = value_type(1)/value_type(LU(i,i));
+
+  auto sum_abs = [N](const work_type& v) {
+    value_type sum(0);
+    for(int i = 0; i < N; ++ i) sum += value_traits::fabs(v[i]);
+    return sum;
+  };
+
+  /* Start from the uniform vector, whose image has the average column norm
+   * of A^-1:
+   */
+  for(int i = 0; i < N; ++ i) x[i] = value_type(1)/value_type(N);
+  detail::lu_solve_array(LU, P, &d[0], &x[0], &y[0]);
+  value_type estimate = sum_abs(y);
+  if(N == 1) return estimate;
+
+  /* Hager's iteration: the sign vector of y gives the subgradient z of the
+   * norm, whose largest element selects the column of A^-1 to try next:
+   */
+  for(int iteration = 0; iteration < 5; ++ iteration) {
+    for(int i = 0; i < N; ++ i)
+      z[i] = (y[i] < value_type(0)) ? value_type(-1) : value_type(1);
+    detail::lu_solve_transpose_array(LU, P, &d[0], &z[0], &y[0]);
+
+    int j = 0;
+    value_type zx(0);
+    for(int i = 0; i < N; ++ i) {
+      zx += y[i]*x[i];
+      if(value_traits::fabs(y[i]) > value_traits::fabs(y[j])) j = i;
+    }
+    if(value_traits::fabs(y[j]) <= zx) break;
+
+    for(int i = 0; i < N; ++ i) x[i] = value_type(i == j ? 1 : 0);
+    detail::lu_solve_array(LU, P, &d[0], &x[0], &y[0]);
+    value_type next = sum_abs(y);
+    if(next <= estimate) break;
+    estimate = next;
+  }
+
+  /* Higham's alternating vector guards against the cases where the
+   * iteration stalls at a poor local maximum:
+   */
+  for(int i = 0; i < N; ++ i) {
+    value_type v = value_type(1) + value_type(i)/value_type(N-1);
+    x[i] = (i % 2) ? - v : v;
+  }
+  detail::lu_solve_array(LU, P, &d[0], &x[0], &y[0]);
+  value_type alternate = value_type(2)*sum_abs(y)/value_type(3*N);
+  return (alternate > estimate) ? alternate : estimate;
+}
+
+template<class Matrix> inline auto
+rcond_estimate(const lu_pivot_result<Matrix>& lup,
+  value_type_of_t<matrix_traits<Matrix>> norm)
+-> value_type_of_t<matrix_traits<Matrix>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+
+  if(lup.sign == 0 || norm == value_type(0)) return value_type(0);
+  return value_type(1)/(norm*inverse_norm_1_estimate(lup));
 }
 
 template<class Sub> inline auto
@@ -44,7 +234,8 @@ template<class LUSub, class BSub> inline auto
 lu_solve(const readable_matrix<LUSub>& LU, const readable_vector<BSub>& b)
 -> temporary_of_t<BSub>
 {
-  temporary_of_t<BSub> x; detail::check_or_resize(x, b);
+  auto x = detail::make_temporary<temporary_of_t<BSub>>(b.actual());
+  detail::check_or_resize(x, b);
   lu_solve(LU, x, b);
   return x;
 }
@@ -65,7 +256,9 @@ lu_solve(const readable_matrix<LUSub>& LU,
    * diagonal of LU correspond to L, understood to be below a diagonal of
    * 1's:
    */
-  temporary_of_t<XSub> y; detail::check_or_resize(y, b);
+  auto y = detail::make_temporary<temporary_of_t<XSub>>(
+    x.actual(), b.actual());
+  detail::check_or_resize(y, b);
   for(int i = 0; i < N; ++ i) {
     value_type sum(0);
     for(int j = 0; j < i; ++ j) sum += LU(i,j)*y[j];
@@ -89,7 +282,8 @@ template<class Matrix, class BSub> inline auto
 lu_solve(const lu_pivot_result<Matrix>& lup, const readable_vector<BSub>& b)
 -> temporary_of_t<BSub>
 {
-  temporary_of_t<BSub> x; detail::check_or_resize(x, b);
+  auto x = detail::make_temporary<temporary_of_t<BSub>>(b.actual());
+  detail::check_or_resize(x, b);
   lu_solve(lup, x, b);
   return x;
 }
@@ -113,7 +307,9 @@ lu_solve(const lu_pivot_result<Matrix>& lup,
    * diagonal of LU correspond to L, understood to be below a diagonal of
    * 1's:
    */
-  temporary_of_t<XSub> y; detail::check_or_resize(y, b);
+  auto y = detail::make_temporary<temporary_of_t<XSub>>(
+    x.actual(), b.actual());
+  detail::check_or_resize(y, b);
   for(int i = 0; i < N; ++ i) {
     value_type sum(0);
     for(int j = 0; j < i; ++ j) sum += LU(i,j)*y[j];
@@ -132,6 +328,46 @@ lu_solve(const lu_pivot_result<Matrix>& lup,
   /* Done. */
 }
 
+
+template<class Matrix, class BSub> inline auto
+lu_solve(const lu_pivot_result<Matrix>& lup, const readable_matrix<BSub>& B)
+-> temporary_of_t<BSub>
+{
+  auto X = detail::make_temporary<temporary_of_t<BSub>>(B.actual());
+  detail::check_or_resize(X, B);
+  lu_solve(lup, X, B);
+  return X;
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+lu_solve(const lu_pivot_result<Matrix>& lup,
+  writable_matrix<XSub>& X, const readable_matrix<BSub>& B)
+{
+  cml::check_same_inner_size(lup.lu, B);
+  cml_require(lup.sign != 0,
+    std::invalid_argument, "lup.sign == 0 (singular matrix?)");
+
+  /* Copy the rows of B to X in pivot order, unless B is X: */
+  if((const void*) &X.actual() == (const void*) &B.actual()) {
+    detail::lu_permute_rows(X, lup.order);
+  } else {
+    detail::check_or_resize(X, B);
+    const auto& P = lup.order;
+    for(int i = 0; i < X.rows(); ++ i)
+      for(int j = 0; j < X.cols(); ++ j) X.put(i,j, B.get(P[i],j));
+  }
+
+  /* Solve LUX = PB in place: */
+  detail::lu_substitute(lup.lu, X);
+}
+
+template<class Matrix, class BSub> inline void
+lu_solve_inplace(const lu_pivot_result<Matrix>& lup,
+  writable_matrix<BSub>& B)
+{
+  lu_solve(lup, B, B);
+}
+
 } // namespace cml
 
 // -------------------------------------------------------------------------
@@ -23,6 +23,40 @@ auto operator*(Sub1&& sub1, Sub2&& sub2)
   actual_operand_type_of_t<decltype(sub1)>,
   actual_operand_type_of_t<decltype(sub2)>>;
 
+/** Multiply two matrices using the Strassen-Winograd algorithm, and
+ * return the result as a temporary.  This takes O(n^2.81) operations
+ * rather than O(n^3), which pays off for large dynamic matrices (more
+ * than about 2048x2048).  The recursion stops at blocks having a
+ * dimension smaller than @c cutoff, which are multiplied by the packed
+ * kernel; if @c cutoff is 0 or less, gemm_blocking<>::strassen_cutoff is
+ * used.  Operands without contiguous storage are multiplied as by
+ * operator*().
+ *
+ * @note The result is not identical to operator*(), and its error is only
+ * bounded normwise: with @c d levels of recursion, @c n0 = @c n / 2^d,
+ * and unit roundoff @c u,
+ *
+ *   max|C - fl(C)| <= [ (n/n0)^log2(18) (n0^2 + 6 n0) - 6 n ] u
+ *                     max|A| max|B| + O(u^2)
+ *
+ * for @c n x @c n operands (Higham, "Accuracy and Stability of Numerical
+ * Algorithms", 2nd ed., Theorem 23.3).  This is weaker than the
+ * componentwise bound |C - fl(C)| <= n u |A| |B| of the conventional
+ * product, in particular for badly scaled operands.
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if either
+ * matrix is dynamically-sized, and @c sub1.cols() != @c sub2.rows().  If
+ * both are fixed-size expressions, then the sizes are checked at compile
+ * time.
+ */
+template<class Sub1, class Sub2,
+  enable_if_matrix_t<Sub1>* = nullptr,
+  enable_if_matrix_t<Sub2>* = nullptr>
+auto strassen_product(Sub1&& sub1, Sub2&& sub2, int cutoff = 0)
+-> matrix_inner_product_promote_t<
+  actual_operand_type_of_t<decltype(sub1)>,
+  actual_operand_type_of_t<decltype(sub2)>>;
+
 } // namespace cml
 
 #define __CML_MATRIX_MATRIX_PRODUCT_TPP
@@ -8,9 +8,213 @@
 #error "matrix/matrix_product.tpp not included correctly"
 #endif
 
+#include <cml/common/allocator.h>
 #include <cml/matrix/detail/resize.h>
+#include <cml/matrix/detail/gemm.h>
+#include <cml/matrix/detail/strassen.h>
+#include <cml/matrix/detail/mat44_product.h>
 
 namespace cml {
+namespace detail {
+
+/** Tag selecting the element-by-element matrix product. */
+struct generic_product_tag {};
+
+/** Tag selecting the packed gemm() kernel. */
+struct gemm_product_tag {};
+
+/** Tag selecting the fixed-size 4x4 kernel. */
+struct mat44_product_tag {};
+
+/** Tag selecting the symmetric syrk() kernel for A^T*A and A*A^T, if both
+ * operands turn out to be the same matrix at run-time.
+ */
+struct syrk_product_tag {};
+
+/** Defines @c type as the tag of the kernel used to compute the product of
+ * @c Left and @c Right into a @c Result matrix.
+ */
+template<class Result, class Left, class Right> struct matrix_product_kernel
+{
+  typedef value_type_trait_of_t<Result>			value_type;
+  typedef layout_tag_trait_of_t<Result>			layout_tag;
+
+  /* The kernels require operands sharing the element type of the
+   * result:
+   */
+  static const bool same_value_type
+    =  std::is_same<value_type_trait_of_t<Left>, value_type>::value
+    && std::is_same<value_type_trait_of_t<Right>, value_type>::value;
+
+  /* The 4x4 kernel also requires all three matrices to have the same
+   * layout:
+   */
+  static const bool same_layout
+    =  std::is_same<layout_tag_trait_of_t<Left>, layout_tag>::value
+    && std::is_same<layout_tag_trait_of_t<Right>, layout_tag>::value;
+
+  static const bool use_mat44
+    =  same_value_type && same_layout
+    && is_mat44_operand<Result>::value
+    && is_mat44_operand<Left>::value && is_mat44_operand<Right>::value;
+
+  /* The packed kernel also reads transposed operands directly: */
+  static const bool use_gemm
+    =  same_value_type && has_contiguous_data<Result>::value
+    && gemm_operand<Left>::value && gemm_operand<Right>::value;
+
+  static const bool use_syrk
+    = use_gemm && is_syrk_operand_pair<Left, Right>::value;
+
+  typedef typename std::conditional<use_mat44, mat44_product_tag,
+	  typename std::conditional<use_syrk, syrk_product_tag,
+	  typename std::conditional<use_gemm, gemm_product_tag,
+	  generic_product_tag>::type>::type>::type	type;
+};
+
+/** Compute @c M = @c sub1 * @c sub2 element-by-element for arbitrary
+ * matrix expressions.
+ */
+template<class Sub, class Sub1, class Sub2> inline void
+matrix_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  generic_product_tag)
+{
+  for(int i = 0; i < M.rows(); ++ i) {
+    for(int j = 0; j < M.cols(); ++ j) {
+      auto m = sub1(i,0) * sub2(0,j);
+      for(int k = 1; k < sub1.cols(); ++ k) m += sub1(i,k) * sub2(k,j);
+      M(i,j) = m;
+    }
+  }
+}
+
+/** Compute @c M = @c sub1 * @c sub2 using the packed gemm() kernel, when
+ * both operands have contiguous storage, or are the transpose of a matrix
+ * with contiguous storage.
+ */
+template<class Sub, class Sub1, class Sub2> inline void
+matrix_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  gemm_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  auto& C = M.actual();
+  detail::gemm(C.rows(), C.cols(), A.cols(),
+    left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    right_operand::data(B),
+    right_operand::row_stride(B), right_operand::col_stride(B),
+    C.data(), row_stride(C, layout()), col_stride(C, layout()));
+}
+
+/** Compute @c M = @c sub1 * @c sub2 using the symmetric syrk() kernel if
+ * the product is A^T*A or A*A^T for the same matrix A, or the packed
+ * gemm() kernel otherwise.
+ */
+template<class Sub, class Sub1, class Sub2> inline void
+matrix_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  syrk_product_tag)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  if(left_operand::source(A) != right_operand::source(B)) {
+    detail::matrix_product(M, sub1, sub2, gemm_product_tag());
+    return;
+  }
+
+  auto& C = M.actual();
+  detail::syrk(C.rows(), A.cols(), value_type(1), left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    C.data(), row_stride(C, layout()), col_stride(C, layout()));
+}
+
+/** Compute @c M = @c sub1 * @c sub2 for row-major 4x4 matrices. */
+template<class Sub, class Sub1, class Sub2> inline void
+mat44_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  row_major)
+{
+  detail::mat44_product(
+    sub1.actual().data(), sub2.actual().data(), M.actual().data());
+}
+
+/** Compute @c M = @c sub1 * @c sub2 for column-major 4x4 matrices. */
+template<class Sub, class Sub1, class Sub2> inline void
+mat44_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  col_major)
+{
+  /* The column-major arrays hold the transposes, so compute B^T * A^T: */
+  detail::mat44_product(
+    sub2.actual().data(), sub1.actual().data(), M.actual().data());
+}
+
+/** Compute @c M = @c sub1 * @c sub2 using the 4x4 kernel. */
+template<class Sub, class Sub1, class Sub2> inline void
+matrix_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  mat44_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  detail::mat44_product(M, sub1, sub2, layout());
+}
+
+/** strassen_product() for operands without contiguous storage, which are
+ * multiplied by the conventional kernel.
+ */
+template<class Sub, class Sub1, class Sub2, class Tag> inline void
+strassen_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  int, Tag)
+{
+  detail::matrix_product(M, sub1, sub2, Tag());
+}
+
+/** Compute @c M = @c sub1 * @c sub2 using the strassen() kernel. */
+template<class Sub, class Sub1, class Sub2> inline void
+strassen_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  int cutoff, gemm_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  auto& C = M.actual();
+  detail::strassen(C.rows(), C.cols(), A.cols(),
+    left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    right_operand::data(B),
+    right_operand::row_stride(B), right_operand::col_stride(B),
+    C.data(), row_stride(C, layout()), col_stride(C, layout()), cutoff);
+}
+
+/** strassen_product() for A^T*A and A*A^T, which uses the strassen()
+ * kernel like any other product.
+ */
+template<class Sub, class Sub1, class Sub2> inline void
+strassen_product(writable_matrix<Sub>& M,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  int cutoff, syrk_product_tag)
+{
+  detail::strassen_product(M, sub1, sub2, cutoff, gemm_product_tag());
+}
+
+} // namespace detail
 
 template<class Sub1, class Sub2,
   enable_if_matrix_t<Sub1>*, enable_if_matrix_t<Sub2>*>
@@ -22,18 +226,41 @@ inline auto operator*(Sub1&& sub1, Sub2&& sub2)
   typedef matrix_inner_product_promote_t<
     actual_operand_type_of_t<decltype(sub1)>,
     actual_operand_type_of_t<decltype(sub2)>>		result_type;
+  typedef cml::actual_type_of_t<Sub1>			left_type;
+  typedef cml::actual_type_of_t<Sub2>			right_type;
+  typedef typename detail::matrix_product_kernel<
+    result_type, left_type, right_type>::type		kernel_tag;
 
   cml::check_same_inner_size(sub1, sub2);
 
-  result_type M;
+  result_type M = detail::make_temporary<result_type>(sub1, sub2);
   detail::resize(M, array_rows_of(sub1), array_cols_of(sub2));
-  for(int i = 0; i < M.rows(); ++ i) {
-    for(int j = 0; j < M.cols(); ++ j) {
-      auto m = sub1(i,0) * sub2(0,j);
-      for(int k = 1; k < sub1.cols(); ++ k) m += sub1(i,k) * sub2(k,j);
-      M(i,j) = m;
-    }
-  }
+  detail::matrix_product(M, sub1, sub2, kernel_tag());
+  return M;
+}
+
+template<class Sub1, class Sub2,
+  enable_if_matrix_t<Sub1>*, enable_if_matrix_t<Sub2>*>
+inline auto strassen_product(Sub1&& sub1, Sub2&& sub2, int cutoff)
+-> matrix_inner_product_promote_t<
+  actual_operand_type_of_t<decltype(sub1)>,
+  actual_operand_type_of_t<decltype(sub2)>>
+{
+  typedef matrix_inner_product_promote_t<
+    actual_operand_type_of_t<decltype(sub1)>,
+    actual_operand_type_of_t<decltype(sub2)>>		result_type;
+  typedef value_type_trait_of_t<result_type>		value_type;
+  typedef cml::actual_type_of_t<Sub1>			left_type;
+  typedef cml::actual_type_of_t<Sub2>			right_type;
+  typedef typename detail::matrix_product_kernel<
+    result_type, left_type, right_type>::type		kernel_tag;
+
+  cml::check_same_inner_size(sub1, sub2);
+
+  if(cutoff <= 0) cutoff = gemm_blocking<value_type>::strassen_cutoff;
+  result_type M = detail::make_temporary<result_type>(sub1, sub2);
+  detail::resize(M, array_rows_of(sub1), array_cols_of(sub2));
+  detail::strassen_product(M, sub1, sub2, cutoff, kernel_tag());
   return M;
 }
 
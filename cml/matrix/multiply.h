@@ -0,0 +1,118 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_multiply_h
+#define	cml_matrix_multiply_h
+
+#include <stdexcept>
+#include <cml/vector/writable_vector.h>
+#include <cml/matrix/writable_matrix.h>
+
+namespace cml {
+
+/** Exception thrown when run-time alias checking is enabled, and the
+ * destination of a product shares memory with one of its operands.
+ */
+struct product_alias_error : std::runtime_error {
+  product_alias_error()
+    : std::runtime_error("product destination aliases an operand") {}
+};
+
+/** Compute @c C = @c A * @c B in place, resizing @c C if necessary.  No
+ * temporary is created for operands with storage, so a dynamically-sized
+ * @c C already having the right size is reused without allocating.  The
+ * same kernels as operator*() are used, so the result is identical.
+ *
+ * Operands that are expressions, other than the transpose of a matrix
+ * with storage, are evaluated into temporaries first, so they may read @c
+ * C.
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if @c A or @c
+ * B is dynamically-sized, and @c A.cols() != @c B.rows().  If both are
+ * fixed-size expressions, then the sizes are checked at compile time.
+ *
+ * @throws matrix_size_error at run-time if @c C is not resizable, and
+ * does not have the size of the product.
+ *
+ * @throws product_alias_error if NDEBUG is not defined, and @c C shares
+ * memory with @c A or @c B having storage, or transposing a matrix with
+ * storage.
+ */
+template<class Sub, class Sub1, class Sub2> Sub& multiply(
+  writable_matrix<Sub>& C,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B);
+
+/** Compute @c C = @c alpha * @c A * @c B + @c beta * @c C in place.  If
+ * @c beta is 0, @c C is not read and is resized if necessary; otherwise,
+ * it must already have the size of the product.  Expression operands are
+ * evaluated first, as for multiply().
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if @c A or @c
+ * B is dynamically-sized, and @c A.cols() != @c B.rows().  If both are
+ * fixed-size expressions, then the sizes are checked at compile time.
+ *
+ * @throws matrix_size_error at run-time if @c C does not have the size of
+ * the product, and @c beta is not 0 or @c C is not resizable.
+ *
+ * @throws product_alias_error if NDEBUG is not defined, and @c C shares
+ * memory with @c A or @c B having storage, or transposing a matrix with
+ * storage.
+ */
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+Sub& gemm(writable_matrix<Sub>& C, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  const Scalar2& beta);
+
+/** Compute @c y = @c A * @c x in place, resizing @c y if necessary.
+ * Operands that are expressions are evaluated into temporaries first, as
+ * for multiply() of matrices, so each element of @c x is computed once.
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if @c A or @c
+ * x is dynamically-sized, and @c A.cols() != @c x.size().  If both are
+ * fixed-size expressions, then the sizes are checked at compile time.
+ *
+ * @throws vector_size_error at run-time if @c y is not resizable, and
+ * does not have the size of the product.
+ *
+ * @throws product_alias_error if NDEBUG is not defined, and @c y shares
+ * memory with @c A or @c x having storage.
+ */
+template<class Sub, class Sub1, class Sub2> Sub& multiply(
+  writable_vector<Sub>& y,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x);
+
+/** Compute @c y = @c alpha * @c A * @c x + @c beta * @c y in place.  If
+ * @c beta is 0, @c y is not read and is resized if necessary; otherwise,
+ * it must already have the size of the product.  Expression operands are
+ * evaluated first, as for multiply().
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if @c A or @c
+ * x is dynamically-sized, and @c A.cols() != @c x.size().  If both are
+ * fixed-size expressions, then the sizes are checked at compile time.
+ *
+ * @throws vector_size_error at run-time if @c y does not have the size of
+ * the product, and @c beta is not 0 or @c y is not resizable.
+ *
+ * @throws product_alias_error if NDEBUG is not defined, and @c y shares
+ * memory with @c A or @c x having storage.
+ */
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+Sub& gemv(writable_vector<Sub>& y, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x,
+  const Scalar2& beta);
+
+} // namespace cml
+
+#define __CML_MATRIX_MULTIPLY_TPP
+#include <cml/matrix/multiply.tpp>
+#undef __CML_MATRIX_MULTIPLY_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
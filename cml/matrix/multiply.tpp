@@ -0,0 +1,345 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_MULTIPLY_TPP
+#error "matrix/multiply.tpp not included correctly"
+#endif
+
+#include <cml/common/exception.h>
+#include <cml/vector/detail/aliasing.h>
+#include <cml/vector/size_checking.h>
+#include <cml/vector/detail/check_or_resize.h>
+#include <cml/matrix/size_checking.h>
+#include <cml/matrix/matrix_product.h>
+#include <cml/matrix/transpose_node.h>
+#include <cml/matrix/detail/check_or_resize.h>
+
+namespace cml {
+namespace detail {
+
+/** Defines @c type as std::true_type if products read @c Sub directly:
+ * @c Sub is a matrix or vector with contiguous storage, or the transpose
+ * of such a matrix.  Otherwise, @c Sub is an expression that may read any
+ * object, and @c type is std::false_type.
+ */
+template<class Sub> struct is_stored_operand
+{
+  typedef std::integral_constant<bool,
+    has_contiguous_data<Sub>::value>			type;
+};
+
+/** is_stored_operand for a transposed matrix. */
+template<class Sub> struct is_stored_operand<matrix_transpose_node<Sub>>
+{
+  typedef std::integral_constant<bool,
+    has_contiguous_data<Sub>::value>			type;
+};
+
+/* stored_operand() for operands with storage, which are returned
+ * as-is.
+ */
+template<class Sub, class Dest> inline const Sub&
+stored_operand(const Sub& sub, const Dest&, std::true_type)
+{
+  return sub;
+}
+
+/* stored_operand() for expressions, which are evaluated into a temporary
+ * using the allocator of @c dest, if any.
+ */
+template<class Sub, class Dest> inline temporary_of_t<Sub>
+stored_operand(const Sub& sub, const Dest& dest, std::false_type)
+{
+  auto temp = make_temporary<temporary_of_t<Sub>>(dest);
+  temp = sub;
+  return temp;
+}
+
+/** Return @c sub if products read it directly, or @c sub evaluated into a
+ * temporary otherwise, so that the product can be written to @c dest even
+ * if the expression reads it.
+ */
+template<class Sub, class Dest> inline auto
+stored_operand(const Sub& sub, const Dest& dest)
+-> decltype(stored_operand(
+    sub, dest, typename is_stored_operand<Sub>::type()))
+{
+  return stored_operand(sub, dest, typename is_stored_operand<Sub>::type());
+}
+
+#ifndef NDEBUG
+/** Throw product_alias_error if @c dest shares memory with the operand @c
+ * src, which has contiguous storage.
+ */
+template<class Dest, class Src> inline void
+check_product_alias(const Dest& dest, const Src& src)
+{
+  cml_require(!overlaps(make_alias_target(dest), make_alias_target(src)),
+    product_alias_error, /**/);
+}
+#else
+/** Products are not checked for aliasing if NDEBUG is defined. */
+template<class Dest, class Src> inline void
+check_product_alias(const Dest&, const Src&)
+{
+}
+#endif
+
+/** check_product_alias() for a transposed operand, which shares memory
+ * with the matrix it transposes.
+ */
+template<class Dest, class Sub> inline void
+check_product_alias(const Dest& dest, const matrix_transpose_node<Sub>& src)
+{
+  detail::check_product_alias(dest, src.sub());
+}
+
+
+/** Compute @c C = @c alpha * @c sub1 * @c sub2 + @c beta * @c C
+ * element-by-element for arbitrary matrix expressions.
+ */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+matrix_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, generic_product_tag)
+{
+  for(int i = 0; i < C.rows(); ++ i) {
+    for(int j = 0; j < C.cols(); ++ j) {
+      auto m = sub1(i,0) * sub2(0,j);
+      for(int k = 1; k < sub1.cols(); ++ k) m += sub1(i,k) * sub2(k,j);
+      if(beta == T(0))
+	C.put(i,j, alpha*m);
+      else
+	C.put(i,j, alpha*m + beta*C.get(i,j));
+    }
+  }
+}
+
+/** Compute @c C = @c alpha * @c sub1 * @c sub2 + @c beta * @c C using the
+ * packed gemm() kernel.
+ */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+matrix_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, gemm_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  auto& M = C.actual();
+  detail::gemm(M.rows(), M.cols(), A.cols(), alpha,
+    left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    right_operand::data(B),
+    right_operand::row_stride(B), right_operand::col_stride(B),
+    beta, M.data(), row_stride(M, layout()), col_stride(M, layout()));
+}
+
+/** Compute @c C = @c alpha * @c sub1 * @c sub2 + @c beta * @c C using the
+ * symmetric syrk() kernel if @c beta is 0, and the product is A^T*A or
+ * A*A^T for the same matrix A.  Otherwise, the packed gemm() kernel is
+ * used, since @c C itself need not be symmetric.
+ */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+matrix_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, syrk_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  if(beta != T(0) || left_operand::source(A) != right_operand::source(B)) {
+    detail::matrix_product(C, alpha, sub1, sub2, beta, gemm_product_tag());
+    return;
+  }
+
+  auto& M = C.actual();
+  detail::syrk(M.rows(), A.cols(), alpha, left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    M.data(), row_stride(M, layout()), col_stride(M, layout()));
+}
+
+/** Compute the product of row-major 4x4 arrays @c A and @c B into @c C. */
+template<class T> inline void
+mat44_product(const T* A, const T* B, T* C, row_major)
+{
+  detail::mat44_product(A, B, C);
+}
+
+/** Compute the product of column-major 4x4 arrays @c A and @c B into @c
+ * C.
+ */
+template<class T> inline void
+mat44_product(const T* A, const T* B, T* C, col_major)
+{
+  detail::mat44_product(B, A, C);
+}
+
+/** Compute @c C = @c alpha * @c sub1 * @c sub2 + @c beta * @c C using the
+ * 4x4 kernel.
+ */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+matrix_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, mat44_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+
+  T P[16];
+  detail::mat44_product(
+    sub1.actual().data(), sub2.actual().data(), P, layout());
+
+  T* c = C.actual().data();
+  if(beta == T(0)) {
+    for(int t = 0; t < 16; ++ t) c[t] = alpha*P[t];
+  } else {
+    for(int t = 0; t < 16; ++ t) c[t] = alpha*P[t] + beta*c[t];
+  }
+}
+
+/** multiply() once both operands have storage. */
+template<class Sub, class Sub1, class Sub2> inline Sub&
+multiply(writable_matrix<Sub>& C,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B)
+{
+  typedef typename detail::matrix_product_kernel<
+    Sub, Sub1, Sub2>::type				kernel_tag;
+
+  detail::check_product_alias(C.actual(), A.actual());
+  detail::check_product_alias(C.actual(), B.actual());
+  detail::check_or_resize(C, array_rows_of(A), array_cols_of(B));
+  detail::matrix_product(C, A, B, kernel_tag());
+  return C.actual();
+}
+
+/** gemm() once both operands have storage. */
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+inline Sub&
+gemm(writable_matrix<Sub>& C, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  const Scalar2& beta)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef typename detail::matrix_product_kernel<
+    Sub, Sub1, Sub2>::type				kernel_tag;
+
+  detail::check_product_alias(C.actual(), A.actual());
+  detail::check_product_alias(C.actual(), B.actual());
+
+  /* C is only read if beta is not 0: */
+  value_type a = value_type(alpha), b = value_type(beta);
+  if(b == value_type(0))
+    detail::check_or_resize(C, array_rows_of(A), array_cols_of(B));
+  else
+    cml::check_size(C, array_rows_of(A), array_cols_of(B));
+
+  detail::matrix_product(C, a, A, B, b, kernel_tag());
+  return C.actual();
+}
+
+/** multiply() for vectors once both operands have storage. */
+template<class Sub, class Sub1, class Sub2> inline Sub&
+multiply(writable_vector<Sub>& y,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x)
+{
+  detail::check_product_alias(y.actual(), A.actual());
+  detail::check_product_alias(y.actual(), x.actual());
+  detail::check_or_resize(y, array_rows_of(A));
+  for(int i = 0; i < y.size(); ++ i) {
+    auto m = A(i,0) * x[0];
+    for(int k = 1; k < x.size(); ++ k) m += A(i,k) * x[k];
+    y.put(i, m);
+  }
+  return y.actual();
+}
+
+/** gemv() once both operands have storage. */
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+inline Sub&
+gemv(writable_vector<Sub>& y, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x,
+  const Scalar2& beta)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+
+  detail::check_product_alias(y.actual(), A.actual());
+  detail::check_product_alias(y.actual(), x.actual());
+
+  /* y is only read if beta is not 0: */
+  value_type a = value_type(alpha), b = value_type(beta);
+  if(b == value_type(0))
+    detail::check_or_resize(y, array_rows_of(A));
+  else
+    cml::check_size(y, array_rows_of(A));
+
+  for(int i = 0; i < y.size(); ++ i) {
+    auto m = A(i,0) * x[0];
+    for(int k = 1; k < x.size(); ++ k) m += A(i,k) * x[k];
+    if(b == value_type(0))
+      y.put(i, a*m);
+    else
+      y.put(i, a*m + b*y.get(i));
+  }
+  return y.actual();
+}
+
+} // namespace detail
+
+
+template<class Sub, class Sub1, class Sub2> inline Sub&
+multiply(writable_matrix<Sub>& C,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B)
+{
+  cml::check_same_inner_size(A, B);
+  return detail::multiply(C,
+    detail::stored_operand(A.actual(), C.actual()),
+    detail::stored_operand(B.actual(), C.actual()));
+}
+
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+inline Sub&
+gemm(writable_matrix<Sub>& C, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  const Scalar2& beta)
+{
+  cml::check_same_inner_size(A, B);
+  return detail::gemm(C, alpha,
+    detail::stored_operand(A.actual(), C.actual()),
+    detail::stored_operand(B.actual(), C.actual()), beta);
+}
+
+template<class Sub, class Sub1, class Sub2> inline Sub&
+multiply(writable_vector<Sub>& y,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x)
+{
+  cml::check_same_inner_size(A, x);
+  return detail::multiply(y,
+    detail::stored_operand(A.actual(), y.actual()),
+    detail::stored_operand(x.actual(), y.actual()));
+}
+
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+inline Sub&
+gemv(writable_vector<Sub>& y, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_vector<Sub2>& x,
+  const Scalar2& beta)
+{
+  cml::check_same_inner_size(A, x);
+  return detail::gemv(y, alpha,
+    detail::stored_operand(A.actual(), y.actual()),
+    detail::stored_operand(x.actual(), y.actual()), beta);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
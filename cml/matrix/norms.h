@@ -0,0 +1,44 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_norms_h
+#define	cml_matrix_norms_h
+
+#include <cml/common/traits.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+
+/** Return the 1-norm of @c M, the largest sum of the absolute values of
+ * the elements of a column.
+ */
+template<class Sub> auto
+norm_1(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>;
+
+/** Return the infinity-norm of @c M, the largest sum of the absolute
+ * values of the elements of a row.
+ */
+template<class Sub> auto
+norm_inf(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>;
+
+/** Return the Frobenius norm of @c M, the square root of the sum of the
+ * squares of its elements.
+ */
+template<class Sub> auto
+norm_frobenius(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>;
+
+} // namespace cml
+
+#define __CML_MATRIX_NORMS_TPP
+#include <cml/matrix/norms.tpp>
+#undef __CML_MATRIX_NORMS_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,64 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_NORMS_TPP
+#error "matrix/norms.tpp not included correctly"
+#endif
+
+#include <cml/scalar/traits.h>
+#include <cml/matrix/readable_matrix.h>
+
+namespace cml {
+
+template<class Sub> inline auto
+norm_1(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef traits_of_t<value_type>			element_traits;
+
+  value_type result(0);
+  for(int j = 0; j < M.cols(); ++ j) {
+    value_type sum(0);
+    for(int i = 0; i < M.rows(); ++ i) sum += element_traits::fabs(M.get(i,j));
+    if(sum > result) result = sum;
+  }
+  return result;
+}
+
+template<class Sub> inline auto
+norm_inf(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef traits_of_t<value_type>			element_traits;
+
+  value_type result(0);
+  for(int i = 0; i < M.rows(); ++ i) {
+    value_type sum(0);
+    for(int j = 0; j < M.cols(); ++ j) sum += element_traits::fabs(M.get(i,j));
+    if(sum > result) result = sum;
+  }
+  return result;
+}
+
+template<class Sub> inline auto
+norm_frobenius(const readable_matrix<Sub>& M) -> value_type_trait_of_t<Sub>
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef traits_of_t<value_type>			element_traits;
+
+  value_type sum(0);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) {
+      value_type m = M.get(i,j);
+      sum += m*m;
+    }
+  return element_traits::sqrt(sum);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,54 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * LU decomposition with multi-threaded trailing updates.  Like
+ * cml/matrix/parallel_multiply.h, this header is not included by
+ * cml/matrix.h, since programs using it must be linked with the platform
+ * thread library.
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_parallel_lu_h
+#define	cml_matrix_parallel_lu_h
+
+#include <cml/matrix/lu.h>
+#include <cml/matrix/parallel_multiply.h>
+
+namespace cml {
+namespace parallel {
+
+/** Compute the LU decomposition of M with partial pivoting, like
+ * cml::lu_pivot(), computing the trailing updates of the blocked algorithm
+ * with up to @c threads threads.  If @c threads is 0 or less,
+ * default_threads() is used.  Each update is split as by
+ * parallel::multiply(), so the result does not depend on the number of
+ * threads, and is identical to cml::lu_pivot().
+ *
+ * @note if @c result.sign is 0, the input matrix is singular.
+ */
+template<class Sub> auto
+lu_pivot(const readable_matrix<Sub>& M, int threads = 0)
+-> lu_pivot_result< temporary_of_t<Sub> >;
+
+/** In-place computation of the partial-pivoting LU decomposition of @c
+ * result.lu, using up to @c threads threads as above.
+ *
+ * @note if @c result.sign is 0, the input matrix is singular.
+ */
+template<class Matrix> void
+lu_pivot(lu_pivot_result<Matrix>& result, int threads = 0);
+
+} // namespace parallel
+} // namespace cml
+
+#define __CML_MATRIX_PARALLEL_LU_TPP
+#include <cml/matrix/parallel_lu.tpp>
+#undef __CML_MATRIX_PARALLEL_LU_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
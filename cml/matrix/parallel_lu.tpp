@@ -0,0 +1,60 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_PARALLEL_LU_TPP
+#error "matrix/parallel_lu.tpp not included correctly"
+#endif
+
+namespace cml {
+namespace detail {
+
+/** Trailing-update policy for lu_pivot_inplace(), computing each update
+ * with parallel_gemm().
+ */
+struct lu_parallel_update
+{
+  explicit lu_parallel_update(int threads) : threads(threads) {}
+
+  template<class T> void operator()(int m, int n, int k, T alpha,
+    const T* A, int a_rs, int a_cs,
+    const T* B, int b_rs, int b_cs,
+    T beta, T* C, int c_rs, int c_cs) const
+  {
+    detail::parallel_gemm(threads, m, n, k, alpha,
+      A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs);
+  }
+
+  int threads;
+};
+
+} // namespace detail
+
+namespace parallel {
+
+template<class Sub> inline auto
+lu_pivot(const readable_matrix<Sub>& M, int threads)
+-> lu_pivot_result< temporary_of_t<Sub> >
+{
+  cml::check_square(M);
+  lu_pivot_result<temporary_of_t<Sub>> result(M);
+  parallel::lu_pivot(result, threads);
+  return result;
+}
+
+template<class Matrix> inline void
+lu_pivot(lu_pivot_result<Matrix>& result, int threads)
+{
+  cml::check_square(result.lu);
+  if(threads <= 0) threads = default_threads();
+  result.sign = detail::lu_pivot_inplace(
+    result.lu, result.order, detail::lu_parallel_update(threads));
+}
+
+} // namespace parallel
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
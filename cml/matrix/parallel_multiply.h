@@ -0,0 +1,70 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Multi-threaded matrix products.  This header is not included by
+ * cml/matrix.h, since programs using it must be linked with the platform
+ * thread library (e.g. -pthread).
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_parallel_multiply_h
+#define	cml_matrix_parallel_multiply_h
+
+#include <cml/matrix/multiply.h>
+
+namespace cml {
+namespace parallel {
+
+/** Return the number of threads used by default, which is the number of
+ * hardware threads reported by the platform, or 1 if it is unknown.
+ */
+inline int default_threads();
+
+/** Compute @c C = @c A * @c B in place using up to @c threads threads,
+ * resizing @c C if necessary.  If @c threads is 0 or less,
+ * default_threads() is used.
+ *
+ * @c C is split into contiguous strips of rows or columns, one per
+ * thread, each of which is computed by the packed gemm() kernel.  The
+ * summation order of each element of @c C does not depend on the
+ * partitioning, so the result is identical for any number of threads,
+ * and to cml::multiply().
+ *
+ * Products that cannot use the packed kernel, or that have fewer than
+ * gemm_blocking<>::parallel_product multiply-adds, are computed by
+ * cml::multiply() on the calling thread.
+ *
+ * @throws the same exceptions as cml::multiply().  An exception thrown by
+ * a worker thread is rethrown on the calling thread after all workers
+ * have finished.
+ */
+template<class Sub, class Sub1, class Sub2> Sub& multiply(
+  writable_matrix<Sub>& C,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  int threads = 0);
+
+/** Compute @c C = @c alpha * @c A * @c B + @c beta * @c C in place using
+ * up to @c threads threads.  The partitioning and fallback are the same as
+ * for parallel::multiply(), and the result is identical to cml::gemm().
+ *
+ * @throws the same exceptions as cml::gemm().
+ */
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+Sub& gemm(writable_matrix<Sub>& C, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  const Scalar2& beta, int threads = 0);
+
+} // namespace parallel
+} // namespace cml
+
+#define __CML_MATRIX_PARALLEL_MULTIPLY_TPP
+#include <cml/matrix/parallel_multiply.tpp>
+#undef __CML_MATRIX_PARALLEL_MULTIPLY_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,199 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_PARALLEL_MULTIPLY_TPP
+#error "matrix/parallel_multiply.tpp not included correctly"
+#endif
+
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+namespace cml {
+namespace detail {
+
+/** Compute @c C = @c alpha * @c A * @c B + @c beta * @c C like gemm(),
+ * splitting the larger dimension of @c C into strips computed by up to @c
+ * threads threads.  Strip boundaries are multiples of the register tile
+ * size, and the calling thread computes the first strip.
+ */
+template<class T> inline void
+parallel_gemm(int threads, int m, int n, int k, T alpha,
+  const T* A, int a_rs, int a_cs,
+  const T* B, int b_rs, int b_cs,
+  T beta, T* C, int c_rs, int c_cs)
+{
+  typedef gemm_blocking<T>				blocking;
+
+  /* Use a single thread if there is not enough work to share: */
+  if(threads <= 1 || k == 0 || gemm_is_small<T>(m, n, k)
+    || double(m)*double(n)*double(k) < double(blocking::parallel_product))
+  {
+    detail::gemm(m, n, k, alpha,
+      A, a_rs, a_cs, B, b_rs, b_cs, beta, C, c_rs, c_cs);
+    return;
+  }
+
+  /* Split the rows of C if it is tall, otherwise its columns: */
+  bool split_rows = (m >= n);
+  int extent = split_rows ? m : n;
+  int tile = split_rows ? blocking::mr : blocking::nr;
+  int tiles = (extent + tile - 1)/tile;
+  int strips = std::min(threads, tiles);
+  int strip = (tiles + strips - 1)/strips*tile;
+
+  std::vector<std::exception_ptr> errors(strips);
+  auto compute_strip = [&](int s) {
+    try {
+      int first = s*strip, last = std::min(extent, first + strip);
+      if(first >= last) return;
+      if(split_rows) {
+	detail::gemm_blocked(last - first, n, k, alpha,
+	  A + first*a_rs, a_rs, a_cs, B, b_rs, b_cs,
+	  beta, C + first*c_rs, c_rs, c_cs);
+      } else {
+	detail::gemm_blocked(m, last - first, k, alpha,
+	  A, a_rs, a_cs, B + first*b_cs, b_rs, b_cs,
+	  beta, C + first*c_cs, c_rs, c_cs);
+      }
+    } catch(...) {
+      errors[s] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(strips - 1);
+  try {
+    for(int s = 1; s < strips; ++ s)
+      workers.emplace_back(compute_strip, s);
+  } catch(...) {
+    /* Compute the strips that did not get a thread here: */
+    for(int s = int(workers.size()) + 1; s < strips; ++ s)
+      compute_strip(s);
+  }
+  compute_strip(0);
+  for(auto& w : workers) w.join();
+
+  for(const auto& e : errors) if(e) std::rethrow_exception(e);
+}
+
+/** parallel_product() for products that cannot use the packed kernel,
+ * which are computed on the calling thread.
+ */
+template<class Sub, class Sub1, class Sub2, class T, class Tag> inline void
+parallel_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, int, Tag)
+{
+  detail::matrix_product(C, alpha, sub1, sub2, beta, Tag());
+}
+
+/** parallel_product() for products using the packed kernel. */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+parallel_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, int threads, gemm_product_tag)
+{
+  typedef layout_tag_trait_of_t<Sub>			layout;
+  typedef gemm_operand<Sub1>				left_operand;
+  typedef gemm_operand<Sub2>				right_operand;
+
+  const auto& A = sub1.actual();
+  const auto& B = sub2.actual();
+  auto& M = C.actual();
+  detail::parallel_gemm(threads, M.rows(), M.cols(), A.cols(), alpha,
+    left_operand::data(A),
+    left_operand::row_stride(A), left_operand::col_stride(A),
+    right_operand::data(B),
+    right_operand::row_stride(B), right_operand::col_stride(B),
+    beta, M.data(), row_stride(M, layout()), col_stride(M, layout()));
+}
+
+/** parallel_product() for A^T*A and A*A^T.  The full product is split
+ * between threads, which gives the same result as the symmetric kernel.
+ */
+template<class Sub, class Sub1, class Sub2, class T> inline void
+parallel_product(writable_matrix<Sub>& C, T alpha,
+  const readable_matrix<Sub1>& sub1, const readable_matrix<Sub2>& sub2,
+  T beta, int threads, syrk_product_tag)
+{
+  detail::parallel_product(
+    C, alpha, sub1, sub2, beta, threads, gemm_product_tag());
+}
+
+} // namespace detail
+
+namespace parallel {
+
+inline int
+default_threads()
+{
+  unsigned int n = std::thread::hardware_concurrency();
+  return (n > 0) ? int(n) : 1;
+}
+
+template<class Sub, class Sub1, class Sub2> inline Sub&
+multiply(writable_matrix<Sub>& C,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  int threads)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef typename detail::matrix_product_kernel<
+    Sub, Sub1, Sub2>::type				kernel_tag;
+
+  /* Only the packed kernels are threaded: */
+  if(!std::is_same<kernel_tag, detail::gemm_product_tag>::value
+    && !std::is_same<kernel_tag, detail::syrk_product_tag>::value)
+    return cml::multiply(C, A, B);
+
+  cml::check_same_inner_size(A, B);
+  detail::check_product_alias(C.actual(), A.actual());
+  detail::check_product_alias(C.actual(), B.actual());
+  detail::check_or_resize(C, array_rows_of(A), array_cols_of(B));
+
+  if(threads <= 0) threads = default_threads();
+  detail::parallel_product(C, value_type(1), A, B, value_type(0),
+    threads, kernel_tag());
+  return C.actual();
+}
+
+template<class Sub, class Scalar1, class Sub1, class Sub2, class Scalar2>
+inline Sub&
+gemm(writable_matrix<Sub>& C, const Scalar1& alpha,
+  const readable_matrix<Sub1>& A, const readable_matrix<Sub2>& B,
+  const Scalar2& beta, int threads)
+{
+  typedef value_type_trait_of_t<Sub>			value_type;
+  typedef typename detail::matrix_product_kernel<
+    Sub, Sub1, Sub2>::type				kernel_tag;
+
+  /* Only the packed kernels are threaded: */
+  if(!std::is_same<kernel_tag, detail::gemm_product_tag>::value
+    && !std::is_same<kernel_tag, detail::syrk_product_tag>::value)
+    return cml::gemm(C, alpha, A, B, beta);
+
+  cml::check_same_inner_size(A, B);
+  detail::check_product_alias(C.actual(), A.actual());
+  detail::check_product_alias(C.actual(), B.actual());
+
+  /* C is only read if beta is not 0: */
+  value_type a = value_type(alpha), b = value_type(beta);
+  if(b == value_type(0))
+    detail::check_or_resize(C, array_rows_of(A), array_cols_of(B));
+  else
+    cml::check_size(C, array_rows_of(A), array_cols_of(B));
+
+  if(threads <= 0) threads = default_threads();
+  detail::parallel_product(C, a, A, B, b, threads, kernel_tag());
+  return C.actual();
+}
+
+} // namespace parallel
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,137 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_qr_h
+#define	cml_matrix_qr_h
+
+#include <array>
+#include <vector>
+#include <cml/common/type_util.h>
+#include <cml/common/array_size_of.h>
+#include <cml/vector/temporary.h>
+#include <cml/matrix/temporary.h>
+#include <cml/matrix/promotion.h>
+
+namespace cml {
+
+/** Specializable class to hold results from Householder QR
+ * decomposition.  @c qr holds R at and above its diagonal, and the
+ * Householder vectors below it.  The vector v_k defining the reflector H_k
+ * = I - @c tau[k] v_k v_k^T is stored in column @c k below the diagonal,
+ * with an implicit 1 on the diagonal.  Q = H_0 H_1 ... H_n-1 is not
+ * formed.
+ */
+template<class Matrix, class Enable = void> struct qr_result;
+
+/** Results from Householder QR decomposition of a fixed-size matrix. */
+template<class Matrix>
+struct qr_result<Matrix, enable_if_fixed_size_t<matrix_traits<Matrix>>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+  static const int N = array_cols_of_c<matrix_traits<Matrix>>::value;
+
+  Matrix			qr;
+  std::array<value_type,N>	tau;
+
+  explicit qr_result(const Matrix& M) : qr(M), tau() {}
+};
+
+/** Results from Householder QR decomposition of a dynamic-size matrix. */
+template<class Matrix>
+struct qr_result<Matrix, enable_if_dynamic_size_t<matrix_traits<Matrix>>>
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+
+  Matrix			qr;
+  std::vector<value_type>	tau;
+
+  explicit qr_result(const Matrix& M) : qr(M), tau(M.cols()) {}
+};
+
+
+/** Compute the Householder QR decomposition A = QR of the @c m x @c n
+ * matrix @c A, where @c m >= @c n.  The result is returned in a
+ * qr_result.  Matrices with more than qr_blocking<>::nb columns are
+ * factored by panels, each applied to the remaining columns as a block
+ * reflector using the packed matrix product.
+ *
+ * @throws minimum_matrix_size_error at run-time if @c A has fewer rows
+ * than columns.
+ */
+template<class Sub> auto
+qr(const readable_matrix<Sub>& A)
+-> qr_result< temporary_of_t<Sub> >;
+
+/** In-place computation of the Householder QR decomposition of @c
+ * result.qr.
+ *
+ * @throws minimum_matrix_size_error at run-time if @c result.qr has fewer
+ * rows than columns.
+ */
+template<class Matrix> void
+qr(qr_result<Matrix>& result);
+
+/** Overwrite @c b with Q^T @c b, applying the reflectors of @c qr one at
+ * a time.  @c b must have as many elements as @c qr.qr has rows.
+ */
+template<class Matrix, class Sub> void
+qr_apply_transpose(const qr_result<Matrix>& qr, writable_vector<Sub>& b);
+
+/** Overwrite each column of @c B with Q^T times the column.  @c B must
+ * have as many rows as @c qr.qr.
+ */
+template<class Matrix, class Sub> void
+qr_apply_transpose(const qr_result<Matrix>& qr, writable_matrix<Sub>& B);
+
+/** Compute the least-squares solution @c x minimizing ||A x - @c b||,
+ * where @c qr is the QR decomposition of A.  Q^T @c b is computed
+ * implicitly, and R x = (Q^T b)[0:n] is solved by back substitution.  @c b
+ * must have as many elements as A has rows, and @c x is resized to the
+ * number of columns of A if possible.
+ *
+ * @throws std::invalid_argument if A is numerically rank deficient, i.e.
+ * if the magnitude of a diagonal element of R is at most m*epsilon times
+ * the largest one.
+ */
+template<class Matrix, class XSub, class BSub> void
+qr_solve_least_squares(const qr_result<Matrix>& qr,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b);
+
+/** Compute the least-squares solution of A x = @c b from the QR
+ * decomposition of A, and return it as a temporary vector.
+ *
+ * @throws std::invalid_argument if A is numerically rank deficient.
+ */
+template<class Matrix, class BSub> auto
+qr_solve_least_squares(const qr_result<Matrix>& qr,
+  const readable_vector<BSub>& b) -> row_type_of_t<Matrix>;
+
+/** Compute the least-squares solution of @c A x = @c b, and return it as
+ * a temporary vector.  This is equivalent to computing qr(A), then
+ * solving with it; to solve for several right-hand sides, keep the
+ * qr_result instead.
+ *
+ * @throws minimum_matrix_size_error at run-time if @c A has fewer rows
+ * than columns.
+ *
+ * @throws std::invalid_argument if @c A is numerically rank deficient.
+ */
+template<class ASub, class BSub> auto
+qr_solve_least_squares(const readable_matrix<ASub>& A,
+  const readable_vector<BSub>& b) -> row_type_of_t<temporary_of_t<ASub>>;
+
+} // namespace cml
+
+#define __CML_MATRIX_QR_TPP
+#include <cml/matrix/qr.tpp>
+#undef __CML_MATRIX_QR_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
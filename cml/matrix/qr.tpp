@@ -0,0 +1,115 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_QR_TPP
+#error "matrix/qr.tpp not included correctly"
+#endif
+
+#include <cml/common/traits.h>
+#include <cml/common/allocator.h>
+#include <cml/vector/writable_vector.h>
+#include <cml/vector/detail/check_or_resize.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/size_checking.h>
+#include <cml/matrix/detail/check_or_resize.h>
+#include <cml/matrix/detail/qr.h>
+
+namespace cml {
+
+template<class Sub> inline auto
+qr(const readable_matrix<Sub>& A)
+-> qr_result< temporary_of_t<Sub> >
+{
+  qr_result<temporary_of_t<Sub>> result(A);
+  qr(result);
+  return result;
+}
+
+template<class Matrix> inline void
+qr(qr_result<Matrix>& result)
+{
+  typedef layout_tag_trait_of_t<Matrix>			layout;
+  static_assert(has_contiguous_data<Matrix>::value,
+    "qr_result requires a matrix with contiguous storage");
+
+  auto& A = result.qr;
+  cml::check_minimum_size(A, A.cols(), 0);
+  detail::qr_blocked(A.rows(), A.cols(), A.data(),
+    detail::row_stride(A, layout()), detail::col_stride(A, layout()),
+    result.tau.data());
+}
+
+template<class Matrix, class Sub> inline void
+qr_apply_transpose(const qr_result<Matrix>& qr, writable_vector<Sub>& b)
+{
+  cml::check_same_inner_size(b, qr.qr);
+  detail::qr_apply_transpose(qr.qr, qr.tau, b);
+}
+
+template<class Matrix, class Sub> inline void
+qr_apply_transpose(const qr_result<Matrix>& qr, writable_matrix<Sub>& B)
+{
+  cml_require(B.rows() == qr.qr.rows(),
+    incompatible_matrix_row_size_error, /**/);
+  detail::qr_apply_transpose(qr.qr, qr.tau, B);
+}
+
+template<class Matrix, class XSub, class BSub> inline void
+qr_solve_least_squares(const qr_result<Matrix>& qr,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b)
+{
+  typedef value_type_of_t<matrix_traits<Matrix>>	value_type;
+  typedef traits_of_t<value_type>			value_traits;
+
+  const auto& QR = qr.qr;
+  int m = QR.rows(), n = QR.cols();
+  cml::check_same_inner_size(b, QR);
+  detail::check_or_resize(x, n);
+
+  /* Check the diagonal of R for numerical rank deficiency: */
+  value_type rmax(0);
+  for(int i = 0; i < n; ++ i)
+    rmax = std::max(rmax, value_type(value_traits::fabs(QR(i,i))));
+  value_type tol = value_type(m)*value_traits::epsilon()*rmax;
+  for(int i = 0; i < n; ++ i)
+    cml_require(value_traits::fabs(QR(i,i)) > tol,
+      std::invalid_argument, "rank-deficient matrix");
+
+  /* Compute y = Q^T b in a temporary shaped like b: */
+  auto y = detail::make_temporary<temporary_of_t<BSub>>(
+    x.actual(), b.actual());
+  detail::check_or_resize(y, b);
+  for(int i = 0; i < m; ++ i) y.put(i, b.get(i));
+  detail::qr_apply_transpose(QR, qr.tau, y);
+
+  /* Solve R x = y[0:n] by backward substitution: */
+  for(int i = n-1; i >= 0; -- i) {
+    value_type s = y[i];
+    for(int j = i+1; j < n; ++ j) s -= QR(i,j)*x[j];
+    x[i] = s/QR(i,i);
+  }
+}
+
+template<class Matrix, class BSub> inline auto
+qr_solve_least_squares(const qr_result<Matrix>& qr,
+  const readable_vector<BSub>& b) -> row_type_of_t<Matrix>
+{
+  auto x = detail::make_temporary<row_type_of_t<Matrix>>(qr.qr);
+  qr_solve_least_squares(qr, x, b);
+  return x;
+}
+
+template<class ASub, class BSub> inline auto
+qr_solve_least_squares(const readable_matrix<ASub>& A,
+  const readable_vector<BSub>& b) -> row_type_of_t<temporary_of_t<ASub>>
+{
+  return qr_solve_least_squares(cml::qr(A), b);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -103,6 +103,16 @@ class matrix_scalar_node
 #endif
 
 
+  public:
+
+    /** Return true if the matrix subexpression reads the object at @c
+     * dest out of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_matrix Interface */
@@ -8,6 +8,8 @@
 #error "matrix/scalar_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* matrix_scalar_node 'structors: */
@@ -36,6 +38,18 @@ matrix_scalar_node<Sub,Scalar,Op>::matrix_scalar_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub, class Scalar, class Op> bool
+matrix_scalar_node<Sub,Scalar,Op>::aliases(
+  const detail::alias_target& dest
+  ) const
+{
+  return detail::aliases(this->m_left, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_matrix interface: */
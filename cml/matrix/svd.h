@@ -0,0 +1,73 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_svd_h
+#define	cml_matrix_svd_h
+
+#include <cml/vector/fwd.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+
+/** Compute the thin singular value decomposition M = U diag(S) V^T of the
+ * @c m x @c n matrix @c M, where @c m >= @c n.  @c U receives the @c m x
+ * @c n left singular vectors, @c S the @c n singular values in decreasing
+ * order, and @c V the @c n x @c n right singular vectors.  Each is resized
+ * if possible, and the element type of @c S is used for the computation.
+ *
+ * The decomposition is computed by one-sided Jacobi rotations, which are
+ * accurate for small singular values.  Fixed-size matrices are factored
+ * in local arrays with compile-time loop bounds.  If @c sweeps is
+ * positive, exactly that many sweeps are taken regardless of convergence,
+ * so the cost does not depend on the input; 6 sweeps reach working
+ * precision for well-conditioned 3x3 and 4x4 matrices.  Otherwise,
+ * iteration stops at convergence.
+ *
+ * @throws minimum_matrix_size_error at run-time if @c M is
+ * dynamically-sized and has fewer rows than columns.
+ */
+template<class Sub, class USub, class SSub, class VSub> void
+svd(const readable_matrix<Sub>& M, writable_matrix<USub>& U,
+  writable_vector<SSub>& S, writable_matrix<VSub>& V, int sweeps = 0);
+
+/** Compute the singular values of @c M into @c S in decreasing order,
+ * without forming the singular vectors.
+ *
+ * @throws minimum_matrix_size_error at run-time if @c M is
+ * dynamically-sized and has fewer rows than columns.
+ */
+template<class Sub, class SSub> void
+singular_values(const readable_matrix<Sub>& M, writable_vector<SSub>& S,
+  int sweeps = 0);
+
+/** Compute the polar decomposition M = R S of the square matrix @c M,
+ * where @c R is orthogonal and @c S is symmetric positive semi-definite,
+ * from the SVD of @c M as R = U V^T and S = V diag(s) V^T.  @c R is the
+ * orthogonal matrix nearest to @c M, which makes it the preferred way to
+ * restore a rotation matrix that has drifted from orthogonality.  @c R is
+ * a rotation if det(M) > 0, and a reflection if det(M) < 0.  @c R and @c S
+ * are resized if possible, and the element type of @c R is used for the
+ * computation.  @c sweeps is as for svd().
+ *
+ * @throws non_square_matrix_error at run-time if @c M is dynamically-sized
+ * and not square.
+ */
+template<class Sub, class RSub, class SSub> void
+polar_decomposition(const readable_matrix<Sub>& M, writable_matrix<RSub>& R,
+  writable_matrix<SSub>& S, int sweeps = 0);
+
+} // namespace cml
+
+#define __CML_MATRIX_SVD_TPP
+#include <cml/matrix/svd.tpp>
+#undef __CML_MATRIX_SVD_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
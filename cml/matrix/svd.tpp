@@ -0,0 +1,134 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_SVD_TPP
+#error "matrix/svd.tpp not included correctly"
+#endif
+
+#include <cml/vector/writable_vector.h>
+#include <cml/vector/detail/check_or_resize.h>
+#include <cml/matrix/writable_matrix.h>
+#include <cml/matrix/temporary.h>
+#include <cml/matrix/size_checking.h>
+#include <cml/matrix/detail/check_or_resize.h>
+#include <cml/matrix/detail/svd.h>
+
+namespace cml {
+namespace detail {
+
+/** Defines @c type as the svd_workspace for the elements of type @c T of
+ * matrix expressions of type @c Sub.
+ */
+template<class Sub, class T> struct svd_workspace_of
+{
+  typedef matrix_traits<temporary_of_t<Sub>>		traits_type;
+  typedef svd_workspace<T,
+	  traits_type::array_rows, traits_type::array_cols> type;
+};
+
+/** Copy @c M into @c work, and factor it by svd_jacobi(). */
+template<class Sub, class Workspace> inline void
+svd_factor(const readable_matrix<Sub>& M, Workspace& work, bool vectors,
+  int sweeps)
+{
+  typedef typename Workspace::value_type		value_type;
+
+  auto m = work.rows();
+  auto n = work.cols();
+  for(int j = 0; j < n; ++ j)
+    for(int i = 0; i < m; ++ i) work.W[j*m + i] = value_type(M.get(i,j));
+  detail::svd_jacobi(m, n, work.W.data(),
+    vectors ? work.V.data() : (value_type*) 0, work.s.data(), sweeps);
+}
+
+} // namespace detail
+
+
+template<class Sub, class USub, class SSub, class VSub> inline void
+svd(const readable_matrix<Sub>& M, writable_matrix<USub>& U,
+  writable_vector<SSub>& S, writable_matrix<VSub>& V, int sweeps)
+{
+  typedef value_type_trait_of_t<SSub>			value_type;
+  typedef typename detail::svd_workspace_of<
+    Sub, value_type>::type				workspace_type;
+
+  cml::check_minimum_size(M, M.cols(), 0);
+  int m = M.rows(), n = M.cols();
+  detail::check_or_resize(U, m, n);
+  detail::check_or_resize(S, n);
+  detail::check_or_resize(V, n, n);
+  if(n == 0) return;
+
+  workspace_type work(m, n);
+  detail::svd_factor(M, work, true, sweeps);
+  detail::svd_normalize(work.rows(), work.cols(), work.W.data(),
+    work.s.data());
+
+  for(int j = 0; j < n; ++ j) {
+    S.put(j, work.s[j]);
+    for(int i = 0; i < m; ++ i) U.put(i,j, work.W[j*m + i]);
+    for(int i = 0; i < n; ++ i) V.put(i,j, work.V[j*n + i]);
+  }
+}
+
+template<class Sub, class SSub> inline void
+singular_values(const readable_matrix<Sub>& M, writable_vector<SSub>& S,
+  int sweeps)
+{
+  typedef value_type_trait_of_t<SSub>			value_type;
+  typedef typename detail::svd_workspace_of<
+    Sub, value_type>::type				workspace_type;
+
+  cml::check_minimum_size(M, M.cols(), 0);
+  int n = M.cols();
+  detail::check_or_resize(S, n);
+  if(n == 0) return;
+
+  workspace_type work(M.rows(), n);
+  detail::svd_factor(M, work, false, sweeps);
+  for(int j = 0; j < n; ++ j) S.put(j, work.s[j]);
+}
+
+template<class Sub, class RSub, class SSub> inline void
+polar_decomposition(const readable_matrix<Sub>& M, writable_matrix<RSub>& R,
+  writable_matrix<SSub>& S, int sweeps)
+{
+  typedef value_type_trait_of_t<RSub>			value_type;
+  typedef typename detail::svd_workspace_of<
+    Sub, value_type>::type				workspace_type;
+
+  cml::check_square(M);
+  int n = M.rows();
+  detail::check_or_resize(R, n, n);
+  detail::check_or_resize(S, n, n);
+  if(n == 0) return;
+
+  workspace_type work(n, n);
+  detail::svd_factor(M, work, true, sweeps);
+  detail::svd_normalize(work.rows(), work.cols(), work.W.data(),
+    work.s.data());
+
+  /* R = U V^T, and S = V diag(s) V^T: */
+  const auto& U = work.W;
+  const auto& V = work.V;
+  const auto& s = work.s;
+  for(int i = 0; i < n; ++ i) {
+    for(int j = 0; j < n; ++ j) {
+      value_type r(0), t(0);
+      for(int k = 0; k < n; ++ k) {
+	r += U[k*n + i]*V[k*n + j];
+	t += V[k*n + i]*s[k]*V[k*n + j];
+      }
+      R.put(i,j, r);
+      S.put(i,j, t);
+    }
+  }
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -103,6 +103,19 @@ class matrix_transpose_node
 #endif
 
 
+  public:
+
+    /** Return a const reference to the transposed subexpression. */
+    const sub_type& sub() const;
+
+    /** Return true if the subexpression reads the object at @c dest out
+     * of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_matrix Interface */
@@ -8,6 +8,8 @@
 #error "matrix/transpose_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* matrix_transpose_node 'structors: */
@@ -34,6 +36,22 @@ matrix_transpose_node<Sub>::matrix_transpose_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub> auto
+matrix_transpose_node<Sub>::sub() const -> const sub_type&
+{
+  return this->m_sub;
+}
+
+template<class Sub> bool
+matrix_transpose_node<Sub>::aliases(const detail::alias_target& dest) const
+{
+  return detail::aliases(this->m_sub, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_matrix interface: */
@@ -97,6 +97,16 @@ class matrix_unary_node
 #endif
 
 
+  public:
+
+    /** Return true if the subexpression reads the object at @c dest out
+     * of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_matrix Interface */
@@ -10,28 +10,39 @@
 #define	cml_matrix_vector_product_h
 
 #include <cml/matrix/promotion.h>
+#include <cml/matrix/vector_product_node.h>
 
 namespace cml {
 
-/** Multiply a vector by a matrix, and return the vector result as a
- * temporary.
+/** Multiply a matrix by a vector, and return the vector result as an
+ * expression node (matrix_vector_product_node).
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if either
+ * operand is dynamically-sized, and the number of columns of @c sub1
+ * differs from the size of @c sub2.  The sizes are checked at compile time
+ * for fixed-size expressions.
  */
 template<class Sub1, class Sub2,
   enable_if_matrix_t<Sub1>* = nullptr,
   enable_if_vector_t<Sub2>* = nullptr>
 auto operator*(Sub1&& sub1, Sub2&& sub2)
--> matrix_inner_product_promote_t<
+-> matrix_vector_product_node<
   actual_operand_type_of_t<decltype(sub1)>,
   actual_operand_type_of_t<decltype(sub2)>>;
 
-/** Multiply a matrix by a vector, and return the vector result as a
- * temporary.
+/** Multiply a vector by a matrix, and return the vector result as an
+ * expression node (matrix_vector_product_node).
+ *
+ * @throws incompatible_matrix_inner_size_error at run-time if either
+ * operand is dynamically-sized, and the size of @c sub1 differs from the
+ * number of rows of @c sub2.  The sizes are checked at compile time for
+ * fixed-size expressions.
  */
 template<class Sub1, class Sub2,
   enable_if_vector_t<Sub1>* = nullptr,
   enable_if_matrix_t<Sub2>* = nullptr>
 auto operator*(Sub1&& sub1, Sub2&& sub2)
--> matrix_inner_product_promote_t<
+-> matrix_vector_product_node<
   actual_operand_type_of_t<decltype(sub1)>,
   actual_operand_type_of_t<decltype(sub2)>>;
 
@@ -39,7 +50,7 @@ auto operator*(Sub1&& sub1, Sub2&& sub2)
 
 #define __CML_MATRIX_VECTOR_PRODUCT_TPP
 #include <cml/matrix/vector_product.tpp>
-#undef __CML_MATRIX_VECTOR_PRPDUCT_TPP
+#undef __CML_MATRIX_VECTOR_PRODUCT_TPP
 
 #endif
 
@@ -0,0 +1,213 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_matrix_vector_product_node_h
+#define	cml_matrix_vector_product_node_h
+
+#include <cml/common/type_util.h>
+#include <cml/vector/readable_vector.h>
+#include <cml/matrix/readable_matrix.h>
+#include <cml/matrix/promotion.h>
+
+namespace cml {
+
+template<class Sub1, class Sub2> class matrix_vector_product_node;
+
+/** matrix_vector_product_node<> traits. */
+template<class Sub1, class Sub2>
+struct vector_traits< matrix_vector_product_node<Sub1,Sub2> >
+{
+  typedef matrix_vector_product_node<Sub1,Sub2>		vector_type;
+  typedef Sub1						left_arg_type;
+  typedef Sub2						right_arg_type;
+  typedef cml::unqualified_type_t<Sub1>			left_type;
+  typedef cml::unqualified_type_t<Sub2>			right_type;
+
+  /* The node has the same element and storage types as the vector
+   * temporary that would hold the product:
+   */
+  typedef matrix_inner_product_promote_t<
+    left_type, right_type>				promoted_type;
+  typedef vector_traits<promoted_type>			promoted_traits;
+  typedef typename promoted_traits::element_traits	element_traits;
+  typedef typename promoted_traits::value_type		value_type;
+  typedef value_type					immutable_value;
+  typedef typename promoted_traits::storage_type	storage_type;
+
+  /* Traits and types for the storage: */
+  typedef typename storage_type::size_tag		size_tag;
+
+  /* Array size: */
+  static const int array_size = storage_type::array_size;
+};
+
+/** Represents the product of a matrix and a vector (or a vector and a
+ * matrix) in an expression tree.  Each element of the product is computed
+ * on demand as the inner product of a matrix row (or column) with the
+ * vector, so the product fuses into the enclosing assignment without a
+ * temporary.
+ *
+ * The vector operand is read once for every element of the product.  To
+ * avoid re-evaluating it, a vector operand that is itself an expression
+ * node is evaluated into a temporary when the node is constructed.
+ * Vectors with storage are referenced directly, and assigning the product
+ * to its own vector operand goes through a temporary (see aliases()).
+ */
+template<class Sub1, class Sub2>
+class matrix_vector_product_node
+: public readable_vector< matrix_vector_product_node<Sub1,Sub2> >
+{
+  public:
+
+    typedef matrix_vector_product_node<Sub1,Sub2>	node_type;
+    typedef readable_vector<node_type>			readable_type;
+    typedef vector_traits<node_type>			traits_type;
+    typedef typename traits_type::left_arg_type		left_arg_type;
+    typedef typename traits_type::right_arg_type	right_arg_type;
+    typedef typename traits_type::left_type		left_type;
+    typedef typename traits_type::right_type		right_type;
+    typedef typename traits_type::element_traits	element_traits;
+    typedef typename traits_type::value_type		value_type;
+    typedef typename traits_type::immutable_value	immutable_value;
+    typedef typename traits_type::storage_type		storage_type;
+    typedef typename traits_type::size_tag		size_tag;
+
+
+  public:
+
+    /** Constant containing the array size. */
+    static const int array_size = traits_type::array_size;
+
+    /** True if the product is vector*matrix, false if it is
+     * matrix*vector.
+     */
+    static const bool left_is_vector = is_vector<left_type>::value;
+
+
+  public:
+
+    /** Construct from the wrapped sub-expressions.  Sub1 and Sub2 must be
+     * lvalue reference or rvalue reference types.
+     *
+     * @throws incompatible_matrix_inner_size_error at run-time if either
+     * Sub1 or Sub2 is dynamically-sized, and the inner sizes of Sub1 and
+     * Sub2 differ.  If both Sub1 and Sub2 are fixed-size expressions, then
+     * the sizes are checked at compile time.
+     */
+    matrix_vector_product_node(Sub1 left, Sub2 right);
+
+    /** Move constructor. */
+    matrix_vector_product_node(node_type&& other);
+
+#ifndef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+    /** Copy constructor. */
+    matrix_vector_product_node(const node_type& other);
+#endif
+
+
+  public:
+
+    /** Return true if the vector operand is @c dest or shares its memory,
+     * for example through an external<> vector, or if either subexpression
+     * reads it out of order.  Since every element of the product reads the
+     * whole vector operand, the product must then be evaluated into a
+     * temporary before assignment.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
+  protected:
+
+    /** @name readable_vector Interface */
+    /*@{*/
+
+    friend readable_type;
+
+    /** Return the size of the vector expression. */
+    int i_size() const;
+
+    /** Return element @c i of the product. */
+    immutable_value i_get(int i) const;
+
+    /*@}*/
+
+
+  protected:
+
+    /** Helper defining the type used to store the subexpression @c Sub.
+     * Matrix expressions, and vectors with storage, are stored as a copy
+     * if Sub is an rvalue reference (temporary), or by const reference if
+     * Sub is an lvalue reference.  Vector expression nodes are evaluated
+     * into a temporary.
+     */
+    template<class Sub, class Type = cml::unqualified_type_t<Sub>>
+      using wrap_type_of = cml::if_t<
+	is_vector<Type>::value && !has_contiguous_data<Type>::value,
+	temporary_of_t<Type>, cml::if_t<
+	  std::is_lvalue_reference<Sub>::value, const Type&, Type>>;
+
+    /** The type used to store the left subexpression. */
+    typedef wrap_type_of<Sub1>				left_wrap_type;
+
+    /** The type used to store the right subexpression. */
+    typedef wrap_type_of<Sub2>				right_wrap_type;
+
+
+  protected:
+
+    /** Return the number of rows of @c left, where @c left is a matrix. */
+    int i_size(std::false_type) const;
+
+    /** Return the number of columns of @c right, where @c left is a
+     * vector.
+     */
+    int i_size(std::true_type) const;
+
+    /** Compute element @c i of @c left * @c right, where @c left is a
+     * matrix.
+     */
+    immutable_value i_get(int i, std::false_type) const;
+
+    /** Compute element @c j of @c left * @c right, where @c left is a
+     * vector.
+     */
+    immutable_value i_get(int j, std::true_type) const;
+
+
+  protected:
+
+    /** The wrapped left subexpression. */
+    left_wrap_type		m_left;
+
+    /** The wrapped right subexpression. */
+    right_wrap_type		m_right;
+
+
+  private:
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+    // Not copy constructible.
+    matrix_vector_product_node(const node_type&);
+#endif
+
+    // Not assignable.
+    node_type& operator=(const node_type&);
+};
+
+} // namespace cml
+
+#define __CML_MATRIX_VECTOR_PRODUCT_NODE_TPP
+#include <cml/matrix/vector_product_node.tpp>
+#undef __CML_MATRIX_VECTOR_PRODUCT_NODE_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,121 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_MATRIX_VECTOR_PRODUCT_NODE_TPP
+#error "matrix/vector_product_node.tpp not included correctly"
+#endif
+
+#include <cml/matrix/size_checking.h>
+#include <cml/vector/detail/aliasing.h>
+
+namespace cml {
+
+/* matrix_vector_product_node 'structors: */
+
+template<class Sub1, class Sub2>
+matrix_vector_product_node<Sub1,Sub2>::matrix_vector_product_node(
+  Sub1 left, Sub2 right
+  )
+: m_left(std::move(left)), m_right(std::move(right))
+{
+  cml::check_same_inner_size(this->m_left, this->m_right);
+}
+
+template<class Sub1, class Sub2>
+matrix_vector_product_node<Sub1,Sub2>::matrix_vector_product_node(
+  node_type&& other
+  )
+: m_left(std::move(other.m_left)), m_right(std::move(other.m_right))
+{
+}
+
+#ifndef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+template<class Sub1, class Sub2>
+matrix_vector_product_node<Sub1,Sub2>::matrix_vector_product_node(
+  const node_type& other
+  )
+: m_left(other.m_left), m_right(other.m_right)
+{
+}
+#endif
+
+
+
+/* Public methods: */
+
+template<class Sub1, class Sub2> bool
+matrix_vector_product_node<Sub1,Sub2>::aliases(
+  const detail::alias_target& dest
+  ) const
+{
+  bool is_operand = left_is_vector
+    ? detail::is_alias(this->m_left, dest)
+    : detail::is_alias(this->m_right, dest);
+  return is_operand
+    || detail::aliases(this->m_left, dest)
+    || detail::aliases(this->m_right, dest);
+}
+
+
+
+/* Internal methods: */
+
+/* readable_vector interface: */
+
+template<class Sub1, class Sub2> int
+matrix_vector_product_node<Sub1,Sub2>::i_size() const
+{
+  return this->i_size(std::integral_constant<bool, left_is_vector>());
+}
+
+template<class Sub1, class Sub2> auto
+matrix_vector_product_node<Sub1,Sub2>::i_get(int i) const -> immutable_value
+{
+  return this->i_get(i, std::integral_constant<bool, left_is_vector>());
+}
+
+template<class Sub1, class Sub2> int
+matrix_vector_product_node<Sub1,Sub2>::i_size(std::false_type) const
+{
+  return this->m_left.rows();
+}
+
+template<class Sub1, class Sub2> int
+matrix_vector_product_node<Sub1,Sub2>::i_size(std::true_type) const
+{
+  return this->m_right.cols();
+}
+
+template<class Sub1, class Sub2> auto
+matrix_vector_product_node<Sub1,Sub2>::i_get(
+  int i, std::false_type
+  ) const -> immutable_value
+{
+  const auto& left = this->m_left;
+  const auto& right = this->m_right;
+  auto m = left.get(i,0) * right.get(0);
+  for(int k = 1, n = right.size(); k < n; ++ k)
+    m += left.get(i,k) * right.get(k);
+  return immutable_value(m);
+}
+
+template<class Sub1, class Sub2> auto
+matrix_vector_product_node<Sub1,Sub2>::i_get(
+  int j, std::true_type
+  ) const -> immutable_value
+{
+  const auto& left = this->m_left;
+  const auto& right = this->m_right;
+  auto m = left.get(0) * right.get(0,j);
+  for(int k = 1, n = left.size(); k < n; ++ k)
+    m += left.get(k) * right.get(k,j);
+  return immutable_value(m);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -9,14 +9,16 @@
 #ifndef	cml_quaternion_fixed_compiled_h
 #define	cml_quaternion_fixed_compiled_h
 
+#include <cml/common/alignment.h>
 #include <cml/storage/compiled_selector.h>
 #include <cml/quaternion/writable_quaternion.h>
 #include <cml/quaternion/quaternion.h>
 
 namespace cml {
 
-template<class Element, class Order, class Cross>
-struct quaternion_traits< quaternion<Element, fixed<>, Order, Cross> >
+template<class Element, int Align, class Order, class Cross>
+struct quaternion_traits<
+  quaternion<Element, fixed<-1,-1,Align>, Order, Cross> >
 {
   /* Traits and types for the quaternion element: */
   typedef scalar_traits<Element>			element_traits;
@@ -29,7 +31,8 @@ struct quaternion_traits< quaternion<Element, fixed<>, Order, Cross> >
   typedef typename element_traits::immutable_value	immutable_value;
 
   /* The quaternion storage type: */
-  typedef rebind_t<compiled<4>, quaternion_storage_tag>	storage_type;
+  typedef rebind_t<
+    compiled<4,-1,Align>, quaternion_storage_tag>	storage_type;
   typedef typename storage_type::size_tag		size_tag;
   static_assert(std::is_same<size_tag, fixed_size_tag>::value,
     "invalid size tag");
@@ -38,6 +41,10 @@ struct quaternion_traits< quaternion<Element, fixed<>, Order, Cross> >
   static const int array_size = storage_type::array_size;
   static_assert(array_size == 4, "invalid quaternion size");
 
+  /* Array alignment in bytes: */
+  static const int alignment
+    = storage_alignment<value_type, array_size, Align>::value;
+
   /** Quaternion order. */
   typedef Order						order_type;
 
@@ -46,13 +53,15 @@ struct quaternion_traits< quaternion<Element, fixed<>, Order, Cross> >
 };
 
 /** Fixed-length quaternion. */
-template<class Element, class Order, class Cross>
-class quaternion<Element, fixed<>, Order, Cross>
-: public writable_quaternion< quaternion<Element, fixed<>, Order, Cross> >
+template<class Element, int Align, class Order, class Cross>
+class quaternion<Element, fixed<-1,-1,Align>, Order, Cross>
+: public writable_quaternion<
+  quaternion<Element, fixed<-1,-1,Align>, Order, Cross> >
 {
   public:
 
-    typedef quaternion<Element, fixed<>, Order, Cross>	quaternion_type;
+    typedef quaternion<Element,
+	    fixed<-1,-1,Align>, Order, Cross>		quaternion_type;
     typedef readable_quaternion<quaternion_type>	readable_type;
     typedef writable_quaternion<quaternion_type>	writable_type;
     typedef quaternion_traits<quaternion_type>		traits_type;
@@ -90,6 +99,9 @@ class quaternion<Element, fixed<>, Order, Cross>
     /** The dimension (same as array_size). */
     static const int dimension = array_size;
 
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
 
   public:
 
@@ -275,7 +287,7 @@ class quaternion<Element, fixed<>, Order, Cross>
   protected:
 
     /** Fixed-length array. */
-    value_type			m_data[4];
+    alignas(alignment) value_type	m_data[4];
 };
 
 } // namespace cml
@@ -12,44 +12,44 @@ namespace cml {
 
 /* fixed 'structors: */
 
-template<class E, class O, class C> template<class Sub>
-quaternion<E, fixed<>, O, C>::quaternion(
+template<class E, int A, class O, class C> template<class Sub>
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(
   const readable_quaternion<Sub>& sub
   )
 {
   this->assign(sub);
 }
 
-template<class E, class O, class C>
+template<class E, int A, class O, class C>
 template<class Array, enable_if_array_t<Array>*>
-quaternion<E, fixed<>, O, C>::quaternion(const Array& array)
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(const Array& array)
 {
   this->assign(array);
 }
 
-template<class E, class O, class C>
+template<class E, int A, class O, class C>
 template<class Pointer, enable_if_pointer_t<Pointer>*>
-quaternion<E, fixed<>, O, C>::quaternion(const Pointer& array)
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(const Pointer& array)
 {
   this->assign(array);
 }
 
-template<class E, class O, class C>
+template<class E, int A, class O, class C>
 template<class E0, class Array, enable_if_array_t<Array>*>
-quaternion<E, fixed<>, O, C>::quaternion(const E0& e0, const Array& array)
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(const E0& e0, const Array& array)
 {
   this->assign(array, e0);
 }
 
-template<class E, class O, class C>
+template<class E, int A, class O, class C>
 template<class Array, class E1, enable_if_array_t<Array>*>
-quaternion<E, fixed<>, O, C>::quaternion(const Array& array, const E1& e1)
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(const Array& array, const E1& e1)
 {
   this->assign(array, e1);
 }
 
-template<class E, class O, class C> template<class Other>
-quaternion<E, fixed<>, O, C>::quaternion(std::initializer_list<Other> l)
+template<class E, int A, class O, class C> template<class Other>
+quaternion<E, fixed<-1,-1,A>, O, C>::quaternion(std::initializer_list<Other> l)
 {
   this->assign(l);
 }
@@ -58,45 +58,45 @@ quaternion<E, fixed<>, O, C>::quaternion(std::initializer_list<Other> l)
 
 /* Public methods: */
 
-template<class E, class O, class C> int
-quaternion<E, fixed<>, O, C>::size() const
+template<class E, int A, class O, class C> int
+quaternion<E, fixed<-1,-1,A>, O, C>::size() const
 {
   return 4;
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::data() -> pointer
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::data() -> pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::data() const -> const_pointer
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::data() const -> const_pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::begin() const -> const_pointer
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::begin() const -> const_pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::end() const -> const_pointer
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::end() const -> const_pointer
 {
   return (&this->m_data[0]) + 4;
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::operator=(const quaternion_type& other)
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::operator=(const quaternion_type& other)
 -> quaternion_type&
 {
   return this->assign(other);
 }
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::operator=(quaternion_type&& other)
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::operator=(quaternion_type&& other)
 -> quaternion_type&
 {
   this->m_data[W] = std::move(other.m_data[W]);
@@ -112,8 +112,8 @@ quaternion<E, fixed<>, O, C>::operator=(quaternion_type&& other)
 
 /* readable_quaternion interface: */
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::i_get(int i) const -> immutable_value
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::i_get(int i) const -> immutable_value
 {
   return this->m_data[i];
 }
@@ -121,14 +121,14 @@ quaternion<E, fixed<>, O, C>::i_get(int i) const -> immutable_value
 
 /* writable_quaternion interface: */
 
-template<class E, class O, class C> auto
-quaternion<E, fixed<>, O, C>::i_get(int i) -> mutable_value
+template<class E, int A, class O, class C> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::i_get(int i) -> mutable_value
 {
   return this->m_data[i];
 }
 
-template<class E, class O, class C> template<class Other> auto
-quaternion<E, fixed<>, O, C>::i_put(
+template<class E, int A, class O, class C> template<class Other> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::i_put(
   int i, const Other& v
   ) __CML_REF -> quaternion_type&
 {
@@ -137,8 +137,8 @@ quaternion<E, fixed<>, O, C>::i_put(
 }
 
 #ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
-template<class E, class O, class C> template<class Other> auto
-quaternion<E, fixed<>, O, C>::i_put(
+template<class E, int A, class O, class C> template<class Other> auto
+quaternion<E, fixed<-1,-1,A>, O, C>::i_put(
   int i, const Other& v
   ) && -> quaternion_type&&
 {
@@ -0,0 +1,20 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_h
+#define	cml_solvers_h
+
+#include <cml/solvers/preconditioners.h>
+#include <cml/solvers/conjugate_gradient.h>
+#include <cml/solvers/bicgstab.h>
+#include <cml/solvers/gmres.h>
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
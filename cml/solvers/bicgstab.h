@@ -0,0 +1,73 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_bicgstab_h
+#define	cml_solvers_bicgstab_h
+
+#include <cml/vector/writable_vector.h>
+#include <cml/solvers/iterative_solver.h>
+#include <cml/solvers/preconditioners.h>
+
+namespace cml {
+
+/** Right-preconditioned BiCGSTAB solver for general nonsymmetric systems
+ * A x = b.  The operator, preconditioner and work vectors are handled as
+ * by conjugate_gradient.  Each iteration applies A and the preconditioner
+ * twice.  A solve stops without converging if the iteration breaks down.
+ */
+template<class Element>
+class bicgstab : public iterative_solver<Element>
+{
+  public:
+
+    typedef iterative_solver<Element>			solver_type;
+    typedef typename solver_type::value_type		value_type;
+    typedef typename solver_type::vector_type		vector_type;
+
+
+  public:
+
+    /** Allocate the work vectors for @c n x @c n systems. */
+    explicit bicgstab(int n = 0);
+
+    /** Reallocate the work vectors for @c n x @c n systems, if needed. */
+    void resize(int n);
+
+    /** Solve A @c x = @c b using preconditioner @c M, starting from the
+     * initial guess in @c x.
+     *
+     * @returns converged().
+     *
+     * @throws incompatible_vector_size_error at run-time if @c x and @c b
+     * have different sizes.
+     */
+    template<class Operator, class XSub, class BSub, class Preconditioner>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b, const Preconditioner& M);
+
+    /** Solve A @c x = @c b without preconditioning. */
+    template<class Operator, class XSub, class BSub>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b);
+
+
+  protected:
+
+    vector_type				m_x, m_r, m_rhat, m_p, m_v, m_y, m_t;
+};
+
+} // namespace cml
+
+#define __CML_SOLVERS_BICGSTAB_TPP
+#include <cml/solvers/bicgstab.tpp>
+#undef __CML_SOLVERS_BICGSTAB_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,124 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_SOLVERS_BICGSTAB_TPP
+#error "solvers/bicgstab.tpp not included correctly"
+#endif
+
+#include <cml/vector/size_checking.h>
+#include <cml/solvers/detail/krylov.h>
+
+namespace cml {
+
+template<class Element>
+bicgstab<Element>::bicgstab(int n)
+{
+  this->resize(n);
+}
+
+template<class Element> void
+bicgstab<Element>::resize(int n)
+{
+  this->m_x.resize(n);
+  this->m_r.resize(n);
+  this->m_rhat.resize(n);
+  this->m_p.resize(n);
+  this->m_v.resize(n);
+  this->m_y.resize(n);
+  this->m_t.resize(n);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub, class Preconditioner> bool
+bicgstab<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b,
+  const Preconditioner& M
+  )
+{
+  cml::check_same_size(x, b);
+  const int n = b.size();
+  this->resize(n);
+
+  value_type* xp = this->m_x.data();
+  value_type* r = this->m_r.data();
+  value_type* rhat = this->m_rhat.data();
+  value_type* p = this->m_p.data();
+  value_type* v = this->m_v.data();
+  value_type* y = this->m_y.data();
+  value_type* t = this->m_t.data();
+
+  /* A zero right-hand side has the exact solution 0: */
+  detail::krylov_load(b, this->m_r);
+  const value_type b_norm = detail::krylov_norm(n, r);
+  if(b_norm == value_type(0)) {
+    for(int i = 0; i < n; ++ i) xp[i] = value_type(0);
+    detail::krylov_store(this->m_x, x);
+    return this->finish(0, value_type(0));
+  }
+
+  /* r = rhat = b - A x, p = v = 0: */
+  detail::krylov_load(x, this->m_x);
+  detail::apply_operator(A, this->m_x, this->m_t);
+  detail::krylov_axpy(n, value_type(-1), t, r);
+  this->m_rhat = this->m_r;
+  for(int i = 0; i < n; ++ i) p[i] = v[i] = value_type(0);
+  value_type rho(1), alpha(1), omega(1);
+  value_type residual = detail::krylov_norm(n, r)/b_norm;
+
+  const int limit = this->iteration_limit(n);
+  int k = 0;
+  while(k < limit && residual > this->m_tolerance) {
+    value_type rho_next = detail::krylov_dot(n, rhat, r);
+    if(rho_next == value_type(0)) break;
+
+    /* p = r + beta (p - omega v), v = A M^-1 p: */
+    value_type beta = (rho_next/rho)*(alpha/omega);
+    for(int i = 0; i < n; ++ i) p[i] = r[i] + beta*(p[i] - omega*v[i]);
+    M.apply(this->m_p, this->m_y);
+    detail::apply_operator(A, this->m_y, this->m_v);
+    value_type rv = detail::krylov_dot(n, rhat, v);
+    if(rv == value_type(0)) break;
+    alpha = rho_next/rv;
+    rho = rho_next;
+
+    /* The half step x += alpha M^-1 p leaves the residual s = r - alpha v,
+     * kept in r:
+     */
+    detail::krylov_axpy(n, alpha, y, xp);
+    detail::krylov_axpy(n, - alpha, v, r);
+    residual = detail::krylov_norm(n, r)/b_norm;
+    ++ k;
+    if(residual <= this->m_tolerance) break;
+
+    /* t = A M^-1 s, omega = (t.s)/(t.t): */
+    M.apply(this->m_r, this->m_y);
+    detail::apply_operator(A, this->m_y, this->m_t);
+    value_type tt = detail::krylov_dot(n, t, t);
+    if(tt == value_type(0)) break;
+    omega = detail::krylov_dot(n, t, r)/tt;
+    detail::krylov_axpy(n, omega, y, xp);
+    detail::krylov_axpy(n, - omega, t, r);
+    residual = detail::krylov_norm(n, r)/b_norm;
+    if(omega == value_type(0)) break;
+  }
+
+  detail::krylov_store(this->m_x, x);
+  return this->finish(k, residual);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub> bool
+bicgstab<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b
+  )
+{
+  return this->solve(A, x, b, identity_preconditioner());
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
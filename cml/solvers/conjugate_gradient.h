@@ -0,0 +1,75 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_conjugate_gradient_h
+#define	cml_solvers_conjugate_gradient_h
+
+#include <cml/vector/writable_vector.h>
+#include <cml/solvers/iterative_solver.h>
+#include <cml/solvers/preconditioners.h>
+
+namespace cml {
+
+/** Preconditioned conjugate gradient solver for symmetric positive
+ * definite systems A x = b.  @c A is either a square readable_matrix, or a
+ * callable A(x, y) setting @c y to A @c x, where @c x and @c y are
+ * vector_type and @c y already has the size of @c x.  The work vectors are
+ * allocated by the constructor or resize(), and are reused by every solve
+ * of the same size, so iterations do not allocate.
+ */
+template<class Element>
+class conjugate_gradient : public iterative_solver<Element>
+{
+  public:
+
+    typedef iterative_solver<Element>			solver_type;
+    typedef typename solver_type::value_type		value_type;
+    typedef typename solver_type::vector_type		vector_type;
+
+
+  public:
+
+    /** Allocate the work vectors for @c n x @c n systems. */
+    explicit conjugate_gradient(int n = 0);
+
+    /** Reallocate the work vectors for @c n x @c n systems, if needed. */
+    void resize(int n);
+
+    /** Solve A @c x = @c b using preconditioner @c M, starting from the
+     * initial guess in @c x.
+     *
+     * @returns converged().
+     *
+     * @throws incompatible_vector_size_error at run-time if @c x and @c b
+     * have different sizes.
+     */
+    template<class Operator, class XSub, class BSub, class Preconditioner>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b, const Preconditioner& M);
+
+    /** Solve A @c x = @c b without preconditioning. */
+    template<class Operator, class XSub, class BSub>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b);
+
+
+  protected:
+
+    vector_type				m_x, m_r, m_z, m_p, m_q;
+};
+
+} // namespace cml
+
+#define __CML_SOLVERS_CONJUGATE_GRADIENT_TPP
+#include <cml/solvers/conjugate_gradient.tpp>
+#undef __CML_SOLVERS_CONJUGATE_GRADIENT_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,105 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_SOLVERS_CONJUGATE_GRADIENT_TPP
+#error "solvers/conjugate_gradient.tpp not included correctly"
+#endif
+
+#include <cml/vector/size_checking.h>
+#include <cml/solvers/detail/krylov.h>
+
+namespace cml {
+
+template<class Element>
+conjugate_gradient<Element>::conjugate_gradient(int n)
+{
+  this->resize(n);
+}
+
+template<class Element> void
+conjugate_gradient<Element>::resize(int n)
+{
+  this->m_x.resize(n);
+  this->m_r.resize(n);
+  this->m_z.resize(n);
+  this->m_p.resize(n);
+  this->m_q.resize(n);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub, class Preconditioner> bool
+conjugate_gradient<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b,
+  const Preconditioner& M
+  )
+{
+  cml::check_same_size(x, b);
+  const int n = b.size();
+  this->resize(n);
+
+  value_type* xp = this->m_x.data();
+  value_type* r = this->m_r.data();
+  value_type* z = this->m_z.data();
+  value_type* p = this->m_p.data();
+  value_type* q = this->m_q.data();
+
+  /* A zero right-hand side has the exact solution 0: */
+  detail::krylov_load(b, this->m_r);
+  const value_type b_norm = detail::krylov_norm(n, r);
+  if(b_norm == value_type(0)) {
+    for(int i = 0; i < n; ++ i) xp[i] = value_type(0);
+    detail::krylov_store(this->m_x, x);
+    return this->finish(0, value_type(0));
+  }
+
+  /* r = b - A x, p = z = M r: */
+  detail::krylov_load(x, this->m_x);
+  detail::apply_operator(A, this->m_x, this->m_q);
+  detail::krylov_axpy(n, value_type(-1), q, r);
+  M.apply(this->m_r, this->m_z);
+  this->m_p = this->m_z;
+  value_type rz = detail::krylov_dot(n, r, z);
+  value_type residual = detail::krylov_norm(n, r)/b_norm;
+
+  const int limit = this->iteration_limit(n);
+  int k = 0;
+  while(k < limit && residual > this->m_tolerance) {
+    detail::apply_operator(A, this->m_p, this->m_q);
+
+    /* Stop if A is not positive definite along p: */
+    value_type pq = detail::krylov_dot(n, p, q);
+    if(!(pq > value_type(0))) break;
+
+    value_type alpha = rz/pq;
+    detail::krylov_axpy(n, alpha, p, xp);
+    detail::krylov_axpy(n, - alpha, q, r);
+    residual = detail::krylov_norm(n, r)/b_norm;
+    ++ k;
+    if(residual <= this->m_tolerance) break;
+
+    M.apply(this->m_r, this->m_z);
+    value_type rz_next = detail::krylov_dot(n, r, z);
+    detail::krylov_xpby(n, z, rz_next/rz, p);
+    rz = rz_next;
+  }
+
+  detail::krylov_store(this->m_x, x);
+  return this->finish(k, residual);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub> bool
+conjugate_gradient<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b
+  )
+{
+  return this->solve(A, x, b, identity_preconditioner());
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
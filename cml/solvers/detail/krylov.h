@@ -0,0 +1,68 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_detail_krylov_h
+#define	cml_solvers_detail_krylov_h
+
+#include <type_traits>
+#include <cml/common/layout_tags.h>
+#include <cml/matrix/readable_matrix.h>
+#include <cml/matrix/type_util.h>
+#include <cml/vector/writable_vector.h>
+#include <cml/vector/dynamic.h>
+
+namespace cml {
+namespace detail {
+
+/** Return the dot product of the @c n-element arrays @c x and @c y. */
+template<class T> inline T
+krylov_dot(int n, const T* x, const T* y);
+
+/** Return the Euclidean norm of the @c n-element array @c x. */
+template<class T> inline T
+krylov_norm(int n, const T* x);
+
+/** Compute @c y += @c a * @c x for the @c n-element arrays @c x and @c y.
+ */
+template<class T> inline void
+krylov_axpy(int n, T a, const T* x, T* y);
+
+/** Compute @c y = @c x + @c b * @c y for the @c n-element arrays @c x
+ * and @c y.
+ */
+template<class T> inline void
+krylov_xpby(int n, const T* x, T b, T* y);
+
+/** Copy the elements of @c v to the work vector @c w of the same size. */
+template<class Sub, class E, class Allocator> inline void
+krylov_load(const readable_vector<Sub>& v, vector<E, dynamic<Allocator>>& w);
+
+/** Copy the elements of the work vector @c w to @c v of the same size. */
+template<class Sub, class E, class Allocator> inline void
+krylov_store(const vector<E, dynamic<Allocator>>& w, writable_vector<Sub>& v);
+
+/** Compute @c y = @c A * @c x, where @c A is a square matrix or a
+ * callable taking (const vector&, vector&).  Matrices are multiplied
+ * element-wise through get(), so no temporary is created.  @c y must
+ * already have the size of @c x.
+ */
+template<class Operator, class E, class Allocator> inline void
+apply_operator(const Operator& A,
+  const vector<E, dynamic<Allocator>>& x, vector<E, dynamic<Allocator>>& y);
+
+} // namespace detail
+} // namespace cml
+
+#define __CML_SOLVERS_DETAIL_KRYLOV_TPP
+#include <cml/solvers/detail/krylov.tpp>
+#undef __CML_SOLVERS_DETAIL_KRYLOV_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
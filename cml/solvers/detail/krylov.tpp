@@ -0,0 +1,114 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_SOLVERS_DETAIL_KRYLOV_TPP
+#error "solvers/detail/krylov.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <stdexcept>
+#include <cml/common/exception.h>
+
+namespace cml {
+namespace detail {
+namespace {
+
+/** Row-major and any-major matrices are multiplied one row at a time. */
+template<class Sub, class T, class Tag> inline void
+apply_matrix(const readable_matrix<Sub>& A, const T* x, T* y, Tag)
+{
+  const int rows = A.rows(), cols = A.cols();
+  for(int i = 0; i < rows; ++ i) {
+    T sum(0);
+    for(int j = 0; j < cols; ++ j) sum += T(A.get(i,j))*x[j];
+    y[i] = sum;
+  }
+}
+
+/** Column-major matrices are multiplied one column at a time. */
+template<class Sub, class T> inline void
+apply_matrix(const readable_matrix<Sub>& A, const T* x, T* y, col_major)
+{
+  const int rows = A.rows(), cols = A.cols();
+  for(int i = 0; i < rows; ++ i) y[i] = T(0);
+  for(int j = 0; j < cols; ++ j) {
+    T xj = x[j];
+    for(int i = 0; i < rows; ++ i) y[i] += T(A.get(i,j))*xj;
+  }
+}
+
+template<class Operator, class Vector> inline void
+apply_operator(const Operator& A, const Vector& x, Vector& y, std::true_type)
+{
+  typedef layout_tag_trait_of_t<Operator> layout_tag;
+  cml_require(A.rows() == x.size() && A.cols() == x.size(),
+    std::invalid_argument, "operator size does not match the vector size");
+  apply_matrix(A, x.data(), y.data(), layout_tag());
+}
+
+template<class Operator, class Vector> inline void
+apply_operator(const Operator& A, const Vector& x, Vector& y, std::false_type)
+{
+  A(x, y);
+}
+
+} // namespace
+
+template<class T> inline T
+krylov_dot(int n, const T* x, const T* y)
+{
+  T sum(0);
+  for(int i = 0; i < n; ++ i) sum += x[i]*y[i];
+  return sum;
+}
+
+template<class T> inline T
+krylov_norm(int n, const T* x)
+{
+  return std::sqrt(krylov_dot(n, x, x));
+}
+
+template<class T> inline void
+krylov_axpy(int n, T a, const T* x, T* y)
+{
+  for(int i = 0; i < n; ++ i) y[i] += a*x[i];
+}
+
+template<class T> inline void
+krylov_xpby(int n, const T* x, T b, T* y)
+{
+  for(int i = 0; i < n; ++ i) y[i] = x[i] + b*y[i];
+}
+
+template<class Sub, class E, class Allocator> inline void
+krylov_load(const readable_vector<Sub>& v, vector<E, dynamic<Allocator>>& w)
+{
+  const int n = w.size();
+  E* dst = w.data();
+  for(int i = 0; i < n; ++ i) dst[i] = E(v.get(i));
+}
+
+template<class Sub, class E, class Allocator> inline void
+krylov_store(const vector<E, dynamic<Allocator>>& w, writable_vector<Sub>& v)
+{
+  const int n = w.size();
+  const E* src = w.data();
+  for(int i = 0; i < n; ++ i) v.put(i, src[i]);
+}
+
+template<class Operator, class E, class Allocator> inline void
+apply_operator(const Operator& A,
+  const vector<E, dynamic<Allocator>>& x, vector<E, dynamic<Allocator>>& y)
+{
+  typedef std::integral_constant<bool, is_matrix<Operator>::value> tag;
+  apply_operator(A, x, y, tag());
+}
+
+} // namespace detail
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,101 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_gmres_h
+#define	cml_solvers_gmres_h
+
+#include <vector>
+#include <cml/vector/writable_vector.h>
+#include <cml/solvers/iterative_solver.h>
+#include <cml/solvers/preconditioners.h>
+
+namespace cml {
+
+/** Restarted, right-preconditioned GMRES(m) solver for general systems A
+ * x = b.  The Krylov basis is orthogonalized by modified Gram-Schmidt, and
+ * the least-squares problem is updated by Givens rotations, so residual()
+ * is available at each iteration without forming x.  After @c m
+ * iterations, x is updated and the iteration restarts from the true
+ * residual.  The operator, preconditioner and work vectors are handled as
+ * by conjugate_gradient; the basis takes (m+1)*n elements.
+ */
+template<class Element>
+class gmres : public iterative_solver<Element>
+{
+  public:
+
+    typedef iterative_solver<Element>			solver_type;
+    typedef typename solver_type::value_type		value_type;
+    typedef typename solver_type::vector_type		vector_type;
+
+
+  public:
+
+    /** Allocate the work vectors for @c n x @c n systems, restarting every
+     * @c restart iterations.
+     */
+    explicit gmres(int n = 0, int restart = 30);
+
+    /** Reallocate the work vectors for @c n x @c n systems, if needed. */
+    void resize(int n);
+
+    /** Set the number of iterations between restarts, reallocating the
+     * basis if needed.
+     */
+    void set_restart(int restart);
+
+    /** Return the number of iterations between restarts. */
+    int restart() const { return m_restart; }
+
+    /** Solve A @c x = @c b using preconditioner @c M, starting from the
+     * initial guess in @c x.
+     *
+     * @returns converged().
+     *
+     * @throws incompatible_vector_size_error at run-time if @c x and @c b
+     * have different sizes.
+     */
+    template<class Operator, class XSub, class BSub, class Preconditioner>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b, const Preconditioner& M);
+
+    /** Solve A @c x = @c b without preconditioning. */
+    template<class Operator, class XSub, class BSub>
+      bool solve(const Operator& A, writable_vector<XSub>& x,
+	const readable_vector<BSub>& b);
+
+
+  protected:
+
+    /** Iterations between restarts. */
+    int					m_restart;
+
+    /** Orthonormal Krylov basis, m_restart+1 vectors. */
+    std::vector<vector_type>		m_basis;
+
+    /** Column-major (m_restart+1) x m_restart Hessenberg matrix, reduced
+     * to upper triangular form by the Givens rotations.
+     */
+    std::vector<value_type>		m_hessenberg;
+
+    /** Givens rotations, the rotated residual vector, and its solution. */
+    std::vector<value_type>		m_cos, m_sin, m_g, m_y;
+
+    vector_type				m_x, m_b, m_w, m_z;
+};
+
+} // namespace cml
+
+#define __CML_SOLVERS_GMRES_TPP
+#include <cml/solvers/gmres.tpp>
+#undef __CML_SOLVERS_GMRES_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
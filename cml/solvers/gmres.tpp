@@ -0,0 +1,173 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_SOLVERS_GMRES_TPP
+#error "solvers/gmres.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <stdexcept>
+#include <cml/common/exception.h>
+#include <cml/vector/size_checking.h>
+#include <cml/solvers/detail/krylov.h>
+
+namespace cml {
+
+template<class Element>
+gmres<Element>::gmres(int n, int restart)
+: m_restart(0)
+{
+  this->resize(n);
+  this->set_restart(restart);
+}
+
+template<class Element> void
+gmres<Element>::resize(int n)
+{
+  this->m_x.resize(n);
+  this->m_b.resize(n);
+  this->m_w.resize(n);
+  this->m_z.resize(n);
+  for(auto& v : this->m_basis) v.resize(n);
+}
+
+template<class Element> void
+gmres<Element>::set_restart(int restart)
+{
+  cml_require(restart > 0, std::invalid_argument, "restart must be positive");
+  const int m = restart;
+  this->m_restart = m;
+  this->m_basis.resize(m+1);
+  for(auto& v : this->m_basis) v.resize(this->m_x.size());
+  this->m_hessenberg.resize((m+1)*m);
+  this->m_cos.resize(m);
+  this->m_sin.resize(m);
+  this->m_g.resize(m+1);
+  this->m_y.resize(m);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub, class Preconditioner> bool
+gmres<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b,
+  const Preconditioner& M
+  )
+{
+  cml::check_same_size(x, b);
+  const int n = b.size();
+  this->resize(n);
+
+  const int m = this->m_restart;
+  value_type* xp = this->m_x.data();
+  value_type* bp = this->m_b.data();
+  value_type* w = this->m_w.data();
+  value_type* H = this->m_hessenberg.data();
+  value_type* cs = this->m_cos.data();
+  value_type* sn = this->m_sin.data();
+  value_type* g = this->m_g.data();
+  value_type* y = this->m_y.data();
+
+  /* A zero right-hand side has the exact solution 0: */
+  detail::krylov_load(b, this->m_b);
+  const value_type b_norm = detail::krylov_norm(n, bp);
+  if(b_norm == value_type(0)) {
+    for(int i = 0; i < n; ++ i) xp[i] = value_type(0);
+    detail::krylov_store(this->m_x, x);
+    return this->finish(0, value_type(0));
+  }
+  detail::krylov_load(x, this->m_x);
+
+  const int limit = this->iteration_limit(n);
+  int k = 0;
+  value_type residual(0);
+  for(;;) {
+
+    /* w = b - A x, the residual of the current solution: */
+    detail::apply_operator(A, this->m_x, this->m_w);
+    detail::krylov_xpby(n, bp, value_type(-1), w);
+    value_type beta = detail::krylov_norm(n, w);
+    residual = beta/b_norm;
+    if(k >= limit || residual <= this->m_tolerance) break;
+
+    /* Start the basis from the normalized residual: */
+    value_type* v0 = this->m_basis[0].data();
+    for(int i = 0; i < n; ++ i) v0[i] = w[i]/beta;
+    g[0] = beta;
+
+    int j = 0;
+    while(j < m && k < limit) {
+      value_type* h = H + j*(m+1);
+
+      /* w = A M^-1 v_j, orthogonalized against v_0..v_j: */
+      M.apply(this->m_basis[j], this->m_z);
+      detail::apply_operator(A, this->m_z, this->m_w);
+      for(int i = 0; i <= j; ++ i) {
+	const value_type* vi = this->m_basis[i].data();
+	h[i] = detail::krylov_dot(n, w, vi);
+	detail::krylov_axpy(n, - h[i], vi, w);
+      }
+      h[j+1] = detail::krylov_norm(n, w);
+      if(h[j+1] != value_type(0)) {
+	value_type* vj = this->m_basis[j+1].data();
+	for(int i = 0; i < n; ++ i) vj[i] = w[i]/h[j+1];
+      }
+
+      /* Apply the previous rotations to the new column, then zero its
+       * subdiagonal element:
+       */
+      for(int i = 0; i < j; ++ i) {
+	value_type hi = cs[i]*h[i] + sn[i]*h[i+1];
+	h[i+1] = cs[i]*h[i+1] - sn[i]*h[i];
+	h[i] = hi;
+      }
+      value_type r = std::hypot(h[j], h[j+1]);
+      cs[j] = (r != value_type(0)) ? h[j]/r : value_type(1);
+      sn[j] = (r != value_type(0)) ? h[j+1]/r : value_type(0);
+      bool exhausted = (h[j+1] == value_type(0));
+      h[j] = r;
+      h[j+1] = value_type(0);
+      g[j+1] = - sn[j]*g[j];
+      g[j] = cs[j]*g[j];
+
+      residual = std::abs(g[j+1])/b_norm;
+      ++ j;
+      ++ k;
+      if(residual <= this->m_tolerance || exhausted) break;
+    }
+
+    /* Solve the triangular system H y = g, then x += M^-1 (V y): */
+    for(int i = j-1; i >= 0; -- i) {
+      value_type s = g[i];
+      for(int l = i+1; l < j; ++ l) s -= H[l*(m+1) + i]*y[l];
+      y[i] = (H[i*(m+1) + i] != value_type(0)) ? s/H[i*(m+1) + i]
+	: value_type(0);
+    }
+    for(int i = 0; i < n; ++ i) w[i] = value_type(0);
+    for(int i = 0; i < j; ++ i)
+      detail::krylov_axpy(n, y[i], this->m_basis[i].data(), w);
+    M.apply(this->m_w, this->m_z);
+    detail::krylov_axpy(n, value_type(1), this->m_z.data(), xp);
+
+    if(residual <= this->m_tolerance) break;
+  }
+
+  detail::krylov_store(this->m_x, x);
+  return this->finish(k, residual);
+}
+
+template<class Element>
+template<class Operator, class XSub, class BSub> bool
+gmres<Element>::solve(const Operator& A,
+  writable_vector<XSub>& x, const readable_vector<BSub>& b
+  )
+{
+  return this->solve(A, x, b, identity_preconditioner());
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
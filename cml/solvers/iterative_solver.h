@@ -0,0 +1,94 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_iterative_solver_h
+#define	cml_solvers_iterative_solver_h
+
+#include <cmath>
+#include <limits>
+#include <cml/vector/dynamic.h>
+
+namespace cml {
+
+/** Settings and statistics shared by the iterative solvers.  A solve
+ * stops once the relative residual norm ||b - A*x||/||b|| drops to
+ * tolerance(), or after max_iterations() iterations.  The default
+ * tolerance is the square root of epsilon, and a maximum of 0 (the
+ * default) allows 10*n iterations for an n x n system.
+ */
+template<class Element> class iterative_solver
+{
+  public:
+
+    typedef Element					value_type;
+    typedef vector<Element, dynamic<>>			vector_type;
+
+
+  public:
+
+    /** Set the relative residual norm at which a solve stops. */
+    void set_tolerance(value_type tolerance) { m_tolerance = tolerance; }
+
+    /** Set the maximum number of iterations of a solve, or 0 to use 10*n.
+     */
+    void set_max_iterations(int max_iterations) {
+      m_max_iterations = max_iterations; }
+
+    /** Return the relative residual norm at which a solve stops. */
+    value_type tolerance() const { return m_tolerance; }
+
+    /** Return the maximum number of iterations of a solve, or 0. */
+    int max_iterations() const { return m_max_iterations; }
+
+    /** Return the number of iterations taken by the last solve. */
+    int iterations() const { return m_iterations; }
+
+    /** Return the relative residual norm reached by the last solve, as
+     * tracked by the iteration's own recurrence.
+     */
+    value_type residual() const { return m_residual; }
+
+    /** Return true if the last solve reached tolerance(). */
+    bool converged() const { return m_converged; }
+
+
+  protected:
+
+    iterative_solver()
+      : m_tolerance(std::sqrt(std::numeric_limits<Element>::epsilon()))
+      , m_max_iterations(0), m_iterations(0), m_residual(0)
+      , m_converged(false) {}
+
+    /** Return the iteration limit for an @c n x @c n system. */
+    int iteration_limit(int n) const {
+      return (m_max_iterations > 0) ? m_max_iterations : 10*n; }
+
+    /** Record the statistics of a finished solve. */
+    bool finish(int iterations, value_type residual) {
+      m_iterations = iterations;
+      m_residual = residual;
+      m_converged = (residual <= m_tolerance);
+      return m_converged;
+    }
+
+
+  protected:
+
+    value_type				m_tolerance;
+    int					m_max_iterations;
+    int					m_iterations;
+    value_type				m_residual;
+    bool				m_converged;
+};
+
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
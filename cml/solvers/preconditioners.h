@@ -0,0 +1,155 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Preconditioners for the iterative solvers.  A preconditioner is any
+ * type with a member apply(r, z) that sets @c z to an approximation of
+ * A^-1 r, where @c r and @c z are iterative_solver<>::vector_type and @c
+ * z already has the size of @c r.
+ */
+
+#pragma once
+
+#ifndef	cml_solvers_preconditioners_h
+#define	cml_solvers_preconditioners_h
+
+#include <vector>
+#include <cml/matrix/readable_matrix.h>
+#include <cml/vector/dynamic.h>
+
+namespace cml {
+
+/** The trivial preconditioner, which copies @c r to @c z. */
+struct identity_preconditioner
+{
+  template<class Vector> void apply(const Vector& r, Vector& z) const {
+    z = r; }
+};
+
+/** Diagonal (Jacobi) preconditioner, dividing each element of the
+ * residual by the corresponding diagonal element of A.  Zero diagonal
+ * elements are replaced by 1.
+ */
+template<class Element> class jacobi_preconditioner
+{
+  public:
+
+    typedef Element					value_type;
+    typedef vector<Element, dynamic<>>			vector_type;
+
+
+  public:
+
+    jacobi_preconditioner() {}
+
+    /** Construct from the diagonal of the square matrix @c A.
+     *
+     * @throws non_square_matrix_error at run-time if @c A is not square.
+     */
+    template<class Sub>
+      explicit jacobi_preconditioner(const readable_matrix<Sub>& A);
+
+    /** Recompute from the diagonal of the square matrix @c A, reusing the
+     * storage if the size is unchanged.
+     *
+     * @throws non_square_matrix_error at run-time if @c A is not square.
+     */
+    template<class Sub> void compute(const readable_matrix<Sub>& A);
+
+    /** Set @c z to D^-1 @c r. */
+    void apply(const vector_type& r, vector_type& z) const;
+
+
+  protected:
+
+    vector_type				m_inverse;
+};
+
+/** Zero fill-in incomplete Cholesky preconditioner, IC(0), for symmetric
+ * positive definite matrices.  The factor L has the sparsity pattern of
+ * the lower triangle of A, and is stored compressed by rows, so the cost
+ * of apply() is proportional to the number of nonzeros of A.  If the
+ * factorization breaks down, it is repeated on A + alpha*diag(A), doubling
+ * alpha from 1/1024 until it succeeds.
+ *
+ * @note For a dense matrix, IC(0) is the complete Cholesky factor.
+ */
+template<class Element> class incomplete_cholesky_preconditioner
+{
+  public:
+
+    typedef Element					value_type;
+    typedef vector<Element, dynamic<>>			vector_type;
+
+
+  public:
+
+    incomplete_cholesky_preconditioner() : m_shift(0) {}
+
+    /** Construct from the lower triangle of the square matrix @c A.
+     *
+     * @throws non_square_matrix_error at run-time if @c A is not square.
+     * @throws std::invalid_argument if a diagonal element of @c A is not
+     * positive.
+     */
+    template<class Sub>
+      explicit incomplete_cholesky_preconditioner(
+	const readable_matrix<Sub>& A);
+
+    /** Recompute the factor from the lower triangle of the square matrix
+     * @c A.
+     *
+     * @throws non_square_matrix_error at run-time if @c A is not square.
+     * @throws std::invalid_argument if a diagonal element of @c A is not
+     * positive.
+     */
+    template<class Sub> void compute(const readable_matrix<Sub>& A);
+
+    /** Set @c z to (L L^T)^-1 @c r by forward and back substitution. */
+    void apply(const vector_type& r, vector_type& z) const;
+
+    /** Return the diagonal shift alpha used by the last compute(), or 0
+     * if the factorization did not break down.
+     */
+    value_type shift() const { return m_shift; }
+
+    /** Return the number of nonzeros of the factor. */
+    int nonzeros() const { return int(m_values.size()); }
+
+
+  protected:
+
+    /** Factor with diagonal shift @c alpha, returning false on breakdown.
+     */
+    template<class Sub>
+      bool factor(const readable_matrix<Sub>& A, value_type alpha);
+
+
+  protected:
+
+    /** Index in m_cols and m_values of the first entry of each row, and
+     * one past the last.  The diagonal is the last entry of its row.
+     */
+    std::vector<int>			m_rows;
+
+    /** Column of each entry, increasing along a row. */
+    std::vector<int>			m_cols;
+
+    /** Value of each entry of L. */
+    std::vector<value_type>		m_values;
+
+    /** Diagonal shift of the last factorization. */
+    value_type				m_shift;
+};
+
+} // namespace cml
+
+#define __CML_SOLVERS_PRECONDITIONERS_TPP
+#include <cml/solvers/preconditioners.tpp>
+#undef __CML_SOLVERS_PRECONDITIONERS_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,164 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_SOLVERS_PRECONDITIONERS_TPP
+#error "solvers/preconditioners.tpp not included correctly"
+#endif
+
+#include <cmath>
+#include <stdexcept>
+#include <cml/common/exception.h>
+#include <cml/matrix/size_checking.h>
+
+namespace cml {
+
+/* jacobi_preconditioner: */
+
+template<class Element> template<class Sub>
+jacobi_preconditioner<Element>::jacobi_preconditioner(
+  const readable_matrix<Sub>& A
+  )
+{
+  this->compute(A);
+}
+
+template<class Element> template<class Sub> void
+jacobi_preconditioner<Element>::compute(const readable_matrix<Sub>& A)
+{
+  cml::check_square(A);
+  const int n = A.rows();
+  this->m_inverse.resize(n);
+  for(int i = 0; i < n; ++ i) {
+    value_type d = value_type(A.get(i,i));
+    this->m_inverse[i] = (d != value_type(0)) ? value_type(1)/d
+      : value_type(1);
+  }
+}
+
+template<class Element> void
+jacobi_preconditioner<Element>::apply(
+  const vector_type& r, vector_type& z
+  ) const
+{
+  const int n = r.size();
+  const value_type* d = this->m_inverse.data();
+  const value_type* src = r.data();
+  value_type* dst = z.data();
+  for(int i = 0; i < n; ++ i) dst[i] = d[i]*src[i];
+}
+
+
+/* incomplete_cholesky_preconditioner: */
+
+template<class Element> template<class Sub>
+incomplete_cholesky_preconditioner<Element>::
+incomplete_cholesky_preconditioner(const readable_matrix<Sub>& A)
+: m_shift(0)
+{
+  this->compute(A);
+}
+
+template<class Element> template<class Sub> void
+incomplete_cholesky_preconditioner<Element>::compute(
+  const readable_matrix<Sub>& A
+  )
+{
+  cml::check_square(A);
+  const int n = A.rows();
+
+  /* Collect the pattern of the lower triangle, with the diagonal last: */
+  this->m_rows.assign(1, 0);
+  this->m_cols.clear();
+  for(int i = 0; i < n; ++ i) {
+    cml_require(value_type(A.get(i,i)) > value_type(0),
+      std::invalid_argument, "diagonal must be positive");
+    for(int j = 0; j < i; ++ j)
+      if(value_type(A.get(i,j)) != value_type(0)) this->m_cols.push_back(j);
+    this->m_cols.push_back(i);
+    this->m_rows.push_back(int(this->m_cols.size()));
+  }
+  this->m_values.resize(this->m_cols.size());
+
+  /* A large enough shift makes A diagonally dominant, so this stops: */
+  value_type alpha(0);
+  while(!this->factor(A, alpha))
+    alpha = (alpha == value_type(0)) ? value_type(1)/value_type(1024)
+      : value_type(2)*alpha;
+  this->m_shift = alpha;
+}
+
+template<class Element> template<class Sub> bool
+incomplete_cholesky_preconditioner<Element>::factor(
+  const readable_matrix<Sub>& A, value_type alpha
+  )
+{
+  const int n = A.rows();
+  const int* rows = this->m_rows.data();
+  const int* cols = this->m_cols.data();
+  value_type* L = this->m_values.data();
+
+  for(int i = 0; i < n; ++ i) {
+    for(int p = rows[i]; p < rows[i+1]; ++ p) {
+      const int k = cols[p];
+
+      /* Subtract the dot product of rows i and k of L over the columns
+       * before k, merging their sorted patterns:
+       */
+      value_type s = value_type(A.get(i,k));
+      int a = rows[i], b = rows[k];
+      const int b_end = rows[k+1] - 1;
+      while(a < p && b < b_end) {
+	if(cols[a] < cols[b]) ++ a;
+	else if(cols[b] < cols[a]) ++ b;
+	else s -= L[a++]*L[b++];
+      }
+
+      if(k < i) {
+	L[p] = s/L[b_end];
+      } else {
+	s += alpha*value_type(A.get(i,i));
+	if(!(s > value_type(0))) return false;
+	L[p] = std::sqrt(s);
+      }
+    }
+  }
+  return true;
+}
+
+template<class Element> void
+incomplete_cholesky_preconditioner<Element>::apply(
+  const vector_type& r, vector_type& z
+  ) const
+{
+  const int n = r.size();
+  const int* rows = this->m_rows.data();
+  const int* cols = this->m_cols.data();
+  const value_type* L = this->m_values.data();
+  const value_type* src = r.data();
+  value_type* dst = z.data();
+
+  /* Solve L y = r: */
+  for(int i = 0; i < n; ++ i) {
+    value_type s = src[i];
+    const int diag = rows[i+1] - 1;
+    for(int p = rows[i]; p < diag; ++ p) s -= L[p]*dst[cols[p]];
+    dst[i] = s/L[diag];
+  }
+
+  /* Solve L^T z = y, scattering each solved element into the rows above:
+   */
+  for(int i = n-1; i >= 0; -- i) {
+    const int diag = rows[i+1] - 1;
+    value_type zi = dst[i]/L[diag];
+    dst[i] = zi;
+    for(int p = rows[i]; p < diag; ++ p) dst[cols[p]] -= L[p]*zi;
+  }
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,98 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_storage_aligned_allocator_h
+#define	cml_storage_aligned_allocator_h
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace cml {
+
+/** Stateless allocator returning storage aligned to @c Align bytes, for
+ * use with allocated<> (dynamic<>) vectors and matrices:
+ *
+ * @code
+ * typedef vector<float, dynamic<aligned_allocator<void,32>>> vectorf_a32;
+ * @endcode
+ *
+ * With C++17 aligned new, storage comes from the aligned operator new;
+ * otherwise, it is over-allocated from operator new and the original
+ * pointer is stored just before the aligned block.
+ *
+ * @tparam Align Alignment in bytes, a power of two at least as large as
+ * the alignment of a pointer.
+ */
+template<class T, int Align = 32> class aligned_allocator
+{
+  static_assert(Align > 0 && (Align & (Align - 1)) == 0,
+    "alignment must be a power of two");
+  static_assert(Align >= int(alignof(void*)),
+    "alignment must be at least that of a pointer");
+
+  public:
+
+    typedef T						value_type;
+    typedef T*						pointer;
+    typedef const T*					const_pointer;
+    typedef std::size_t					size_type;
+    typedef std::ptrdiff_t				difference_type;
+    typedef std::true_type				is_always_equal;
+
+    /** The alignment of allocated storage, in bytes. */
+    static const int alignment = Align;
+
+    /** Rebind to another element type. */
+    template<class U> struct rebind {
+      typedef aligned_allocator<U, Align>		other;
+    };
+
+
+  public:
+
+    aligned_allocator() = default;
+
+    template<class U>
+      aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    /** Allocate aligned storage for @c n elements.
+     *
+     * @throws std::bad_alloc if the allocation fails.
+     */
+    T* allocate(std::size_t n);
+
+    /** Release storage returned by allocate(). */
+    void deallocate(T* p, std::size_t n) noexcept;
+};
+
+/** All aligned_allocator<> with the same alignment are interchangeable. */
+template<class T, class U, int Align> inline bool operator==(
+  const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&)
+{
+  return true;
+}
+
+/** All aligned_allocator<> with the same alignment are interchangeable. */
+template<class T, class U, int Align> inline bool operator!=(
+  const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&)
+{
+  return false;
+}
+
+} // namespace cml
+
+#define __CML_STORAGE_ALIGNED_ALLOCATOR_TPP
+#include <cml/storage/aligned_allocator.tpp>
+#undef __CML_STORAGE_ALIGNED_ALLOCATOR_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
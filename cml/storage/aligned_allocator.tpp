@@ -0,0 +1,50 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_STORAGE_ALIGNED_ALLOCATOR_TPP
+#error "storage/aligned_allocator.tpp not included correctly"
+#endif
+
+#include <limits>
+
+namespace cml {
+
+template<class T, int Align> T*
+aligned_allocator<T, Align>::allocate(std::size_t n)
+{
+  if(n > std::numeric_limits<std::size_t>::max()/sizeof(T) - Align)
+    throw std::bad_alloc();
+  const std::size_t bytes = n*sizeof(T);
+
+#if defined(__cpp_aligned_new)
+  return static_cast<T*>(
+    ::operator new(bytes, std::align_val_t(std::size_t(Align))));
+#else
+  /* Reserve room for the original pointer below the aligned block: */
+  void* raw = ::operator new(bytes + Align + sizeof(void*));
+  std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+  std::uintptr_t aligned
+    = (base + std::uintptr_t(Align - 1)) & ~std::uintptr_t(Align - 1);
+  reinterpret_cast<void**>(aligned)[-1] = raw;
+  return reinterpret_cast<T*>(aligned);
+#endif
+}
+
+template<class T, int Align> void
+aligned_allocator<T, Align>::deallocate(T* p, std::size_t) noexcept
+{
+  if(p == nullptr) return;
+#if defined(__cpp_aligned_new)
+  ::operator delete(p, std::align_val_t(std::size_t(Align)));
+#else
+  ::operator delete(reinterpret_cast<void**>(p)[-1]);
+#endif
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -14,9 +14,10 @@
 #include <cml/common/size_tags.h>
 #include <cml/common/storage_tags.h>
 #include <cml/common/memory_tags.h>
+#include <cml/common/allocator.h>
 #include <cml/storage/type_util.h>
 
-// XXX Temporary, for fixed-size allocated proxies:
+// XXX Temporary, for fixed-size allocated quaternion proxies:
 #include <cml/storage/compiled_selector.h>
 
 namespace cml {
@@ -78,18 +79,13 @@ struct allocated<Allocator, -1, -1, vector_storage_tag>
   };
 };
 
-/** Specialized selector for dynamically-allocated, fixed-size vectors.
- *
- * @todo Fixed-size allocated types are not actually implemented by CML, so
- * the proxy_type is set to compiled<Size>.
- */
+/** Specialized selector for dynamically-allocated, fixed-size vectors. */
 template<int Size, class Allocator>
 struct allocated<Allocator, Size, -1, vector_storage_tag>
 {
   typedef allocated<>					selector_type;
   typedef allocated<Allocator>				unbound_type;
-  //XXX typedef allocated<Allocator, Size>		proxy_type;
-  typedef compiled<Size>				proxy_type;
+  typedef allocated<Allocator, Size>			proxy_type;
   typedef vector_storage_tag				storage_tag;
   typedef fixed_size_tag				size_tag;
   typedef allocated_memory_tag				memory_tag;
@@ -126,18 +122,13 @@ struct allocated<Allocator, -1, -1, matrix_storage_tag>
   };
 };
 
-/** Specialized selector for dynamically-allocated, fixed-size matrices.
- *
- * @todo Fixed-size allocated types are not actually implemented by CML, so
- * the proxy_type is set to compiled<Size1,Size2>.
- */
+/** Specialized selector for dynamically-allocated, fixed-size matrices. */
 template<class Allocator, int Size1, int Size2>
 struct allocated<Allocator, Size1, Size2, matrix_storage_tag>
 {
   typedef allocated<>					selector_type;
   typedef allocated<Allocator>				unbound_type;
-  //XXX typedef allocated<Allocator, Size1, Size2>	proxy_type;
-  typedef compiled<Size1, Size2>			proxy_type;
+  typedef allocated<Allocator, Size1, Size2>		proxy_type;
   typedef matrix_storage_tag				storage_tag;
   typedef fixed_size_tag				size_tag;
   typedef allocated_memory_tag				memory_tag;
@@ -149,15 +140,15 @@ struct allocated<Allocator, Size1, Size2, matrix_storage_tag>
   static const int array_cols = Size2;
 
   /** Make a partially bound selector with size @c R x @c C. */
-  template<int R, int C> struct resize {
+  template<int R, int C> struct reshape {
     typedef allocated<Allocator, R, C>			type;
   };
 };
 
 /** Specialized selector for dynamically-allocated quaternions.
  *
- * @todo Fixed-size allocated types are not actually implemented by CML, so
- * the proxy_type is set to compiled<Size>.
+ * @todo Allocated quaternion types are not implemented by CML, so the
+ * proxy_type is set to compiled<4>.
  */
 template<class Allocator>
 struct allocated<Allocator, 4, -1, quaternion_storage_tag>
@@ -186,23 +177,19 @@ struct is_storage_selector<allocated<Allocator, Size1, Size2, Tag>> {
   static const bool value = true;
 };
 
-/** Determine an unbound allocated<> storage type using an allocator that
- * best represents the combination of the passed-in allocators.  If the
- * best allocator cannot be determined, std::allocator<> is used.
+/** Determine an unbound allocator (rebound to void) that best represents
+ * the combination of the passed-in allocators.  If the best allocator
+ * cannot be determined, std::allocator<void> is used.
  *
  * @note This can be specialized for user-defined allocators if the default
  * disambiguation strategy fails to yield the proper type.
  */
-template<
-  class Allocator1, int R1, int C1, class Tag1,
-  class Allocator2, int R2, int C2, class Tag2>
-struct storage_disambiguate<
-  allocated<Allocator1, R1, C1, Tag1>,
-  allocated<Allocator2, R2, C2, Tag2>>
+template<class Allocator1, class Allocator2>
+struct allocator_disambiguate
 {
   /* Rebind the allocators to void to compare them: */
-  typedef typename Allocator1::template rebind<void>::other	left_type;
-  typedef typename Allocator2::template rebind<void>::other	right_type;
+  typedef rebind_alloc_t<Allocator1, void>		left_type;
+  typedef rebind_alloc_t<Allocator2, void>		right_type;
 
   /* True if the unbound allocators are the same: */
   static const bool is_same
@@ -226,7 +213,7 @@ struct storage_disambiguate<
   static const bool prefer_default
     = !(is_same || prefer_left || prefer_right);
   static_assert(is_same || prefer_left || prefer_right || prefer_default,
-    "unexpected storage_disambiguate result");
+    "unexpected allocator_disambiguate result");
 
   /* Determine the preferred allocator type: */
   typedef
@@ -234,10 +221,27 @@ struct storage_disambiguate<
     cml::if_t<prefer_left,	left_type,
     cml::if_t<prefer_right,	right_type,
     /*else*/			std::allocator<void>
-      >>>						allocator_type;
+      >>>						type;
+};
+
+/** Convenience alias for allocator_disambiguate. */
+template<class Allocator1, class Allocator2> using allocator_disambiguate_t
+  = typename allocator_disambiguate<Allocator1, Allocator2>::type;
 
+/** Determine an unbound allocated<> storage type using an allocator that
+ * best represents the combination of the passed-in allocators (see
+ * allocator_disambiguate).
+ */
+template<
+  class Allocator1, int R1, int C1, class Tag1,
+  class Allocator2, int R2, int C2, class Tag2>
+struct storage_disambiguate<
+  allocated<Allocator1, R1, C1, Tag1>,
+  allocated<Allocator2, R2, C2, Tag2>>
+{
   /* Build the disambiguated unbound storage type: */
-  typedef allocated<allocator_type>			type;
+  typedef allocated<
+    allocator_disambiguate_t<Allocator1, Allocator2>>	type;
 };
 
 
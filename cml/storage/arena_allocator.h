@@ -0,0 +1,219 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_storage_arena_allocator_h
+#define	cml_storage_arena_allocator_h
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace cml {
+
+/** Monotonic memory arena, similar to std::pmr::monotonic_buffer_resource.
+ * Allocations are carved from large blocks, deallocation is a no-op, and
+ * all memory is returned at once by release() or the destructor.  An
+ * arena is not thread-safe.
+ */
+class arena
+{
+  public:
+
+    /** Construct an arena allocating blocks of at least @c block_size
+     * bytes from operator new.
+     */
+    explicit arena(std::size_t block_size = 64*1024);
+
+    /** Construct an arena that allocates from @c buffer until its @c size
+     * bytes are exhausted, and then from blocks of at least @c size bytes.
+     * The buffer is not owned by the arena.
+     */
+    arena(void* buffer, std::size_t size);
+
+    /** Release all memory. */
+    ~arena();
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+
+  public:
+
+    /** Return @c bytes bytes aligned to @c align, a power of two.
+     *
+     * @throws std::bad_alloc if a new block cannot be allocated.
+     */
+    void* allocate(std::size_t bytes, std::size_t align);
+
+    /** No-op; memory is released by release(). */
+    void deallocate(void*, std::size_t) noexcept {}
+
+    /** Release all allocated blocks, and reuse the initial buffer, if any.
+     * Any memory returned by allocate() becomes invalid.
+     */
+    void release() noexcept;
+
+    /** Return the number of bytes allocated since construction or the
+     * last release(), including alignment padding.
+     */
+    std::size_t bytes_used() const { return m_used; }
+
+
+  public:
+
+    /** Return the arena of the innermost arena_scope on this thread, or
+     * nullptr if there is none.
+     */
+    static arena* current() { return current_ref(); }
+
+
+  private:
+
+    friend class arena_scope;
+
+    /** Header of a block allocated from operator new. */
+    struct block { block* next; };
+
+    /** The current arena of this thread. */
+    static arena*& current_ref() {
+      static thread_local arena* current = nullptr;
+      return current;
+    }
+
+
+  private:
+
+    /** The initial buffer, if any. */
+    char*			m_buffer;
+
+    /** Size of the initial buffer. */
+    std::size_t			m_buffer_size;
+
+    /** Minimum size of new blocks. */
+    std::size_t			m_block_size;
+
+    /** The blocks allocated from operator new, most recent first. */
+    block*			m_blocks;
+
+    /** The free space in the current block or buffer. */
+    char*			m_next;
+    char*			m_end;
+
+    /** Bytes handed out since the last release(). */
+    std::size_t			m_used;
+};
+
+/** Makes @c a the current arena of this thread for the lifetime of the
+ * scope, so that default-constructed arena_allocator<> instances allocate
+ * from it.  Scopes can be nested.
+ */
+class arena_scope
+{
+  public:
+
+    explicit arena_scope(arena& a)
+      : m_previous(arena::current_ref()) { arena::current_ref() = &a; }
+    ~arena_scope() { arena::current_ref() = m_previous; }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+
+  private:
+
+    arena*			m_previous;
+};
+
+/** Stateful allocator drawing storage from an arena, for use with
+ * allocated<> (dynamic<>) and small<> vectors and matrices:
+ *
+ * @code
+ * typedef vector<double, dynamic<arena_allocator<void>>> vectord_a;
+ *
+ * arena frame;
+ * vectord_a v(3, arena_allocator<double>(frame));
+ * @endcode
+ *
+ * A default-constructed allocator uses the current arena of the thread
+ * (see arena_scope), or operator new if there is none.  Like
+ * std::pmr::polymorphic_allocator, the allocator stays with its container
+ * on assignment.  Copies of a container, and temporaries computed from
+ * it, use the same arena.
+ */
+template<class T> class arena_allocator
+{
+  public:
+
+    typedef T						value_type;
+    typedef T*						pointer;
+    typedef const T*					const_pointer;
+    typedef std::size_t					size_type;
+    typedef std::ptrdiff_t				difference_type;
+    typedef std::false_type			propagate_on_container_copy_assignment;
+    typedef std::false_type			propagate_on_container_move_assignment;
+    typedef std::false_type			propagate_on_container_swap;
+
+    /** Rebind to another element type. */
+    template<class U> struct rebind {
+      typedef arena_allocator<U>			other;
+    };
+
+
+  public:
+
+    /** Use the current arena, if any. */
+    arena_allocator() noexcept : m_arena(arena::current()) {}
+
+    /** Use @c a. */
+    arena_allocator(arena& a) noexcept : m_arena(&a) {}
+
+    template<class U> arena_allocator(const arena_allocator<U>& other)
+      noexcept : m_arena(other.resource()) {}
+
+    /** Return the arena, or nullptr for operator new. */
+    arena* resource() const { return m_arena; }
+
+    /** Allocate storage for @c n elements.
+     *
+     * @throws std::bad_alloc if the allocation fails.
+     */
+    T* allocate(std::size_t n);
+
+    /** Release storage returned by allocate(). */
+    void deallocate(T* p, std::size_t n) noexcept;
+
+
+  private:
+
+    arena*			m_arena;
+};
+
+/** Allocators are interchangeable if they use the same arena. */
+template<class T, class U> inline bool operator==(
+  const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+  return a.resource() == b.resource();
+}
+
+/** Allocators are interchangeable if they use the same arena. */
+template<class T, class U> inline bool operator!=(
+  const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+  return a.resource() != b.resource();
+}
+
+} // namespace cml
+
+#define __CML_STORAGE_ARENA_ALLOCATOR_TPP
+#include <cml/storage/arena_allocator.tpp>
+#undef __CML_STORAGE_ARENA_ALLOCATOR_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
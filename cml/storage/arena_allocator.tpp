@@ -0,0 +1,109 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_STORAGE_ARENA_ALLOCATOR_TPP
+#error "storage/arena_allocator.tpp not included correctly"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace cml {
+
+/* arena 'structors: */
+
+inline
+arena::arena(std::size_t block_size)
+: m_buffer(nullptr), m_buffer_size(0), m_block_size(block_size)
+, m_blocks(nullptr), m_next(nullptr), m_end(nullptr), m_used(0)
+{
+}
+
+inline
+arena::arena(void* buffer, std::size_t size)
+: m_buffer(static_cast<char*>(buffer)), m_buffer_size(size)
+, m_block_size(size), m_blocks(nullptr)
+, m_next(m_buffer), m_end(m_buffer + size), m_used(0)
+{
+}
+
+inline
+arena::~arena()
+{
+  this->release();
+}
+
+
+/* Public methods: */
+
+inline void*
+arena::allocate(std::size_t bytes, std::size_t align)
+{
+  /* Try the free space of the current block: */
+  std::uintptr_t next = reinterpret_cast<std::uintptr_t>(this->m_next);
+  std::uintptr_t aligned
+    = (next + std::uintptr_t(align - 1)) & ~std::uintptr_t(align - 1);
+  std::uintptr_t end = reinterpret_cast<std::uintptr_t>(this->m_end);
+  if(this->m_next == nullptr || aligned > end || bytes > end - aligned) {
+
+    /* Allocate a new block with room for the header and alignment: */
+    std::size_t overhead = sizeof(block) + align;
+    if(bytes > std::numeric_limits<std::size_t>::max() - overhead)
+      throw std::bad_alloc();
+    std::size_t size = std::max(bytes + overhead, this->m_block_size);
+    char* raw = static_cast<char*>(::operator new(size));
+    block* b = reinterpret_cast<block*>(raw);
+    b->next = this->m_blocks;
+    this->m_blocks = b;
+    this->m_next = raw + sizeof(block);
+    this->m_end = raw + size;
+
+    next = reinterpret_cast<std::uintptr_t>(this->m_next);
+    aligned = (next + std::uintptr_t(align - 1)) & ~std::uintptr_t(align - 1);
+  }
+
+  this->m_used += (aligned - next) + bytes;
+  this->m_next = reinterpret_cast<char*>(aligned + bytes);
+  return reinterpret_cast<void*>(aligned);
+}
+
+inline void
+arena::release() noexcept
+{
+  while(this->m_blocks) {
+    block* next = this->m_blocks->next;
+    ::operator delete(this->m_blocks);
+    this->m_blocks = next;
+  }
+  this->m_next = this->m_buffer;
+  this->m_end = this->m_buffer + this->m_buffer_size;
+  this->m_used = 0;
+}
+
+
+/* arena_allocator methods: */
+
+template<class T> T*
+arena_allocator<T>::allocate(std::size_t n)
+{
+  if(n > std::numeric_limits<std::size_t>::max()/sizeof(T))
+    throw std::bad_alloc();
+  if(this->m_arena == nullptr)
+    return static_cast<T*>(::operator new(n*sizeof(T)));
+  return static_cast<T*>(this->m_arena->allocate(n*sizeof(T), alignof(T)));
+}
+
+template<class T> void
+arena_allocator<T>::deallocate(T* p, std::size_t) noexcept
+{
+  if(this->m_arena == nullptr) ::operator delete(p);
+}
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -17,7 +17,8 @@
 namespace cml {
 
 /* Forward declarations: */
-template<int Size1 = -1, int Size2 = -1, class Tag = void> struct compiled;
+template<int Size1 = -1, int Size2 = -1, int Align = 0, class Tag = void>
+  struct compiled;
 
 /** Base selector to choose compiled storage types.
  *
@@ -25,36 +26,41 @@ template<int Size1 = -1, int Size2 = -1, class Tag = void> struct compiled;
  *
  * @tparam Size2 Second dimension size.
  *
+ * @tparam Align Alignment of the storage in bytes, or 0 to use
+ * default_storage_alignment for the element type and size.  The element
+ * type is only known once the selector is bound to a vector, matrix or
+ * quaternion, which resolves the alignment with storage_alignment<>.
+ *
  * @tparam Tag Tag specifying the type of storage (e.g.
  * vector_storage_tag).  This is set by instantiating @c rebind with the
  * required tag.
  */
-template<int Size1, int Size2>
-struct compiled<Size1, Size2, void>
+template<int Size1, int Size2, int Align>
+struct compiled<Size1, Size2, Align, void>
 {
   /** Rebind the base selector to the required type. */
   template<class Rebind> struct rebind {
-    typedef compiled<Size1, Size2, Rebind>		other;
+    typedef compiled<Size1, Size2, Align, Rebind>	other;
   };
 
   /** Make a partially bound selector with size @c N. */
   template<int N> struct resize {
-    typedef compiled<N>					type;
+    typedef compiled<N, -1, Align>			type;
   };
 
   /** Make a partially bound selector with size @c R x @c C. */
   template<int R, int C> struct reshape {
-    typedef compiled<R, C>				type;
+    typedef compiled<R, C, Align>			type;
   };
 };
 
 /** Specialized selector for fixed-size compiled vectors. */
-template<int Size>
-struct compiled<Size, -1, vector_storage_tag>
+template<int Size, int Align>
+struct compiled<Size, -1, Align, vector_storage_tag>
 {
   typedef compiled<>					selector_type;
   typedef compiled<>					unbound_type;
-  typedef compiled<Size>				proxy_type;
+  typedef compiled<Size, -1, Align>			proxy_type;
   typedef vector_storage_tag				storage_tag;
   typedef fixed_size_tag				size_tag;
   typedef compiled_memory_tag				memory_tag;
@@ -62,19 +68,22 @@ struct compiled<Size, -1, vector_storage_tag>
   /** Constant for the array size. */
   static const int array_size = Size;
 
+  /** Constant for the requested alignment, or 0 for the default. */
+  static const int array_alignment = Align;
+
   /** Make a partially bound selector with size @c N. */
   template<int N> struct resize {
-    typedef compiled<N>					type;
+    typedef compiled<N, -1, Align>			type;
   };
 };
 
 /** Specialized selector for fixed-size compiled matrices. */
-template<int Size1, int Size2>
-struct compiled<Size1, Size2, matrix_storage_tag>
+template<int Size1, int Size2, int Align>
+struct compiled<Size1, Size2, Align, matrix_storage_tag>
 {
   typedef compiled<>					selector_type;
   typedef compiled<>					unbound_type;
-  typedef compiled<Size1, Size2>			proxy_type;
+  typedef compiled<Size1, Size2, Align>			proxy_type;
   typedef matrix_storage_tag				storage_tag;
   typedef fixed_size_tag				size_tag;
   typedef compiled_memory_tag				memory_tag;
@@ -85,19 +94,22 @@ struct compiled<Size1, Size2, matrix_storage_tag>
   /** Constant for the number of array columns. */
   static const int array_cols = Size2;
 
+  /** Constant for the requested alignment, or 0 for the default. */
+  static const int array_alignment = Align;
+
   /** Make a partially bound selector with size @c R x @c C. */
   template<int R, int C> struct reshape {
-    typedef compiled<R, C>				type;
+    typedef compiled<R, C, Align>			type;
   };
 };
 
 /** Specialized selector for quaternions. */
-template<>
-struct compiled<4, -1, quaternion_storage_tag>
+template<int Align>
+struct compiled<4, -1, Align, quaternion_storage_tag>
 {
   typedef compiled<>					selector_type;
   typedef compiled<>					unbound_type;
-  typedef compiled<>					proxy_type;
+  typedef compiled<-1, -1, Align>			proxy_type;
   typedef quaternion_storage_tag			storage_tag;
   typedef fixed_size_tag				size_tag;
   typedef compiled_memory_tag				memory_tag;
@@ -105,29 +117,34 @@ struct compiled<4, -1, quaternion_storage_tag>
   /** Constant for the array size. */
   static const int array_size = 4;
 
+  /** Constant for the requested alignment, or 0 for the default. */
+  static const int array_alignment = Align;
+
   /** Make a partially bound selector with size @c N. */
   template<int N> struct resize {
     static_assert(N == 4, "invalid quaternion storage size");
-    typedef compiled<4>					type;
+    typedef compiled<4, -1, Align>			type;
   };
 };
 
 /** is_storage_selector for compiled<>. */
-template<int Size1, int Size2, class Tag>
-struct is_storage_selector<compiled<Size1, Size2, Tag>> {
+template<int Size1, int Size2, int Align, class Tag>
+struct is_storage_selector<compiled<Size1, Size2, Align, Tag>> {
   static const bool value = true;
 };
 
 /** Helper to disambiguate compiled<> types. */
-template<int R1, int C1, class Tag1, int R2, int C2, class Tag2>
-struct storage_disambiguate<compiled<R1, C1, Tag1>, compiled<R2, C2, Tag2>>
+template<int R1, int C1, int A1, class Tag1, int R2, int C2, int A2, class Tag2>
+struct storage_disambiguate<
+  compiled<R1, C1, A1, Tag1>, compiled<R2, C2, A2, Tag2>>
 {
   typedef compiled<>					type;
 };
 
 
 /** For compatibility with CML1. */
-template<int Size1 = -1, int Size2 = -1> using fixed = compiled<Size1, Size2>;
+template<int Size1 = -1, int Size2 = -1, int Align = 0>
+  using fixed = compiled<Size1, Size2, Align>;
 
 } // namespace cml
 
@@ -56,6 +56,24 @@ struct storage_promote
 
     ,     selector_map< compiled<>,	any_storage<>,	compiled<>	>
 
+    /* Override and select small<> if PreferDynamic is true and the
+     * original storage types are not both fixed-size:
+     */
+    ,     selector_map< compiled<>,	small<>,
+    			cml::if_t<is_fixed, compiled<>, small<>>
+			>
+
+    /* Prefer small<> over allocated<> and external<>, so temporaries of
+     * mixed expressions avoid the heap:
+     */
+    ,     selector_map< small<>,	small<>,	small<>		>
+
+    ,     selector_map< small<>,	allocated<>,	small<>		>
+
+    ,     selector_map< small<>,	external<>,	small<>		>
+
+    ,     selector_map< small<>,	any_storage<>,	small<>		>
+
     ,     selector_map< allocated<>,	allocated<>,	allocated<>	>
 
     ,     selector_map< allocated<>,	external<>,	allocated<>	>
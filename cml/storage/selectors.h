@@ -11,6 +11,7 @@
 
 #include <cml/storage/compiled_selector.h>
 #include <cml/storage/allocated_selector.h>
+#include <cml/storage/small_selector.h>
 #include <cml/storage/external_selector.h>
 #include <cml/storage/any_selector.h>
 
@@ -0,0 +1,211 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_storage_small_selector_h
+#define	cml_storage_small_selector_h
+
+#include <memory>
+#include <cml/common/size_tags.h>
+#include <cml/common/storage_tags.h>
+#include <cml/common/memory_tags.h>
+#include <cml/storage/type_util.h>
+#include <cml/storage/compiled_selector.h>
+#include <cml/storage/allocated_selector.h>
+
+namespace cml {
+
+/* Forward declarations: */
+template<int N = 16, class Allocator = std::allocator<void>,
+  int Size1 = -1, int Size2 = -1, class Tag = void> struct small;
+
+/** Base selector to choose dynamic-size types with a small inline buffer
+ * (small-buffer optimized storage).  Up to @c N elements are stored in the
+ * object itself, and larger arrays are allocated using @c Allocator.
+ *
+ * @tparam N Number of elements stored inline.  For matrices, this is the
+ * maximum number of rows times columns stored inline.
+ *
+ * @tparam Allocator Optional allocator type that must be compatible with
+ * std::allocator. The default is std::allocator<void>.
+ *
+ * @tparam Size1 First dimension size.
+ *
+ * @tparam Size2 Second dimension size.
+ *
+ * @tparam Tag Tag specifying the type of storage (e.g.
+ * vector_storage_tag).  This is set by instantiating @c rebind with the
+ * required tag.
+ */
+template<int N, class Allocator, int Size1, int Size2>
+struct small<N, Allocator, Size1, Size2>
+{
+  static_assert(N > 0, "invalid small<> buffer size");
+
+  /** Rebind the base selector to the required type. */
+  template<class Rebind> struct rebind {
+    typedef small<N, Allocator, Size1, Size2, Rebind>	other;
+  };
+
+  /** Make a partially bound selector with size @c M. */
+  template<int M> struct resize {
+    typedef small<N, Allocator, M>			type;
+  };
+
+  /** Make a partially bound selector with size @c R x @c C. */
+  template<int R, int C> struct reshape {
+    typedef small<N, Allocator, R, C>			type;
+  };
+};
+
+/** Specialized selector for small-buffer vectors. */
+template<int N, class Allocator>
+struct small<N, Allocator, -1, -1, vector_storage_tag>
+{
+  typedef small<>					selector_type;
+  typedef small<N, Allocator>				unbound_type;
+  typedef small<N, Allocator>				proxy_type;
+  typedef vector_storage_tag				storage_tag;
+  typedef dynamic_size_tag				size_tag;
+  typedef allocated_memory_tag				memory_tag;
+
+  /** Unspecified array size. */
+  static const int array_size = -1;
+
+  /** Constant for the inline buffer size. */
+  static const int buffer_size = N;
+
+  /** Make a partially bound selector with size @c M. */
+  template<int M> struct resize {
+    typedef small<N, Allocator, M>			type;
+  };
+};
+
+/** Specialized selector for fixed-size small-buffer vectors.  These are
+ * not implemented by CML, so the proxy_type is set to compiled<Size>.
+ */
+template<int N, class Allocator, int Size>
+struct small<N, Allocator, Size, -1, vector_storage_tag>
+{
+  typedef small<>					selector_type;
+  typedef small<N, Allocator>				unbound_type;
+  typedef compiled<Size>				proxy_type;
+  typedef vector_storage_tag				storage_tag;
+  typedef fixed_size_tag				size_tag;
+  typedef allocated_memory_tag				memory_tag;
+
+  /** Constant for the array size. */
+  static const int array_size = Size;
+
+  /** Make a partially bound selector with size @c M. */
+  template<int M> struct resize {
+    typedef small<N, Allocator, M>			type;
+  };
+};
+
+/** Specialized selector for small-buffer matrices. */
+template<int N, class Allocator>
+struct small<N, Allocator, -1, -1, matrix_storage_tag>
+{
+  typedef small<>					selector_type;
+  typedef small<N, Allocator>				unbound_type;
+  typedef small<N, Allocator>				proxy_type;
+  typedef matrix_storage_tag				storage_tag;
+  typedef dynamic_size_tag				size_tag;
+  typedef allocated_memory_tag				memory_tag;
+
+  /** Unspecified array rows. */
+  static const int array_rows = -1;
+
+  /** Unspecified array columns. */
+  static const int array_cols = -1;
+
+  /** Constant for the inline buffer size. */
+  static const int buffer_size = N;
+
+  /** Make a partially bound selector with size @c R x @c C. */
+  template<int R, int C> struct reshape {
+    typedef small<N, Allocator, R, C>			type;
+  };
+};
+
+/** Specialized selector for fixed-size small-buffer matrices.  These are
+ * not implemented by CML, so the proxy_type is set to compiled<Size1,
+ * Size2>.
+ */
+template<int N, class Allocator, int Size1, int Size2>
+struct small<N, Allocator, Size1, Size2, matrix_storage_tag>
+{
+  typedef small<>					selector_type;
+  typedef small<N, Allocator>				unbound_type;
+  typedef compiled<Size1, Size2>			proxy_type;
+  typedef matrix_storage_tag				storage_tag;
+  typedef fixed_size_tag				size_tag;
+  typedef allocated_memory_tag				memory_tag;
+
+  /** Constant for the number of array rows. */
+  static const int array_rows = Size1;
+
+  /** Constant for the number of array columns. */
+  static const int array_cols = Size2;
+
+  /** Make a partially bound selector with size @c R x @c C. */
+  template<int R, int C> struct reshape {
+    typedef small<N, Allocator, R, C>			type;
+  };
+};
+
+/** Specialized selector for small-buffer quaternions.  These are always
+ * fixed-size, so the proxy_type is set to compiled<4>.
+ */
+template<int N, class Allocator>
+struct small<N, Allocator, 4, -1, quaternion_storage_tag>
+{
+  typedef small<>					selector_type;
+  typedef small<N, Allocator>				unbound_type;
+  typedef compiled<4>					proxy_type;
+  typedef quaternion_storage_tag			storage_tag;
+  typedef fixed_size_tag				size_tag;
+  typedef allocated_memory_tag				memory_tag;
+
+  /** Constant for the array size. */
+  static const int array_size = 4;
+
+  /** Make a partially bound selector with size @c M. */
+  template<int M> struct resize {
+    static_assert(M == 4, "invalid quaternion storage size");
+    typedef small<N, Allocator, 4>			type;
+  };
+};
+
+/** is_storage_selector for small<>. */
+template<int N, class Allocator, int Size1, int Size2, class Tag>
+struct is_storage_selector<small<N, Allocator, Size1, Size2, Tag>> {
+  static const bool value = true;
+};
+
+/** Determine an unbound small<> storage type using the larger of the two
+ * buffer sizes, and the allocator that best represents the combination of
+ * the passed-in allocators (see allocator_disambiguate).
+ */
+template<
+  int N1, class Allocator1, int R1, int C1, class Tag1,
+  int N2, class Allocator2, int R2, int C2, class Tag2>
+struct storage_disambiguate<
+  small<N1, Allocator1, R1, C1, Tag1>,
+  small<N2, Allocator2, R2, C2, Tag2>>
+{
+  typedef small<(N1 > N2 ? N1 : N2),
+    allocator_disambiguate_t<Allocator1, Allocator2>>	type;
+};
+
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -93,6 +93,16 @@ class vector_binary_node
 #endif
 
 
+  public:
+
+    /** Return true if either subexpression reads the object at @c dest out
+     * of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_vector Interface */
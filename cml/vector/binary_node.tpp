@@ -9,6 +9,7 @@
 #endif
 
 #include <cml/vector/size_checking.h>
+#include <cml/vector/detail/aliasing.h>
 
 namespace cml {
 
@@ -40,6 +41,19 @@ vector_binary_node<Sub1,Sub2,Op>::vector_binary_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub1, class Sub2, class Op> bool
+vector_binary_node<Sub1,Sub2,Op>::aliases(
+  const detail::alias_target& dest
+  ) const
+{
+  return detail::aliases(this->m_left, dest)
+    || detail::aliases(this->m_right, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
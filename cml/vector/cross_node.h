@@ -95,6 +95,17 @@ class vector_cross_node
 #endif
 
 
+  public:
+
+    /** Return true if either subexpression is @c dest or shares its
+     * memory, or reads it out of order.  Each element of the cross
+     * product reads the other two elements of both operands.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_vector Interface */
@@ -9,6 +9,7 @@
 #endif
 
 #include <cml/vector/size_checking.h>
+#include <cml/vector/detail/aliasing.h>
 
 namespace cml {
 
@@ -39,6 +40,19 @@ vector_cross_node<Sub1,Sub2>::vector_cross_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub1, class Sub2> bool
+vector_cross_node<Sub1,Sub2>::aliases(const detail::alias_target& dest) const
+{
+  return detail::is_alias(this->m_left, dest)
+    || detail::is_alias(this->m_right, dest)
+    || detail::aliases(this->m_left, dest)
+    || detail::aliases(this->m_right, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
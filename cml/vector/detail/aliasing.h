@@ -0,0 +1,188 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_vector_detail_aliasing_h
+#define	cml_vector_detail_aliasing_h
+
+#include <functional>
+#include <type_traits>
+#include <cml/common/type_util.h>
+#include <cml/common/allocator.h>
+#include <cml/common/temporary.h>
+#include <cml/vector/fwd.h>
+#include <cml/matrix/fwd.h>
+
+namespace cml {
+namespace detail {
+
+/** The object assigned from an expression, as seen by aliases(): its
+ * address and, if it has contiguous storage, the bounds of its element
+ * array.  The bounds are null otherwise.
+ */
+struct alias_target
+{
+  const void*				object;
+  const void*				first;
+  const void*				last;
+};
+
+/** Return the number of elements stored by matrix @c M. */
+template<class Sub> inline int
+stored_size(const readable_matrix<Sub>& M)
+{
+  return M.rows()*M.cols();
+}
+
+/** Return the number of elements stored by vector @c v. */
+template<class Sub> inline int
+stored_size(const readable_vector<Sub>& v)
+{
+  return v.size();
+}
+
+/* make_alias_target() for objects without contiguous storage. */
+template<class Dest> inline alias_target
+make_alias_target(const Dest& dest, std::false_type)
+{
+  return alias_target{ &dest, nullptr, nullptr };
+}
+
+/* make_alias_target() for objects with contiguous storage. */
+template<class Dest> inline alias_target
+make_alias_target(const Dest& dest, std::true_type)
+{
+  if(dest.data() == nullptr) return alias_target{ &dest, nullptr, nullptr };
+  return alias_target{
+    &dest, dest.data(), dest.data() + stored_size(dest) };
+}
+
+/** Return the alias_target describing @c dest. */
+template<class Dest> inline alias_target
+make_alias_target(const Dest& dest)
+{
+  typedef std::integral_constant<bool,
+    has_contiguous_data<Dest>::value>			tag;
+  return make_alias_target(dest, tag());
+}
+
+/** Return true if the element arrays of @c a and @c b overlap. */
+inline bool
+overlaps(const alias_target& a, const alias_target& b)
+{
+  std::less<const void*> less;
+  return a.first != a.last && b.first != b.last
+    && less(a.first, b.last) && less(b.first, a.last);
+}
+
+/** Return true if @c operand is the object described by @c dest, or if
+ * both have contiguous storage and their element arrays overlap.
+ */
+template<class Operand> inline bool
+is_alias(const Operand& operand, const alias_target& dest)
+{
+  return (const void*) &operand == dest.object
+    || overlaps(make_alias_target(operand), dest);
+}
+
+/** Defines @c value as true if the vector or matrix expression @c Sub
+ * implements aliases(const alias_target&), or false otherwise.
+ * Expressions that read more than element @c i of an operand to compute
+ * their element @c i implement aliases() to report whether that operand
+ * is, or shares memory with, the assigned object (see is_alias()).
+ * Expressions wrapping other expressions implement aliases() to forward
+ * the query.
+ */
+template<class Sub> struct has_alias_check
+{
+  private:
+
+  template<class X> static auto test(int)
+    -> decltype(std::declval<const X&>().aliases(
+	std::declval<const alias_target&>()), std::true_type());
+  template<class X> static auto test(...) -> std::false_type;
+
+  public:
+
+  typedef decltype(test<Sub>(0))			type;
+  static const bool value = type::value;
+};
+
+/* aliases() for expressions that never read their operands out of
+ * order.
+ */
+template<class Node> inline bool
+aliases(const Node&, const alias_target&, std::false_type)
+{
+  return false;
+}
+
+/* aliases() for expressions implementing aliases(const alias_target&). */
+template<class Node> inline bool
+aliases(const Node& node, const alias_target& dest, std::true_type)
+{
+  return node.aliases(dest);
+}
+
+/** Return true if assigning @c sub element-by-element to the object
+ * described by @c dest could read elements of @c dest that were already
+ * overwritten.
+ */
+template<class Sub> inline bool
+aliases(const readable_vector<Sub>& sub, const alias_target& dest)
+{
+  return aliases(sub.actual(), dest, typename has_alias_check<Sub>::type());
+}
+
+/** Return true if a vector expression reading @c sub could read elements
+ * of the vector described by @c dest that were already overwritten, for
+ * example through an outer product of that vector.
+ */
+template<class Sub> inline bool
+aliases(const readable_matrix<Sub>& sub, const alias_target& dest)
+{
+  return aliases(sub.actual(), dest, typename has_alias_check<Sub>::type());
+}
+
+/* alias_free() for expressions that cannot alias, which are returned
+ * as-is.
+ */
+template<class Sub, class Dest> inline const Sub&
+alias_free(const readable_vector<Sub>& sub, const Dest&, std::false_type)
+{
+  return sub.actual();
+}
+
+/* alias_free() for expressions that can alias, which are evaluated into a
+ * temporary using the allocator of @c dest, if any.
+ */
+template<class Sub, class Dest> inline temporary_of_t<Sub>
+alias_free(const readable_vector<Sub>& sub, const Dest& dest, std::true_type)
+{
+  auto temp = make_temporary<temporary_of_t<Sub>>(dest);
+  temp = sub;
+  return temp;
+}
+
+/** Return @c sub evaluated into a temporary if it implements aliases(),
+ * or @c sub itself otherwise.  This should be called only when
+ * aliases() returns true for @c dest, the vector being assigned.
+ */
+template<class Sub, class Dest> inline auto
+alias_free(const readable_vector<Sub>& sub, const Dest& dest)
+-> decltype(alias_free(sub, dest, typename has_alias_check<Sub>::type()))
+{
+  return alias_free(sub, dest, typename has_alias_check<Sub>::type());
+}
+
+} // namespace detail
+} // namespace cml
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
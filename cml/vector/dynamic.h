@@ -10,6 +10,7 @@
 #define	cml_vector_dynamic_h
 
 #include <cml/vector/dynamic_allocated.h>
+#include <cml/vector/dynamic_small.h>
 
 #endif
 
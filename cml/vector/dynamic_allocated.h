@@ -11,6 +11,8 @@
 
 #include <cml/common/mpl/enable_if_t.h>
 #include <cml/common/mpl/rebind.h>
+#include <cml/common/alignment.h>
+#include <cml/common/allocator.h>
 #include <cml/storage/allocated_selector.h>
 #include <cml/vector/writable_vector.h>
 #include <cml/vector/vector.h>
@@ -40,21 +42,31 @@ struct vector_traits< vector<Element, dynamic<Allocator>> >
   /* Array size (should be -1): */
   static const int array_size = storage_type::array_size;
   static_assert(array_size == -1, "invalid vector size");
+
+  /* Array alignment in bytes, from the allocator: */
+  static const int alignment
+    = storage_alignment_of<rebind_alloc_t<Allocator, Element>>::value;
 };
 
-/** Resizable vector. */
+/** Resizable vector.  The vector stores an instance of its allocator,
+ * which is propagated on copy and move as directed by
+ * std::allocator_traits, and inherited by vectors constructed from it.
+ */
 template<class Element, class Allocator>
 class vector<Element, dynamic<Allocator>>
 : public writable_vector< vector<Element, dynamic<Allocator>> >
+, private detail::allocator_base<rebind_alloc_t<Allocator, Element>>
 {
-  protected:
+  public:
 
     /** The real allocator type. */
-    typedef rebind_t<Allocator, Element>		allocator_type;
+    typedef rebind_alloc_t<Allocator, Element>		allocator_type;
+
 
-    /** Require a stateless allocator. */
-    static_assert(std::is_empty<allocator_type>::value,
-      "cannot use a stateful allocator for dynamic<> vectors");
+  protected:
+
+    /** Base class storing the allocator. */
+    typedef detail::allocator_base<allocator_type>	allocator_base_type;
 
 
   public:
@@ -89,6 +101,9 @@ class vector<Element, dynamic<Allocator>>
     /** Constant containing the array size. */
     static const int array_size = traits_type::array_size;
 
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
 
   public:
 
@@ -98,6 +113,9 @@ class vector<Element, dynamic<Allocator>>
      */
     vector();
 
+    /** Construct an empty vector using @c alloc. */
+    explicit vector(const allocator_type& alloc);
+
     /** Construct given a size.
      *
      * @throws std::invalid_argument if @c size < 0.
@@ -106,15 +124,36 @@ class vector<Element, dynamic<Allocator>>
       enable_if_t<std::is_integral<Int>::value>* = nullptr>
       explicit vector(Int size);
 
-    /** Copy constructor. */
+    /** Construct given a size, using @c alloc.
+     *
+     * @throws std::invalid_argument if @c size < 0.
+     */
+    template<class Int,
+      enable_if_t<std::is_integral<Int>::value>* = nullptr>
+      vector(Int size, const allocator_type& alloc);
+
+    /** Copy constructor.  The allocator is copied from @c other by
+     * select_on_container_copy_construction().
+     */
     vector(const vector_type& other);
 
-    /** Move constructor. */
+    /** Copy @c other, using @c alloc. */
+    vector(const vector_type& other, const allocator_type& alloc);
+
+    /** Move constructor.  The allocator and array are taken from @c other.
+     */
     vector(vector_type&& other);
 
-    /** Construct from a readable_vector. */
+    /** Construct from a readable_vector.  If @c sub is a vector with a
+     * compatible allocator, its allocator is copied as by the copy
+     * constructor.
+     */
     template<class Sub> vector(const readable_vector<Sub>& sub);
 
+    /** Construct from a readable_vector, using @c alloc. */
+    template<class Sub>
+      vector(const readable_vector<Sub>& sub, const allocator_type& alloc);
+
     /** Construct from at least 1 value.  The vector is resized to
      * accomodate the number of elements passed.
      *
@@ -126,7 +165,7 @@ class vector<Element, dynamic<Allocator>>
 	vector(const E0& e0, const Elements&... eN)
 	// XXX Should be in vector/dynamic_allocated.tpp, but VC++12 has
 	// brain-dead out-of-line template argument matching...
-	: m_data(0), m_size(0)
+	: m_data(0), m_size(0), m_capacity(0)
 	{
 	  this->assign_elements(e0, eN...);
 	}
@@ -146,7 +185,7 @@ class vector<Element, dynamic<Allocator>>
 	  )
 	// XXX Should be in vector/fixed_compiled.tpp, but VC++12 has
 	// brain-dead out-of-line template argument matching...
-	: m_data(0), m_size(0)
+	: m_data(0), m_size(0), m_capacity(0)
 	{
 	  this->assign(sub, e0, eN...);
 	}
@@ -172,6 +211,9 @@ class vector<Element, dynamic<Allocator>>
 
   public:
 
+    /** Return a copy of the allocator. */
+    allocator_type get_allocator() const;
+
     /** Return access to the vector data as a raw pointer. */
     pointer data();
 
@@ -184,10 +226,28 @@ class vector<Element, dynamic<Allocator>>
     /** Read-only iterator. */
     const_pointer end() const;
 
+    /** Return the number of elements the vector can hold without
+     * reallocating.
+     */
+    int capacity() const;
+
+    /** Ensure the vector can hold at least @c n elements without
+     * reallocating.  The size and elements are unchanged.
+     *
+     * @throws std::invalid_argument if @c n is negative.
+     */
+    void reserve(int n);
+
+    /** Reallocate the array to exactly fit the current size, if it is
+     * larger.
+     */
+    void shrink_to_fit();
+
     /** Resize the vector to the specified size.
      *
-     * @note This will reallocate the array and copy existing elements, if
-     * any.
+     * @note This only reallocates if @c n exceeds capacity(), in which
+     * case the capacity grows geometrically and existing elements are
+     * copied to the new array.
      *
      * @throws std::invalid_argument if @c n is negative.
      */
@@ -203,10 +263,15 @@ class vector<Element, dynamic<Allocator>>
 
   public:
 
-    /** Copy assignment. */
+    /** Copy assignment.  The allocator is copied if it propagates on
+     * copy assignment.
+     */
     vector_type& operator=(const vector_type& other);
 
-    /** Move assignment. */
+    /** Move assignment.  The array of @c other is taken if the allocators
+     * are equal or the allocator propagates on move assignment, and
+     * otherwise the elements are copied.
+     */
     vector_type& operator=(vector_type&& other);
 
 #ifdef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
@@ -229,6 +294,21 @@ class vector<Element, dynamic<Allocator>>
 
   protected:
 
+    /** Return the capacity to allocate for at least @c n elements, growing
+     * the current capacity geometrically.
+     */
+    int grown_capacity(int n) const;
+
+    /** Replace the array with a new one of @c capacity elements, copying
+     * the first @c copy elements of the current array.
+     */
+    void reallocate(int capacity, int copy);
+
+    /** Exchange the arrays of this vector and @c other, without exchanging
+     * their allocators.
+     */
+    void swap_arrays(vector_type& other);
+
     /** No-op for trivially destructible elements
      * (is_trivially_destructible).
      */
@@ -284,6 +364,9 @@ class vector<Element, dynamic<Allocator>>
 
     /** Size of the vector. */
     int				m_size;
+
+    /** Number of elements allocated at m_data. */
+    int				m_capacity;
 };
 
 } // namespace cml
@@ -8,6 +8,8 @@
 #error "vector/dynamic_allocated.tpp not included correctly"
 #endif
 
+#include <algorithm>
+#include <memory>
 #include <cml/common/exception.h>
 
 namespace cml {
@@ -16,35 +18,71 @@ namespace cml {
 
 template<class E, class A>
 vector<E, dynamic<A>>::vector()
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
+{
+}
+
+template<class E, class A>
+vector<E, dynamic<A>>::vector(const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(0), m_size(0), m_capacity(0)
 {
 }
 
 template<class E, class A>
 template<class Int, enable_if_t<std::is_integral<Int>::value>*>
 vector<E, dynamic<A>>::vector(Int size)
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
+{
+  this->resize_fast(int(size));
+}
+
+template<class E, class A>
+template<class Int, enable_if_t<std::is_integral<Int>::value>*>
+vector<E, dynamic<A>>::vector(Int size, const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(0), m_size(0), m_capacity(0)
 {
   this->resize_fast(int(size));
 }
 
 template<class E, class A>
 vector<E, dynamic<A>>::vector(const vector_type& other)
-: m_data(0), m_size(0)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(0), m_size(0), m_capacity(0)
+{
+  this->assign(other);
+}
+
+template<class E, class A>
+vector<E, dynamic<A>>::vector(
+  const vector_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0), m_size(0), m_capacity(0)
 {
   this->assign(other);
 }
 
 template<class E, class A>
 vector<E, dynamic<A>>::vector(vector_type&& other)
-: m_data(0), m_size(0)
+: allocator_base_type(other.stored_allocator())
+, m_data(0), m_size(0), m_capacity(0)
 {
-  this->operator=(std::move(other));
+  this->swap_arrays(other);
 }
 
 template<class E, class A> template<class Sub>
 vector<E, dynamic<A>>::vector(const readable_vector<Sub>& sub)
-: m_data(0), m_size(0)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(0), m_size(0), m_capacity(0)
+{
+  this->assign(sub);
+}
+
+template<class E, class A> template<class Sub>
+vector<E, dynamic<A>>::vector(
+  const readable_vector<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0), m_size(0), m_capacity(0)
 {
   this->assign(sub);
 }
@@ -52,7 +90,7 @@ vector<E, dynamic<A>>::vector(const readable_vector<Sub>& sub)
 template<class E, class A>
 template<class Array, enable_if_array_t<Array>*>
 vector<E, dynamic<A>>::vector(const Array& array)
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
 {
   this->assign(array);
 }
@@ -60,7 +98,7 @@ vector<E, dynamic<A>>::vector(const Array& array)
 template<class E, class A>
 template<class Pointer, enable_if_pointer_t<Pointer>*>
 vector<E, dynamic<A>>::vector(const Pointer& array, int size)
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
 {
   this->resize_fast(size);
   this->assign(array);
@@ -69,7 +107,7 @@ vector<E, dynamic<A>>::vector(const Pointer& array, int size)
 template<class E, class A>
 template<class Pointer, enable_if_pointer_t<Pointer>*>
 vector<E, dynamic<A>>::vector(int size, const Pointer& array)
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
 {
   this->resize_fast(size);
   this->assign(array);
@@ -77,7 +115,7 @@ vector<E, dynamic<A>>::vector(int size, const Pointer& array)
 
 template<class E, class A> template<class Other>
 vector<E, dynamic<A>>::vector(std::initializer_list<Other> l)
-: m_data(0), m_size(0)
+: m_data(0), m_size(0), m_capacity(0)
 {
   this->assign(l);
 }
@@ -85,16 +123,24 @@ vector<E, dynamic<A>>::vector(std::initializer_list<Other> l)
 template<class E, class A>
 vector<E, dynamic<A>>::~vector()
 {
-  typedef typename allocator_type::size_type size_type;
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
   this->destruct(this->m_data, this->m_size,
     typename std::is_trivially_destructible<E>::type());
-  allocator_type().deallocate(this->m_data, size_type(this->m_size));
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
 }
 
 
 
 /* Public methods: */
 
+template<class E, class A> auto
+vector<E, dynamic<A>>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
 template<class E, class A> auto
 vector<E, dynamic<A>>::data() -> pointer
 {
@@ -119,44 +165,34 @@ vector<E, dynamic<A>>::end() const -> const_pointer
   return this->m_data + this->m_size;
 }
 
+template<class E, class A> int
+vector<E, dynamic<A>>::capacity() const
+{
+  return this->m_capacity;
+}
+
 template<class E, class A> void
-vector<E, dynamic<A>>::resize(int n)
+vector<E, dynamic<A>>::reserve(int n)
 {
-  cml_require(n >= 0, std::invalid_argument, "size < 0");
+  cml_require(n >= 0, std::invalid_argument, "capacity < 0");
+  if(n > this->m_capacity) this->reallocate(n, this->m_size);
+}
 
-  /* Short-circuit same size: */
-  if(n == this->m_size) return;
+template<class E, class A> void
+vector<E, dynamic<A>>::shrink_to_fit()
+{
+  if(this->m_capacity > this->m_size)
+    this->reallocate(this->m_size, this->m_size);
+}
 
-  /* Allocator to use: */
-  auto allocator = allocator_type();
-
-  /* Allocate the new array: */
-  pointer data = this->m_data;
-  int size = this->m_size;
-  pointer copy = allocator.allocate(n);
-  try {
-
-    /* Destruct elements if necessary: */
-    this->destruct(data, size,
-      typename std::is_trivially_destructible<E>::type());
-
-    /* Copy elements to the new array if necessary: */
-    if(data) {
-      int to = std::min(size, n);
-      for(pointer src = data, dst = copy; src < data + to; ++ src, ++ dst) {
-	allocator.construct(dst, *src);
-      }
-
-      /* Deallocate the old array: */
-      allocator.deallocate(data, size);
-    }
-  } catch(...) {
-    allocator_type().deallocate(copy, n);
-    throw;
-  }
+template<class E, class A> void
+vector<E, dynamic<A>>::resize(int n)
+{
+  cml_require(n >= 0, std::invalid_argument, "size < 0");
 
-  /* Save the new array: */
-  this->m_data = copy;
+  /* Reuse the current array if it is large enough: */
+  if(n > this->m_capacity)
+    this->reallocate(this->grown_capacity(n), this->m_size);
   this->m_size = n;
 }
 
@@ -165,31 +201,8 @@ vector<E, dynamic<A>>::resize_fast(int n)
 {
   cml_require(n >= 0, std::invalid_argument, "size < 0");
 
-  /* Short-circuit same size: */
-  if(n == this->m_size) return;
-
-  /* Allocator to use: */
-  auto allocator = allocator_type();
-
-  /* Allocate the new array: */
-  pointer data = this->m_data;
-  int size = this->m_size;
-  pointer copy = allocator.allocate(n);
-  try {
-
-    /* Destruct elements if necessary: */
-    this->destruct(data, size,
-      typename std::is_trivially_destructible<E>::type());
-
-    /* Deallocate the old array: */
-    allocator.deallocate(data, size);
-  } catch(...) {
-    allocator_type().deallocate(copy, n);
-    throw;
-  }
-
-  /* Save the new array: */
-  this->m_data = copy;
+  /* Reuse the current array if it is large enough: */
+  if(n > this->m_capacity) this->reallocate(this->grown_capacity(n), 0);
   this->m_size = n;
 }
 
@@ -197,16 +210,47 @@ vector<E, dynamic<A>>::resize_fast(int n)
 template<class E, class A> auto
 vector<E, dynamic<A>>::operator=(const vector_type& other) -> vector_type&
 {
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    this->reallocate(0, 0);
+    this->m_size = 0;
+  }
+  this->copy_assign_allocator(other);
   return this->assign(other);
 }
 
 template<class E, class A> auto
 vector<E, dynamic<A>>::operator=(vector_type&& other) -> vector_type&
 {
-  /* Ensure deletion of the current array, if any: */
-  std::swap(this->m_data, other.m_data);
-  std::swap(this->m_size, other.m_size);
-  /* Note: swap() can't throw here, so this is exception-safe. */
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  if(this->stored_allocator() == other.stored_allocator()) {
+    /* Ensure deletion of the current array, if any, by other: */
+    this->swap_arrays(other);
+  }
+
+  else if(propagate::value) {
+    /* Release the current array before taking the allocator of other: */
+    this->reallocate(0, 0);
+    this->m_size = 0;
+    this->move_assign_allocator(other);
+    this->swap_arrays(other);
+  }
+
+  else {
+    /* The array of other cannot be released by this allocator: */
+    this->assign(other);
+  }
 
   return *this;
 }
@@ -215,6 +259,52 @@ vector<E, dynamic<A>>::operator=(vector_type&& other) -> vector_type&
 
 /* Internal methods: */
 
+template<class E, class A> int
+vector<E, dynamic<A>>::grown_capacity(int n) const
+{
+  return std::max(n, 2*this->m_capacity);
+}
+
+template<class E, class A> void
+vector<E, dynamic<A>>::reallocate(int capacity, int copy)
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef std::allocator_traits<allocator_type> alloc_traits;
+
+  /* Allocator to use: */
+  allocator_type allocator = this->stored_allocator();
+
+  /* Allocate the new array, and copy elements if necessary: */
+  pointer data = nullptr;
+  if(capacity > 0) {
+    data = allocator.allocate(size_type(capacity));
+    try {
+      for(int i = 0; i < copy; ++ i)
+	alloc_traits::construct(allocator, data + i, this->m_data[i]);
+    } catch(...) {
+      allocator.deallocate(data, size_type(capacity));
+      throw;
+    }
+  }
+
+  /* Release the old array, and save the new one: */
+  this->destruct(this->m_data, this->m_size,
+    typename std::is_trivially_destructible<E>::type());
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
+  this->m_data = data;
+  this->m_capacity = capacity;
+}
+
+template<class E, class A> void
+vector<E, dynamic<A>>::swap_arrays(vector_type& other)
+{
+  /* Note: swap() can't throw here, so this is exception-safe. */
+  std::swap(this->m_data, other.m_data);
+  std::swap(this->m_size, other.m_size);
+  std::swap(this->m_capacity, other.m_capacity);
+}
+
 template<class E, class A> void
 vector<E, dynamic<A>>::destruct(pointer, int, std::true_type)
 {
@@ -228,7 +318,9 @@ vector<E, dynamic<A>>::destruct(pointer data, int n, std::false_type)
   if(data == nullptr) return;
 
   /* Destruct each element: */
-  else for(pointer e = data; e < data + n; ++ e) allocator_type().destroy(e);
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
 }
 
 
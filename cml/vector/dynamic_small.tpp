@@ -0,0 +1,392 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_VECTOR_DYNAMIC_SMALL_TPP
+#error "vector/dynamic_small.tpp not included correctly"
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <cml/common/exception.h>
+
+namespace cml {
+
+/* small 'structors: */
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::vector()
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+}
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::vector(const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(m_buffer), m_size(0), m_capacity(N)
+{
+}
+
+template<class E, int N, class A>
+template<class Int, enable_if_t<std::is_integral<Int>::value>*>
+vector<E, small<N, A>>::vector(Int size)
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->resize_fast(int(size));
+}
+
+template<class E, int N, class A>
+template<class Int, enable_if_t<std::is_integral<Int>::value>*>
+vector<E, small<N, A>>::vector(Int size, const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->resize_fast(int(size));
+}
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::vector(const vector_type& other)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(other);
+}
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::vector(
+  const vector_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(other);
+}
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::vector(vector_type&& other)
+: allocator_base_type(other.stored_allocator())
+, m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->operator=(std::move(other));
+}
+
+template<class E, int N, class A> template<class Sub>
+vector<E, small<N, A>>::vector(const readable_vector<Sub>& sub)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(sub);
+}
+
+template<class E, int N, class A> template<class Sub>
+vector<E, small<N, A>>::vector(
+  const readable_vector<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(sub);
+}
+
+template<class E, int N, class A>
+template<class Array, enable_if_array_t<Array>*>
+vector<E, small<N, A>>::vector(const Array& array)
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(array);
+}
+
+template<class E, int N, class A>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+vector<E, small<N, A>>::vector(const Pointer& array, int size)
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->resize_fast(size);
+  this->assign(array);
+}
+
+template<class E, int N, class A>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+vector<E, small<N, A>>::vector(int size, const Pointer& array)
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->resize_fast(size);
+  this->assign(array);
+}
+
+template<class E, int N, class A> template<class Other>
+vector<E, small<N, A>>::vector(std::initializer_list<Other> l)
+: m_data(m_buffer), m_size(0), m_capacity(N)
+{
+  this->assign(l);
+}
+
+template<class E, int N, class A>
+vector<E, small<N, A>>::~vector()
+{
+  this->release();
+}
+
+
+
+/* Public methods: */
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::data() -> pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::data() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::begin() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::end() const -> const_pointer
+{
+  return this->m_data + this->m_size;
+}
+
+template<class E, int N, class A> bool
+vector<E, small<N, A>>::is_inline() const
+{
+  return this->m_data == this->m_buffer;
+}
+
+template<class E, int N, class A> int
+vector<E, small<N, A>>::capacity() const
+{
+  return this->m_capacity;
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::reserve(int n)
+{
+  cml_require(n >= 0, std::invalid_argument, "capacity < 0");
+  if(n > this->m_capacity) this->reallocate(n, this->m_size);
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::shrink_to_fit()
+{
+  /* Short-circuit inline storage: */
+  if(this->is_inline()) return;
+
+  if(this->m_size <= N) {
+    /* Move the elements back to the inline buffer: */
+    std::copy(this->m_data, this->m_data + this->m_size, this->m_buffer);
+    this->release();
+  }
+
+  else if(this->m_capacity > this->m_size)
+    this->reallocate(this->m_size, this->m_size);
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::resize(int n)
+{
+  cml_require(n >= 0, std::invalid_argument, "size < 0");
+
+  /* Reuse the current array if it is large enough: */
+  if(n > this->m_capacity)
+    this->reallocate(this->grown_capacity(n), this->m_size);
+  this->m_size = n;
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::resize_fast(int n)
+{
+  cml_require(n >= 0, std::invalid_argument, "size < 0");
+
+  /* Reuse the current array if it is large enough: */
+  if(n > this->m_capacity) this->reallocate(this->grown_capacity(n), 0);
+  this->m_size = n;
+}
+
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::operator=(const vector_type& other) -> vector_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the heap array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    this->release();
+    this->m_size = 0;
+  }
+  this->copy_assign_allocator(other);
+  return this->assign(other);
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::operator=(vector_type&& other) -> vector_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  /* Release the heap array before taking an unequal allocator: */
+  bool equal = this->stored_allocator() == other.stored_allocator();
+  if(propagate::value && !equal) {
+    this->release();
+    this->m_size = 0;
+    this->move_assign_allocator(other);
+    equal = true;
+  }
+
+  if(other.is_inline()) {
+    /* Copy inline elements; this cannot allocate, since other.m_size <= N
+     * <= this->m_capacity:
+     */
+    this->resize_fast(other.m_size);
+    std::copy(other.m_data, other.m_data + other.m_size, this->m_data);
+  } else if(!equal) {
+    /* The heap array of other cannot be released by this allocator: */
+    this->assign(other);
+  } else {
+    /* Take ownership of the heap array, leaving other empty: */
+    this->release();
+    this->m_data = other.m_data;
+    this->m_size = other.m_size;
+    this->m_capacity = other.m_capacity;
+    other.m_data = other.m_buffer;
+    other.m_capacity = N;
+  }
+  other.m_size = 0;
+  return *this;
+}
+
+
+
+/* Internal methods: */
+
+template<class E, int N, class A> int
+vector<E, small<N, A>>::grown_capacity(int n) const
+{
+  return std::max(n, 2*this->m_capacity);
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::reallocate(int n, int copy)
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef std::allocator_traits<allocator_type> alloc_traits;
+
+  /* Allocator to use: */
+  allocator_type allocator = this->stored_allocator();
+
+  /* Allocate the new array, and copy elements if necessary: */
+  pointer data = allocator.allocate(size_type(n));
+  try {
+    for(int i = 0; i < copy; ++ i)
+      alloc_traits::construct(allocator, data + i, this->m_data[i]);
+  } catch(...) {
+    allocator.deallocate(data, size_type(n));
+    throw;
+  }
+
+  /* Release the old array, and save the new one: */
+  this->release();
+  this->m_data = data;
+  this->m_capacity = n;
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::release()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  /* Short-circuit inline storage: */
+  if(this->is_inline()) return;
+
+  this->destruct(this->m_data, this->m_size,
+    typename std::is_trivially_destructible<E>::type());
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(this->m_capacity));
+  this->m_data = this->m_buffer;
+  this->m_capacity = N;
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::destruct(pointer, int, std::true_type)
+{
+  /* Nothing to do. */
+}
+
+template<class E, int N, class A> void
+vector<E, small<N, A>>::destruct(pointer data, int n, std::false_type)
+{
+  /* Short-circuit null: */
+  if(data == nullptr) return;
+
+  /* Destruct each element: */
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
+}
+
+
+/* readable_vector interface: */
+
+template<class E, int N, class A> int
+vector<E, small<N, A>>::i_size() const
+{
+  return this->m_size;
+}
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::i_get(int i) const -> immutable_value
+{
+  return this->m_data[i];
+}
+
+
+/* writable_vector interface: */
+
+template<class E, int N, class A> auto
+vector<E, small<N, A>>::i_get(int i) -> mutable_value
+{
+  return this->m_data[i];
+}
+
+template<class E, int N, class A> template<class Other> auto
+vector<E, small<N, A>>::i_put(int i, const Other& v) __CML_REF -> vector_type&
+{
+  this->m_data[i] = value_type(v);
+  return *this;
+}
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+template<class E, int N, class A> template<class Other> auto
+vector<E, small<N, A>>::i_put(int i, const Other& v) && -> vector_type&&
+{
+  this->m_data[i] = value_type(v);
+  return (vector_type&&) *this;
+}
+#endif
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
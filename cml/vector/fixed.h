@@ -10,6 +10,7 @@
 #define	cml_vector_fixed_h
 
 #include <cml/vector/fixed_compiled.h>
+#include <cml/vector/fixed_allocated.h>
 
 #endif
 
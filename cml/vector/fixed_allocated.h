@@ -0,0 +1,329 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#pragma once
+
+#ifndef	cml_vector_fixed_allocated_h
+#define	cml_vector_fixed_allocated_h
+
+#include <cml/common/mpl/enable_if_t.h>
+#include <cml/common/mpl/rebind.h>
+#include <cml/common/alignment.h>
+#include <cml/common/allocator.h>
+#include <cml/storage/allocated_selector.h>
+#include <cml/vector/writable_vector.h>
+#include <cml/vector/vector.h>
+
+namespace cml {
+
+template<class Element, int Size, class Allocator>
+struct vector_traits< vector<Element, allocated<Allocator, Size>> >
+{
+  /* Traits and types for the vector element: */
+  typedef scalar_traits<Element>			element_traits;
+  typedef typename element_traits::value_type		value_type;
+  typedef typename element_traits::pointer		pointer;
+  typedef typename element_traits::reference		reference;
+  typedef typename element_traits::const_pointer	const_pointer;
+  typedef typename element_traits::const_reference	const_reference;
+  typedef typename element_traits::mutable_value	mutable_value;
+  typedef typename element_traits::immutable_value	immutable_value;
+
+  /* The vector storage type: */
+  typedef rebind_t<
+    allocated<Allocator, Size>, vector_storage_tag>	storage_type;
+  typedef typename storage_type::size_tag		size_tag;
+  static_assert(std::is_same<size_tag, fixed_size_tag>::value,
+    "invalid size tag");
+
+  /* Array size (should be positive): */
+  static const int array_size = storage_type::array_size;
+  static_assert(array_size > 0, "invalid vector size");
+
+  /* Array alignment in bytes, from the allocator: */
+  static const int alignment
+    = storage_alignment_of<rebind_alloc_t<Allocator, Element>>::value;
+};
+
+/** Fixed-length vector with its elements on the heap.  Unlike
+ * vector<Element, compiled<Size>>, the vector itself is the size of a
+ * pointer (plus the allocator, if stateful), and moving it transfers the
+ * array instead of copying the elements.
+ *
+ * @note A moved-from vector has no array until it is next written through
+ * assignment, element access or data(); its elements must not be read
+ * before then.
+ */
+template<class Element, int Size, class Allocator>
+class vector<Element, allocated<Allocator, Size>>
+: public writable_vector< vector<Element, allocated<Allocator, Size>> >
+, private detail::allocator_base<rebind_alloc_t<Allocator, Element>>
+{
+  public:
+
+    /** The real allocator type. */
+    typedef rebind_alloc_t<Allocator, Element>		allocator_type;
+
+
+  protected:
+
+    /** Base class storing the allocator. */
+    typedef detail::allocator_base<allocator_type>	allocator_base_type;
+
+
+  public:
+
+    typedef vector<Element, allocated<Allocator, Size>>	vector_type;
+    typedef readable_vector<vector_type>		readable_type;
+    typedef writable_vector<vector_type>		writable_type;
+    typedef vector_traits<vector_type>			traits_type;
+    typedef typename traits_type::element_traits	element_traits;
+    typedef typename traits_type::value_type		value_type;
+    typedef typename traits_type::pointer		pointer;
+    typedef typename traits_type::reference		reference;
+    typedef typename traits_type::const_pointer		const_pointer;
+    typedef typename traits_type::const_reference	const_reference;
+    typedef typename traits_type::mutable_value		mutable_value;
+    typedef typename traits_type::immutable_value	immutable_value;
+    typedef typename traits_type::storage_type		storage_type;
+    typedef typename traits_type::size_tag		size_tag;
+
+
+  public:
+
+    /* Include methods from writable_type: */
+    using writable_type::operator[];
+#ifndef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
+    using writable_type::operator=;
+#endif
+
+
+  public:
+
+    /** Constant containing the array size. */
+    static const int array_size = traits_type::array_size;
+
+    /** The dimension (same as array_size). */
+    static const int dimension = array_size;
+
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
+
+  public:
+
+    /** Default constructor.
+     *
+     * @note The vector elements are uninitialized.
+     */
+    vector();
+
+    /** Construct using @c alloc.
+     *
+     * @note The vector elements are uninitialized.
+     */
+    explicit vector(const allocator_type& alloc);
+
+    /** Copy constructor.  The allocator is copied from @c other by
+     * select_on_container_copy_construction().
+     */
+    vector(const vector_type& other);
+
+    /** Copy @c other, using @c alloc. */
+    vector(const vector_type& other, const allocator_type& alloc);
+
+    /** Move constructor.  The allocator and array are taken from @c other,
+     * without copying the elements or allocating, and @c other is left
+     * without an array.
+     */
+    vector(vector_type&& other) noexcept;
+
+    /** Construct from a readable_vector.  If @c sub is a vector with a
+     * compatible allocator, its allocator is copied as by the copy
+     * constructor.
+     */
+    template<class Sub> vector(const readable_vector<Sub>& sub);
+
+    /** Construct from a readable_vector, using @c alloc. */
+    template<class Sub>
+      vector(const readable_vector<Sub>& sub, const allocator_type& alloc);
+
+    /** Construct from at least 1 value.
+     *
+     * @note This overload is enabled only if all of the arguments are
+     * convertible to value_type.
+     */
+    template<class E0, class... Elements,
+      enable_if_convertible_t<value_type, E0, Elements...>* = nullptr>
+	vector(const E0& e0, const Elements&... eN)
+	// XXX Should be in vector/fixed_allocated.tpp, but VC++12 has
+	// brain-dead out-of-line template argument matching...
+	: m_data(0)
+	{
+	  this->allocate_array();
+	  this->assign_elements(e0, eN...);
+	}
+
+    /** Construct from a readable_vector and at least one
+     * additional element.
+     *
+     * @note This overload is enabled only if the value_type of @c sub and
+     * all of the scalar arguments are convertible to value_type.
+     */
+    template<class Sub, class E0, class... Elements,
+      enable_if_convertible_t<
+	value_type, value_type_trait_of_t<Sub>, E0, Elements...>* = nullptr>
+	vector(
+	  const readable_vector<Sub>& sub, const E0& e0, const Elements&... eN
+	  )
+	// XXX Should be in vector/fixed_allocated.tpp, but VC++12 has
+	// brain-dead out-of-line template argument matching...
+	: m_data(0)
+	{
+	  this->allocate_array();
+	  this->assign(sub, e0, eN...);
+	}
+
+    /** Construct from an array type. */
+    template<class Array, enable_if_array_t<Array>* = nullptr>
+      vector(const Array& array);
+
+    /** Construct from a pointer to an array. */
+    template<class Pointer, enable_if_pointer_t<Pointer>* = nullptr>
+      vector(const Pointer& array);
+
+    /** Construct from std::initializer_list. */
+    template<class Other> vector(std::initializer_list<Other> l);
+
+    /** Destructor. */
+    ~vector();
+
+
+  public:
+
+    /** Return a copy of the allocator. */
+    allocator_type get_allocator() const;
+
+    /** Return access to the vector data as a raw pointer. */
+    pointer data();
+
+    /** Return const access to the vector data as a raw pointer. */
+    const_pointer data() const;
+
+    /** Read-only iterator. */
+    const_pointer begin() const;
+
+    /** Read-only iterator. */
+    const_pointer end() const;
+
+
+  public:
+
+    /** Copy assignment.  The allocator is copied if it propagates on
+     * copy assignment.
+     */
+    vector_type& operator=(const vector_type& other);
+
+    /** Move assignment.  The array of @c other is taken if the allocators
+     * are equal or the allocator propagates on move assignment, in which
+     * case @c other is left with the old array or none, and otherwise the
+     * elements are copied.  The move does not throw if the allocator
+     * propagates.
+     */
+    vector_type& operator=(vector_type&& other) noexcept(
+      std::allocator_traits<allocator_type>
+      ::propagate_on_container_move_assignment::value);
+
+#ifdef CML_HAS_MSVC_BRAIN_DEAD_ASSIGNMENT_OVERLOADS
+    template<class Other>
+      inline vector_type& operator=(const readable_vector<Other>& other) {
+	return this->assign(other);
+      }
+
+    template<class Array, enable_if_array_t<Array>* = nullptr>
+      inline vector_type& operator=(const Array& array) {
+	return this->assign(array);
+      }
+
+    template<class Other>
+      inline vector_type& operator=(std::initializer_list<Other> l) {
+	return this->assign(l);
+      }
+#endif
+
+
+  protected:
+
+    /** Allocate the array if the vector does not have one. */
+    void allocate_array();
+
+    /** Release the array, if any. */
+    void release_array();
+
+    /** No-op for trivially destructible elements
+     * (is_trivially_destructible).
+     */
+    void destruct(pointer, int, std::true_type);
+
+    /** Invoke non-trivial destructors for @c n elements starting at @c
+     * data.
+     */
+    void destruct(pointer data, int n, std::false_type);
+
+
+  protected:
+
+    /** @name readable_vector Interface */
+    /*@{*/
+
+    friend readable_type;
+
+    /** Return the length of the vector. */
+    int i_size() const;
+
+    /** Return vector const element @c i. */
+    immutable_value i_get(int i) const;
+
+    /*@}*/
+
+
+  protected:
+
+    /** @name writable_vector Interface */
+    /*@{*/
+
+    friend writable_type;
+
+    /** Return vector element @c i. */
+    mutable_value i_get(int i);
+
+    /** Set element @c i. */
+    template<class Other> vector_type& i_put(int i, const Other& v) __CML_REF;
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+    /** Set element @c i on a temporary. */
+    template<class Other> vector_type&& i_put(int i, const Other& v) &&;
+#endif
+
+    /*@}*/
+
+
+  protected:
+
+    /** Array of Size elements. */
+    pointer			m_data;
+};
+
+} // namespace cml
+
+#define __CML_VECTOR_FIXED_ALLOCATED_TPP
+#include <cml/vector/fixed_allocated.tpp>
+#undef __CML_VECTOR_FIXED_ALLOCATED_TPP
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
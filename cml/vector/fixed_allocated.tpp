@@ -0,0 +1,293 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#ifndef __CML_VECTOR_FIXED_ALLOCATED_TPP
+#error "vector/fixed_allocated.tpp not included correctly"
+#endif
+
+#include <memory>
+
+namespace cml {
+
+/* fixed allocated 'structors: */
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::vector()
+: m_data(0)
+{
+  this->allocate_array();
+}
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::vector(const allocator_type& alloc)
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+}
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::vector(const vector_type& other)
+: allocator_base_type(std::allocator_traits<allocator_type>
+    ::select_on_container_copy_construction(other.stored_allocator()))
+, m_data(0)
+{
+  this->allocate_array();
+  this->assign(other);
+}
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::vector(
+  const vector_type& other, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+  this->assign(other);
+}
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::vector(vector_type&& other) noexcept
+: allocator_base_type(other.stored_allocator()), m_data(other.m_data)
+{
+  /* other is given an array when it is next written: */
+  other.m_data = nullptr;
+}
+
+template<class E, int S, class A> template<class Sub>
+vector<E, allocated<A,S>>::vector(const readable_vector<Sub>& sub)
+: allocator_base_type(detail::inherit_allocator<allocator_type>(sub.actual()))
+, m_data(0)
+{
+  this->allocate_array();
+  this->assign(sub);
+}
+
+template<class E, int S, class A> template<class Sub>
+vector<E, allocated<A,S>>::vector(
+  const readable_vector<Sub>& sub, const allocator_type& alloc
+  )
+: allocator_base_type(alloc), m_data(0)
+{
+  this->allocate_array();
+  this->assign(sub);
+}
+
+template<class E, int S, class A>
+template<class Array, enable_if_array_t<Array>*>
+vector<E, allocated<A,S>>::vector(const Array& array)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(array);
+}
+
+template<class E, int S, class A>
+template<class Pointer, enable_if_pointer_t<Pointer>*>
+vector<E, allocated<A,S>>::vector(const Pointer& array)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(array);
+}
+
+template<class E, int S, class A> template<class Other>
+vector<E, allocated<A,S>>::vector(std::initializer_list<Other> l)
+: m_data(0)
+{
+  this->allocate_array();
+  this->assign(l);
+}
+
+template<class E, int S, class A>
+vector<E, allocated<A,S>>::~vector()
+{
+  this->release_array();
+}
+
+
+
+/* Public methods: */
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::get_allocator() const -> allocator_type
+{
+  return this->stored_allocator();
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::data() -> pointer
+{
+  this->allocate_array();
+  return this->m_data;
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::data() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::begin() const -> const_pointer
+{
+  return this->m_data;
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::end() const -> const_pointer
+{
+  return this->m_data + S;
+}
+
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::operator=(const vector_type& other)
+-> vector_type&
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_copy_assignment propagate;
+
+  /* Release the array before taking an unequal allocator that cannot
+   * deallocate it:
+   */
+  if(propagate::value && this->stored_allocator() != other.stored_allocator())
+  {
+    allocator_type allocator = other.stored_allocator();
+    pointer data = allocator.allocate(size_type(S));
+    this->release_array();
+    this->copy_assign_allocator(other);
+    this->m_data = data;
+  }
+  return this->assign(other);
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::operator=(vector_type&& other) noexcept(
+  std::allocator_traits<allocator_type>
+  ::propagate_on_container_move_assignment::value) -> vector_type&
+{
+  typedef typename std::allocator_traits<allocator_type>
+    ::propagate_on_container_move_assignment propagate;
+
+  /* Short-circuit self-assignment: */
+  if(&other == this) return *this;
+
+  if(this->stored_allocator() == other.stored_allocator()) {
+    /* Ensure deletion of the current array by other: */
+    std::swap(this->m_data, other.m_data);
+  }
+
+  else if(propagate::value) {
+    /* Release the current array before taking the allocator of other: */
+    this->release_array();
+    this->move_assign_allocator(other);
+    this->m_data = other.m_data;
+    other.m_data = nullptr;
+  }
+
+  else {
+    /* The array of other cannot be released by this allocator: */
+    this->assign(other);
+  }
+
+  return *this;
+}
+
+
+
+/* Internal methods: */
+
+template<class E, int S, class A> void
+vector<E, allocated<A,S>>::allocate_array()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  if(this->m_data == nullptr) {
+    allocator_type allocator = this->stored_allocator();
+    this->m_data = allocator.allocate(size_type(S));
+  }
+}
+
+template<class E, int S, class A> void
+vector<E, allocated<A,S>>::release_array()
+{
+  typedef typename std::allocator_traits<
+    allocator_type>::size_type size_type;
+
+  if(this->m_data == nullptr) return;
+  this->destruct(this->m_data, S,
+    typename std::is_trivially_destructible<E>::type());
+  allocator_type allocator = this->stored_allocator();
+  allocator.deallocate(this->m_data, size_type(S));
+  this->m_data = nullptr;
+}
+
+template<class E, int S, class A> void
+vector<E, allocated<A,S>>::destruct(pointer, int, std::true_type)
+{
+  /* Nothing to do. */
+}
+
+template<class E, int S, class A> void
+vector<E, allocated<A,S>>::destruct(pointer data, int n, std::false_type)
+{
+  /* Destruct each element: */
+  allocator_type allocator = this->stored_allocator();
+  for(pointer e = data; e < data + n; ++ e)
+    std::allocator_traits<allocator_type>::destroy(allocator, e);
+}
+
+
+/* readable_vector interface: */
+
+template<class E, int S, class A> int
+vector<E, allocated<A,S>>::i_size() const
+{
+  return S;
+}
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::i_get(int i) const -> immutable_value
+{
+  return this->m_data[i];
+}
+
+
+/* writable_vector interface: */
+
+template<class E, int S, class A> auto
+vector<E, allocated<A,S>>::i_get(int i) -> mutable_value
+{
+  this->allocate_array();
+  return this->m_data[i];
+}
+
+template<class E, int S, class A> template<class Other> auto
+vector<E, allocated<A,S>>::i_put(int i, const Other& v) __CML_REF
+-> vector_type&
+{
+  this->allocate_array();
+  this->m_data[i] = value_type(v);
+  return *this;
+}
+
+#ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
+template<class E, int S, class A> template<class Other> auto
+vector<E, allocated<A,S>>::i_put(int i, const Other& v) && -> vector_type&&
+{
+  this->allocate_array();
+  this->m_data[i] = value_type(v);
+  return (vector_type&&) *this;
+}
+#endif
+
+} // namespace cml
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -9,14 +9,15 @@
 #ifndef	cml_vector_fixed_compiled_h
 #define	cml_vector_fixed_compiled_h
 
+#include <cml/common/alignment.h>
 #include <cml/storage/compiled_selector.h>
 #include <cml/vector/writable_vector.h>
 #include <cml/vector/vector.h>
 
 namespace cml {
 
-template<class Element, int Size>
-struct vector_traits< vector<Element, fixed<Size>> >
+template<class Element, int Size, int Align>
+struct vector_traits< vector<Element, fixed<Size,-1,Align>> >
 {
   /* Traits and types for the vector element: */
   typedef scalar_traits<Element>			element_traits;
@@ -29,7 +30,8 @@ struct vector_traits< vector<Element, fixed<Size>> >
   typedef typename element_traits::immutable_value	immutable_value;
 
   /* The vector storage type: */
-  typedef rebind_t<compiled<Size>, vector_storage_tag>	storage_type;
+  typedef rebind_t<
+    compiled<Size,-1,Align>, vector_storage_tag>	storage_type;
   typedef typename storage_type::size_tag		size_tag;
   static_assert(std::is_same<size_tag, fixed_size_tag>::value,
     "invalid size tag");
@@ -37,16 +39,20 @@ struct vector_traits< vector<Element, fixed<Size>> >
   /* Array size (should be positive): */
   static const int array_size = storage_type::array_size;
   static_assert(array_size > 0, "invalid vector size");
+
+  /* Array alignment in bytes: */
+  static const int alignment
+    = storage_alignment<value_type, array_size, Align>::value;
 };
 
 /** Fixed-length vector. */
-template<class Element, int Size>
-class vector<Element, fixed<Size>>
-: public writable_vector< vector<Element, fixed<Size>> >
+template<class Element, int Size, int Align>
+class vector<Element, fixed<Size,-1,Align>>
+: public writable_vector< vector<Element, fixed<Size,-1,Align>> >
 {
   public:
 
-    typedef vector<Element, fixed<Size>>		vector_type;
+    typedef vector<Element, fixed<Size,-1,Align>>	vector_type;
     typedef readable_vector<vector_type>		readable_type;
     typedef writable_vector<vector_type>		writable_type;
     typedef vector_traits<vector_type>			traits_type;
@@ -79,6 +85,9 @@ class vector<Element, fixed<Size>>
     /** The dimension (same as array_size). */
     static const int dimension = array_size;
 
+    /** Constant containing the array alignment in bytes. */
+    static const int alignment = traits_type::alignment;
+
 
   public:
 
@@ -227,7 +236,7 @@ class vector<Element, fixed<Size>>
   protected:
 
     /** Fixed-length array. */
-    value_type			m_data[Size];
+    alignas(alignment) value_type	m_data[Size];
 };
 
 } // namespace cml
@@ -12,28 +12,28 @@ namespace cml {
 
 /* fixed 'structors: */
 
-template<class E, int S> template<class Sub>
-vector<E, fixed<S>>::vector(const readable_vector<Sub>& sub)
+template<class E, int S, int A> template<class Sub>
+vector<E, fixed<S,-1,A>>::vector(const readable_vector<Sub>& sub)
 {
   this->assign(sub);
 }
 
-template<class E, int S>
+template<class E, int S, int A>
 template<class Array, enable_if_array_t<Array>*>
-vector<E, fixed<S>>::vector(const Array& array)
+vector<E, fixed<S,-1,A>>::vector(const Array& array)
 {
   this->assign(array);
 }
 
-template<class E, int S>
+template<class E, int S, int A>
 template<class Pointer, enable_if_pointer_t<Pointer>*>
-vector<E, fixed<S>>::vector(const Pointer& array)
+vector<E, fixed<S,-1,A>>::vector(const Pointer& array)
 {
   this->assign(array);
 }
 
-template<class E, int S> template<class Other>
-vector<E, fixed<S>>::vector(std::initializer_list<Other> l)
+template<class E, int S, int A> template<class Other>
+vector<E, fixed<S,-1,A>>::vector(std::initializer_list<Other> l)
 {
   this->assign(l);
 }
@@ -42,39 +42,39 @@ vector<E, fixed<S>>::vector(std::initializer_list<Other> l)
 
 /* Public methods: */
 
-template<class E, int S> auto
-vector<E, fixed<S>>::data() -> pointer
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::data() -> pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::data() const -> const_pointer
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::data() const -> const_pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::begin() const -> const_pointer
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::begin() const -> const_pointer
 {
   return &this->m_data[0];
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::end() const -> const_pointer
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::end() const -> const_pointer
 {
   return (&this->m_data[0]) + S;
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::operator=(const vector_type& other)
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::operator=(const vector_type& other)
 -> vector_type&
 {
   return this->assign(other);
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::operator=(vector_type&& other)
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::operator=(vector_type&& other)
 -> vector_type&
 {
   for(int i = 0; i < S; ++ i) this->m_data[i] = std::move(other.m_data[i]);
@@ -87,14 +87,14 @@ vector<E, fixed<S>>::operator=(vector_type&& other)
 
 /* readable_vector interface: */
 
-template<class E, int S> int
-vector<E, fixed<S>>::i_size() const
+template<class E, int S, int A> int
+vector<E, fixed<S,-1,A>>::i_size() const
 {
   return S;
 }
 
-template<class E, int S> auto
-vector<E, fixed<S>>::i_get(int i) const -> immutable_value
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::i_get(int i) const -> immutable_value
 {
   return this->m_data[i];
 }
@@ -102,22 +102,22 @@ vector<E, fixed<S>>::i_get(int i) const -> immutable_value
 
 /* writable_vector interface: */
 
-template<class E, int S> auto
-vector<E, fixed<S>>::i_get(int i) -> mutable_value
+template<class E, int S, int A> auto
+vector<E, fixed<S,-1,A>>::i_get(int i) -> mutable_value
 {
   return this->m_data[i];
 }
 
-template<class E, int S> template<class Other> auto
-vector<E, fixed<S>>::i_put(int i, const Other& v) __CML_REF -> vector_type&
+template<class E, int S, int A> template<class Other> auto
+vector<E, fixed<S,-1,A>>::i_put(int i, const Other& v) __CML_REF -> vector_type&
 {
   this->m_data[i] = value_type(v);
   return *this;
 }
 
 #ifdef CML_HAS_RVALUE_REFERENCE_FROM_THIS
-template<class E, int S> template<class Other> auto
-vector<E, fixed<S>>::i_put(int i, const Other& v) && -> vector_type&&
+template<class E, int S, int A> template<class Other> auto
+vector<E, fixed<S,-1,A>>::i_put(int i, const Other& v) && -> vector_type&&
 {
   this->m_data[i] = value_type(v);
   return (vector_type&&) *this;
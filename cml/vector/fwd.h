@@ -14,6 +14,8 @@ namespace cml {
 template<class DerivedT> class readable_vector;
 template<class DerivedT> class writable_vector;
 
+namespace detail { struct alias_target; }
+
 } // namespace cml
 
 #endif
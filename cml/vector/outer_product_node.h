@@ -123,6 +123,17 @@ class outer_product_node
     outer_product_node(const node_type& other);
 #endif
 
+  public:
+
+    /** Return true if either vector subexpression is @c dest or shares
+     * its memory, or reads it out of order.  Each element of the vector is
+     * read by a whole row or column of the product.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_matrix Interface */
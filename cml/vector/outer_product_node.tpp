@@ -8,6 +8,8 @@
 #error "vector/outer_product_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* outer_product_node 'structors: */
@@ -34,6 +36,19 @@ outer_product_node<Sub1,Sub2>::outer_product_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub1, class Sub2> bool
+outer_product_node<Sub1,Sub2>::aliases(const detail::alias_target& dest) const
+{
+  return detail::is_alias(this->m_left, dest)
+    || detail::is_alias(this->m_right, dest)
+    || detail::aliases(this->m_left, dest)
+    || detail::aliases(this->m_right, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_matrix interface: */
@@ -81,6 +81,16 @@ class vector_scalar_node
 #endif
 
 
+  public:
+
+    /** Return true if the vector subexpression reads the object at @c dest out
+     * of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_vector Interface */
@@ -8,6 +8,8 @@
 #error "vector/scalar_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* vector_scalar_node 'structors: */
@@ -35,6 +37,18 @@ vector_scalar_node<Sub,Scalar,Op>::vector_scalar_node(const node_type& other)
 #endif
 
 
+/* Public methods: */
+
+template<class Sub, class Scalar, class Op> bool
+vector_scalar_node<Sub,Scalar,Op>::aliases(
+  const detail::alias_target& dest
+  ) const
+{
+  return detail::aliases(this->m_left, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
@@ -92,6 +92,17 @@ class subvector_node
 #endif
 
 
+  public:
+
+    /** Return true if the subexpression is @c dest or shares its memory,
+     * which may be resized or overwritten by assignment before all of its
+     * elements are read, or reads it out of order.
+     *
+     * @sa detail::aliases
+     */
+    bool aliases(const detail::alias_target& dest) const;
+
+
   protected:
 
     /** @name readable_vector Interface */
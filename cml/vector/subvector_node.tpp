@@ -8,6 +8,8 @@
 #error "vector/subvector_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* subvector_node 'structors: */
@@ -34,6 +36,17 @@ subvector_node<Sub>::subvector_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub> bool
+subvector_node<Sub>::aliases(const detail::alias_target& dest) const
+{
+  return detail::is_alias(this->m_sub, dest)
+    || detail::aliases(this->m_sub, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
@@ -8,6 +8,8 @@
 #error "vector/unary_node.tpp not included correctly"
 #endif
 
+#include <cml/vector/detail/aliasing.h>
+
 namespace cml {
 
 /* vector_unary_node 'structors: */
@@ -34,6 +36,16 @@ vector_unary_node<Sub,Op>::vector_unary_node(const node_type& other)
 
 
 
+/* Public methods: */
+
+template<class Sub, class Op> bool
+vector_unary_node<Sub,Op>::aliases(const detail::alias_target& dest) const
+{
+  return detail::aliases(this->m_sub, dest);
+}
+
+
+
 /* Internal methods: */
 
 /* readable_vector interface: */
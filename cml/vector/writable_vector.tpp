@@ -11,6 +11,7 @@
 #include <random>
 #include <cml/scalar/binary_ops.h>
 #include <cml/vector/detail/check_or_resize.h>
+#include <cml/vector/detail/aliasing.h>
 
 namespace cml {
 namespace detail {
@@ -274,6 +275,8 @@ template<class DT> template<class ODT> DT&
 writable_vector<DT>::operator+=(const readable_vector<ODT>& other) __CML_REF
 {
   typedef binary_plus_t<DT, ODT> op_type;
+  if(detail::aliases(other, detail::make_alias_target(this->actual())))
+    return this->operator+=(detail::alias_free(other, this->actual()));
   detail::check_or_resize(*this, other);
   for(int i = 0; i < this->size(); ++ i)
     this->put(i, op_type().apply(this->get(i), other.get(i)));
@@ -293,6 +296,8 @@ template<class DT> template<class ODT> DT&
 writable_vector<DT>::operator-=(const readable_vector<ODT>& other) __CML_REF
 {
   typedef binary_minus_t<DT, ODT> op_type;
+  if(detail::aliases(other, detail::make_alias_target(this->actual())))
+    return this->operator-=(detail::alias_free(other, this->actual()));
   detail::check_or_resize(*this, other);
   for(int i = 0; i < this->size(); ++ i)
     this->put(i, op_type().apply(this->get(i), other.get(i)));
@@ -363,6 +368,11 @@ writable_vector<DT>::operator/=(const ScalarT& v) &&
 template<class DT> template<class ODT> DT&
 writable_vector<DT>::assign(const readable_vector<ODT>& other)
 {
+  /* Evaluate expressions that read this vector out of order into a
+   * temporary first:
+   */
+  if(detail::aliases(other, detail::make_alias_target(this->actual())))
+    return this->assign(detail::alias_free(other, this->actual()));
   detail::check_or_resize(*this, other);
   for(int i = 0; i < this->size(); ++ i) this->put(i, other.get(i));
   return this->actual();
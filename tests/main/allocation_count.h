@@ -0,0 +1,39 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Replaces the global operator new to count allocations.  Since this
+ * defines the replacement functions, include it in only one source file
+ * of a test.
+ */
+
+#pragma once
+
+#ifndef Support_GTL_tests_main_allocation_count_h
+#define Support_GTL_tests_main_allocation_count_h
+
+#include <new>
+#include <cstdlib>
+
+/** Return the number of calls to the global operator new so far. */
+inline int& allocation_count()
+{
+  static int count = 0;
+  return count;
+}
+
+void* operator new(std::size_t n)
+{
+  ++ allocation_count();
+  if(void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -11,11 +11,30 @@
 
 #include <cml/vector.h>
 #include <cml/matrix.h>
+#include <cml/mathlib/matrix/rotation.h>
+#include <cml/mathlib/matrix/translation.h>
 
 /* Testing headers: */
 #include "catch_runner.h"
 
 
+namespace {
+
+/* Check that inverse_auto() gives the same result as inverse(): */
+template<class Matrix> void
+check_inverse_auto(const Matrix& M, double epsilon)
+{
+  auto expected = cml::inverse(M);
+  auto X = M;
+  cml::inverse_auto(X);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j)
+      CATCH_CHECK(X(i,j) == Approx(expected(i,j)).epsilon(0.).margin(epsilon));
+}
+
+} // namespace
+
+
 CATCH_TEST_CASE("invert 2D, invert_2D_1")
 {
   auto M = cml::matrix33d(
@@ -85,6 +104,75 @@ CATCH_TEST_CASE("invert 3D, invert_nD_1")
   CATCH_CHECK(M.basis_element(3,2) == -1.);
 }
 
+CATCH_TEST_CASE("invert auto, rigid_3D")
+{
+  cml::matrix44d M;
+  cml::matrix_rotation_world_z(M, .7);
+  cml::matrix_set_translation(M, 3., -2., 1.);
+  check_inverse_auto(M, 1e-14);
+
+  cml::matrix44d_r R;
+  cml::matrix_rotation_world_x(R, -1.2);
+  cml::matrix_set_translation(R, 3., -2., 1.);
+  check_inverse_auto(R, 1e-14);
+
+  cml::matrix44f F;
+  cml::matrix_rotation_world_y(F, .3f);
+  cml::matrix_set_translation(F, 3.f, -2.f, 1.f);
+  check_inverse_auto(F, 1e-5);
+}
+
+CATCH_TEST_CASE("invert auto, affine")
+{
+  auto M = cml::matrix44d(
+    2., 1., 0., 3.,
+    0., 3., 1., 2.,
+    1., 0., 4., 1.,
+    0., 0., 0., 1.
+    );
+  check_inverse_auto(M, 1e-14);
+
+  auto R = cml::matrix44d_r(
+    2., 0., 1., 0.,
+    1., 3., 0., 0.,
+    0., 1., 4., 0.,
+    3., 2., 1., 1.
+    );
+  check_inverse_auto(R, 1e-14);
+
+  auto M2 = cml::matrix33d(
+    2., 1., 3.,
+    1., 3., 2.,
+    0., 0., 1.
+    );
+  check_inverse_auto(M2, 1e-14);
+}
+
+CATCH_TEST_CASE("invert auto, general")
+{
+  auto M = cml::matrix44d(
+    1.,  2.,  3., 4.,
+    1.,  4.,  9., 16.,
+    1., 16., 25., 36.,
+    1., 36., 81., 100.
+    );
+  check_inverse_auto(M, 1e-14);
+
+  /* The last row is not (0,0,0,1): */
+  auto P = cml::matrix44d(
+    1., 0., 0., 0.,
+    0., 1., 0., 0.,
+    0., 0., 1., 0.,
+    0., 0., 2., 1.5
+    );
+  check_inverse_auto(P, 1e-14);
+
+  cml::matrixd D(2,2);
+  D(0,0) = 2.; D(0,1) = 1.;
+  D(1,0) = 1.; D(1,1) = 1.;
+  check_inverse_auto(D, 1e-14);
+}
+
 
 // -------------------------------------------------------------------------
 // vim:ft=cpp:sw=2
@@ -0,0 +1,138 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/batch_lu.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <cml/vector/fixed.h>
+#include <cml/matrix/fixed.h>
+#include <cml/matrix/lu.h>
+#include <cml/matrix/vector_product.h>
+#include <cml/vector/binary_ops.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill A and b with count random systems: */
+template<class Matrix, class Vector> void
+random_systems(std::vector<Matrix>& A, std::vector<Vector>& b, int count)
+{
+  std::mt19937 rng(count);
+  A.resize(count);
+  b.resize(count);
+  for(int s = 0; s < count; ++ s) {
+    for(int i = 0; i < A[s].rows(); ++ i) {
+      for(int j = 0; j < A[s].cols(); ++ j)
+	A[s](i,j) = typename Matrix::value_type(rng()/4294967296. - .5);
+      b[s][i] = typename Vector::value_type(rng()/4294967296. - .5);
+    }
+  }
+}
+
+/* Compare the batched solution to lu_pivot() and lu_solve(): */
+template<class Matrix, class Vector> void
+check_batch(int count, double epsilon)
+{
+  std::vector<Matrix> A;
+  std::vector<Vector> b;
+  random_systems(A, b, count);
+
+  std::vector<Vector> x(count);
+  std::unique_ptr<bool[]> singular(new bool[count]);
+  int bad = cml::batch_lu_solve(A.data(), b.data(), x.data(), count,
+    singular.get());
+  CATCH_REQUIRE(bad == 0);
+
+  for(int s = 0; s < count; ++ s) {
+    CATCH_CHECK(!singular[s]);
+    auto lup = cml::lu_pivot(A[s]);
+    Vector y;
+    cml::lu_solve(lup, y, b[s]);
+    for(int i = 0; i < y.size(); ++ i)
+      CATCH_CHECK(x[s][i] == Approx(y[i]).epsilon(epsilon).margin(epsilon));
+  }
+}
+
+} // namespace
+
+CATCH_TEST_CASE("fixed, batch_lu_solve1")
+{
+  /* Not a multiple of the number of lanes: */
+  check_batch<cml::matrix<double, cml::fixed<6,6>>,
+    cml::vector<double, cml::fixed<6>>>(61, 1e-10);
+}
+
+CATCH_TEST_CASE("fixed, batch_lu_solve2")
+{
+  check_batch<cml::matrix<double, cml::fixed<12,12>>,
+    cml::vector<double, cml::fixed<12>>>(35, 1e-9);
+}
+
+CATCH_TEST_CASE("fixed, batch_lu_solve3")
+{
+  check_batch<cml::matrix<float, cml::fixed<4,4>>,
+    cml::vector<float, cml::fixed<4>>>(3, 1e-3);
+}
+
+CATCH_TEST_CASE("fixed, batch_lu_solve_inplace1")
+{
+  typedef cml::matrix<double, cml::fixed<5,5>>		matrix_type;
+  typedef cml::vector<double, cml::fixed<5>>		vector_type;
+
+  std::vector<matrix_type> A;
+  std::vector<vector_type> b;
+  random_systems(A, b, 20);
+
+  std::vector<vector_type> x = b;
+  CATCH_REQUIRE(cml::batch_lu_solve(A.data(), x.data(), x.data(), 20) == 0);
+  for(int s = 0; s < 20; ++ s) {
+    vector_type r = A[s]*x[s] - b[s];
+    for(int i = 0; i < 5; ++ i) CATCH_CHECK(r[i] == Approx(0.).margin(1e-10));
+  }
+}
+
+CATCH_TEST_CASE("fixed, batch_lu_solve_singular1")
+{
+  typedef cml::matrix<double, cml::fixed<3,3>>		matrix_type;
+  typedef cml::vector<double, cml::fixed<3>>		vector_type;
+
+  std::vector<matrix_type> A;
+  std::vector<vector_type> b;
+  random_systems(A, b, 10);
+
+  /* Make systems 2 and 9 singular: */
+  for(int j = 0; j < 3; ++ j) A[2](2,j) = A[2](0,j) + A[2](1,j);
+  A[9].zero();
+
+  std::vector<vector_type> x(10);
+  vector_type sentinel(7., 7., 7.);
+  for(auto& v : x) v = sentinel;
+
+  bool singular[10];
+  int bad = cml::batch_lu_solve(A.data(), b.data(), x.data(), 10, singular);
+  CATCH_CHECK(bad == 2);
+  for(int s = 0; s < 10; ++ s) {
+    bool expected = (s == 2 || s == 9);
+    CATCH_CHECK(singular[s] == expected);
+    if(expected) {
+      for(int i = 0; i < 3; ++ i) CATCH_CHECK(x[s][i] == 7.);
+    } else {
+      vector_type r = A[s]*x[s] - b[s];
+      for(int i = 0; i < 3; ++ i)
+	CATCH_CHECK(r[i] == Approx(0.).margin(1e-10));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
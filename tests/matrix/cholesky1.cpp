@@ -0,0 +1,249 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/cholesky.h>
+
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill A with a random symmetric positive-definite matrix, computed as
+ * B*B^T + N*I:
+ */
+template<class Matrix> void
+random_spd(Matrix& A, int seed)
+{
+  int N = A.rows();
+  std::mt19937 rng(seed);
+  cml::matrixd B(N,N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) B(i,j) = rng()/4294967296. - .5;
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) {
+      double s = (i == j) ? double(N) : 0.;
+      for(int k = 0; k < N; ++ k) s += B(i,k)*B(j,k);
+      A(i,j) = s;
+    }
+}
+
+/* Check that L L^T reproduces A: */
+template<class Matrix> void
+check_llt(const Matrix& A, const Matrix& L, double epsilon)
+{
+  int N = A.rows();
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) {
+      if(j > i) CATCH_CHECK(L(i,j) == 0.);
+      double s = 0.;
+      for(int k = 0; k < N; ++ k) s += L(i,k)*L(j,k);
+      CATCH_CHECK(s == Approx(A(i,j)).epsilon(epsilon));
+    }
+}
+
+/* Check that L D L^T reproduces A: */
+template<class Matrix> void
+check_ldlt(const Matrix& A, const Matrix& LD, double epsilon)
+{
+  int N = A.rows();
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) {
+      if(j > i) CATCH_CHECK(LD(i,j) == 0.);
+      double s = 0.;
+      for(int k = 0; k <= std::min(i,j); ++ k) {
+	double lik = (k == i) ? 1. : LD(i,k), ljk = (k == j) ? 1. : LD(j,k);
+	s += lik*LD(k,k)*ljk;
+      }
+      CATCH_CHECK(s == Approx(A(i,j)).epsilon(epsilon));
+    }
+}
+
+} // namespace
+
+CATCH_TEST_CASE("fixed, cholesky1")
+{
+  auto A = cml::matrix33d(
+    4., 12., -16.,
+    12., 37., -43.,
+    -16., -43., 98.
+    );
+  auto chol = cml::cholesky(A);
+  CATCH_REQUIRE(chol.positive_definite);
+
+  auto expected = cml::matrix33d(
+    2., 0., 0.,
+    6., 1., 0.,
+    -8., 5., 3.
+    );
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j)
+      CATCH_CHECK(chol.llt(i,j) == Approx(expected(i,j)).epsilon(1e-12));
+
+  auto fact = cml::ldlt(A);
+  CATCH_REQUIRE(fact.positive_definite);
+  auto expected_ld = cml::matrix33d(
+    4., 0., 0.,
+    3., 1., 0.,
+    -4., 5., 9.
+    );
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j)
+      CATCH_CHECK(fact.ldlt(i,j) == Approx(expected_ld(i,j)).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, cholesky2")
+{
+  cml::matrix<double, cml::fixed<10,10>> A;
+  random_spd(A, 10);
+
+  /* The upper triangle is not read: */
+  auto M = A;
+  for(int i = 0; i < 10; ++ i)
+    for(int j = i+1; j < 10; ++ j) M(i,j) = 1e9;
+
+  auto chol = cml::cholesky(M);
+  CATCH_REQUIRE(chol.positive_definite);
+  check_llt(A, chol.llt, 1e-12);
+
+  auto fact = cml::ldlt(M);
+  CATCH_REQUIRE(fact.positive_definite);
+  check_ldlt(A, fact.ldlt, 1e-12);
+
+  cml::vector<double, cml::fixed<10>> b;
+  for(int i = 0; i < 10; ++ i) b[i] = double(i) - 4.5;
+  auto x = cml::cholesky_solve(chol, b);
+  auto y = cml::ldlt_solve(fact, b);
+  for(int i = 0; i < 10; ++ i) {
+    double r = - b[i], s = - b[i];
+    for(int j = 0; j < 10; ++ j) {
+      r += A(i,j)*x[j];
+      s += A(i,j)*y[j];
+    }
+    CATCH_CHECK(r == Approx(0.).margin(1e-12));
+    CATCH_CHECK(s == Approx(0.).margin(1e-12));
+  }
+}
+
+CATCH_TEST_CASE("fixed, cholesky_not_positive_definite1")
+{
+  auto A = cml::matrix33d(
+    1., 2., 0.,
+    2., 1., 0.,
+    0., 0., 1.
+    );
+  auto chol = cml::cholesky(A);
+  CATCH_CHECK(!chol.positive_definite);
+  auto fact = cml::ldlt(A);
+  CATCH_CHECK(!fact.positive_definite);
+
+  auto b = cml::vector3d(1., 2., 3.);
+  CATCH_CHECK_THROWS_AS(cml::cholesky_solve(chol, b), std::invalid_argument);
+  CATCH_CHECK_THROWS_AS(cml::ldlt_solve(fact, b), std::invalid_argument);
+}
+
+CATCH_TEST_CASE("fixed, cholesky_inplace1")
+{
+  cml::matrix<double, cml::fixed<14,14>> A;
+  random_spd(A, 14);
+
+  /* Larger than the unrolled sizes: */
+  cml::cholesky_result<decltype(A)> chol(A);
+  cml::cholesky(chol);
+  CATCH_REQUIRE(chol.positive_definite);
+  check_llt(A, chol.llt, 1e-12);
+
+  cml::ldlt_result<decltype(A)> fact(A);
+  cml::ldlt(fact);
+  CATCH_REQUIRE(fact.positive_definite);
+  check_ldlt(A, fact.ldlt, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, cholesky1")
+{
+  /* Large enough for several panels: */
+  const int N = 150;
+  cml::matrixd A(N,N);
+  random_spd(A, N);
+
+  auto chol = cml::cholesky(A);
+  CATCH_REQUIRE(chol.positive_definite);
+  check_llt(A, chol.llt, 1e-10);
+
+  auto fact = cml::ldlt(A);
+  CATCH_REQUIRE(fact.positive_definite);
+  check_ldlt(A, fact.ldlt, 1e-10);
+}
+
+CATCH_TEST_CASE("dynamic, cholesky2")
+{
+  const int N = 100;
+  cml::matrixd_c A(N,N);
+  random_spd(A, N);
+
+  auto chol = cml::cholesky(A);
+  CATCH_REQUIRE(chol.positive_definite);
+  check_llt(A, chol.llt, 1e-10);
+
+  auto fact = cml::ldlt(A);
+  CATCH_REQUIRE(fact.positive_definite);
+  check_ldlt(A, fact.ldlt, 1e-10);
+}
+
+CATCH_TEST_CASE("dynamic, cholesky_not_positive_definite1")
+{
+  const int N = 80;
+  cml::matrixd A(N,N);
+  random_spd(A, N);
+
+  /* Make the trailing 2x2 block indefinite: */
+  A(N-2,N-1) = A(N-1,N-2) = 2.*std::max(A(N-2,N-2), A(N-1,N-1));
+  CATCH_CHECK(!cml::cholesky(A).positive_definite);
+  CATCH_CHECK(!cml::ldlt(A).positive_definite);
+}
+
+CATCH_TEST_CASE("dynamic, cholesky_solve_matrix1")
+{
+  const int N = 90, M = 7;
+  cml::matrixd A(N,N), B(N,M);
+  random_spd(A, N);
+  std::mt19937 rng(M);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < M; ++ j) B(i,j) = rng()/4294967296. - .5;
+
+  auto chol = cml::cholesky(A);
+  auto fact = cml::ldlt(A);
+  CATCH_REQUIRE(chol.positive_definite);
+  CATCH_REQUIRE(fact.positive_definite);
+
+  auto X = cml::cholesky_solve(chol, B);
+  cml::matrixd Y = B;
+  cml::ldlt_solve(fact, Y, Y);
+  for(int j = 0; j < M; ++ j) {
+    cml::vectord b(N);
+    for(int i = 0; i < N; ++ i) b[i] = B(i,j);
+    auto x = cml::cholesky_solve(chol, b);
+    for(int i = 0; i < N; ++ i) {
+      double r = - B(i,j), s = - B(i,j);
+      for(int k = 0; k < N; ++ k) {
+	r += A(i,k)*X(k,j);
+	s += A(i,k)*Y(k,j);
+      }
+      CATCH_CHECK(r == Approx(0.).margin(1e-12));
+      CATCH_CHECK(s == Approx(0.).margin(1e-12));
+      CATCH_CHECK(X(i,j) == Approx(x[i]).epsilon(1e-12));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
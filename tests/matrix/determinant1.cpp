@@ -5,6 +5,9 @@
  */
 
 #include <iostream>
+#include <cmath>
+#include <random>
+#include <limits>
 
 // Make sure the main header compiles cleanly:
 #include <cml/matrix/determinant.h>
@@ -13,11 +16,51 @@
 #include <cml/matrix/dynamic.h>
 #include <cml/matrix/external.h>
 #include <cml/matrix/types.h>
+#include <cml/matrix/inverse.h>
 
 /* Testing headers: */
 #include "catch_runner.h"
 
 
+namespace {
+
+/* Return the infinity norm of M: */
+template<class Matrix> double
+infinity_norm(const Matrix& M)
+{
+  double n = 0.;
+  for(int i = 0; i < M.rows(); ++ i) {
+    double s = 0.;
+    for(int j = 0; j < M.cols(); ++ j) s += std::fabs(M(i,j));
+    n = std::max(n, s);
+  }
+  return n;
+}
+
+/* Check that the determinants of random N x N matrices agree with the
+ * dynamic-size LU determinant, relative to the condition number:
+ */
+template<int N> void
+check_det_random(int seeds)
+{
+  const double eps = std::numeric_limits<double>::epsilon();
+  for(int seed = 0; seed < seeds; ++ seed) {
+    std::mt19937 rng(seed);
+    cml::matrix<double, cml::fixed<N,N>> M;
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j) M(i,j) = rng()/4294967296. - .5;
+
+    cml::matrixd L(M);
+    double D = cml::determinant(L);
+    double kappa = infinity_norm(M)*infinity_norm(cml::inverse(L));
+    CATCH_CHECK(std::fabs(cml::determinant(M) - D)
+      <= 4.*kappa*eps*std::fabs(D));
+  }
+}
+
+} // namespace
+
+
 CATCH_TEST_CASE("fixed, det_2x2")
 {
   auto M = cml::matrix22d(
@@ -67,6 +110,54 @@ CATCH_TEST_CASE("fixed, det_5x5")
 
 
 
+CATCH_TEST_CASE("fixed, det_block")
+{
+  /* Sizes 5 through 8 use the Schur complement of the leading block: */
+  cml::matrix<double, cml::fixed<8,8>> M;
+  for(int i = 0; i < 8; ++ i)
+    for(int j = 0; j < 8; ++ j) M(i,j) = 1./(i + j + 1.) + (i == j ? 1. : 0.);
+  auto D = cml::detail::determinant(M, cml::int_c<8>(), std::false_type());
+  CATCH_CHECK(cml::determinant(M) == Approx(D).epsilon(1e-12));
+
+  cml::matrix<double, cml::fixed<7,7>> M7;
+  for(int i = 0; i < 7; ++ i)
+    for(int j = 0; j < 7; ++ j)
+      M7(i,j) = std::sin(i + 2.*j) + (i == j ? 2. : 0.);
+  D = cml::detail::determinant(M7, cml::int_c<7>(), std::false_type());
+  CATCH_CHECK(cml::determinant(M7) == Approx(D).epsilon(1e-10));
+
+  /* The leading 3x3 block is singular: */
+  cml::matrix<double, cml::fixed<6,6>> P;
+  P.zero();
+  for(int i = 0; i < 3; ++ i) {
+    P(i,i+3) = double(i+1);
+    P(i+3,i) = 1.;
+  }
+  CATCH_CHECK(cml::determinant(P) == Approx(-6.).epsilon(1e-12));
+
+  /* The leading 3x3 block is well conditioned, but tiny: */
+  cml::matrix<double, cml::fixed<6,6>> T;
+  T.zero();
+  for(int i = 0; i < 3; ++ i) {
+    T(i,i) = 1e-13*(1. + .1*i);
+    T(i,i+3) = T(i+3,i) = 1.;
+    T(i+3,i+3) = 2. + i;
+  }
+  T(3,4) = .5;
+  T(1,5) = .25;
+  D = cml::detail::determinant(T, cml::int_c<6>(), std::false_type());
+  CATCH_CHECK(cml::determinant(T) == Approx(D).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, det_block_random")
+{
+  /* The Schur determinant is used only when its error is small: */
+  check_det_random<5>(2000);
+  check_det_random<6>(2000);
+  check_det_random<7>(2000);
+  check_det_random<8>(2000);
+}
+
 CATCH_TEST_CASE("fixed external, det_2x2")
 {
   double avM[] = {
@@ -223,6 +314,55 @@ CATCH_TEST_CASE("dynamic, det_5x5")
   CATCH_CHECK(result == Approx(464).epsilon(1e-12));
 }
 
+CATCH_TEST_CASE("fixed, log_abs_determinant1")
+{
+  auto M = cml::matrix<double, cml::fixed<5,5>>(
+     2.,  0.,  2.,  .5,   2.,
+     3.,  3.,  4.,  -2., -1.,
+     5.,  5.,  4.,   2.,  1.,
+    -1., -2.,  3.,  -1.,  5.,
+     1.,  6.,  7.,  .5,   1.
+    );
+  int sign = 0;
+  double L = cml::log_abs_determinant(M, sign);
+  CATCH_CHECK(sign == 1);
+  CATCH_CHECK(L == Approx(std::log(464.)).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, log_abs_determinant1")
+{
+  auto M = cml::matrixd(3,3,
+     2.,  0.,  2.,
+     3.,  3.,  4.,
+     5.,  5.,  4.
+    );
+  int sign = 0;
+  double L = cml::log_abs_determinant(M, sign);
+  CATCH_CHECK(sign == -1);
+  CATCH_CHECK(L == Approx(std::log(16.)).epsilon(1e-12));
+
+  cml::matrixd Z(3,3);
+  Z.zero();
+  L = cml::log_abs_determinant(Z, sign);
+  CATCH_CHECK(sign == 0);
+  CATCH_CHECK(std::isinf(L));
+}
+
+CATCH_TEST_CASE("fixed, log_abs_determinant_last_pivot")
+{
+  /* Only the last pivot of U is 0: */
+  auto M = cml::matrix33d(
+    1., 2., 3.,
+    4., 5., 6.,
+    0., 0., 0.
+    );
+  int sign = 1;
+  double L = cml::log_abs_determinant(M, sign);
+  CATCH_CHECK(sign == 0);
+  CATCH_CHECK(std::isinf(L));
+  CATCH_CHECK(L < 0.);
+}
+
 
 // -------------------------------------------------------------------------
 // vim:ft=cpp:sw=2
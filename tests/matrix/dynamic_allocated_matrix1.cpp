@@ -52,6 +52,67 @@ CATCH_TEST_CASE("resize2")
   CATCH_REQUIRE(M.cols() == 4);
 }
 
+CATCH_TEST_CASE("resize3")
+{
+  /* Elements keep their (i,j) positions as either dimension changes: */
+  cml::matrixd M(2,3);
+  cml::matrixd_c N(2,3);
+  for(int i = 0; i < 2; ++ i)
+    for(int j = 0; j < 3; ++ j) M(i,j) = N(i,j) = 10.*i + j;
+
+  M.resize(4,5);
+  N.resize(4,5);
+  M.resize(3,2);
+  N.resize(3,2);
+  for(int i = 0; i < 2; ++ i) {
+    for(int j = 0; j < 2; ++ j) {
+      CATCH_CHECK(M(i,j) == 10.*i + j);
+      CATCH_CHECK(N(i,j) == 10.*i + j);
+    }
+  }
+}
+
+CATCH_TEST_CASE("resize4")
+{
+  /* Resizing without an array, or to and from empty, keeps no elements: */
+  cml::matrixd M;
+  M.resize(0,3);
+  M.resize(0,5);
+  CATCH_REQUIRE(M.rows() == 0);
+  CATCH_REQUIRE(M.cols() == 5);
+  M.resize(2,2);
+  M(1,1) = 1.;
+  M.resize(2,0);
+  M.resize(1,0);
+  CATCH_REQUIRE(M.rows() == 1);
+  CATCH_REQUIRE(M.cols() == 0);
+}
+
+CATCH_TEST_CASE("reserve1")
+{
+  cml::matrixd M(2,2);
+  M.identity();
+  M.reserve(8,8);
+  CATCH_REQUIRE(M.rows() == 2);
+  CATCH_REQUIRE(M.capacity() == 64);
+  CATCH_CHECK(M(1,1) == 1.);
+
+  /* Growing one row at a time stays within the reserved array: */
+  const double* p = M.data();
+  for(int k = 3; k <= 8; ++ k) M.resize(k,k);
+  CATCH_CHECK(M.data() == p);
+  CATCH_CHECK(M(0,0) == 1.);
+  CATCH_CHECK(M(1,1) == 1.);
+  CATCH_CHECK(M(0,1) == 0.);
+
+  M.resize(3,3);
+  M.shrink_to_fit();
+  CATCH_CHECK(M.capacity() == 9);
+  CATCH_CHECK(M(1,1) == 1.);
+
+  CATCH_CHECK_THROWS_AS(M.reserve(-1,2), std::invalid_argument);
+}
+
 CATCH_TEST_CASE("array_construct1")
 {
   double aM[] = {
@@ -0,0 +1,157 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#include <utility>
+
+#include <cml/matrix/dynamic_small.h>
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+namespace {
+
+typedef cml::matrix<double, cml::small<16>>		matrixd_s16;
+typedef cml::matrix<double, cml::small<16>,
+	cml::col_basis, cml::col_major>			matrixd_s16_c;
+typedef cml::vector<double, cml::small<16>>		vectord_s16;
+
+} // namespace
+
+CATCH_TEST_CASE("typecheck")
+{
+  CATCH_CHECK((std::is_same<matrixd_s16::basis_tag,cml::col_basis>::value));
+  CATCH_CHECK((std::is_same<matrixd_s16::layout_tag,cml::row_major>::value));
+  CATCH_CHECK((std::is_same<matrixd_s16_c::layout_tag,cml::col_major>::value));
+}
+
+CATCH_TEST_CASE("alloc1")
+{
+  matrixd_s16 M(3,4);
+  CATCH_REQUIRE(M.rows() == 3);
+  CATCH_REQUIRE(M.cols() == 4);
+  CATCH_CHECK(M.is_inline());
+
+  matrixd_s16_c N(5,4);
+  CATCH_REQUIRE(N.rows() == 5);
+  CATCH_CHECK(!N.is_inline());
+}
+
+CATCH_TEST_CASE("resize1")
+{
+  matrixd_s16 M(2,2);
+  M = { 1., 2., 3., 4. };
+  M.resize(4,4);
+  CATCH_REQUIRE(M.rows() == 4);
+  CATCH_CHECK(M.is_inline());
+  CATCH_CHECK(M.data()[3] == 4.);
+
+  /* Growing past the buffer spills to the heap, keeping the elements: */
+  M.resize(5,5);
+  CATCH_REQUIRE(M.rows() == 5);
+  CATCH_CHECK(!M.is_inline());
+  CATCH_CHECK(M.data()[3] == 4.);
+
+  CATCH_CHECK_THROWS_AS(M.resize(-1,2), std::invalid_argument);
+}
+
+CATCH_TEST_CASE("resize2")
+{
+  /* Elements keep their (i,j) positions as either dimension changes: */
+  matrixd_s16 M(2,3);
+  matrixd_s16_c N(2,3);
+  for(int i = 0; i < 2; ++ i)
+    for(int j = 0; j < 3; ++ j) M(i,j) = N(i,j) = 10.*i + j;
+
+  M.resize(3,5);
+  N.resize(3,5);
+  M.resize(5,5);
+  N.resize(5,5);
+  for(int i = 0; i < 2; ++ i) {
+    for(int j = 0; j < 3; ++ j) {
+      CATCH_CHECK(M(i,j) == 10.*i + j);
+      CATCH_CHECK(N(i,j) == 10.*i + j);
+    }
+  }
+
+  /* Shrinking returns to the inline buffer when the elements fit: */
+  M.resize(2,2);
+  M.shrink_to_fit();
+  CATCH_CHECK(M.is_inline());
+  CATCH_CHECK(M(1,1) == 11.);
+}
+
+CATCH_TEST_CASE("element_construct1")
+{
+  matrixd_s16 M(2, 3,
+    1., 2., 3.,
+    4., 5., 6.
+    );
+  CATCH_REQUIRE(M.rows() == 2);
+  CATCH_REQUIRE(M.cols() == 3);
+  CATCH_CHECK(M(0,2) == 3.);
+  CATCH_CHECK(M(1,0) == 4.);
+}
+
+CATCH_TEST_CASE("move1")
+{
+  matrixd_s16 M(5,5);
+  M.identity();
+  const double* p = M.data();
+  matrixd_s16 N(std::move(M));
+  CATCH_CHECK(N.data() == p);
+  CATCH_CHECK(N(4,4) == 1.);
+  CATCH_CHECK(M.rows() == 0);
+  CATCH_CHECK(M.is_inline());
+
+  matrixd_s16 P(2,2);
+  P.identity();
+  N = std::move(P);
+  CATCH_REQUIRE(N.rows() == 2);
+  CATCH_CHECK(N(1,1) == 1.);
+  CATCH_CHECK(N(0,1) == 0.);
+}
+
+CATCH_TEST_CASE("temporary1")
+{
+  matrixd_s16 A(3,3);
+  A.identity();
+  cml::matrixd B(3,3);
+  B.identity();
+  vectord_s16 x = { 1., 2., 3. };
+
+  /* Temporaries mixing small<> and allocated<> matrices are small<>: */
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(A + B)>, matrixd_s16>::value));
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(A*x)>, vectord_s16>::value));
+
+  matrixd_s16 C = 2.*A + B;
+  CATCH_CHECK(C.is_inline());
+  CATCH_CHECK(C(1,1) == 3.);
+
+  matrixd_s16 D = C*A;
+  CATCH_CHECK(D(2,2) == 3.);
+
+  vectord_s16 y = C*x;
+  CATCH_CHECK(y.is_inline());
+  CATCH_CHECK(y[2] == 9.);
+}
+
+CATCH_TEST_CASE("size_check1")
+{
+  matrixd_s16 M(3,4);
+  CATCH_REQUIRE_THROWS_AS(
+    (M = {
+     1.,  2.,  3.,  4.,
+     5.,  6.,  7.,  8.,
+     9.
+     }), cml::incompatible_matrix_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
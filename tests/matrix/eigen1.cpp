@@ -0,0 +1,235 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/eigen.h>
+
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill the symmetric matrix A with uniform random elements: */
+template<class Matrix> void
+random_symmetric(Matrix& A, int seed)
+{
+  std::mt19937 rng(seed);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j <= i; ++ j) A(i,j) = A(j,i) = rng()/4294967296. - .5;
+}
+
+/* Check that the columns of V are orthonormal eigenvectors of A for the
+ * increasing eigenvalues w, and that the values-only solution matches w:
+ */
+template<class Matrix> void
+check_eigen(const Matrix& A, double epsilon)
+{
+  typedef cml::value_type_trait_of_t<Matrix>		value_type;
+  int N = A.rows();
+
+  cml::vector<value_type, cml::dynamic<>> w, u;
+  cml::matrix<value_type, cml::dynamic<>> V;
+  cml::eigen_symmetric(A, w, V);
+  CATCH_REQUIRE(w.size() == N);
+  CATCH_REQUIRE(V.rows() == N);
+  CATCH_REQUIRE(V.cols() == N);
+
+  for(int j = 0; j < N; ++ j) {
+    if(j > 0) CATCH_CHECK(w[j-1] <= w[j]);
+    for(int i = 0; i < N; ++ i) {
+      double s = 0.;
+      for(int k = 0; k < N; ++ k) s += A(i,k)*V(k,j);
+      CATCH_CHECK(s == Approx(w[j]*V(i,j)).margin(epsilon));
+    }
+    for(int k = 0; k < N; ++ k) {
+      double s = 0.;
+      for(int i = 0; i < N; ++ i) s += V(i,j)*V(i,k);
+      CATCH_CHECK(s == Approx(j == k ? 1. : 0.).margin(epsilon));
+    }
+  }
+
+  cml::eigen_symmetric(A, u);
+  CATCH_REQUIRE(u.size() == N);
+  for(int j = 0; j < N; ++ j)
+    CATCH_CHECK(u[j] == Approx(w[j]).margin(epsilon));
+}
+
+} // namespace
+
+CATCH_TEST_CASE("fixed, eigen_symmetric1")
+{
+  auto A = cml::matrix33d(
+    2., 1., 0.,
+    1., 2., 0.,
+    0., 0., 5.
+    );
+  cml::vector3d w;
+  cml::matrix33d V;
+  cml::eigen_symmetric(A, w, V);
+  CATCH_CHECK(w[0] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(w[1] == Approx(3.).epsilon(1e-12));
+  CATCH_CHECK(w[2] == Approx(5.).epsilon(1e-12));
+
+  /* Eigenvectors are unique up to their signs: */
+  CATCH_CHECK(std::fabs(V(0,0)) == Approx(std::sqrt(.5)).epsilon(1e-12));
+  CATCH_CHECK(V(0,0) == Approx(- V(1,0)).epsilon(1e-12));
+  CATCH_CHECK(V(0,1) == Approx(V(1,1)).epsilon(1e-12));
+  CATCH_CHECK(std::fabs(V(2,2)) == Approx(1.).epsilon(1e-12));
+
+  cml::vector3d u;
+  cml::eigen_symmetric(A, u);
+  CATCH_CHECK(u[0] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(u[1] == Approx(3.).epsilon(1e-12));
+  CATCH_CHECK(u[2] == Approx(5.).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, eigen_symmetric_3x3")
+{
+  for(int seed = 0; seed < 20; ++ seed) {
+    cml::matrix33d A;
+    random_symmetric(A, seed);
+    check_eigen(A, 1e-12);
+
+    cml::matrix33f B;
+    random_symmetric(B, seed);
+    check_eigen(B, 1e-5);
+  }
+}
+
+CATCH_TEST_CASE("fixed, eigen_symmetric_degenerate")
+{
+  cml::matrix33d I;
+  I.identity();
+  check_eigen(I, 1e-12);
+
+  cml::matrix33d Z;
+  Z.zero();
+  check_eigen(Z, 1e-12);
+
+  /* Two equal eigenvalues: */
+  auto A = cml::matrix33d(
+    2., 1., 1.,
+    1., 2., 1.,
+    1., 1., 2.
+    );
+  check_eigen(A, 1e-12);
+}
+
+CATCH_TEST_CASE("fixed, eigenvalues_3x3_range")
+{
+  /* Cubing the scale of the elements would overflow float: */
+  auto A = cml::matrix33f(
+    2e13f, 1e13f, 0.f,
+    1e13f, 2e13f, 0.f,
+    0.f, 0.f, 1e13f
+    );
+  cml::vector3f w;
+  cml::eigen_symmetric(A, w);
+  CATCH_CHECK(w[0] == Approx(1e13).epsilon(1e-5));
+  CATCH_CHECK(w[1] == Approx(1e13).epsilon(1e-5));
+  CATCH_CHECK(w[2] == Approx(3e13).epsilon(1e-5));
+
+  /* A widely graded positive definite matrix: */
+  auto B = cml::matrix33d(
+    1e-20, 0., 0.,
+    0., 1., 0.,
+    0., 0., 1e20
+    );
+  cml::vector3d u;
+  cml::eigen_symmetric(B, u);
+  CATCH_CHECK(u[0] == Approx(1e-20).epsilon(1e-12));
+  CATCH_CHECK(u[1] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(u[2] == Approx(1e20).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, eigenvalues_3x3_close")
+{
+  /* diag(1e-3, 1, 1.001) rotated about (1,2,2)/3 by 2.8 radians, whose two
+   * close eigenvalues are ill-conditioned roots of the characteristic
+   * polynomial:
+   */
+  double c = std::cos(2.8), s = std::sin(2.8);
+  double n[3] = { 1./3., 2./3., 2./3. }, d[3] = { 1e-3, 1., 1.001 };
+  double K[3][3] = {
+    { 0., - n[2], n[1] }, { n[2], 0., - n[0] }, { - n[1], n[0], 0. } };
+  double R[3][3];
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j)
+      R[i][j] = (i == j ? c : 0.) + s*K[i][j] + (1. - c)*n[i]*n[j];
+
+  cml::matrix33f A;
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j) {
+      double a = 0.;
+      for(int k = 0; k < 3; ++ k) a += R[i][k]*d[k]*R[j][k];
+      A(i,j) = float(a);
+    }
+
+  cml::vector3f w;
+  cml::eigen_symmetric(A, w);
+  CATCH_CHECK(w[0] == Approx(1e-3).epsilon(1e-4));
+  CATCH_CHECK(w[1] == Approx(1.).epsilon(1e-6));
+  CATCH_CHECK(w[2] == Approx(1.001).epsilon(1e-6));
+  check_eigen(A, 1e-5);
+}
+
+CATCH_TEST_CASE("fixed, eigen_symmetric_lower")
+{
+  /* Only the lower triangle is read: */
+  auto A = cml::matrix33d(
+    2., 9., 9.,
+    1., 2., 9.,
+    0., 0., 5.
+    );
+  cml::vector3d w;
+  cml::eigen_symmetric(A, w);
+  CATCH_CHECK(w[0] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(w[1] == Approx(3.).epsilon(1e-12));
+  CATCH_CHECK(w[2] == Approx(5.).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, eigen_symmetric_6x6")
+{
+  cml::matrix<double, cml::fixed<6,6>> A;
+  random_symmetric(A, 6);
+  check_eigen(A, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, eigen_symmetric1")
+{
+  cml::matrixd A(5,5);
+  random_symmetric(A, 5);
+  check_eigen(A, 1e-12);
+
+  cml::matrixd B(40,40);
+  random_symmetric(B, 40);
+  check_eigen(B, 1e-11);
+
+  cml::matrixd_c C(3,3);
+  random_symmetric(C, 3);
+  check_eigen(C, 1e-12);
+
+  cml::matrixd D(1,1);
+  D(0,0) = 2.;
+  check_eigen(D, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, eigen_symmetric_size_checking1")
+{
+  cml::vectord w;
+  CATCH_CHECK_THROWS_AS(
+    cml::eigen_symmetric(cml::matrixd(3, 4), w),
+    cml::non_square_matrix_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,192 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#include <cml/matrix.h>
+#include <cml/vector.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+namespace {
+
+typedef cml::allocated<std::allocator<void>, 3, 3>	allocated33;
+typedef cml::allocated<std::allocator<void>, 64, 64>	allocated64;
+
+typedef cml::matrix<double, allocated33>		matrix33d_a;
+typedef cml::matrix<double, allocated33,
+	cml::col_basis, cml::col_major>			matrix33d_a_c;
+typedef cml::matrix<double, allocated64>		matrix64d_a;
+
+} // namespace
+
+CATCH_TEST_CASE("typecheck")
+{
+  CATCH_CHECK(int(matrix64d_a::array_rows) == 64);
+  CATCH_CHECK(int(matrix64d_a::array_cols) == 64);
+  CATCH_CHECK((std::is_same<matrix64d_a::size_tag,cml::fixed_size_tag>::value));
+
+  /* Only the pointer lives in the matrix: */
+  CATCH_CHECK(sizeof(matrix64d_a) == sizeof(double*));
+}
+
+CATCH_TEST_CASE("array2_construct1")
+{
+  double aM[2][2] = {
+    { 1., 2. },
+    { 3., 4. }
+  };
+  cml::matrix<double, cml::allocated<std::allocator<void>, 2, 2>> M(aM);
+  CATCH_CHECK(M(0,1) == 2.);
+  CATCH_CHECK(M.data()[1] == 2.);
+  CATCH_CHECK(M(1,0) == 3.);
+}
+
+CATCH_TEST_CASE("element_construct1")
+{
+  matrix33d_a M(
+    1., 2., 3.,
+    4., 5., 6.,
+    7., 8., 9.
+    );
+  CATCH_REQUIRE(M.rows() == 3);
+  CATCH_REQUIRE(M.cols() == 3);
+  CATCH_CHECK(M(0,2) == 3.);
+  CATCH_CHECK(M.data()[2] == 3.);
+}
+
+CATCH_TEST_CASE("element_construct2")
+{
+  matrix33d_a_c M(
+    1., 2., 3.,
+    4., 5., 6.,
+    7., 8., 9.
+    );
+  CATCH_CHECK(M(0,2) == 3.);
+  CATCH_CHECK(M.data()[2] == 7.);
+}
+
+CATCH_TEST_CASE("list_construct1")
+{
+  matrix33d_a M = {
+    1., 2., 3.,
+    4., 5., 6.,
+    7., 8., 9.
+  };
+  CATCH_CHECK(M(2,0) == 7.);
+}
+
+CATCH_TEST_CASE("copy1")
+{
+  matrix33d_a M;
+  M.identity();
+  matrix33d_a N(M);
+  CATCH_CHECK(N.data() != M.data());
+  CATCH_CHECK(N(1,1) == 1.);
+
+  N(0,1) = 2.;
+  M = N;
+  CATCH_CHECK(M(0,1) == 2.);
+  CATCH_CHECK(M.data() != N.data());
+}
+
+CATCH_TEST_CASE("move1")
+{
+  matrix64d_a M;
+  M.identity();
+  const double* p = M.data();
+
+  /* Moves transfer the array without copying elements: */
+  matrix64d_a N(std::move(M));
+  CATCH_CHECK(N.data() == p);
+  CATCH_CHECK(N(63,63) == 1.);
+
+  matrix64d_a P;
+  P.zero();
+  const double* q = P.data();
+  P = std::move(N);
+  CATCH_CHECK(P.data() == p);
+  CATCH_CHECK(N.data() == q);
+
+  /* A moved-from matrix can be assigned: */
+  M = P;
+  CATCH_CHECK(M.data() != nullptr);
+  CATCH_CHECK(M(10,10) == 1.);
+  CATCH_CHECK(M(10,11) == 0.);
+}
+
+CATCH_TEST_CASE("move2")
+{
+  matrix33d_a A(
+    1., 2., 3.,
+    4., 5., 6.,
+    7., 8., 9.
+    );
+  matrix33d_a B(std::move(A));
+
+  /* A moved-from matrix can be assigned an expression: */
+  A = B + B;
+  CATCH_CHECK(A(0,0) == 2.);
+  CATCH_CHECK(A(2,1) == 16.);
+
+  /* A moved-from matrix is given an array when its elements are written: */
+  matrix33d_a C(std::move(B));
+  B(1,1) = 7.;
+  CATCH_CHECK(B(1,1) == 7.);
+
+  /* Moving from a moved-from matrix leaves the target writable: */
+  matrix33d_a D(std::move(A));
+  matrix33d_a E(std::move(A));
+  E = C - D;
+  CATCH_CHECK(E(1,2) == -6.);
+  D = std::move(A);
+  D.zero();
+  CATCH_CHECK(D(2,2) == 0.);
+}
+
+CATCH_TEST_CASE("move3")
+{
+  /* Moves only transfer the array, so they cannot throw: */
+  CATCH_CHECK(std::is_nothrow_move_constructible<matrix64d_a>::value);
+  CATCH_CHECK(std::is_nothrow_move_assignable<matrix64d_a>::value);
+}
+
+CATCH_TEST_CASE("product1")
+{
+  matrix64d_a A, B;
+  for(int i = 0; i < 64; ++ i)
+    for(int j = 0; j < 64; ++ j) {
+      A(i,j) = double(i + j);
+      B(i,j) = (i == j) ? 2. : 0.;
+    }
+
+  /* Products of allocated matrices stay on the heap: */
+  auto C = A*B;
+  CATCH_CHECK((std::is_same<decltype(C), matrix64d_a>::value));
+  CATCH_CHECK(C(3,5) == 16.);
+
+  matrix33d_a M(
+    2., 0., 0.,
+    0., 4., 0.,
+    0., 0., 8.
+    );
+  cml::vector<double, cml::allocated<std::allocator<void>, 3>> v(1., 1., 1.);
+  auto w = M*v;
+  CATCH_CHECK(w[2] == 8.);
+
+  auto I = cml::inverse(M);
+  CATCH_CHECK((std::is_same<decltype(I), matrix33d_a>::value));
+  CATCH_CHECK(I(1,1) == .25);
+}
+
+CATCH_TEST_CASE("size_check1")
+{
+  matrix33d_a M;
+  CATCH_REQUIRE_THROWS_AS(
+    (M = cml::matrixd(2,3)), cml::incompatible_matrix_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
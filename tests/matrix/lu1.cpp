@@ -7,6 +7,9 @@
 // Make sure the main header compiles cleanly:
 #include <cml/matrix/lu.h>
 
+#include <cmath>
+#include <random>
+
 #include <cml/vector.h>
 #include <cml/matrix.h>
 
@@ -15,6 +18,7 @@
 
 /* Testing headers: */
 #include "catch_runner.h"
+#include "allocation_count.h"
 
 
 CATCH_TEST_CASE("fixed, lu1")
@@ -740,6 +744,288 @@ CATCH_TEST_CASE("dynamic, lu_pivot_solve3")
   for(int i = 0; i < 4; ++ i) CATCH_CHECK(Ax[i] == Approx(b[i]).epsilon(1e-12));
 }
 
+CATCH_TEST_CASE("dynamic, lu_pivot_solve_matrix1")
+{
+  auto A = cml::matrixd(
+    4,4,
+     2.,  0.,  2.,  .6,
+     3.,  3.,  4.,  -2.,
+     5.,  5.,  4.,   2.,
+    -1., -2., 3.4,  -1.
+    );
+  auto lup = cml::lu_pivot(A);
+  CATCH_CHECK(lup.sign == -1);
+
+  auto B = cml::matrixd(
+    4,2,
+    5., 1.,
+    1., 0.,
+    8., -2.,
+    3., 7.
+    );
+  auto X = cml::lu_solve(lup, B);
+  CATCH_REQUIRE(X.rows() == 4);
+  CATCH_REQUIRE(X.cols() == 2);
+  for(int j = 0; j < 2; ++ j) {
+    auto x = cml::lu_solve(lup, cml::vectord(B(0,j), B(1,j), B(2,j), B(3,j)));
+    for(int i = 0; i < 4; ++ i) CATCH_CHECK(X(i,j) == Approx(x[i]).epsilon(1e-12));
+  }
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot_solve_matrix2")
+{
+  /* Several blocks of rows, and many right-hand sides: */
+  const int N = 150, M = 37;
+  cml::matrixd A(N,N), B(N,M);
+  std::mt19937 rng(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < M; ++ j) B(i,j) = rng()/4294967296. - .5;
+
+  auto lup = cml::lu_pivot(A);
+  CATCH_REQUIRE(lup.sign != 0);
+
+  cml::matrixd X;
+  cml::lu_solve(lup, X, B);
+  CATCH_REQUIRE(X.rows() == N);
+  CATCH_REQUIRE(X.cols() == M);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < M; ++ j) {
+      double m = 0.;
+      for(int k = 0; k < N; ++ k) m += A(i,k)*X(k,j);
+      CATCH_CHECK(m == Approx(B(i,j)).epsilon(1e-9).margin(1e-9));
+    }
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot_solve_matrix3")
+{
+  /* In-place, with column-major right-hand sides: */
+  const int N = 100, M = 9;
+  cml::matrixd A(N,N);
+  cml::matrixd_c B(N,M);
+  std::mt19937 rng(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < M; ++ j) B(i,j) = rng()/4294967296. - .5;
+
+  auto lup = cml::lu_pivot(A);
+  CATCH_REQUIRE(lup.sign != 0);
+
+  /* The rows are permuted without allocating: */
+  cml::matrixd_c X = B;
+  int count = allocation_count();
+  cml::lu_solve_inplace(lup, X);
+  CATCH_CHECK(allocation_count() == count);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < M; ++ j) {
+      double m = 0.;
+      for(int k = 0; k < N; ++ k) m += A(i,k)*X(k,j);
+      CATCH_CHECK(m == Approx(B(i,j)).epsilon(1e-9).margin(1e-9));
+    }
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot3")
+{
+  /* A negative diagonal element is a valid pivot: */
+  auto A = cml::matrixd(
+    2,2,
+    -1., 0.,
+     0., 1.
+    );
+  auto lup = cml::lu_pivot(A);
+  CATCH_CHECK(lup.sign == 1);
+  CATCH_CHECK(lup.lu(0,0) == -1.);
+  CATCH_CHECK(lup.lu(1,1) == 1.);
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot_blocked1")
+{
+  /* Several panels, with a partial last panel: */
+  const int N = 150;
+  cml::matrixd A(N,N);
+  std::mt19937 rng(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+
+  auto lup = cml::lu_pivot(A);
+  CATCH_REQUIRE(lup.sign != 0);
+
+  /* L*U must reproduce the permuted rows of A: */
+  for(int i = 0; i < N; ++ i) {
+    for(int j = 0; j < N; ++ j) {
+      double m = 0.;
+      for(int k = 0; k <= std::min(i,j); ++ k)
+	m += (k == i ? 1. : lup.lu(i,k))*lup.lu(k,j);
+      CATCH_CHECK(m == Approx(A(lup.order[i],j)).epsilon(1e-10));
+    }
+  }
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot_blocked2")
+{
+  /* Column-major storage: */
+  const int N = 100;
+  cml::matrixd_c A(N,N);
+  std::mt19937 rng(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+
+  auto lup = cml::lu_pivot(A);
+  CATCH_REQUIRE(lup.sign != 0);
+
+  cml::vectord b(N);
+  for(int i = 0; i < N; ++ i) b[i] = double(i%7) - 3.;
+  auto x = cml::lu_solve(lup, b);
+  for(int i = 0; i < N; ++ i) {
+    double m = 0.;
+    for(int k = 0; k < N; ++ k) m += A(i,k)*x[k];
+    CATCH_CHECK(m == Approx(b[i]).epsilon(1e-9).margin(1e-9));
+  }
+}
+
+CATCH_TEST_CASE("fixed, lu_pivot_determinant1")
+{
+  auto M = cml::matrix44d(
+     2.,  0.,  2.,  .6,
+     3.,  3.,  4.,  -2.,
+     5.,  5.,  4.,   2.,
+    -1., -2., 3.4,  -1.
+    );
+  auto lup = cml::lu_pivot(M);
+  CATCH_CHECK(cml::determinant(lup) == Approx(-120.).epsilon(1e-12));
+
+  int sign = 0;
+  double L = cml::log_abs_determinant(lup, sign);
+  CATCH_CHECK(sign == -1);
+  CATCH_CHECK(L == Approx(std::log(120.)).epsilon(1e-12));
+
+  /* The same factorization gives the inverse: */
+  auto Minv = cml::inverse(lup);
+  auto I = M*Minv;
+  for(int i = 0; i < 4; ++ i)
+    for(int j = 0; j < 4; ++ j)
+      CATCH_CHECK(I(i,j) == Approx(i == j ? 1. : 0.).margin(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot_workspace1")
+{
+  /* Reuse one factorization for a sequence of matrices large enough for
+   * the blocked algorithm:
+   */
+  const int N = 300;
+  cml::lu_pivot_result<cml::matrixd> lup(cml::matrixd(N,N));
+  for(int seed = 0; seed < 3; ++ seed) {
+    cml::matrixd A(N,N);
+    std::mt19937 rng(seed);
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+
+    /* Only the first factorization allocates the packing buffers: */
+    const double* data = lup.lu.data();
+    int count = allocation_count();
+    double D = cml::determinant(A, lup);
+    int sign = 0;
+    double L = cml::log_abs_determinant(A, sign, lup);
+    if(seed > 0) CATCH_CHECK(allocation_count() == count);
+    CATCH_CHECK(lup.lu.data() == data);
+    CATCH_CHECK(D == Approx(cml::determinant(A)).epsilon(1e-10));
+    CATCH_CHECK(double(sign)*std::exp(L) == Approx(D).epsilon(1e-10));
+
+    auto Ainv = cml::inverse(lup);
+    cml::matrixd I = A*Ainv;
+    double error = 0.;
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j)
+	error = std::max(error, std::fabs(I(i,j) - (i == j ? 1. : 0.)));
+    CATCH_CHECK(error < 1e-10);
+  }
+}
+
+CATCH_TEST_CASE("dynamic, log_abs_determinant1")
+{
+  /* det(2I) overflows for N = 1100, but its logarithm does not: */
+  const int N = 1100;
+  cml::matrixd A(N,N);
+  A.identity();
+  A *= -2.;
+  cml::lu_pivot_result<cml::matrixd> lup(A);
+  int sign = 0;
+  double L = cml::log_abs_determinant(A, sign, lup);
+  CATCH_CHECK(sign == 1);
+  CATCH_CHECK(L == Approx(N*std::log(2.)).epsilon(1e-12));
+  CATCH_CHECK(std::isinf(cml::determinant(lup)));
+
+  /* Singular: */
+  cml::matrixd B(6,6);
+  B.zero();
+  L = cml::log_abs_determinant(B, sign, lup);
+  CATCH_CHECK(sign == 0);
+  CATCH_CHECK(std::isinf(L));
+  CATCH_CHECK(L < 0.);
+  CATCH_CHECK(cml::determinant(lup) == 0.);
+}
+
+CATCH_TEST_CASE("dynamic, rcond_estimate1")
+{
+  /* The estimate of ||A^-1|| is a lower bound, usually exact: */
+  const int N = 30;
+  cml::lu_pivot_result<cml::matrixd> lup(cml::matrixd(N,N));
+  int exact = 0;
+  for(int seed = 0; seed < 10; ++ seed) {
+    cml::matrixd A(N,N);
+    std::mt19937 rng(seed);
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+
+    double norm = cml::norm_1(A);
+    cml::lu_pivot(A, lup);
+    double inverse_norm = cml::norm_1(cml::inverse(lup));
+    double estimate = cml::inverse_norm_1_estimate(lup);
+    CATCH_CHECK(estimate <= inverse_norm*(1. + 1e-10));
+    CATCH_CHECK(estimate >= inverse_norm/3.);
+    exact += (estimate >= inverse_norm*(1. - 1e-10));
+
+    double rcond = cml::rcond_estimate(lup, norm);
+    CATCH_CHECK(rcond == Approx(1./(norm*estimate)).epsilon(1e-12));
+  }
+  CATCH_CHECK(exact >= 5);
+}
+
+CATCH_TEST_CASE("fixed, rcond_estimate1")
+{
+  /* The Hilbert matrix is badly conditioned: */
+  cml::matrix44d H;
+  for(int i = 0; i < 4; ++ i)
+    for(int j = 0; j < 4; ++ j) H(i,j) = 1./double(i + j + 1);
+
+  double norm = cml::norm_1(H);
+  cml::lu_pivot_result<cml::matrix44d> lup(H);
+  cml::lu_pivot(lup);
+  double exact = 1./(norm*cml::norm_1(cml::inverse(lup)));
+  double rcond = cml::rcond_estimate(lup, norm);
+  CATCH_CHECK(rcond == Approx(exact).epsilon(1e-8));
+  CATCH_CHECK(rcond < 1e-4);
+
+  cml::matrix44d I;
+  I.identity();
+  cml::lu_pivot_result<cml::matrix44d> lui(I);
+  cml::lu_pivot(lui);
+  CATCH_CHECK(cml::rcond_estimate(lui, 1.) == Approx(1.).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, rcond_estimate_singular1")
+{
+  cml::matrixd A(3,3);
+  A.zero();
+  cml::lu_pivot_result<cml::matrixd> lup(A);
+  cml::lu_pivot(lup);
+  CATCH_CHECK(lup.sign == 0);
+  CATCH_CHECK(cml::rcond_estimate(lup, cml::norm_1(A)) == 0.);
+  CATCH_CHECK(std::isinf(cml::inverse_norm_1_estimate(lup)));
+}
+
 
 // -------------------------------------------------------------------------
 // vim:ft=cpp:sw=2
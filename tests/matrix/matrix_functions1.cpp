@@ -7,8 +7,12 @@
 // Make sure the main header compiles cleanly:
 //#include <cml/matrix/functions.h>
 
+#include <cmath>
+
 #include <cml/vector/fixed.h>
 #include <cml/matrix/fixed.h>
+#include <cml/matrix/dynamic.h>
+#include <cml/matrix/functions.h>
 #include <cml/types.h>
 
 /* Testing headers: */
@@ -117,6 +121,33 @@ CATCH_TEST_CASE("fixed, trace1")
   CATCH_CHECK(M.trace() == Approx(expected).epsilon(1e-12));
 }
 
+CATCH_TEST_CASE("fixed, norms1")
+{
+  cml::matrix23d M(
+    1., -2., 3.,
+    -4., 5., -6.
+    );
+  CATCH_CHECK(cml::norm_1(M) == 9.);
+  CATCH_CHECK(cml::norm_inf(M) == 15.);
+  CATCH_CHECK(cml::norm_frobenius(M)
+    == Approx(std::sqrt(91.)).epsilon(1e-12));
+  CATCH_CHECK(cml::norm_1(cml::transpose(M)) == 15.);
+}
+
+CATCH_TEST_CASE("dynamic, norms1")
+{
+  cml::matrixd M(3,2);
+  M.zero();
+  CATCH_CHECK(cml::norm_1(M) == 0.);
+  CATCH_CHECK(cml::norm_inf(M) == 0.);
+  CATCH_CHECK(cml::norm_frobenius(M) == 0.);
+  M(2,1) = -3.;
+  M(0,1) = 4.;
+  CATCH_CHECK(cml::norm_1(M) == 7.);
+  CATCH_CHECK(cml::norm_inf(M) == 4.);
+  CATCH_CHECK(cml::norm_frobenius(M) == Approx(5.).epsilon(1e-12));
+}
+
 
 // -------------------------------------------------------------------------
 // vim:ft=cpp:sw=2
@@ -7,6 +7,9 @@
 // Make sure the main header compiles cleanly:
 #include <cml/matrix/inverse.h>
 
+#include <random>
+#include <limits>
+
 #include <cml/matrix/fixed.h>
 #include <cml/matrix/dynamic.h>
 #include <cml/matrix/external.h>
@@ -14,7 +17,74 @@
 
 /* Testing headers: */
 #include "catch_runner.h"
+#include "allocation_count.h"
+
+
+namespace {
+
+/* Fill M with uniform random elements: */
+template<class Matrix> void
+random_matrix(Matrix& M, int seed)
+{
+  std::mt19937 rng(seed);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) M(i,j) = rng()/4294967296. - .5;
+}
+
+/* Check that M*X is the identity: */
+template<class Matrix1, class Matrix2> void
+check_inverse(const Matrix1& M, const Matrix2& X, double epsilon)
+{
+  int N = M.rows();
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) {
+      double s = 0.;
+      for(int k = 0; k < N; ++ k) s += M(i,k)*X(k,j);
+      CATCH_CHECK(s == Approx(i == j ? 1. : 0.).margin(epsilon));
+    }
+}
 
+/* Return the infinity norm of M: */
+template<class Matrix> double
+infinity_norm(const Matrix& M)
+{
+  double n = 0.;
+  for(int i = 0; i < M.rows(); ++ i) {
+    double s = 0.;
+    for(int j = 0; j < M.cols(); ++ j) s += std::fabs(M(i,j));
+    n = std::max(n, s);
+  }
+  return n;
+}
+
+/* Check that the inverse of random N x N matrices is as accurate as the
+ * dynamic-size LU inverse, relative to the condition number:
+ */
+template<int N> void
+check_inverse_random(int seeds)
+{
+  const double eps = std::numeric_limits<double>::epsilon();
+  for(int seed = 0; seed < seeds; ++ seed) {
+    cml::matrix<double, cml::fixed<N,N>> M;
+    random_matrix(M, seed);
+    auto X = cml::inverse(M);
+    cml::matrixd L = cml::inverse(cml::matrixd(M));
+    double kappa = infinity_norm(M)*infinity_norm(L);
+
+    double residual = 0., error = 0.;
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j) {
+	double s = (i == j) ? -1. : 0.;
+	for(int k = 0; k < N; ++ k) s += M(i,k)*X(k,j);
+	residual = std::max(residual, std::fabs(s));
+	error = std::max(error, std::fabs(X(i,j) - L(i,j)));
+      }
+    CATCH_CHECK(residual <= 4.*kappa*eps);
+    CATCH_CHECK(error <= 4.*kappa*eps*infinity_norm(L));
+  }
+}
+
+} // namespace
 
 CATCH_TEST_CASE("fixed, inverse_assign_2x2")
 {
@@ -73,6 +143,25 @@ CATCH_TEST_CASE("fixed, inverse_assign_4x4")
       CATCH_CHECK(M(i,j) == Approx(expected(i,j)).epsilon(1e-12));
 }
 
+CATCH_TEST_CASE("fixed, inverse_4x4_layouts")
+{
+  cml::matrix44d M;
+  random_matrix(M, 4);
+  check_inverse(M, cml::inverse(M), 1e-12);
+
+  cml::matrix44d_c C;
+  random_matrix(C, 4);
+  check_inverse(C, cml::inverse(C), 1e-12);
+
+  cml::matrix44f F;
+  random_matrix(F, 4);
+  check_inverse(F, cml::inverse(F), 1e-4);
+
+  cml::matrix44f_c G;
+  random_matrix(G, 4);
+  check_inverse(G, cml::inverse(G), 1e-4);
+}
+
 CATCH_TEST_CASE("fixed, inverse_2x2")
 {
   auto M = cml::inverse(
@@ -90,6 +179,107 @@ CATCH_TEST_CASE("fixed, inverse_2x2")
 
 
 
+CATCH_TEST_CASE("fixed, inverse_5x5")
+{
+  cml::matrix<double, cml::fixed<5,5>> M(
+    2., 0., 0., 0., 1.,
+    0., 3., 0., 0., 0.,
+    0., 0., 0., 4., 0.,
+    0., 0., 5., 0., 0.,
+    1., 0., 0., 0., 1.
+    );
+  auto X = cml::inverse(M);
+
+  cml::matrix<double, cml::fixed<5,5>> expected(
+     1., 0.,    0.,    0., -1.,
+     0., 1./3., 0.,    0.,  0.,
+     0., 0.,    0.,    .2,  0.,
+     0., 0.,    .25,   0.,  0.,
+    -1., 0.,    0.,    0.,  2.
+    );
+  for(int i = 0; i < 5; ++ i)
+    for(int j = 0; j < 5; ++ j)
+      CATCH_CHECK(X(i,j) == Approx(expected(i,j)).epsilon(1e-12).margin(1e-15));
+}
+
+CATCH_TEST_CASE("fixed, inverse_NxN")
+{
+  cml::matrix<double, cml::fixed<6,6>> M6;
+  random_matrix(M6, 6);
+  check_inverse(M6, cml::inverse(M6), 1e-12);
+
+  cml::matrix<double, cml::fixed<8,8>> M8;
+  random_matrix(M8, 8);
+  check_inverse(M8, cml::inverse(M8), 1e-12);
+
+  cml::matrix<double, cml::fixed<11,11>> M11;
+  random_matrix(M11, 11);
+  check_inverse(M11, cml::inverse(M11), 1e-12);
+}
+
+CATCH_TEST_CASE("fixed, inverse_block")
+{
+  /* Sizes 5 through 7 use the Schur complement of the leading block: */
+  for(int seed = 0; seed < 10; ++ seed) {
+    cml::matrix<double, cml::fixed<5,5>> M5;
+    random_matrix(M5, seed);
+    check_inverse(M5, cml::inverse(M5), 1e-12);
+
+    cml::matrix<double, cml::fixed<6,6>> M6;
+    random_matrix(M6, seed);
+    check_inverse(M6, cml::inverse(M6), 1e-12);
+
+    cml::matrix<double, cml::fixed<7,7>> M7;
+    random_matrix(M7, seed);
+    check_inverse(M7, cml::inverse(M7), 1e-12);
+
+    cml::matrix<float, cml::fixed<8,8>> M8;
+    random_matrix(M8, seed);
+    for(int i = 0; i < 8; ++ i) M8(i,i) += 2.f;
+    check_inverse(M8, cml::inverse(M8), 1e-5);
+  }
+}
+
+CATCH_TEST_CASE("fixed, inverse_block_random")
+{
+  /* The unpivoted block inverse is used only when it is accurate: */
+  check_inverse_random<5>(2000);
+  check_inverse_random<6>(2000);
+  check_inverse_random<7>(2000);
+  check_inverse_random<8>(500);
+}
+
+CATCH_TEST_CASE("fixed, inverse_block_fallback")
+{
+  /* The leading 4x4 block is singular: */
+  cml::matrix<double, cml::fixed<7,7>> P;
+  P.zero();
+  for(int i = 0; i < 3; ++ i) {
+    P(i,i+4) = double(i+1);
+    P(i+4,i) = 1.;
+  }
+  P(3,3) = 2.;
+  check_inverse(P, cml::inverse(P), 1e-12);
+
+  /* The leading 3x3 block is nearly singular: */
+  cml::matrix<double, cml::fixed<6,6>> M;
+  random_matrix(M, 6);
+  for(int j = 0; j < 3; ++ j) M(2,j) = M(0,j) + 1e-9*M(1,j);
+  check_inverse(M, cml::inverse(M), 1e-9);
+
+  /* The leading 3x3 block is well conditioned, but tiny: */
+  cml::matrix<double, cml::fixed<6,6>> T;
+  T.zero();
+  for(int i = 0; i < 3; ++ i) {
+    T(i,i) = 1e-13*(1. + .1*i);
+    T(i,i+3) = T(i+3,i) = 1.;
+    T(i+3,i+3) = 2. + i;
+  }
+  T(3,4) = .5;
+  T(1,5) = .25;
+  check_inverse(T, cml::inverse(T), 1e-12);
+}
+
 CATCH_TEST_CASE("fixed external, inverse_assign_2x2")
 {
   double avM[] = {
@@ -326,6 +516,67 @@ CATCH_TEST_CASE("dynamic, inverse_2x2")
   CATCH_CHECK(M(1,1) == Approx(-0.5).epsilon(1e-12));
 }
 
+CATCH_TEST_CASE("dynamic, inverse_4x4_layouts")
+{
+  cml::matrixd M(4,4);
+  random_matrix(M, 4);
+  check_inverse(M, cml::inverse(M), 1e-12);
+
+  cml::matrixf_c F(4,4);
+  random_matrix(F, 4);
+  check_inverse(F, cml::inverse(F), 1e-4);
+}
+
+CATCH_TEST_CASE("dynamic, inverse_NxN")
+{
+  cml::matrixd M(7,7);
+  random_matrix(M, 7);
+  auto X = cml::inverse(M);
+  check_inverse(M, X, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, inverse_blocked1")
+{
+  /* Several blocks, with a partial last one: */
+  cml::matrixd M(150,150);
+  random_matrix(M, 150);
+  check_inverse(M, cml::inverse(M), 1e-10);
+
+  cml::matrixd_c C(100,100);
+  random_matrix(C, 100);
+  check_inverse(C, cml::inverse(C), 1e-10);
+}
+
+CATCH_TEST_CASE("dynamic, inverse_workspace1")
+{
+  cml::inverse_workspace<double> workspace;
+
+  cml::matrixd M(80,80);
+  random_matrix(M, 80);
+  auto X = cml::inverse(M, workspace);
+  check_inverse(M, X, 1e-10);
+
+  /* The workspace is reused for a smaller matrix: */
+  cml::matrixd N(9,9);
+  random_matrix(N, 9);
+  auto Y = N;
+  cml::inverse_inplace(Y, workspace);
+  check_inverse(N, Y, 1e-12);
+
+  /* Once grown, the workspace is reused without allocating, including
+   * the packing buffers of the blocked inverse:
+   */
+  cml::matrixd A(300,300), B(300,300);
+  random_matrix(A, 300);
+  random_matrix(B, 301);
+  cml::inverse_inplace(A, workspace);
+  auto Z = B;
+  int count = allocation_count();
+  cml::inverse_inplace(Z, workspace);
+  CATCH_CHECK(allocation_count() == count);
+  check_inverse(B, Z, 1e-10);
+}
+
 CATCH_TEST_CASE("dynamic, size_check1")
 {
   cml::matrixd M(3,4);
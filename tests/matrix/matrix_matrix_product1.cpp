@@ -7,9 +7,13 @@
 // Make sure the main header compiles cleanly:
 #include <cml/matrix/matrix_product.h>
 
+#include <cmath>
+#include <limits>
+
 #include <cml/matrix/fixed.h>
 #include <cml/matrix/external.h>
 #include <cml/matrix/dynamic.h>
+#include <cml/matrix/transpose.h>
 #include <cml/matrix/types.h>
 
 /* Testing headers: */
@@ -67,6 +71,51 @@ CATCH_TEST_CASE("fixed, product2")
 
 
 
+CATCH_TEST_CASE("fixed, product44_1")
+{
+  /* Non-integer values, to check that the 4x4 kernel rounds the same way
+   * as the generic product:
+   */
+  cml::matrix44f M1, M2;
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      M1(i,j) = 0.1f*float(i+1) - 0.37f*float(j*j);
+      M2(i,j) = 1.f/float(i+2*j+1) + 0.3f;
+    }
+  }
+
+  auto M = M1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrix44f>::value));
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      float m = M1(i,0)*M2(0,j);
+      for(int k = 1; k < 4; ++ k) m += M1(i,k)*M2(k,j);
+      CATCH_CHECK(M(i,j) == m);
+    }
+  }
+}
+
+CATCH_TEST_CASE("fixed, product44_2")
+{
+  cml::matrix44d_c M1, M2;
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      M1(i,j) = 0.1*double(i+1) - 0.37*double(j*j);
+      M2(i,j) = 1./double(i+2*j+1) + 0.3;
+    }
+  }
+
+  auto M = M1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrix44d_c>::value));
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      double m = M1(i,0)*M2(0,j);
+      for(int k = 1; k < 4; ++ k) m += M1(i,k)*M2(k,j);
+      CATCH_CHECK(M(i,j) == m);
+    }
+  }
+}
+
 CATCH_TEST_CASE("fixed external, product1")
 {
   double aM1[] = {
@@ -237,6 +286,116 @@ CATCH_TEST_CASE("dynamic, product2")
   CATCH_CHECK(M(2,2) == 18.);
 }
 
+CATCH_TEST_CASE("dynamic, blocked1")
+{
+  /* Large enough to use the packed kernel, with ragged edge tiles: */
+  cml::matrixd M1(131,70), M2(70,97);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = double((i+2*j)%7) - 3.;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = double((3*i+j)%5) - 2.;
+
+  auto M = M1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrixd>::value));
+  CATCH_REQUIRE(M.rows() == 131);
+  CATCH_REQUIRE(M.cols() == 97);
+  for(int i = 0; i < M.rows(); ++ i) {
+    for(int j = 0; j < M.cols(); ++ j) {
+      double m = 0.;
+      for(int k = 0; k < M1.cols(); ++ k) m += M1(i,k)*M2(k,j);
+      CATCH_CHECK(M(i,j) == m);
+    }
+  }
+}
+
+CATCH_TEST_CASE("dynamic, blocked2")
+{
+  cml::matrixd_c M1(67,300), M2(300,45);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = double((i+2*j)%7) - 3.;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = double((3*i+j)%5) - 2.;
+
+  auto M = M1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrixd_c>::value));
+  CATCH_REQUIRE(M.rows() == 67);
+  CATCH_REQUIRE(M.cols() == 45);
+  for(int i = 0; i < M.rows(); ++ i) {
+    for(int j = 0; j < M.cols(); ++ j) {
+      double m = 0.;
+      for(int k = 0; k < M1.cols(); ++ k) m += M1(i,k)*M2(k,j);
+      CATCH_CHECK(M(i,j) == m);
+    }
+  }
+}
+
+CATCH_TEST_CASE("dynamic, transpose1")
+{
+  /* A^T*B must match the product of the materialized transpose: */
+  cml::matrixd M1(90,131), M2(90,77);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = 1./(1 + (i+2*j)%11) - .2;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = 1./(1 + (3*i+j)%13) - .1;
+
+  cml::matrixd T1 = cml::transpose(M1);
+  auto M = cml::transpose(M1)*M2;
+  auto R = T1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrixd>::value));
+  CATCH_REQUIRE(M.rows() == 131);
+  CATCH_REQUIRE(M.cols() == 77);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) CATCH_CHECK(M(i,j) == R(i,j));
+}
+
+CATCH_TEST_CASE("dynamic, transpose2")
+{
+  /* A*B^T must match the product of the materialized transpose: */
+  cml::matrixd_c M1(67,100), M2(45,100);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = 1./(1 + (i+2*j)%11) - .2;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = 1./(1 + (3*i+j)%13) - .1;
+
+  cml::matrixd_c T2 = cml::transpose(M2);
+  auto M = M1*cml::transpose(M2);
+  auto R = M1*T2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrixd_c>::value));
+  CATCH_REQUIRE(M.rows() == 67);
+  CATCH_REQUIRE(M.cols() == 45);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) CATCH_CHECK(M(i,j) == R(i,j));
+}
+
+CATCH_TEST_CASE("dynamic, transpose3")
+{
+  /* A^T*A and A*A^T are symmetric, and match the full products: */
+  cml::matrixd A(150,210);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j) A(i,j) = 1./(1 + (i+2*j)%11) - .2;
+
+  cml::matrixd T = cml::transpose(A);
+  auto M1 = cml::transpose(A)*A;
+  auto R1 = T*A;
+  CATCH_REQUIRE(M1.rows() == 210);
+  CATCH_REQUIRE(M1.cols() == 210);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) {
+      CATCH_CHECK(M1(i,j) == R1(i,j));
+      CATCH_CHECK(M1(i,j) == M1(j,i));
+    }
+
+  auto M2 = A*cml::transpose(A);
+  auto R2 = A*T;
+  CATCH_REQUIRE(M2.rows() == 150);
+  CATCH_REQUIRE(M2.cols() == 150);
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) {
+      CATCH_CHECK(M2(i,j) == R2(i,j));
+      CATCH_CHECK(M2(i,j) == M2(j,i));
+    }
+}
+
 CATCH_TEST_CASE("dynamic, size_checking1")
 {
   CATCH_REQUIRE_THROWS_AS(
@@ -244,6 +403,53 @@ CATCH_TEST_CASE("dynamic, size_checking1")
     cml::incompatible_matrix_inner_size_error);
 }
 
+CATCH_TEST_CASE("dynamic, strassen1")
+{
+  /* Small integers are exact, so any error is in the recursion, or in the
+   * peeling of the odd sizes:
+   */
+  cml::matrixd M1(101,77), M2(77,93);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = double((i+2*j)%7) - 3.;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = double((3*i+j)%5) - 2.;
+
+  auto M = cml::strassen_product(M1, M2, 8);
+  auto R = M1*M2;
+  CATCH_REQUIRE((std::is_same<decltype(M), cml::matrixd>::value));
+  CATCH_REQUIRE(M.rows() == 101);
+  CATCH_REQUIRE(M.cols() == 93);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) CATCH_CHECK(M(i,j) == R(i,j));
+}
+
+CATCH_TEST_CASE("dynamic, strassen2")
+{
+  cml::matrixd_c M1(130,130), M2(130,130);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = 1./(1 + (i+2*j)%11) - .2;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = 1./(1 + (3*i+j)%13) - .1;
+
+  /* Three levels of recursion, within the documented error bound: */
+  auto M = cml::strassen_product(cml::transpose(M1), M2, 16);
+  auto R = cml::transpose(M1)*M2;
+  double n = 130., n0 = 130./8., u = .5*std::numeric_limits<double>::epsilon();
+  double bound = (std::pow(n/n0, std::log2(18.))*(n0*n0 + 6.*n0) - 6.*n)*u;
+  CATCH_REQUIRE(M.rows() == 130);
+  CATCH_REQUIRE(M.cols() == 130);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j)
+      CATCH_CHECK(std::fabs(M(i,j) - R(i,j)) <= 2.*bound);
+}
+
+CATCH_TEST_CASE("dynamic, strassen_size_checking1")
+{
+  CATCH_REQUIRE_THROWS_AS(
+    cml::strassen_product(cml::matrixd(2,2), cml::matrixd(3,2)),
+    cml::incompatible_matrix_inner_size_error);
+}
+
 
 
 
@@ -10,12 +10,19 @@
 // Make sure the main header compiles cleanly:
 #include <cml/matrix/vector_product.h>
 
+#include <cml/vector/binary_ops.h>
+#include <cml/vector/scalar_ops.h>
+#include <cml/vector/unary_ops.h>
 #include <cml/vector/fixed.h>
 #include <cml/vector/external.h>
 #include <cml/vector/dynamic.h>
+#include <cml/vector/subvector.h>
+#include <cml/vector/cross.h>
+#include <cml/vector/outer_product.h>
 #include <cml/matrix/fixed.h>
 #include <cml/matrix/external.h>
 #include <cml/matrix/dynamic.h>
+#include <cml/matrix/row_col.h>
 #include <cml/types.h>
 
 /* Testing headers: */
@@ -32,7 +39,8 @@ CATCH_TEST_CASE("fixed product1")
     );
 
   auto v = M*v1;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vector2d>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vector2d>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 17.);
   CATCH_CHECK(v[1] == 39.);
@@ -49,7 +57,8 @@ CATCH_TEST_CASE("fixed product2")
     );
 
   auto v = v1*M;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vector2d>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vector2d>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 23.);
   CATCH_CHECK(v[1] == 34.);
@@ -64,7 +73,8 @@ CATCH_TEST_CASE("fixed external product1")
   cml::external2d v1(av1);
 
   auto v = M*v1;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vector2d>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vector2d>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 17.);
   CATCH_CHECK(v[1] == 39.);
@@ -79,7 +89,8 @@ CATCH_TEST_CASE("fixed external product2")
   cml::external2d v1(av1);
 
   auto v = v1*M;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vector2d>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vector2d>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 23.);
   CATCH_CHECK(v[1] == 34.);
@@ -94,7 +105,8 @@ CATCH_TEST_CASE("dynamic external product1")
   cml::externalnd v1(2, av1);
 
   auto v = M*v1;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vectord>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vectord>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 17.);
   CATCH_CHECK(v[1] == 39.);
@@ -109,7 +121,8 @@ CATCH_TEST_CASE("dynamic external product2")
   cml::externalnd v1(2, av1);
 
   auto v = v1*M;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vectord>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vectord>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 23.);
   CATCH_CHECK(v[1] == 34.);
@@ -143,7 +156,8 @@ CATCH_TEST_CASE("dynamic product1")
     );
 
   auto v = M*v1;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vectord>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vectord>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 17.);
   CATCH_CHECK(v[1] == 39.);
@@ -161,12 +175,146 @@ CATCH_TEST_CASE("dynamic product2")
     );
 
   auto v = v1*M;
-  CATCH_REQUIRE((std::is_same<decltype(v), cml::vectord>::value));
+  CATCH_REQUIRE((std::is_same<
+      cml::temporary_of_t<decltype(v)>, cml::vectord>::value));
   CATCH_REQUIRE(v.size() == 2);
   CATCH_CHECK(v[0] == 23.);
   CATCH_CHECK(v[1] == 34.);
 }
 
+CATCH_TEST_CASE("fused product1")
+{
+  cml::matrix22d M(
+    1., 2.,
+    3., 4.
+    );
+  cml::vector2d v1(5., 6.), b(1., -1.);
+
+  cml::vector2d v = M*v1 + b;
+  CATCH_CHECK(v[0] == 18.);
+  CATCH_CHECK(v[1] == 38.);
+
+  v = 2.*(M*v1);
+  CATCH_CHECK(v[0] == 34.);
+  CATCH_CHECK(v[1] == 78.);
+}
+
+CATCH_TEST_CASE("fused product2")
+{
+  cml::matrix22d M(
+    1., 2.,
+    3., 4.
+    );
+  cml::vector2d v1(5., 6.);
+
+  /* The inner product is evaluated into a temporary when the outer node
+   * is constructed, so later changes to v1 are not seen:
+   */
+  auto xpr = M*(M*v1);
+  v1.zero();
+  CATCH_CHECK(xpr[0] == 95.);
+  CATCH_CHECK(xpr[1] == 207.);
+}
+
+CATCH_TEST_CASE("fixed alias1")
+{
+  cml::matrix22d M(
+    1., 2.,
+    3., 4.
+    );
+  cml::vector2d v(5., 6.);
+  v = M*v;
+  CATCH_CHECK(v[0] == 17.);
+  CATCH_CHECK(v[1] == 39.);
+
+  v.set(5., 6.);
+  v = v*M;
+  CATCH_CHECK(v[0] == 23.);
+  CATCH_CHECK(v[1] == 34.);
+}
+
+CATCH_TEST_CASE("dynamic alias1")
+{
+  cml::matrixd M(
+    2,2,
+    1., 2.,
+    3., 4.
+    );
+  cml::vectord v(5., 6.), b(1., -1.);
+  v = M*v + b;
+  CATCH_CHECK(v[0] == 18.);
+  CATCH_CHECK(v[1] == 38.);
+
+  v.set(5., 6.);
+  v += M*v;
+  CATCH_CHECK(v[0] == 22.);
+  CATCH_CHECK(v[1] == 45.);
+
+  v.set(5., 6.);
+  v -= -(v*M);
+  CATCH_CHECK(v[0] == 28.);
+  CATCH_CHECK(v[1] == 40.);
+}
+
+CATCH_TEST_CASE("subvector alias1")
+{
+  cml::matrix33d A(
+    1., 2., 3.,
+    4., 5., 6.,
+    7., 8., 9.
+    );
+  cml::vectord v(1., 1., 1.);
+  v = cml::subvector(A*v, 2);
+  CATCH_REQUIRE(v.size() == 2);
+  CATCH_CHECK(v[0] == 6.);
+  CATCH_CHECK(v[1] == 15.);
+}
+
+CATCH_TEST_CASE("cross alias1")
+{
+  cml::matrix33d B(
+    2., 0., 0.,
+    5., 1., 0.,
+    1., 0., 1.
+    );
+  cml::vector3d a(1., 0., 0.), b(0., 0., 3.);
+  a = cml::cross(B*a, b);
+  CATCH_CHECK(a[0] == 15.);
+  CATCH_CHECK(a[1] == -6.);
+  CATCH_CHECK(a[2] == 0.);
+}
+
+CATCH_TEST_CASE("outer alias1")
+{
+  cml::vector2d v(2., 3.), w(3., 4.);
+  v = cml::row(cml::outer(v, w), 0);
+  CATCH_CHECK(v[0] == 6.);
+  CATCH_CHECK(v[1] == 8.);
+}
+
+CATCH_TEST_CASE("external alias1")
+{
+  cml::matrix22d M(
+    1., 2.,
+    3., 4.
+    );
+  cml::vector2d v(5., 6.);
+
+  /* An external vector over the memory of the operand is detected: */
+  cml::external2d w(v.data());
+  w = M*v;
+  CATCH_CHECK(v[0] == 17.);
+  CATCH_CHECK(v[1] == 39.);
+
+  /* As is a partial overlap: */
+  double a[] = { 5., 6., 0. };
+  cml::external2d x(a), y(a + 1);
+  y = x*M;
+  CATCH_CHECK(a[0] == 5.);
+  CATCH_CHECK(a[1] == 23.);
+  CATCH_CHECK(a[2] == 34.);
+}
+
 CATCH_TEST_CASE("dynamic size_checking1")
 {
   CATCH_REQUIRE_THROWS_AS(
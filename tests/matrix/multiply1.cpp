@@ -0,0 +1,245 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/multiply.h>
+
+#include <cml/vector/fixed.h>
+#include <cml/vector/external.h>
+#include <cml/vector/dynamic.h>
+#include <cml/vector/binary_ops.h>
+#include <cml/matrix/fixed.h>
+#include <cml/matrix/external.h>
+#include <cml/matrix/dynamic.h>
+#include <cml/matrix/transpose.h>
+#include <cml/matrix/binary_ops.h>
+#include <cml/matrix/scalar_ops.h>
+#include <cml/types.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+CATCH_TEST_CASE("fixed, multiply1")
+{
+  cml::matrix22d M1(
+    1., 2.,
+    3., 4.
+    );
+  cml::matrix22d M2(
+    5., 6.,
+    7., 8.
+    );
+
+  cml::matrix22d M;
+  cml::multiply(M, M1, M2);
+  CATCH_CHECK(M(0,0) == 19.);
+  CATCH_CHECK(M(0,1) == 22.);
+  CATCH_CHECK(M(1,0) == 43.);
+  CATCH_CHECK(M(1,1) == 50.);
+}
+
+CATCH_TEST_CASE("fixed, multiply2")
+{
+  cml::matrix44f M1, M2;
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      M1(i,j) = 0.1f*float(i+1) - 0.37f*float(j*j);
+      M2(i,j) = 1.f/float(i+2*j+1) + 0.3f;
+    }
+  }
+
+  cml::matrix44f M;
+  cml::multiply(M, M1, M2);
+  auto P = M1*M2;
+  for(int i = 0; i < 4; ++ i)
+    for(int j = 0; j < 4; ++ j) CATCH_CHECK(M(i,j) == P(i,j));
+}
+
+CATCH_TEST_CASE("fixed, gemm1")
+{
+  cml::matrix22d M1(
+    1., 2.,
+    3., 4.
+    );
+  cml::matrix22d M2(
+    5., 6.,
+    7., 8.
+    );
+
+  cml::matrix22d M(
+    1., 1.,
+    1., -1.
+    );
+  cml::gemm(M, 2., M1, M2, -1.);
+  CATCH_CHECK(M(0,0) == 37.);
+  CATCH_CHECK(M(0,1) == 43.);
+  CATCH_CHECK(M(1,0) == 85.);
+  CATCH_CHECK(M(1,1) == 101.);
+}
+
+CATCH_TEST_CASE("fixed, gemm2")
+{
+  cml::matrix44d M1, M2, M;
+  for(int i = 0; i < 4; ++ i) {
+    for(int j = 0; j < 4; ++ j) {
+      M1(i,j) = double(i+j);
+      M2(i,j) = double(i-j);
+      M(i,j) = 1.;
+    }
+  }
+
+  auto P = M1*M2;
+  cml::gemm(M, 0.5, M1, M2, 2.);
+  for(int i = 0; i < 4; ++ i)
+    for(int j = 0; j < 4; ++ j) CATCH_CHECK(M(i,j) == 0.5*P(i,j) + 2.);
+}
+
+CATCH_TEST_CASE("dynamic, multiply1")
+{
+  cml::matrixd M1(131,70), M2(70,97);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = double((i+2*j)%7) - 3.;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = double((3*i+j)%5) - 2.;
+
+  cml::matrixd M;
+  cml::multiply(M, M1, M2);
+  CATCH_REQUIRE(M.rows() == 131);
+  CATCH_REQUIRE(M.cols() == 97);
+  auto P = M1*M2;
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) CATCH_CHECK(M(i,j) == P(i,j));
+
+  /* Reusing the destination does not reallocate: */
+  const double* data = M.data();
+  cml::multiply(M, M1, M2);
+  CATCH_CHECK(M.data() == data);
+}
+
+CATCH_TEST_CASE("dynamic, gemm1")
+{
+  cml::matrixd_c M1(67,300), M2(300,45), M(67,45);
+  for(int i = 0; i < M1.rows(); ++ i)
+    for(int j = 0; j < M1.cols(); ++ j) M1(i,j) = double((i*j)%9) - 4.;
+  for(int i = 0; i < M2.rows(); ++ i)
+    for(int j = 0; j < M2.cols(); ++ j) M2(i,j) = double((i+5*j)%3) - 1.;
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j) M(i,j) = double(i-j);
+
+  auto P = M1*M2;
+  cml::gemm(M, -1., M1, M2, 3.);
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j)
+      CATCH_CHECK(M(i,j) == 3.*double(i-j) - P(i,j));
+}
+
+CATCH_TEST_CASE("dynamic, gemm2")
+{
+  /* C must already have the size of the product when beta != 0: */
+  cml::matrixd M1(3,2), M2(2,4), M(3,3);
+  CATCH_REQUIRE_THROWS_AS(
+    cml::gemm(M, 1., M1, M2, 1.), cml::matrix_size_error);
+  CATCH_REQUIRE_THROWS_AS(
+    cml::multiply(M, M1, M1), cml::incompatible_matrix_inner_size_error);
+}
+
+CATCH_TEST_CASE("dynamic, gemv1")
+{
+  cml::matrixd M(
+    2,3,
+    1., 2., 3.,
+    4., 5., 6.
+    );
+  cml::vectord x(1., 0., -1.), y;
+
+  cml::multiply(y, M, x);
+  CATCH_REQUIRE(y.size() == 2);
+  CATCH_CHECK(y[0] == -2.);
+  CATCH_CHECK(y[1] == -2.);
+
+  y.set(1., 2.);
+  cml::gemv(y, 2., M, x, 0.5);
+  CATCH_CHECK(y[0] == -3.5);
+  CATCH_CHECK(y[1] == -3.);
+}
+
+#ifndef NDEBUG
+CATCH_TEST_CASE("dynamic, alias1")
+{
+  cml::matrixd M1(
+    2,2,
+    1., 2.,
+    3., 4.
+    );
+  cml::matrixd M2 = M1;
+  CATCH_REQUIRE_THROWS_AS(
+    cml::multiply(M1, M1, M2), cml::product_alias_error);
+  CATCH_REQUIRE_THROWS_AS(
+    cml::gemm(M2, 1., M1, M2, 0.), cml::product_alias_error);
+  CATCH_REQUIRE_THROWS_AS(
+    cml::multiply(M1, cml::transpose(M1), M2), cml::product_alias_error);
+
+  double av[] = { 1., 2., 3., 4. };
+  cml::externalmnd E(av, 2,2);
+  cml::vectord x(1., 1.);
+  cml::externalnd y(av, 2);
+  CATCH_REQUIRE_THROWS_AS(
+    cml::multiply(y, E, x), cml::product_alias_error);
+}
+#endif
+
+CATCH_TEST_CASE("dynamic, expression1")
+{
+  /* Expression operands are evaluated before C is written: */
+  cml::matrixd C(
+    2,2,
+    1., 2.,
+    3., 4.
+    );
+  cml::matrixd D(
+    2,2,
+    1., 0.,
+    0., 1.
+    );
+  cml::matrixd B(
+    2,2,
+    0., 1.,
+    1., 0.
+    );
+
+  cml::matrixd P = (C + D)*B;
+  cml::multiply(C, C + D, B);
+  for(int i = 0; i < 2; ++ i)
+    for(int j = 0; j < 2; ++ j) CATCH_CHECK(C(i,j) == P(i,j));
+
+  P = (2.*C)*B;
+  cml::gemm(C, 1., 2.*C, B, 0.);
+  for(int i = 0; i < 2; ++ i)
+    for(int j = 0; j < 2; ++ j) CATCH_CHECK(C(i,j) == P(i,j));
+}
+
+CATCH_TEST_CASE("dynamic, expression2")
+{
+  /* A vector expression is evaluated once, before y is written: */
+  cml::matrixd M(
+    2,2,
+    1., 2.,
+    3., 4.
+    );
+  cml::vectord y(1., 2.), z(1., -1.);
+
+  cml::multiply(y, M, y + z);
+  CATCH_CHECK(y[0] == 4.);
+  CATCH_CHECK(y[1] == 10.);
+
+  cml::gemv(y, 1., M, y - z, 0.);
+  CATCH_CHECK(y[0] == 25.);
+  CATCH_CHECK(y[1] == 53.);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,70 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/parallel_lu.h>
+
+#include <random>
+
+#include <cml/matrix/fixed.h>
+#include <cml/matrix/dynamic.h>
+#include <cml/types.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+CATCH_TEST_CASE("fixed, lu_pivot1")
+{
+  auto A = cml::matrix44d(
+     2.,  0.,  2.,  .6,
+     3.,  3.,  4.,  -2.,
+     5.,  5.,  4.,   2.,
+    -1., -2., 3.4,  -1.
+    );
+  auto lup = cml::parallel::lu_pivot(A, 4);
+  CATCH_CHECK(lup.sign == -1);
+
+  std::array<int,4> order = { 2, 0, 3, 1 };
+  for(int i = 0; i < 4; ++ i)
+    CATCH_CHECK(lup.order[i] == order[i]);
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot1")
+{
+  /* Large enough for the trailing updates to be split: */
+  const int N = 300;
+  cml::matrixd A(N,N);
+  std::mt19937 rng(N);
+  for(int i = 0; i < N; ++ i)
+    for(int j = 0; j < N; ++ j) A(i,j) = rng()/4294967296. - .5;
+
+  auto expected = cml::lu_pivot(A);
+  CATCH_REQUIRE(expected.sign != 0);
+  for(int threads : { 1, 2, 3 }) {
+    auto lup = cml::parallel::lu_pivot(A, threads);
+    CATCH_CHECK(lup.sign == expected.sign);
+    CATCH_CHECK(lup.order == expected.order);
+
+    bool same = true;
+    for(int i = 0; i < N; ++ i)
+      for(int j = 0; j < N; ++ j)
+	same = same && (lup.lu(i,j) == expected.lu(i,j));
+    CATCH_CHECK(same);
+  }
+}
+
+CATCH_TEST_CASE("dynamic, lu_pivot2")
+{
+  cml::matrixd A(3,3);
+  A.zero();
+  cml::lu_pivot_result<cml::matrixd> lup(A);
+  cml::parallel::lu_pivot(lup, 2);
+  CATCH_CHECK(lup.sign == 0);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,129 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/parallel_multiply.h>
+
+#include <cml/matrix/fixed.h>
+#include <cml/matrix/dynamic.h>
+#include <cml/types.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill M with non-integer values, so that the results depend on the
+ * summation order:
+ */
+template<class Matrix> void
+fill(Matrix& M, int seed)
+{
+  for(int i = 0; i < M.rows(); ++ i)
+    for(int j = 0; j < M.cols(); ++ j)
+      M(i,j) = 1. / (1 + ((i*31 + j*17 + seed) % 97)) - .0125;
+}
+
+/* Return true if A and B have the same size and elements: */
+template<class Matrix1, class Matrix2> bool
+same(const Matrix1& A, const Matrix2& B)
+{
+  if(A.rows() != B.rows() || A.cols() != B.cols()) return false;
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j)
+      if(A(i,j) != B(i,j)) return false;
+  return true;
+}
+
+} // namespace
+
+
+CATCH_TEST_CASE("fixed, multiply1")
+{
+  cml::matrix22d M1(
+    1., 2.,
+    3., 4.
+    );
+  cml::matrix22d M2(
+    5., 6.,
+    7., 8.
+    );
+
+  cml::matrix22d M;
+  cml::parallel::multiply(M, M1, M2, 4);
+  CATCH_CHECK(M(0,0) == 19.);
+  CATCH_CHECK(M(0,1) == 22.);
+  CATCH_CHECK(M(1,0) == 43.);
+  CATCH_CHECK(M(1,1) == 50.);
+}
+
+CATCH_TEST_CASE("dynamic, multiply1")
+{
+  /* Tall result, split by rows: */
+  cml::matrixd A(301,275), B(275,133);
+  fill(A, 1); fill(B, 2);
+
+  cml::matrixd S;
+  cml::multiply(S, A, B);
+  for(int threads : { 1, 2, 3, 7 }) {
+    cml::matrixd M;
+    cml::parallel::multiply(M, A, B, threads);
+    CATCH_CHECK(same(M, S));
+  }
+}
+
+CATCH_TEST_CASE("dynamic, multiply2")
+{
+  /* Wide result, split by columns: */
+  cml::matrixd_c A(97,531), B(531,301);
+  fill(A, 3); fill(B, 4);
+
+  cml::matrixd_c S;
+  cml::multiply(S, A, B);
+  for(int threads : { 1, 2, 5, 16 }) {
+    cml::matrixd_c M;
+    cml::parallel::multiply(M, A, B, threads);
+    CATCH_CHECK(same(M, S));
+  }
+}
+
+CATCH_TEST_CASE("dynamic, multiply3")
+{
+  /* Default thread count: */
+  cml::matrixf A(257,200), B(200,190);
+  fill(A, 5); fill(B, 6);
+
+  cml::matrixf S, M;
+  cml::multiply(S, A, B);
+  cml::parallel::multiply(M, A, B);
+  CATCH_CHECK(same(M, S));
+}
+
+CATCH_TEST_CASE("dynamic, gemm1")
+{
+  cml::matrixd A(210,300), B(300,220), C(210,220);
+  fill(A, 7); fill(B, 8); fill(C, 9);
+
+  cml::matrixd S = C;
+  cml::gemm(S, 2., A, B, .5);
+  for(int threads : { 2, 3, 4 }) {
+    cml::matrixd M = C;
+    cml::parallel::gemm(M, 2., A, B, .5, threads);
+    CATCH_CHECK(same(M, S));
+  }
+}
+
+CATCH_TEST_CASE("dynamic, size_check1")
+{
+  cml::matrixd A(200,200), B(201,200), M;
+  CATCH_REQUIRE_THROWS_AS(
+    cml::parallel::multiply(M, A, B, 4),
+    cml::incompatible_matrix_inner_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,167 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/qr.h>
+
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill A with uniform random elements: */
+template<class Matrix> void
+random_matrix(Matrix& A, int seed)
+{
+  std::mt19937 rng(seed);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j) A(i,j) = rng()/4294967296. - .5;
+}
+
+/* Check that Q^T A is R, with zeros below the diagonal: */
+template<class Matrix> void
+check_qr(const Matrix& A, double epsilon)
+{
+  auto result = cml::qr(A);
+  cml::matrixd QtA = A;
+  cml::qr_apply_transpose(result, QtA);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j) {
+      double r = (i <= j) ? result.qr(i,j) : 0.;
+      CATCH_CHECK(QtA(i,j) == Approx(r).margin(epsilon));
+    }
+}
+
+/* Check that x satisfies the normal equations A^T (A x - b) = 0: */
+template<class Matrix, class Vector, class Solution> void
+check_least_squares(const Matrix& A, const Vector& b, const Solution& x,
+  double epsilon)
+{
+  int m = A.rows(), n = A.cols();
+  CATCH_REQUIRE(x.size() == n);
+  cml::vectord r(m);
+  for(int i = 0; i < m; ++ i) {
+    double s = - b[i];
+    for(int j = 0; j < n; ++ j) s += A(i,j)*x[j];
+    r[i] = s;
+  }
+  for(int j = 0; j < n; ++ j) {
+    double s = 0.;
+    for(int i = 0; i < m; ++ i) s += A(i,j)*r[i];
+    CATCH_CHECK(s == Approx(0.).margin(epsilon));
+  }
+}
+
+} // namespace
+
+CATCH_TEST_CASE("fixed, qr1")
+{
+  auto A = cml::matrix33d(
+    12., -51., 4.,
+    6., 167., -68.,
+    -4., 24., -41.
+    );
+  auto result = cml::qr(A);
+
+  /* R is unique up to the signs of its rows: */
+  auto R = cml::matrix33d(
+    14., 21., -14.,
+    0., 175., -70.,
+    0., 0., 35.
+    );
+  for(int i = 0; i < 3; ++ i) {
+    double sign = (result.qr(i,i) < 0.) ? -1. : 1.;
+    for(int j = i; j < 3; ++ j)
+      CATCH_CHECK(sign*result.qr(i,j) == Approx(R(i,j)).epsilon(1e-12));
+  }
+
+  auto b = cml::vector3d(1., 2., 3.);
+  auto x = cml::qr_solve_least_squares(result, b);
+  auto y = A*x;
+  for(int i = 0; i < 3; ++ i)
+    CATCH_CHECK(y[i] == Approx(b[i]).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, qr_least_squares1")
+{
+  /* Fit a line to 4 points: */
+  cml::matrix<double, cml::fixed<4,2>> A(
+    1., 0.,
+    1., 1.,
+    1., 2.,
+    1., 3.
+    );
+  cml::vector<double, cml::fixed<4>> b(1., 3., 4., 8.);
+  auto x = cml::qr_solve_least_squares(A, b);
+  CATCH_CHECK(x[0] == Approx(.7).epsilon(1e-12));
+  CATCH_CHECK(x[1] == Approx(2.2).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, qr1")
+{
+  cml::matrixd A(40, 12);
+  random_matrix(A, 40);
+  check_qr(A, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, qr_blocked1")
+{
+  /* More columns than one panel: */
+  cml::matrixd A(200, 90);
+  random_matrix(A, 200);
+  check_qr(A, 1e-12);
+
+  cml::matrixd_c B(150, 75);
+  random_matrix(B, 150);
+  check_qr(B, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, qr_least_squares1")
+{
+  const int m = 500, n = 70;
+  cml::matrixd A(m, n);
+  random_matrix(A, m);
+  cml::vectord b(m);
+  std::mt19937 rng(n);
+  for(int i = 0; i < m; ++ i) b[i] = rng()/4294967296. - .5;
+
+  auto x = cml::qr_solve_least_squares(A, b);
+  check_least_squares(A, b, x, 1e-11);
+
+  /* The unblocked factorization gives the same solution: */
+  auto result = cml::qr(A);
+  cml::qr_result<cml::matrixd> unblocked(A);
+  cml::detail::qr_householder(m, n, unblocked.qr.data(), n, 1,
+    unblocked.tau.data());
+  auto y = cml::qr_solve_least_squares(unblocked, b);
+  for(int i = 0; i < n; ++ i) CATCH_CHECK(x[i] == Approx(y[i]).epsilon(1e-10));
+}
+
+CATCH_TEST_CASE("dynamic, qr_rank_deficient1")
+{
+  cml::matrixd A(10, 3);
+  random_matrix(A, 10);
+  for(int i = 0; i < 10; ++ i) A(i,2) = A(i,0) - 2.*A(i,1);
+  cml::vectord b(10);
+  b.zero();
+  CATCH_CHECK_THROWS_AS(
+    cml::qr_solve_least_squares(A, b), std::invalid_argument);
+}
+
+CATCH_TEST_CASE("dynamic, qr_size_checking1")
+{
+  CATCH_CHECK_THROWS_AS(
+    cml::qr(cml::matrixd(3, 4)), cml::minimum_matrix_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,239 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/matrix/svd.h>
+
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Fill A with uniform random elements: */
+template<class Matrix> void
+random_matrix(Matrix& A, int seed)
+{
+  std::mt19937 rng(seed);
+  for(int i = 0; i < A.rows(); ++ i)
+    for(int j = 0; j < A.cols(); ++ j) A(i,j) = rng()/4294967296. - .5;
+}
+
+/* Check that the columns of Q are orthonormal: */
+template<class Matrix> void
+check_orthonormal(const Matrix& Q, double epsilon)
+{
+  for(int j = 0; j < Q.cols(); ++ j)
+    for(int k = 0; k < Q.cols(); ++ k) {
+      double s = 0.;
+      for(int i = 0; i < Q.rows(); ++ i) s += Q(i,j)*Q(i,k);
+      CATCH_CHECK(s == Approx(j == k ? 1. : 0.).margin(epsilon));
+    }
+}
+
+/* Check that U diag(S) V^T reconstructs A, with orthonormal U and V and
+ * decreasing S, and that singular_values() gives the same S:
+ */
+template<class Matrix> void
+check_svd(const Matrix& A, double epsilon, int sweeps = 0)
+{
+  typedef cml::value_type_trait_of_t<Matrix>		value_type;
+  int m = A.rows(), n = A.cols();
+
+  cml::matrix<value_type, cml::dynamic<>> U, V;
+  cml::vector<value_type, cml::dynamic<>> S, T;
+  cml::svd(A, U, S, V, sweeps);
+  CATCH_REQUIRE(U.rows() == m);
+  CATCH_REQUIRE(U.cols() == n);
+  CATCH_REQUIRE(S.size() == n);
+  CATCH_REQUIRE(V.rows() == n);
+  CATCH_REQUIRE(V.cols() == n);
+
+  for(int j = 0; j < n; ++ j) {
+    CATCH_CHECK(S[j] >= 0.);
+    if(j > 0) CATCH_CHECK(S[j-1] >= S[j]);
+  }
+  check_orthonormal(U, epsilon);
+  check_orthonormal(V, epsilon);
+  for(int i = 0; i < m; ++ i)
+    for(int j = 0; j < n; ++ j) {
+      double s = 0.;
+      for(int k = 0; k < n; ++ k) s += U(i,k)*S[k]*V(j,k);
+      CATCH_CHECK(s == Approx(A(i,j)).margin(epsilon));
+    }
+
+  cml::singular_values(A, T, sweeps);
+  CATCH_REQUIRE(T.size() == n);
+  for(int j = 0; j < n; ++ j)
+    CATCH_CHECK(T[j] == Approx(S[j]).margin(epsilon));
+}
+
+/* Check that R S reconstructs A, with orthogonal R and symmetric S: */
+template<class Matrix> void
+check_polar(const Matrix& A, double epsilon, int sweeps = 0)
+{
+  int n = A.rows();
+  Matrix R, S;
+  cml::polar_decomposition(A, R, S, sweeps);
+  check_orthonormal(R, epsilon);
+  for(int i = 0; i < n; ++ i)
+    for(int j = 0; j < n; ++ j) {
+      CATCH_CHECK(S(i,j) == Approx(S(j,i)).margin(epsilon));
+      double s = 0.;
+      for(int k = 0; k < n; ++ k) s += R(i,k)*S(k,j);
+      CATCH_CHECK(s == Approx(A(i,j)).margin(epsilon));
+    }
+}
+
+} // namespace
+
+CATCH_TEST_CASE("fixed, svd1")
+{
+  auto A = cml::matrix22d(
+    3., 0.,
+    4., 5.
+    );
+  cml::matrix22d U, V;
+  cml::vector2d S;
+  cml::svd(A, U, S, V);
+  CATCH_CHECK(S[0] == Approx(3.*std::sqrt(5.)).epsilon(1e-12));
+  CATCH_CHECK(S[1] == Approx(std::sqrt(5.)).epsilon(1e-12));
+  check_svd(A, 1e-12);
+}
+
+CATCH_TEST_CASE("fixed, svd_small")
+{
+  for(int seed = 0; seed < 10; ++ seed) {
+    cml::matrix22d A2;
+    random_matrix(A2, seed);
+    check_svd(A2, 1e-12);
+
+    cml::matrix33d A3;
+    random_matrix(A3, seed);
+    check_svd(A3, 1e-12);
+
+    cml::matrix44d A4;
+    random_matrix(A4, seed);
+    check_svd(A4, 1e-12);
+
+    cml::matrix33f B3;
+    random_matrix(B3, seed);
+    check_svd(B3, 1e-5);
+
+    cml::matrix<double, cml::fixed<4,3>> C;
+    random_matrix(C, seed);
+    check_svd(C, 1e-12);
+  }
+}
+
+CATCH_TEST_CASE("fixed, svd_sweeps")
+{
+  /* A fixed sweep count is enough for well-conditioned matrices: */
+  for(int seed = 0; seed < 10; ++ seed) {
+    cml::matrix33d A;
+    random_matrix(A, seed);
+    for(int i = 0; i < 3; ++ i) A(i,i) += 1.;
+    check_svd(A, 1e-12, 6);
+    check_polar(A, 1e-12, 6);
+  }
+}
+
+CATCH_TEST_CASE("fixed, svd_rank_deficient")
+{
+  cml::matrix33d Z;
+  Z.zero();
+  check_svd(Z, 1e-12);
+
+  /* Rank 1: */
+  auto A = cml::matrix33d(
+    1., 2., 3.,
+    2., 4., 6.,
+    -1., -2., -3.
+    );
+  check_svd(A, 1e-12);
+
+  cml::vector3d S;
+  cml::singular_values(A, S);
+  CATCH_CHECK(S[0] == Approx(std::sqrt(84.)).epsilon(1e-12));
+  CATCH_CHECK(S[1] == Approx(0.).margin(1e-12));
+  CATCH_CHECK(S[2] == Approx(0.).margin(1e-12));
+}
+
+CATCH_TEST_CASE("fixed, polar_decomposition1")
+{
+  /* Perturbing a rotation gives back the rotation and a symmetric S near
+   * the identity:
+   */
+  double c0 = std::cos(.3), s0 = std::sin(.3);
+  double c1 = std::cos(-1.1), s1 = std::sin(-1.1);
+  auto Q = cml::matrix33d(
+    c0, -s0, 0.,
+    s0, c0, 0.,
+    0., 0., 1.
+    ) * cml::matrix33d(
+    1., 0., 0.,
+    0., c1, -s1,
+    0., s1, c1
+    );
+  cml::matrix33d A = Q;
+  A(0,1) += 1e-4;
+  A(2,0) -= 2e-4;
+  check_polar(A, 1e-12);
+
+  cml::matrix33d R, S;
+  cml::polar_decomposition(A, R, S);
+  CATCH_CHECK(R.determinant() == Approx(1.).epsilon(1e-12));
+  for(int i = 0; i < 3; ++ i)
+    for(int j = 0; j < 3; ++ j)
+      CATCH_CHECK(R(i,j) == Approx(Q(i,j)).margin(1e-3));
+
+  for(int seed = 0; seed < 10; ++ seed) {
+    cml::matrix44d B;
+    random_matrix(B, seed);
+    check_polar(B, 1e-12);
+
+    cml::matrix22f C;
+    random_matrix(C, seed);
+    check_polar(C, 1e-5);
+  }
+}
+
+CATCH_TEST_CASE("dynamic, svd1")
+{
+  cml::matrixd A(30, 12);
+  random_matrix(A, 30);
+  check_svd(A, 1e-12);
+
+  cml::matrixd_c B(8, 8);
+  random_matrix(B, 8);
+  check_svd(B, 1e-12);
+  check_polar(B, 1e-12);
+
+  /* Rank deficient: */
+  cml::matrixd C(6, 4);
+  random_matrix(C, 6);
+  for(int i = 0; i < 6; ++ i) C(i,3) = C(i,0) + C(i,1);
+  check_svd(C, 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, svd_size_checking1")
+{
+  cml::matrixd U, V, R, S;
+  cml::vectord s;
+  CATCH_CHECK_THROWS_AS(
+    cml::svd(cml::matrixd(3, 4), U, s, V), cml::minimum_matrix_size_error);
+  CATCH_CHECK_THROWS_AS(
+    cml::polar_decomposition(cml::matrixd(3, 4), R, S),
+    cml::non_square_matrix_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
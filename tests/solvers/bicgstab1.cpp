@@ -0,0 +1,90 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/solvers/bicgstab.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+#include "nonsymmetric_problems.h"
+
+
+CATCH_TEST_CASE("dynamic, convection_diffusion")
+{
+  matrixd A = convection_diffusion(10, .5);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::bicgstab<double> solver(A.rows());
+  solver.set_tolerance(1e-10);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+  CATCH_CHECK(solver.converged());
+  CATCH_CHECK(solver.iterations() > 0);
+  CATCH_CHECK(solver.residual() <= 1e-10);
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, preconditioned")
+{
+  matrixd A = random_dominant(40, 0x1234);
+  vectord b = rhs(40), x0(40), x1(40);
+  x0.zero();
+  x1.zero();
+
+  cml::bicgstab<double> solver;
+  solver.set_tolerance(1e-10);
+  CATCH_REQUIRE(solver.solve(A, x0, b));
+  int plain = solver.iterations();
+
+  cml::jacobi_preconditioner<double> M(A);
+  CATCH_REQUIRE(solver.solve(A, x1, b, M));
+  CATCH_CHECK(solver.iterations() <= plain);
+  CATCH_CHECK(relative_residual(A, x1, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, operator")
+{
+  /* A nonsymmetric tridiagonal operator, applied without a matrix: */
+  int n = 30;
+  auto A = [](const vectord& x, vectord& y) {
+    int n = x.size();
+    for(int i = 0; i < n; ++ i)
+      y[i] = 3.*x[i] - (i > 0 ? 1.5*x[i-1] : 0.)
+	- (i < n-1 ? .5*x[i+1] : 0.);
+  };
+  vectord b = rhs(n), x(n), y(n);
+  x.zero();
+
+  cml::bicgstab<double> solver(n);
+  solver.set_tolerance(1e-12);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+
+  A(x, y);
+  CATCH_CHECK((b - y).length()/b.length() < 1e-10);
+}
+
+CATCH_TEST_CASE("dynamic, statistics")
+{
+  matrixd A = convection_diffusion(10, .5);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::bicgstab<double> solver;
+  solver.set_tolerance(1e-12);
+  solver.set_max_iterations(2);
+  CATCH_CHECK(!solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() == 2);
+  CATCH_CHECK(solver.residual()
+    == Approx(relative_residual(A, x, b)).epsilon(1e-6));
+
+  b.zero();
+  CATCH_CHECK(solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() == 0);
+  CATCH_CHECK(x.length() == 0.);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,217 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/solvers/conjugate_gradient.h>
+
+#include <cmath>
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+typedef cml::vector<double, cml::dynamic<>>		vectord;
+typedef cml::matrix<double, cml::dynamic<>>		matrixd;
+
+/* The 5-point Laplacian of a k x k grid: */
+matrixd laplacian_2d(int k)
+{
+  int n = k*k;
+  matrixd A(n, n);
+  A.zero();
+  for(int i = 0; i < n; ++ i) {
+    A(i,i) = 4.;
+    if(i % k > 0) A(i,i-1) = A(i-1,i) = -1.;
+    if(i >= k) A(i,i-k) = A(i-k,i) = -1.;
+  }
+  return A;
+}
+
+/* A random symmetric positive definite matrix with badly scaled rows and
+ * columns:
+ */
+matrixd random_spd(int n, int seed)
+{
+  std::mt19937 rng(seed);
+  matrixd B(n, n), A(n, n);
+  for(int i = 0; i < n; ++ i)
+    for(int j = 0; j < n; ++ j) B(i,j) = rng()/4294967296. - .5;
+  for(int i = 0; i < n; ++ i)
+    for(int j = 0; j <= i; ++ j) {
+      double s = 0.;
+      for(int k = 0; k < n; ++ k) s += B(k,i)*B(k,j);
+      if(i == j) s += 1.;
+      double scale = (1. + 9.*(i % 4))*(1. + 9.*(j % 4));
+      A(i,j) = A(j,i) = s*scale;
+    }
+  return A;
+}
+
+vectord rhs(int n)
+{
+  vectord b(n);
+  for(int i = 0; i < n; ++ i) b[i] = std::sin(double(i) + 1.);
+  return b;
+}
+
+/* Return ||b - A x||/||b||: */
+double relative_residual(const matrixd& A, const vectord& x, const vectord& b)
+{
+  return (b - A*x).length()/b.length();
+}
+
+} // namespace
+
+
+CATCH_TEST_CASE("dynamic, laplacian")
+{
+  matrixd A = laplacian_2d(8);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::conjugate_gradient<double> cg(A.rows());
+  cg.set_tolerance(1e-10);
+  CATCH_REQUIRE(cg.solve(A, x, b));
+  CATCH_CHECK(cg.converged());
+  CATCH_CHECK(cg.iterations() > 0);
+  CATCH_CHECK(cg.iterations() <= A.rows());
+  CATCH_CHECK(cg.residual() <= 1e-10);
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, jacobi")
+{
+  matrixd A = random_spd(40, 0x1234);
+  vectord b = rhs(40), x0(40), x1(40);
+  x0.zero();
+  x1.zero();
+
+  cml::conjugate_gradient<double> cg;
+  cg.set_tolerance(1e-10);
+  CATCH_REQUIRE(cg.solve(A, x0, b));
+  int plain = cg.iterations();
+
+  cml::jacobi_preconditioner<double> M(A);
+  CATCH_REQUIRE(cg.solve(A, x1, b, M));
+  CATCH_CHECK(cg.iterations() < plain);
+  CATCH_CHECK(relative_residual(A, x1, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, incomplete_cholesky")
+{
+  matrixd A = laplacian_2d(10);
+  vectord b = rhs(A.rows()), x0(A.rows()), x1(A.rows());
+  x0.zero();
+  x1.zero();
+
+  cml::conjugate_gradient<double> cg(A.rows());
+  cg.set_tolerance(1e-10);
+  CATCH_REQUIRE(cg.solve(A, x0, b));
+  int plain = cg.iterations();
+
+  cml::incomplete_cholesky_preconditioner<double> M(A);
+  CATCH_REQUIRE(cg.solve(A, x1, b, M));
+  CATCH_CHECK(cg.iterations() < plain);
+  CATCH_CHECK(relative_residual(A, x1, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, operator")
+{
+  /* The 1D Laplacian, applied without forming the matrix: */
+  int n = 30;
+  auto A = [](const vectord& x, vectord& y) {
+    int n = x.size();
+    for(int i = 0; i < n; ++ i)
+      y[i] = 2.*x[i] - (i > 0 ? x[i-1] : 0.) - (i < n-1 ? x[i+1] : 0.);
+  };
+  vectord b = rhs(n), x(n), y(n);
+  x.zero();
+
+  cml::conjugate_gradient<double> cg(n);
+  cg.set_tolerance(1e-12);
+  CATCH_REQUIRE(cg.solve(A, x, b));
+  CATCH_CHECK(cg.iterations() <= n);
+
+  A(x, y);
+  CATCH_CHECK((b - y).length()/b.length() < 1e-10);
+}
+
+CATCH_TEST_CASE("fixed, matrix")
+{
+  cml::matrix44d A(
+    4., 1., 0., 0.,
+    1., 4., 1., 0.,
+    0., 1., 4., 1.,
+    0., 0., 1., 4.
+    );
+  cml::vector4d b(1., 2., 3., 4.), x(0., 0., 0., 0.);
+
+  cml::conjugate_gradient<double> cg;
+  cg.set_tolerance(1e-14);
+  CATCH_REQUIRE(cg.solve(A, x, b));
+  CATCH_CHECK(cg.iterations() <= 4);
+  cml::vector4d r = b - A*x;
+  CATCH_CHECK(r.length() < 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, initial_guess")
+{
+  matrixd A = laplacian_2d(6);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::conjugate_gradient<double> cg(A.rows());
+  cg.set_tolerance(1e-12);
+  CATCH_REQUIRE(cg.solve(A, x, b));
+
+  /* Restarting from the solution takes no iterations: */
+  cg.set_tolerance(1e-10);
+  CATCH_REQUIRE(cg.solve(A, x, b));
+  CATCH_CHECK(cg.iterations() == 0);
+}
+
+CATCH_TEST_CASE("dynamic, statistics")
+{
+  matrixd A = laplacian_2d(10);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::conjugate_gradient<double> cg;
+  cg.set_tolerance(1e-12);
+  cg.set_max_iterations(3);
+  CATCH_CHECK(cg.max_iterations() == 3);
+  CATCH_CHECK(!cg.solve(A, x, b));
+  CATCH_CHECK(!cg.converged());
+  CATCH_CHECK(cg.iterations() == 3);
+  CATCH_CHECK(cg.residual() > 1e-12);
+  CATCH_CHECK(cg.residual()
+    == Approx(relative_residual(A, x, b)).epsilon(1e-8));
+
+  /* A zero right-hand side has the solution 0: */
+  b.zero();
+  CATCH_CHECK(cg.solve(A, x, b));
+  CATCH_CHECK(cg.iterations() == 0);
+  CATCH_CHECK(cg.residual() == 0.);
+  CATCH_CHECK(x.length() == 0.);
+}
+
+CATCH_TEST_CASE("dynamic, size_mismatch")
+{
+  matrixd A = laplacian_2d(3);
+  vectord b = rhs(9), x(8);
+  cml::conjugate_gradient<double> cg;
+  CATCH_CHECK_THROWS_AS(cg.solve(A, x, b),
+    cml::incompatible_vector_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,126 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/solvers/gmres.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+#include "nonsymmetric_problems.h"
+
+
+CATCH_TEST_CASE("dynamic, convection_diffusion")
+{
+  matrixd A = convection_diffusion(10, .5);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::gmres<double> solver(A.rows());
+  CATCH_CHECK(solver.restart() == 30);
+  solver.set_tolerance(1e-10);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() > 0);
+  CATCH_CHECK(solver.residual() <= 1e-10);
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, restart")
+{
+  /* Restarting more often than the unrestarted iteration count: */
+  matrixd A = convection_diffusion(10, .5);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::gmres<double> solver(A.rows(), 5);
+  solver.set_tolerance(1e-10);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() > 5);
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-9);
+
+  solver.set_restart(10);
+  CATCH_CHECK(solver.restart() == 10);
+  x.zero();
+  CATCH_REQUIRE(solver.solve(A, x, b));
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, exact")
+{
+  /* Without restarts, GMRES is exact after n iterations: */
+  matrixd A = random_dominant(12, 0x5678);
+  vectord b = rhs(12), x(12);
+  x.zero();
+
+  cml::gmres<double> solver(12, 12);
+  solver.set_tolerance(1e-13);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() <= 12);
+  CATCH_CHECK(relative_residual(A, x, b) < 1e-12);
+}
+
+CATCH_TEST_CASE("dynamic, preconditioned")
+{
+  matrixd A = random_dominant(40, 0x1234);
+  vectord b = rhs(40), x0(40), x1(40);
+  x0.zero();
+  x1.zero();
+
+  cml::gmres<double> solver;
+  solver.set_tolerance(1e-10);
+  CATCH_REQUIRE(solver.solve(A, x0, b));
+  int plain = solver.iterations();
+
+  cml::jacobi_preconditioner<double> M(A);
+  CATCH_REQUIRE(solver.solve(A, x1, b, M));
+  CATCH_CHECK(solver.iterations() <= plain);
+  CATCH_CHECK(relative_residual(A, x1, b) < 1e-9);
+}
+
+CATCH_TEST_CASE("dynamic, operator")
+{
+  /* A nonsymmetric tridiagonal operator, applied without a matrix: */
+  int n = 30;
+  auto A = [](const vectord& x, vectord& y) {
+    int n = x.size();
+    for(int i = 0; i < n; ++ i)
+      y[i] = 3.*x[i] - (i > 0 ? 1.5*x[i-1] : 0.)
+	- (i < n-1 ? .5*x[i+1] : 0.);
+  };
+  vectord b = rhs(n), x(n), y(n);
+  x.zero();
+
+  cml::gmres<double> solver(n, 10);
+  solver.set_tolerance(1e-12);
+  CATCH_REQUIRE(solver.solve(A, x, b));
+
+  A(x, y);
+  CATCH_CHECK((b - y).length()/b.length() < 1e-10);
+}
+
+CATCH_TEST_CASE("dynamic, statistics")
+{
+  matrixd A = convection_diffusion(10, .5);
+  vectord b = rhs(A.rows()), x(A.rows());
+  x.zero();
+
+  cml::gmres<double> solver;
+  solver.set_tolerance(1e-12);
+  solver.set_max_iterations(4);
+  CATCH_CHECK(!solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() == 4);
+  CATCH_CHECK(solver.residual()
+    == Approx(relative_residual(A, x, b)).epsilon(1e-6));
+
+  b.zero();
+  CATCH_CHECK(solver.solve(A, x, b));
+  CATCH_CHECK(solver.iterations() == 0);
+  CATCH_CHECK(x.length() == 0.);
+
+  CATCH_CHECK_THROWS_AS(solver.set_restart(0), std::invalid_argument);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
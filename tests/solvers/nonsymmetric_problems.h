@@ -0,0 +1,70 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ *
+ * Nonsymmetric test problems shared by the bicgstab and gmres tests.
+ */
+
+#pragma once
+
+#ifndef Support_GTL_tests_solvers_nonsymmetric_problems_h
+#define Support_GTL_tests_solvers_nonsymmetric_problems_h
+
+#include <cmath>
+#include <random>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+namespace {
+
+typedef cml::vector<double, cml::dynamic<>>		vectord;
+typedef cml::matrix<double, cml::dynamic<>>		matrixd;
+
+/* The 5-point convection-diffusion operator on a k x k grid, with
+ * convection c along both axes:
+ */
+matrixd convection_diffusion(int k, double c)
+{
+  int n = k*k;
+  matrixd A(n, n);
+  A.zero();
+  for(int i = 0; i < n; ++ i) {
+    A(i,i) = 4.;
+    if(i % k > 0) { A(i,i-1) = -1. - c; A(i-1,i) = -1. + c; }
+    if(i >= k) { A(i,i-k) = -1. - c; A(i-k,i) = -1. + c; }
+  }
+  return A;
+}
+
+/* A random nonsymmetric matrix with a badly scaled, dominant diagonal: */
+matrixd random_dominant(int n, int seed)
+{
+  std::mt19937 rng(seed);
+  matrixd A(n, n);
+  for(int i = 0; i < n; ++ i)
+    for(int j = 0; j < n; ++ j) A(i,j) = rng()/4294967296. - .5;
+  for(int i = 0; i < n; ++ i) A(i,i) += double(n)*(1. + 9.*(i % 4));
+  return A;
+}
+
+vectord rhs(int n)
+{
+  vectord b(n);
+  for(int i = 0; i < n; ++ i) b[i] = std::sin(double(i) + 1.);
+  return b;
+}
+
+/* Return ||b - A x||/||b||: */
+double relative_residual(const matrixd& A, const vectord& x, const vectord& b)
+{
+  return (b - A*x).length()/b.length();
+}
+
+} // namespace
+
+#endif
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
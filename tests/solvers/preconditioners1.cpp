@@ -0,0 +1,131 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/solvers/preconditioners.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include <cml/vector.h>
+#include <cml/matrix.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+typedef cml::vector<double, cml::dynamic<>>		vectord;
+typedef cml::matrix<double, cml::dynamic<>>		matrixd;
+
+/* The 5-point Laplacian of a k x k grid: */
+matrixd laplacian_2d(int k)
+{
+  int n = k*k;
+  matrixd A(n, n);
+  A.zero();
+  for(int i = 0; i < n; ++ i) {
+    A(i,i) = 4.;
+    if(i % k > 0) A(i,i-1) = A(i-1,i) = -1.;
+    if(i >= k) A(i,i-k) = A(i-k,i) = -1.;
+  }
+  return A;
+}
+
+} // namespace
+
+
+CATCH_TEST_CASE("dynamic, jacobi")
+{
+  matrixd A(3, 3,
+    2., 1., 0.,
+    1., 4., 1.,
+    0., 1., 0.
+    );
+  vectord r(2., 2., 3.), z(3);
+
+  cml::jacobi_preconditioner<double> M(A);
+  M.apply(r, z);
+  CATCH_CHECK(z[0] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(z[1] == Approx(.5).epsilon(1e-12));
+  CATCH_CHECK(z[2] == Approx(3.).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, incomplete_cholesky_tridiagonal")
+{
+  /* IC(0) of a tridiagonal matrix has no fill-in, so it is exact: */
+  int n = 20;
+  matrixd A(n, n);
+  A.zero();
+  for(int i = 0; i < n; ++ i) {
+    A(i,i) = 2.;
+    if(i > 0) A(i,i-1) = A(i-1,i) = -1.;
+  }
+
+  cml::incomplete_cholesky_preconditioner<double> M(A);
+  CATCH_CHECK(M.nonzeros() == 2*n - 1);
+  CATCH_CHECK(M.shift() == 0.);
+
+  vectord r(n), z(n);
+  for(int i = 0; i < n; ++ i) r[i] = double(i % 3) - 1.;
+  M.apply(r, z);
+
+  vectord Az = A*z;
+  for(int i = 0; i < n; ++ i)
+    CATCH_CHECK(Az[i] == Approx(r[i]).epsilon(0).margin(1e-12));
+}
+
+CATCH_TEST_CASE("dynamic, incomplete_cholesky_pattern")
+{
+  matrixd A = laplacian_2d(6);
+  int n = A.rows();
+
+  cml::incomplete_cholesky_preconditioner<double> M(A);
+  int nonzeros = 0;
+  for(int i = 0; i < n; ++ i)
+    for(int j = 0; j <= i; ++ j) nonzeros += (A(i,j) != 0.);
+  CATCH_CHECK(M.nonzeros() == nonzeros);
+  CATCH_CHECK(M.shift() == 0.);
+
+  /* L L^T matches A on the pattern of A, so applying M to A e_j recovers
+   * e_j closely:
+   */
+  vectord r(n), z(n);
+  for(int i = 0; i < n; ++ i) r[i] = A(i,7);
+  M.apply(r, z);
+  for(int i = 0; i < n; ++ i)
+    CATCH_CHECK(z[i] == Approx(i == 7 ? 1. : 0.).epsilon(0).margin(.1));
+}
+
+CATCH_TEST_CASE("dynamic, incomplete_cholesky_shift")
+{
+  /* Indefinite, so IC(0) breaks down without a diagonal shift: */
+  matrixd A(2, 2,
+    1., 2.,
+    2., 1.
+    );
+  cml::incomplete_cholesky_preconditioner<double> M(A);
+  CATCH_CHECK(M.shift() > 0.);
+
+  vectord r(1., 1.), z(2);
+  M.apply(r, z);
+  CATCH_CHECK(std::isfinite(z[0]));
+  CATCH_CHECK(std::isfinite(z[1]));
+}
+
+CATCH_TEST_CASE("dynamic, incomplete_cholesky_invalid")
+{
+  matrixd A(2, 2,
+    1., 0.,
+    0., 0.
+    );
+  cml::incomplete_cholesky_preconditioner<double> M;
+  CATCH_CHECK_THROWS_AS(M.compute(A), std::invalid_argument);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,322 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/storage/arena_allocator.h>
+
+#include <cstdint>
+#include <cml/vector.h>
+#include <cml/matrix.h>
+#include <cml/matrix/lu.h>
+#include <cml/matrix/cholesky.h>
+#include <cml/matrix/qr.h>
+#include <cml/matrix/inverse.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+/* Stateful allocator counting its live allocations, with propagation on
+ * copy and move assignment selected by Propagate:
+ */
+template<class T, bool Propagate = false> struct counting_allocator
+{
+  typedef T						value_type;
+  typedef std::integral_constant<bool, Propagate>
+    propagate_on_container_copy_assignment;
+  typedef std::integral_constant<bool, Propagate>
+    propagate_on_container_move_assignment;
+
+  template<class U> struct rebind {
+    typedef counting_allocator<U, Propagate>		other;
+  };
+
+  explicit counting_allocator(int* live) : live(live) {}
+
+  template<class U> counting_allocator(
+    const counting_allocator<U, Propagate>& other) : live(other.live) {}
+
+  T* allocate(std::size_t n) {
+    ++ *live; return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    if(p == nullptr) return;
+    -- *live; std::allocator<T>().deallocate(p, n);
+  }
+
+  int* live;
+};
+
+template<class T, class U, bool P> inline bool operator==(
+  const counting_allocator<T,P>& a, const counting_allocator<U,P>& b)
+{
+  return a.live == b.live;
+}
+
+template<class T, class U, bool P> inline bool operator!=(
+  const counting_allocator<T,P>& a, const counting_allocator<U,P>& b)
+{
+  return a.live != b.live;
+}
+
+typedef cml::arena_allocator<void>			arena_alloc;
+typedef cml::vector<double, cml::dynamic<arena_alloc>>	arena_vector;
+typedef cml::matrix<double, cml::dynamic<arena_alloc>>	arena_matrix;
+
+} // namespace
+
+
+CATCH_TEST_CASE("arena, allocate1")
+{
+  cml::arena a(256);
+  void* p = a.allocate(10, 1);
+  void* q = a.allocate(8, 8);
+  CATCH_CHECK(p != q);
+  CATCH_CHECK(reinterpret_cast<std::uintptr_t>(q) % 8 == 0);
+  CATCH_CHECK(a.bytes_used() >= 18);
+
+  /* Larger than a block: */
+  void* r = a.allocate(1024, 16);
+  CATCH_CHECK(reinterpret_cast<std::uintptr_t>(r) % 16 == 0);
+
+  a.release();
+  CATCH_CHECK(a.bytes_used() == 0);
+}
+
+CATCH_TEST_CASE("arena, buffer1")
+{
+  alignas(16) char buffer[64];
+  cml::arena a(buffer, sizeof(buffer));
+  char* p = static_cast<char*>(a.allocate(32, 16));
+  CATCH_CHECK(p == buffer);
+
+  /* Exhaust the buffer: */
+  char* q = static_cast<char*>(a.allocate(64, 8));
+  CATCH_CHECK((q < buffer || q >= buffer + sizeof(buffer)));
+
+  /* Reuse the buffer: */
+  a.release();
+  CATCH_CHECK(a.allocate(8, 8) == buffer);
+}
+
+CATCH_TEST_CASE("arena, scope1")
+{
+  CATCH_CHECK(cml::arena::current() == nullptr);
+  cml::arena a, b;
+  {
+    cml::arena_scope outer(a);
+    CATCH_CHECK(cml::arena::current() == &a);
+    {
+      cml::arena_scope inner(b);
+      CATCH_CHECK(arena_alloc().resource() == &b);
+    }
+    CATCH_CHECK(arena_alloc().resource() == &a);
+  }
+  CATCH_CHECK(arena_alloc().resource() == nullptr);
+}
+
+
+CATCH_TEST_CASE("stateful, size1")
+{
+  /* Stateless allocators take no space: */
+  typedef cml::vector<double, cml::dynamic<>> vector_type;
+  typedef cml::matrix<double, cml::dynamic<>> matrix_type;
+  CATCH_CHECK(sizeof(vector_type) == sizeof(double*) + 2*sizeof(int));
+  CATCH_CHECK(sizeof(matrix_type)
+    == sizeof(cml::matrix<double, cml::dynamic<std::allocator<void>>>));
+  CATCH_CHECK(sizeof(arena_vector) > sizeof(vector_type));
+}
+
+CATCH_TEST_CASE("stateful, vector1")
+{
+  typedef counting_allocator<double> alloc_type;
+  typedef cml::vector<double, cml::dynamic<alloc_type>> vector_type;
+  int live = 0, other_live = 0;
+  {
+    vector_type v(3, alloc_type(&live));
+    v[0] = 1.; v[1] = 2.; v[2] = 3.;
+    CATCH_CHECK(live == 1);
+    CATCH_CHECK(v.get_allocator().live == &live);
+
+    /* Copies inherit the allocator: */
+    vector_type w(v);
+    CATCH_CHECK(w.get_allocator().live == &live);
+    CATCH_CHECK(live == 2);
+
+    /* Expressions take an explicit allocator: */
+    vector_type x(2.*v, alloc_type(&other_live));
+    CATCH_CHECK(x.get_allocator().live == &other_live);
+    CATCH_CHECK(x[2] == 6.);
+
+    /* Moves take the array: */
+    vector_type y(std::move(w));
+    CATCH_CHECK(live == 2);
+    CATCH_CHECK(y.get_allocator().live == &live);
+    CATCH_CHECK(y.size() == 3);
+    CATCH_CHECK(w.size() == 0);
+
+    /* Non-propagating allocators stay with the vector, so move assignment
+     * between different allocators copies:
+     */
+    vector_type z(3, alloc_type(&other_live));
+    z = std::move(y);
+    CATCH_CHECK(z.get_allocator().live == &other_live);
+    CATCH_CHECK(z[1] == 2.);
+    CATCH_CHECK(live == 2);
+    CATCH_CHECK(other_live == 2);
+
+    z = v;
+    CATCH_CHECK(z.get_allocator().live == &other_live);
+  }
+  CATCH_CHECK(live == 0);
+  CATCH_CHECK(other_live == 0);
+}
+
+CATCH_TEST_CASE("stateful, propagate1")
+{
+  typedef counting_allocator<double, true> alloc_type;
+  typedef cml::matrix<double, cml::dynamic<alloc_type>> matrix_type;
+  int live = 0, other_live = 0;
+  {
+    matrix_type A(2, 2, alloc_type(&live));
+    A.identity();
+
+    /* Propagating allocators follow the assigned matrix: */
+    matrix_type B(3, 3, alloc_type(&other_live));
+    B = A;
+    CATCH_CHECK(B.get_allocator().live == &live);
+    CATCH_CHECK(other_live == 0);
+    CATCH_CHECK(live == 2);
+
+    matrix_type C(1, 1, alloc_type(&other_live));
+    C = std::move(B);
+    CATCH_CHECK(C.get_allocator().live == &live);
+    CATCH_CHECK(C.rows() == 2);
+    CATCH_CHECK(C(1,1) == 1.);
+    CATCH_CHECK(other_live == 0);
+  }
+  CATCH_CHECK(live == 0);
+}
+
+CATCH_TEST_CASE("stateful, small1")
+{
+  typedef counting_allocator<double> alloc_type;
+  typedef cml::vector<double, cml::small<2, alloc_type>> vector_type;
+  int live = 0, other_live = 0;
+  {
+    vector_type v(4, alloc_type(&live));
+    CATCH_CHECK(live == 1);
+
+    vector_type w(std::move(v));
+    CATCH_CHECK(w.get_allocator().live == &live);
+    CATCH_CHECK(live == 1);
+
+    vector_type x(1, alloc_type(&other_live));
+    x = std::move(w);
+    CATCH_CHECK(x.size() == 4);
+    CATCH_CHECK(x.get_allocator().live == &other_live);
+    CATCH_CHECK(live == 1);
+    CATCH_CHECK(other_live == 1);
+  }
+  CATCH_CHECK(live == 0);
+  CATCH_CHECK(other_live == 0);
+}
+
+
+CATCH_TEST_CASE("arena, temporaries1")
+{
+  cml::arena a;
+  arena_matrix A(2, 2, arena_alloc(a));
+  A(0,0) = 4.; A(0,1) = 1.;
+  A(1,0) = 2.; A(1,1) = 3.;
+  arena_vector b(2, arena_alloc(a));
+  b[0] = 1.; b[1] = 2.;
+
+  arena_matrix P = A*A;
+  CATCH_CHECK(P.get_allocator().resource() == &a);
+
+  arena_matrix I = cml::inverse(A);
+  CATCH_CHECK(I.get_allocator().resource() == &a);
+
+  auto LU = cml::lu(A);
+  CATCH_CHECK(LU.get_allocator().resource() == &a);
+
+  auto x = cml::lu_solve(LU, b);
+  CATCH_CHECK(x.get_allocator().resource() == &a);
+  CATCH_CHECK(x[0] == Approx(.1).epsilon(1e-12));
+  CATCH_CHECK(x[1] == Approx(.6).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("arena, temporaries2")
+{
+  cml::arena a;
+  arena_matrix A(2, 2, arena_alloc(a));
+  A(0,0) = 4.; A(0,1) = 1.;
+  A(1,0) = 1.; A(1,1) = 3.;
+  arena_vector b(2, arena_alloc(a));
+  b[0] = 1.; b[1] = 2.;
+  arena_matrix B(2, 1, arena_alloc(a));
+  B(0,0) = 1.; B(1,0) = 2.;
+
+  /* Solutions take the allocator of the right-hand side: */
+  auto chol = cml::cholesky(A);
+  auto x = cml::cholesky_solve(chol, b);
+  CATCH_CHECK(x.get_allocator().resource() == &a);
+  CATCH_CHECK(x[0] == Approx(1./11.).epsilon(1e-12));
+  CATCH_CHECK(x[1] == Approx(7./11.).epsilon(1e-12));
+  auto X = cml::cholesky_solve(chol, B);
+  CATCH_CHECK(X.get_allocator().resource() == &a);
+
+  auto fact = cml::ldlt(A);
+  auto y = cml::ldlt_solve(fact, b);
+  CATCH_CHECK(y.get_allocator().resource() == &a);
+  CATCH_CHECK(y[1] == Approx(7./11.).epsilon(1e-12));
+  auto Y = cml::ldlt_solve(fact, B);
+  CATCH_CHECK(Y.get_allocator().resource() == &a);
+}
+
+CATCH_TEST_CASE("arena, temporaries3")
+{
+  cml::arena a;
+  arena_matrix A(3, 2, arena_alloc(a));
+  A(0,0) = 1.; A(0,1) = 0.;
+  A(1,0) = 0.; A(1,1) = 1.;
+  A(2,0) = 1.; A(2,1) = 1.;
+  arena_vector b(3, arena_alloc(a));
+  b[0] = 1.; b[1] = 2.; b[2] = 3.;
+
+  /* The least squares solution takes the allocator of the factors: */
+  auto x = cml::qr_solve_least_squares(cml::qr(A), b);
+  CATCH_CHECK(x.get_allocator().resource() == &a);
+  CATCH_CHECK(x[0] == Approx(1.).epsilon(1e-12));
+  CATCH_CHECK(x[1] == Approx(2.).epsilon(1e-12));
+}
+
+CATCH_TEST_CASE("arena, scope2")
+{
+  cml::arena a;
+  arena_vector v(2, arena_alloc(a)), w(2, arena_alloc(a));
+  v[0] = 1.; v[1] = 2.;
+  w[0] = 3.; w[1] = 4.;
+
+  /* Expression nodes carry no allocator, so the result uses the current
+   * arena:
+   */
+  {
+    cml::arena_scope scope(a);
+    arena_vector s(v + w);
+    CATCH_CHECK(s.get_allocator().resource() == &a);
+  }
+  arena_vector s(v + w);
+  CATCH_CHECK(s.get_allocator().resource() == nullptr);
+  CATCH_CHECK(s[1] == 6.);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,106 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+// Make sure the main header compiles cleanly:
+#include <cml/storage/aligned_allocator.h>
+
+#include <cstdint>
+#include <vector>
+#include <cml/vector.h>
+#include <cml/matrix.h>
+#include <cml/quaternion.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+
+namespace {
+
+template<class T> bool is_aligned(const T* p, int align)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % std::uintptr_t(align) == 0;
+}
+
+} // namespace
+
+
+CATCH_TEST_CASE("fixed, default_alignment")
+{
+  const int simd16 = (cml::max_default_alignment < 16)
+    ? cml::max_default_alignment : 16;
+
+  /* 16-byte arrays are aligned to 16 bytes, up to the maximum: */
+  CATCH_CHECK(int(cml::vector4f::alignment) == simd16);
+  CATCH_CHECK(alignof(cml::vector4f) == std::size_t(simd16));
+  CATCH_CHECK(int(cml::quaternionf_ip::alignment) == simd16);
+  CATCH_CHECK(alignof(cml::quaternionf_ip) == std::size_t(simd16));
+
+  /* 32- and 64-byte arrays are aligned up to the maximum: */
+  CATCH_CHECK(int(cml::vector4d::alignment) == cml::max_default_alignment);
+  CATCH_CHECK(int(cml::matrix44f::alignment) == cml::max_default_alignment);
+  CATCH_CHECK(int(cml::matrix44d::alignment) == cml::max_default_alignment);
+  CATCH_CHECK(alignof(cml::matrix44d)
+    == std::size_t(cml::max_default_alignment));
+
+  /* Other arrays keep the element alignment, and sizes are unchanged: */
+  CATCH_CHECK(int(cml::vector3f::alignment) == int(alignof(float)));
+  CATCH_CHECK(sizeof(cml::vector3f) == 3*sizeof(float));
+  CATCH_CHECK(sizeof(cml::vector4d) == 4*sizeof(double));
+  CATCH_CHECK(sizeof(cml::matrix44f) == 16*sizeof(float));
+}
+
+CATCH_TEST_CASE("fixed, explicit_alignment")
+{
+  typedef cml::vector<float, cml::compiled<4,-1,32>>	vector4f_a32;
+  typedef cml::vector<float, cml::compiled<3,-1,16>>	vector3f_a16;
+  typedef cml::matrix<float, cml::compiled<3,3,64>>	matrix33f_a64;
+
+  CATCH_CHECK(int(vector4f_a32::alignment) == 32);
+  CATCH_CHECK(alignof(vector4f_a32) == 32);
+  CATCH_CHECK(alignof(vector3f_a16) == 16);
+  CATCH_CHECK(sizeof(vector3f_a16) == 16);
+  CATCH_CHECK(alignof(matrix33f_a64) == 64);
+  CATCH_CHECK(int(cml::storage_alignment_of<matrix33f_a64>::value) == 64);
+
+  vector4f_a32 v[3];
+  for(int i = 0; i < 3; ++ i) CATCH_CHECK(is_aligned(v[i].data(), 32));
+
+  /* Aligned and default-aligned vectors mix freely: */
+  v[0] = vector4f_a32(1.f, 2.f, 3.f, 4.f);
+  cml::vector4f w = v[0] + cml::vector4f(1.f, 1.f, 1.f, 1.f);
+  CATCH_CHECK(w[3] == 5.f);
+}
+
+CATCH_TEST_CASE("dynamic, aligned_allocator")
+{
+  typedef cml::aligned_allocator<void, 32>		allocator_type;
+  typedef cml::vector<double, cml::dynamic<allocator_type>>	vectord_a32;
+  typedef cml::matrix<float, cml::dynamic<allocator_type>>	matrixf_a32;
+
+  CATCH_CHECK(int(vectord_a32::alignment) == 32);
+  CATCH_CHECK(int(matrixf_a32::alignment) == 32);
+  CATCH_CHECK(int(cml::vectord::alignment) == int(alignof(double)));
+
+  for(int n = 1; n < 20; ++ n) {
+    vectord_a32 v(n);
+    CATCH_CHECK(is_aligned(v.data(), 32));
+    matrixf_a32 M(n, n+1);
+    CATCH_CHECK(is_aligned(M.data(), 32));
+  }
+
+  /* Expression temporaries keep the allocator: */
+  vectord_a32 a(7), b(7);
+  auto c = a + b;
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(c)>, vectord_a32>::value));
+
+  /* The allocator also works with standard containers: */
+  std::vector<int, cml::aligned_allocator<int, 64>> x(33, 1);
+  CATCH_CHECK(is_aligned(x.data(), 64));
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -47,5 +47,39 @@ CATCH_TEST_CASE("basic1")
 #undef _CHECK
 }
 
+CATCH_TEST_CASE("small1")
+{
+  using cml::compiled;
+  using cml::allocated;
+  using cml::external;
+  using cml::any_storage;
+  using cml::small;
+  using cml::vector_storage_tag;
+  using cml::rebind_t;
+
+  typedef rebind_t<compiled<3>, vector_storage_tag>	compiled_type;
+  typedef rebind_t<allocated<>, vector_storage_tag>	allocated_type;
+  typedef rebind_t<external<>, vector_storage_tag>	external_type;
+  typedef rebind_t<any_storage<>, vector_storage_tag>	any_type;
+  typedef rebind_t<small<8>, vector_storage_tag>	small8_type;
+  typedef rebind_t<small<4>, vector_storage_tag>	small4_type;
+
+#define _CHECK(_S1, _S2, _S)						\
+  CATCH_CHECK((check_c<_S1, _S2, _S>::value));				\
+  CATCH_CHECK((check_c<_S2, _S1, _S>::value))
+
+    _CHECK( small8_type,	small8_type,	small<8>	 );
+    _CHECK( small8_type,	small4_type,	small<8>	 );
+    _CHECK( small8_type,	allocated_type,	small<8>	 );
+    _CHECK( small8_type,	external_type,	small<8>	 );
+    _CHECK( small8_type,	any_type,	small<8>	 );
+    _CHECK( small8_type,	compiled_type,	compiled<>	 );
+#undef _CHECK
+
+  /* Prefer small<> if one of the types is dynamic-size: */
+  CATCH_CHECK((std::is_same<cml::storage_promote_t<
+      compiled_type, small8_type, true>, small<8>>::value));
+}
+
 // -------------------------------------------------------------------------
 // vim:ft=cpp:sw=2
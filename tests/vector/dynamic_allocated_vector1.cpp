@@ -44,6 +44,45 @@ CATCH_TEST_CASE("resize1")
   CATCH_REQUIRE(v.size() == 5);
 }
 
+CATCH_TEST_CASE("resize2")
+{
+  cml::vectord v = { 1., 2., 3. };
+  CATCH_REQUIRE(v.capacity() == 3);
+
+  /* Growing keeps the elements, and reserves extra capacity: */
+  v.resize(4);
+  CATCH_REQUIRE(v.size() == 4);
+  CATCH_CHECK(v.capacity() >= 6);
+  CATCH_CHECK(v[2] == 3.);
+
+  /* Shrinking and regrowing within the capacity does not reallocate: */
+  const double* p = v.data();
+  v.resize(1);
+  v.resize(5);
+  CATCH_CHECK(v.data() == p);
+  CATCH_CHECK(v[0] == 1.);
+}
+
+CATCH_TEST_CASE("reserve1")
+{
+  cml::vectord v = { 1., 2. };
+  v.reserve(10);
+  CATCH_REQUIRE(v.size() == 2);
+  CATCH_REQUIRE(v.capacity() == 10);
+  CATCH_CHECK(v[1] == 2.);
+
+  const double* p = v.data();
+  v.resize(10);
+  CATCH_CHECK(v.data() == p);
+
+  v.resize(3);
+  v.shrink_to_fit();
+  CATCH_CHECK(v.capacity() == 3);
+  CATCH_CHECK(v[1] == 2.);
+
+  CATCH_CHECK_THROWS_AS(v.reserve(-1), std::invalid_argument);
+}
+
 CATCH_TEST_CASE("array_construct")
 {
   double data[] = { 1., 2., 3. };
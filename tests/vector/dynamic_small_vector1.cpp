@@ -0,0 +1,157 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#include <utility>
+
+#include <cml/vector/dynamic_small.h>
+#include <cml/vector.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+namespace {
+
+typedef cml::vector<double, cml::small<4>>		vectord_s4;
+
+} // namespace
+
+CATCH_TEST_CASE("alloc1")
+{
+  vectord_s4 v(3);
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v.is_inline());
+}
+
+CATCH_TEST_CASE("alloc2")
+{
+  vectord_s4 v(9);
+  CATCH_REQUIRE(v.size() == 9);
+  CATCH_CHECK(!v.is_inline());
+}
+
+CATCH_TEST_CASE("resize1")
+{
+  vectord_s4 v = { 1., 2., 3. };
+  CATCH_REQUIRE(v.is_inline());
+
+  /* Growing past the buffer spills to the heap, keeping the elements: */
+  v.resize(6);
+  CATCH_REQUIRE(v.size() == 6);
+  CATCH_CHECK(!v.is_inline());
+  CATCH_CHECK(v[0] == 1.);
+  CATCH_CHECK(v[2] == 3.);
+
+  /* Shrinking reuses the heap array: */
+  const double* p = v.data();
+  v.resize(2);
+  CATCH_REQUIRE(v.size() == 2);
+  CATCH_CHECK(v.data() == p);
+  CATCH_CHECK(v[1] == 2.);
+  v.resize(5);
+  CATCH_CHECK(v.data() == p);
+
+  CATCH_CHECK_THROWS_AS(v.resize(-1), std::invalid_argument);
+}
+
+CATCH_TEST_CASE("reserve1")
+{
+  vectord_s4 v = { 1., 2. };
+  CATCH_REQUIRE(v.capacity() == 4);
+  v.reserve(10);
+  CATCH_REQUIRE(v.capacity() == 10);
+  CATCH_CHECK(!v.is_inline());
+  CATCH_CHECK(v[1] == 2.);
+
+  /* Shrinking returns to the inline buffer when the elements fit: */
+  v.shrink_to_fit();
+  CATCH_CHECK(v.is_inline());
+  CATCH_CHECK(v.capacity() == 4);
+  CATCH_CHECK(v[1] == 2.);
+}
+
+CATCH_TEST_CASE("element_construct1")
+{
+  vectord_s4 v(1., 2., 3.);
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v[0] == 1.);
+  CATCH_CHECK(v[2] == 3.);
+}
+
+CATCH_TEST_CASE("pointer_construct1")
+{
+  double data[] = { 1., 2., 3., 4., 5. };
+  vectord_s4 v(&data[0], 5);
+  CATCH_REQUIRE(v.size() == 5);
+  CATCH_CHECK(v[4] == 5.);
+}
+
+CATCH_TEST_CASE("copy1")
+{
+  vectord_s4 v = { 1., 2., 3., 4., 5., 6. }, w(v);
+  CATCH_REQUIRE(w.size() == 6);
+  CATCH_CHECK(w.data() != v.data());
+  CATCH_CHECK(w[5] == 6.);
+
+  vectord_s4 x = { 1., 2. };
+  w = x;
+  CATCH_REQUIRE(w.size() == 2);
+  CATCH_CHECK(w[1] == 2.);
+}
+
+CATCH_TEST_CASE("move1")
+{
+  /* Heap arrays are transferred: */
+  vectord_s4 v = { 1., 2., 3., 4., 5., 6. };
+  const double* p = v.data();
+  vectord_s4 w(std::move(v));
+  CATCH_CHECK(w.data() == p);
+  CATCH_CHECK(w[5] == 6.);
+  CATCH_CHECK(v.size() == 0);
+  CATCH_CHECK(v.is_inline());
+
+  /* Inline elements are copied: */
+  vectord_s4 x = { 7., 8. };
+  w = std::move(x);
+  CATCH_REQUIRE(w.size() == 2);
+  CATCH_CHECK(w[1] == 8.);
+  CATCH_CHECK(x.size() == 0);
+
+  w = std::move(w);
+  CATCH_CHECK(w.size() == 2);
+}
+
+CATCH_TEST_CASE("temporary1")
+{
+  vectord_s4 v = { 1., 2., 3. };
+  cml::vectord w = { 1., 1., 1. };
+
+  /* Temporaries mixing small<> and allocated<> vectors are small<>: */
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(v + w)>, vectord_s4>::value));
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(w - v)>, vectord_s4>::value));
+
+  /* Fixed-size operands still yield fixed-size temporaries: */
+  CATCH_CHECK((std::is_same<
+      cml::temporary_of_t<decltype(v + cml::vector3d())>,
+      cml::vector3d>::value));
+
+  vectord_s4 x = v + w;
+  CATCH_REQUIRE(x.size() == 3);
+  CATCH_CHECK(x.is_inline());
+  CATCH_CHECK(x[2] == 4.);
+  CATCH_CHECK(cml::dot(x, w) == 9.);
+}
+
+CATCH_TEST_CASE("size_check1")
+{
+  vectord_s4 v(3);
+  CATCH_REQUIRE_THROWS_AS(
+    (v = vectord_s4(3) + vectord_s4(4)), cml::incompatible_vector_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2
@@ -0,0 +1,158 @@
+/* -*- C++ -*- ------------------------------------------------------------
+ @@COPYRIGHT@@
+ *-----------------------------------------------------------------------*/
+/** @file
+ */
+
+#include <cml/vector.h>
+
+/* Testing headers: */
+#include "catch_runner.h"
+
+namespace {
+
+typedef cml::vector<double, cml::allocated<std::allocator<void>, 3>>
+							vector3d_a;
+
+} // namespace
+
+CATCH_TEST_CASE("typecheck")
+{
+  CATCH_CHECK(int(vector3d_a::array_size) == 3);
+  CATCH_CHECK((std::is_same<vector3d_a::size_tag,cml::fixed_size_tag>::value));
+  CATCH_CHECK(sizeof(vector3d_a) == sizeof(double*));
+
+  /* Temporaries keep the storage type: */
+  typedef cml::temporary_of_t<vector3d_a> temporary_type;
+  CATCH_CHECK((std::is_same<temporary_type, vector3d_a>::value));
+}
+
+CATCH_TEST_CASE("array_construct")
+{
+  double data[] = { 1., 2., 3. };
+  vector3d_a v(data);
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v.data()[0] == 1.);
+  CATCH_CHECK(v[0] == 1.);
+}
+
+CATCH_TEST_CASE("element_construct3")
+{
+  vector3d_a v(1., 2., 3.);
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v[0] == 1.);
+  CATCH_CHECK(v[1] == 2.);
+  CATCH_CHECK(v[2] == 3.);
+}
+
+CATCH_TEST_CASE("combine_construct1")
+{
+  cml::vector2d w(1., 2.);
+  vector3d_a v(w, 3.);
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v[0] == 1.);
+  CATCH_CHECK(v[2] == 3.);
+}
+
+CATCH_TEST_CASE("list_construct")
+{
+  vector3d_a v = { 1., 2., 3. };
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_CHECK(v[2] == 3.);
+}
+
+CATCH_TEST_CASE("copy1")
+{
+  vector3d_a v(1., 2., 3.);
+  vector3d_a w(v);
+  CATCH_CHECK(w.data() != v.data());
+  CATCH_CHECK(w[1] == 2.);
+
+  w[1] = 5.;
+  v = w;
+  CATCH_CHECK(v.data() != w.data());
+  CATCH_CHECK(v[1] == 5.);
+}
+
+CATCH_TEST_CASE("move1")
+{
+  vector3d_a v(1., 2., 3.);
+  const double* p = v.data();
+
+  /* Moves transfer the array: */
+  vector3d_a w(std::move(v));
+  CATCH_CHECK(w.data() == p);
+  CATCH_CHECK(w[2] == 3.);
+
+  vector3d_a x(4., 5., 6.);
+  const double* q = x.data();
+  x = std::move(w);
+  CATCH_CHECK(x.data() == p);
+  CATCH_CHECK(x[0] == 1.);
+  CATCH_CHECK(w.data() == q);
+
+  /* A moved-from vector can be assigned: */
+  v = x;
+  CATCH_CHECK(v.data() != nullptr);
+  CATCH_CHECK(v[1] == 2.);
+}
+
+CATCH_TEST_CASE("move2")
+{
+  vector3d_a v(1., 2., 3.);
+  vector3d_a w(std::move(v));
+
+  /* A moved-from vector can be assigned an expression: */
+  v = w*2.;
+  CATCH_CHECK(v[0] == 2.);
+  CATCH_CHECK(v[2] == 6.);
+
+  /* A moved-from vector is given an array when its elements are written: */
+  vector3d_a x(std::move(w));
+  w[1] = 7.;
+  CATCH_CHECK(w[1] == 7.);
+
+  /* Moving from a moved-from vector leaves the target writable: */
+  vector3d_a y(std::move(v));
+  vector3d_a z(std::move(v));
+  z = x + x;
+  CATCH_CHECK(z[1] == 4.);
+  y = std::move(v);
+  y.put(0, 1.);
+  CATCH_CHECK(y[0] == 1.);
+}
+
+CATCH_TEST_CASE("move3")
+{
+  /* Moves only transfer the array, so they cannot throw: */
+  CATCH_CHECK(std::is_nothrow_move_constructible<vector3d_a>::value);
+  CATCH_CHECK(std::is_nothrow_move_assignable<vector3d_a>::value);
+}
+
+CATCH_TEST_CASE("expression1")
+{
+  vector3d_a v(1., 2., 3.), w(4., 5., 6.);
+  vector3d_a x = v + 2.*w;
+  CATCH_CHECK(x[0] == 9.);
+  CATCH_CHECK(x[2] == 15.);
+
+  /* The allocated fixed size is kept by temporaries: */
+  typedef cml::temporary_of_t<decltype(v - w)> temporary_type;
+  CATCH_CHECK((std::is_same<temporary_type, vector3d_a>::value));
+
+  /* Mixed with compiled vectors, temporaries use compiled<>: */
+  cml::vector3d z(1., 1., 1.);
+  typedef cml::temporary_of_t<decltype(v + z)> mixed_type;
+  CATCH_CHECK((std::is_same<mixed_type, cml::vector3d>::value));
+}
+
+CATCH_TEST_CASE("size_check1")
+{
+  vector3d_a v;
+  CATCH_REQUIRE(v.size() == 3);
+  CATCH_REQUIRE_THROWS_AS(
+    (v = { 1., 2., 3., 4. }), cml::incompatible_vector_size_error);
+}
+
+// -------------------------------------------------------------------------
+// vim:ft=cpp:sw=2